@@ -0,0 +1,14 @@
+// Lots of uses of built-in functions and objects, which have to be looked up by name.
+// Run with E.setFlags({bytecode:false}) first to see it without the bytecode's variable cache
+var t = getTime();
+var x = 0, a = [];
+for (var i=0;i<2000;i++) {
+  x += Math.sin(i) + Math.abs(-i) + Math.round(i/3);
+  a.push(i);
+  if (a.length > 8) a.shift();
+  x += parseInt("12") + a.indexOf(i);
+  x += JSON.stringify(i).length;
+  getTime();
+  peek8;
+}
+console.log("builtin_calls: "+(getTime()-t).toFixed(3)+"s");
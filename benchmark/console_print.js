@@ -0,0 +1,7 @@
+// How fast can long strings be printed to the console?
+var line = "";
+for (var i=0;i<200;i++) line += String.fromCharCode(33+i%90);
+var t = getTime();
+for (var i=0;i<500;i++) console.log(line);
+var el = getTime()-t;
+console.log("console_print: "+el.toFixed(3)+"s for 500 lines of 200 chars");
@@ -0,0 +1,10 @@
+// Time allocating flat strings (Uint8Arrays) as the amount of memory grows
+var keep = [];
+var sizes = [0, 4000, 8000, 16000, 32000];
+sizes.forEach(function(n) {
+  while (keep.length<n) keep.push({a:keep.length});
+  var t = getTime();
+  for (var i=0;i<1000;i++) new Uint8Array(64);
+  t = getTime()-t;
+  console.log("memory: "+process.memory().total+" blocks, 1000 allocations: "+t.toFixed(3)+"s");
+});
@@ -0,0 +1,14 @@
+// Turning 10,000 floats (like sensor readings) into JSON and back again, 100 at a time
+var a = new Float64Array(100);
+var tStringify = 0, tParse = 0, sum = 0;
+for (var n=0;n<100;n++) {
+  for (var i=0;i<100;i++) a[i] = Math.sin(n*100+i)*1000;
+  var t = getTime();
+  var json = JSON.stringify(a);
+  tStringify += getTime()-t;
+  t = getTime();
+  sum += JSON.parse(json)[0];
+  tParse += getTime()-t;
+}
+console.log("float_stringify: "+tStringify.toFixed(3)+"s");
+console.log("float_parse: "+tParse.toFixed(3)+"s");
@@ -0,0 +1,13 @@
+// How fast can characters go through the IO event buffer? Sends bursts through LoopbackA to LoopbackB
+var chunk = "";
+for (var i=0;i<200;i++) chunk += String.fromCharCode(33+i%90);
+var received = 0, events = 0, rounds = 0, t = getTime();
+LoopbackB.on('data', function(d) { received += d.length; events++; });
+function send() {
+  LoopbackA.write(chunk);
+  if (++rounds < 500) setTimeout(send, 0);
+  else setTimeout(function() {
+    console.log("io_loopback: "+(getTime()-t).toFixed(3)+"s for "+received+" chars in "+events+" data events");
+  }, 10);
+}
+send();
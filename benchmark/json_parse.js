@@ -0,0 +1,8 @@
+// Parse a few KB of JSON (like an HTTP response) lots of times
+var items = [];
+for (var i=0;i<40;i++)
+  items.push({id:i, name:"sensor "+i, value:Math.sin(i)*100, ok:(i&1)==0, tags:["a","b"], pos:{x:i, y:-i}});
+var json = JSON.stringify({status:"ok", count:items.length, items:items});
+var t = getTime();
+for (i=0;i<50;i++) JSON.parse(json);
+console.log("json_parse: "+(getTime()-t).toFixed(3)+"s for "+json.length+" bytes x 50");
@@ -0,0 +1,19 @@
+// How long does a round trip between a local TCP server and client take? (and how much CPU does it use?)
+var net = require("net");
+var server = net.createServer(function(c) {
+  c.on('data', function(d) { c.write(d); });
+});
+server.listen(41234);
+var count = 0, t;
+var client = net.connect({host:"127.0.0.1", port:41234}, function() {
+  t = getTime();
+  client.write("x");
+});
+client.on('data', function(d) {
+  if (++count < 1000) client.write("x");
+  else {
+    console.log("net_roundtrip: "+((getTime()-t)*1000/count).toFixed(3)+"ms per round trip");
+    client.end();
+    server.close();
+  }
+});
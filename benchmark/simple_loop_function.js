@@ -0,0 +1,14 @@
+// Like simple_loop3.js, but with the loop body in a function - as it would be in a callback
+function step(i) {
+ /* XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX*/
+  if (i >= 0 && i !== undefined) {
+    return i + 1;
+  } else {
+    return 0;
+  }
+}
+
+for (i=0;i<10000;i=step(i));
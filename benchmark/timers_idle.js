@@ -0,0 +1,11 @@
+// How fast do short timers run when there are lots of long ones waiting?
+for (var i=0;i<500;i++) setTimeout(function(){}, 100000+i);
+var n = 0, t = getTime();
+function tick() {
+  if (++n < 2000) setTimeout(tick, 0);
+  else {
+    console.log("timers_idle: "+(getTime()-t).toFixed(3)+"s for 2000 timeouts with 500 pending");
+    clearTimeout();
+  }
+}
+setTimeout(tick, 0);
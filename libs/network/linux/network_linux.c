@@ -13,6 +13,7 @@
  */
 #include "network.h"
 #include "network_linux.h"
+#include "jshardware.h"
 
 #include <string.h> // for memset
 
@@ -141,6 +142,9 @@ int net_linux_createsocket(JsNetwork *net, uint32_t host, unsigned short port) {
   if (setsockopt(sckt,SOL_SOCKET,SO_NOSIGPIPE,(const char *)&optval,sizeof(optval))<0)
     jsWarn("setsockopt(SO_NOSIGPIPE) failed\n");
 #endif
+#ifdef LINUX_EPOLL
+  jshSleepWakeOnFd(sckt);
+#endif
 
   return sckt;
 }
@@ -166,6 +170,9 @@ int net_linux_accept(JsNetwork *net, int sckt) {
   if (n>0) {
     // we have a client waiting to connect... try to connect and see what happens
     int theClient = accept(sckt,0,0);
+#ifdef LINUX_EPOLL
+    if (theClient >= 0) jshSleepWakeOnFd(theClient);
+#endif
     return theClient;
   }
   return -1;
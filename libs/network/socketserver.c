@@ -48,6 +48,13 @@ extern int os_printf_plus(const char *format, ...)  __attribute__((format(printf
 #define printf os_printf_plus
 #endif
 
+#ifdef LINUX_EPOLL
+/* Linux's jshSleep wakes as soon as a socket can be read or written, so
+ * rather than staying busy whenever we have sockets, we only stay busy
+ * when one of them has actually done something */
+static bool socketActivity;
+#endif
+
 // -----------------------------
 
 static void httpAppendHeaders(JsVar *string, JsVar *headerObject) {
@@ -193,6 +200,9 @@ void _socketConnectionKill(JsNetwork *net, JsVar *connection) {
   if (!net || networkState != NETWORKSTATE_ONLINE) return;
   int sckt = (int)jsvGetIntegerAndUnLock(jsvObjectGetChild(connection,HTTP_NAME_SOCKET,0))-1; // so -1 if undefined
   if (sckt>=0) {
+#ifdef LINUX_EPOLL
+    socketActivity = true;
+#endif
     netCloseSocket(net, sckt);
     jsvObjectRemoveChild(connection,HTTP_NAME_SOCKET);
   }
@@ -231,6 +241,9 @@ int socketSendData(JsNetwork *net, JsVar *connection, int sckt, JsVar **sendData
 
   size_t bufLen = httpStringGet(*sendData, buf, net->chunkSize);
   int num = netSend(net, sckt, buf, bufLen);
+#ifdef LINUX_EPOLL
+  if (num != 0) socketActivity = true;
+#endif
   if (num < 0) return num; // an error occurred
   // Now cut what we managed to send off the beginning of sendData
   if (num > 0) {
@@ -318,6 +331,9 @@ bool socketServerConnectionsIdle(JsNetwork *net) {
 
     if (!closeConnectionNow) {
       int num = netRecv(net, sckt, buf, net->chunkSize);
+#ifdef LINUX_EPOLL
+      if (num != 0) socketActivity = true;
+#endif
       if (num<0) {
         // we probably disconnected so just get rid of this
         closeConnectionNow = true;
@@ -513,6 +529,9 @@ bool socketClientConnectionsIdle(JsNetwork *net) {
         if (!receiveData || !hadHeaders) {
           int num = netRecv(net, sckt, buf, net->chunkSize);
           //if (num != 0) printf("recv returned %d\r\n", num);
+#ifdef LINUX_EPOLL
+          if (num != 0) socketActivity = true;
+#endif
           if (!alreadyConnected && num == SOCKET_ERR_NO_CONN) {
             ; // ignore... it's just telling us we're not connected yet
           } else if (num < 0) {
@@ -604,6 +623,9 @@ bool socketIdle(JsNetwork *net) {
     return false;
   }
   bool hadSockets = false;
+#ifdef LINUX_EPOLL
+  socketActivity = false;
+#endif
   JsVar *arr = socketGetArray(HTTP_ARRAY_HTTP_SERVERS,false);
   if (arr) {
     JsvObjectIterator it;
@@ -616,6 +638,9 @@ bool socketIdle(JsNetwork *net) {
 
       int theClient = netAccept(net, sckt);
       if (theClient >= 0) {
+#ifdef LINUX_EPOLL
+        socketActivity = true;
+#endif
         SocketType socketType = socketGetType(server);
         if ((socketType&ST_TYPE_MASK) == ST_HTTP) {
           JsVar *req = jspNewObject(0, "httpSRq");
@@ -659,6 +684,10 @@ bool socketIdle(JsNetwork *net) {
   if (socketServerConnectionsIdle(net)) hadSockets = true;
   if (socketClientConnectionsIdle(net)) hadSockets = true;
   netCheckError(net);
+#ifdef LINUX_EPOLL
+  if (net->data.type == JSNETWORKTYPE_SOCKET)
+    return socketActivity;
+#endif
   return hadSockets;
 }
 
@@ -140,10 +140,15 @@ def getCDeclaration(jsondata, name):
 
 def codeOutSymbolTable(builtin):
   codeName = builtin["name"]
+  # if something is documented twice, use the last definition (each name can only be in the table once)
+  functionsByName = {}
+  for sym in builtin["functions"]:
+    functionsByName[sym["name"]] = sym
   # sort by name
-  builtin["functions"] = sorted(builtin["functions"], key=lambda n: n["name"]);
+  builtin["functions"] = sorted(functionsByName.values(), key=lambda n: n["name"]);
   # output tables
   listSymbols = []
+  listNames = []
   listChars = ""
   strLen = 0
   for sym in builtin["functions"]:
@@ -153,6 +158,7 @@ def codeOutSymbolTable(builtin):
       continue # don't include libraries on global namespace
     if "generate" in sym:
       listSymbols.append("{"+", ".join([str(strLen), getArgumentSpecifier(sym), "(void (*)(void))"+sym["generate"]])+"}")
+      listNames.append(symName)
       listChars = listChars + symName + "\\0";
       strLen = strLen + len(symName) + 1
     else:
@@ -160,9 +166,71 @@ def codeOutSymbolTable(builtin):
   builtin["symbolTableChars"] = "\""+listChars+"\"";
   builtin["symbolTableCount"] = str(len(listSymbols));
   codeOut("static const JswSymPtr jswSymbols_"+codeName+"[] FLASH_SECT = {\n  "+",\n  ".join(listSymbols)+"\n};");
+  codeOut("#ifdef JSWRAPPER_SYMBOL_HASH")
+  builtin["hash"] = codeOutPerfectHash("jswSymbols_"+codeName+"_hash", listNames)
+  codeOut("#endif")
 
 def codeOutBuiltins(indent, builtin):
-  codeOut(indent+"jswBinarySearch(&jswSymbolTables["+builtin["indexName"]+"], parent, name);");
+  codeOut(indent+"jswSearchSymbolTable(&jswSymbolTables["+builtin["indexName"]+"], parent, name);");
+
+# Perfect hash of a list of names, for jswHashSearch. Each name's hash picks a
+# bucket, and each bucket has a displacement (chosen here) which is added to the
+# hash to give a slot - which contains the index of the only name that can be there.
+# The table is the displacement for each bucket followed by the index in each slot.
+HASH_EMPTY = 255
+
+def hashName(name):
+  h = 2166136261 # FNV-1a - must match jswHashSearch
+  for c in bytearray(name.encode("ascii")):
+    h = ((h ^ c) * 16777619) & 0xFFFFFFFF
+  return h
+
+def hashSlot(h, displacement, slots):
+  x = (h + displacement*0x9E3779B9) & 0xFFFFFFFF
+  x ^= x >> 16
+  x = (x * 0x85EBCA6B) & 0xFFFFFFFF
+  x ^= x >> 13
+  return x % slots
+
+def makePerfectHash(names):
+  if len(names) >= HASH_EMPTY:
+    raise Exception("Too many names ("+str(len(names))+") for a symbol table")
+  hashes = [hashName(n) for n in names]
+  if len(set(hashes)) != len(hashes):
+    raise Exception("Hash collision in symbol names "+str(names))
+  bucketCount = max(1, (len(names)+3) // 4)
+  slotCount = max(1, len(names))
+  while True:
+    buckets = [[] for b in range(bucketCount)]
+    for i in range(len(names)):
+      buckets[hashes[i] % bucketCount].append(i)
+    displacements = [0] * bucketCount
+    slots = [HASH_EMPTY] * slotCount
+    ok = True
+    # fill in the fullest buckets first, while there are still lots of free slots
+    for b in sorted(range(bucketCount), key=lambda b: -len(buckets[b])):
+      for d in range(256):
+        pos = [hashSlot(hashes[i], d, slotCount) for i in buckets[b]]
+        if len(set(pos))==len(pos) and all(slots[p]==HASH_EMPTY for p in pos):
+          for p,i in zip(pos, buckets[b]):
+            slots[p] = i
+          displacements[b] = d
+          break
+      else:
+        ok = False
+        break
+    if ok:
+      return { "buckets" : bucketCount, "slots" : slotCount, "table" : displacements + slots }
+    # no luck - try again with more space
+    slotCount = slotCount + 1
+    if slotCount > 255:
+      bucketCount = bucketCount + 1
+      slotCount = max(1, len(names))
+
+def codeOutPerfectHash(varName, names):
+  hashInfo = makePerfectHash(names)
+  codeOut("static const unsigned char "+varName+"[] FLASH_SECT = {"+",".join([str(x) for x in hashInfo["table"]])+"};")
+  return hashInfo
 
 #================== to remove JS-definitions given by blacklist==============
 def delete_by_indices(lst, indices):
@@ -281,9 +349,42 @@ codeOut('// --------------------------------------------------------------------
 codeOut('');
 
 codeOut("""
-// Binary search coded to allow for JswSyms to be in flash on the esp8266 where they require
+static JsVar *jswCreateFromSymbol(const JswSymPtr *sym, JsVar *parent) {
+  unsigned short functionSpec = READ_FLASH_UINT16(&sym->functionSpec);
+  if ((functionSpec & JSWAT_EXECUTE_IMMEDIATELY_MASK) == JSWAT_EXECUTE_IMMEDIATELY)
+    return jsnCallFunction(sym->functionPtr, functionSpec, parent, 0, 0);
+  return jsvNewNativeFunction(sym->functionPtr, functionSpec);
+}
+
+#ifdef JSWRAPPER_SYMBOL_HASH
+/* Look up a name in a perfect hash table made by build_jswrapper.py (makePerfectHash).
+ * The table is a displacement for each bucket, followed by the index for each slot.
+ * Returns the index of the only name that could match (which must still be compared
+ * against), or -1 if nothing could */
+static int jswHashSearch(const unsigned char *hashTable, unsigned char buckets, unsigned char slots, const char *name) {
+  uint32_t h = 2166136261u; // FNV-1a
+  while (*name) h = (h ^ (unsigned char)*(name++)) * 16777619u;
+  uint32_t x = h + READ_FLASH_UINT8(&hashTable[h % buckets]) * 0x9E3779B9u;
+  x ^= x >> 16;
+  x *= 0x85EBCA6Bu;
+  x ^= x >> 13;
+  unsigned char idx = READ_FLASH_UINT8(&hashTable[buckets + (x % slots)]);
+  return (idx==""" + str(HASH_EMPTY) + """) ? -1 : idx;
+}
+#endif
+
+// Coded to allow for JswSyms to be in flash on the esp8266 where they require
 // word accesses
-JsVar *jswBinarySearch(const JswSymList *symbolsPtr, JsVar *parent, const char *name) {
+JsVar *jswSearchSymbolTable(const JswSymList *symbolsPtr, JsVar *parent, const char *name) {
+#ifdef JSWRAPPER_SYMBOL_HASH
+  int idx = jswHashSearch(symbolsPtr->hashTable, READ_FLASH_UINT8(&symbolsPtr->hashBuckets), READ_FLASH_UINT8(&symbolsPtr->hashSlots), name);
+  if (idx<0) return 0;
+  const JswSymPtr *sym = &symbolsPtr->symbols[idx];
+  unsigned short strOffset = READ_FLASH_UINT16(&sym->strOffset);
+  if (FLASH_STRCMP(name, &symbolsPtr->symbolChars[strOffset])!=0) return 0;
+  return jswCreateFromSymbol(sym, parent);
+#else
+  // Binary search
   uint8_t symbolCount = READ_FLASH_UINT8(&symbolsPtr->symbolCount);
   int searchMin = 0;
   int searchMax = symbolCount - 1;
@@ -293,10 +394,7 @@ JsVar *jswBinarySearch(const JswSymList *symbolsPtr, JsVar *parent, const char *
     unsigned short strOffset = READ_FLASH_UINT16(&sym->strOffset);
     int cmp = FLASH_STRCMP(name, &symbolsPtr->symbolChars[strOffset]);
     if (cmp==0) {
-      unsigned short functionSpec = READ_FLASH_UINT16(&sym->functionSpec);
-      if ((functionSpec & JSWAT_EXECUTE_IMMEDIATELY_MASK) == JSWAT_EXECUTE_IMMEDIATELY)
-        return jsnCallFunction(sym->functionPtr, functionSpec, parent, 0, 0);
-      return jsvNewNativeFunction(sym->functionPtr, functionSpec);
+      return jswCreateFromSymbol(sym, parent);
     } else {
       if (cmp<0) {
         // searchMin is the same
@@ -308,6 +406,7 @@ JsVar *jswBinarySearch(const JswSymList *symbolsPtr, JsVar *parent, const char *
     }
   }
   return 0;
+#endif
 }
 
 """);
@@ -371,10 +470,16 @@ for b in builtins:
   codeOut("FLASH_STR(jswSymbols_"+builtin["name"]+"_str, " + builtin["symbolTableChars"] +");");
 codeOut('');
 # output the symbol table array referencing the above strings
+codeOut('#ifdef JSWRAPPER_SYMBOL_HASH')
+codeOut('#define JSW_SYMBOL_HASH(TABLE, BUCKETS, SLOTS) , TABLE, BUCKETS, SLOTS')
+codeOut('#else')
+codeOut('#define JSW_SYMBOL_HASH(TABLE, BUCKETS, SLOTS)')
+codeOut('#endif')
 codeOut('const JswSymList jswSymbolTables[] FLASH_SECT = {');
 for b in builtins:
   builtin = builtins[b]
-  codeOut("  {"+", ".join(["jswSymbols_"+builtin["name"], "jswSymbols_"+builtin["name"]+"_str", builtin["symbolTableCount"]])+"},");
+  hashInfo = "JSW_SYMBOL_HASH("+", ".join(["jswSymbols_"+builtin["name"]+"_hash", str(builtin["hash"]["buckets"]), str(builtin["hash"]["slots"])])+")"
+  codeOut("  {"+", ".join(["jswSymbols_"+builtin["name"], "jswSymbols_"+builtin["name"]+"_str", builtin["symbolTableCount"]])+" "+hashInfo+"},");
 codeOut('};');
 
 codeOut('');
@@ -491,17 +596,28 @@ codeOut('')
 codeOut('')
 
 builtinChecks = []
+builtinObjects = []
 for jsondata in jsondatas:
   if "class" in jsondata:
     check = 'strcmp(name, "'+jsondata["class"]+'")==0';
     if not jsondata["class"] in libraries:
       if not check in builtinChecks:
         builtinChecks.append(check)
+        builtinObjects.append(jsondata["class"])
 
 
+codeOut('#ifdef JSWRAPPER_SYMBOL_HASH')
+codeOut('static const char *jswBuiltInObjects[] = {\n  '+",\n  ".join(['"'+n+'"' for n in builtinObjects])+'\n};')
+hashInfo = codeOutPerfectHash("jswBuiltInObjects_hash", builtinObjects)
+codeOut('bool jswIsBuiltInObject(const char *name) {')
+codeOut('  int idx = jswHashSearch(jswBuiltInObjects_hash, '+str(hashInfo["buckets"])+', '+str(hashInfo["slots"])+', name);')
+codeOut('  return idx>=0 && strcmp(name, jswBuiltInObjects[idx])==0;')
+codeOut('}')
+codeOut('#else')
 codeOut('bool jswIsBuiltInObject(const char *name) {')
 codeOut('  return\n'+" ||\n    ".join(builtinChecks)+';')
 codeOut('}')
+codeOut('#endif')
 
 codeOut('')
 codeOut('')
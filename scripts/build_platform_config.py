@@ -236,9 +236,9 @@ codeOut("""
 #define DEFAULT_SLEEP_PIN_INDICATOR (Pin)-1 // no indicator
 
 // When to send the message that the IO buffer is getting full
-#define IOBUFFER_XOFF ((TXBUFFERMASK)*6/8)
+#define IOBUFFER_XOFF ((IOBUFFERMASK)*6/8)
 // When to send the message that we can start receiving again
-#define IOBUFFER_XON ((TXBUFFERMASK)*3/8)
+#define IOBUFFER_XON ((IOBUFFERMASK)*3/8)
 
 """);
 
@@ -330,8 +330,8 @@ if "default_console_baudrate" in board.info:
 
 codeOut("");
 if LINUX:
-  bufferSizeIO = 256
-  bufferSizeTX = 256
+  bufferSizeIO = 1024
+  bufferSizeTX = 4096
   bufferSizeTimer = 16
 else:
   bufferSizeIO = 64 if board.chip["ram"]<20 else 128
@@ -340,9 +340,11 @@ else:
 
 if 'util_timer_tasks' in board.info:
   bufferSizeTimer = board.info['util_timer_tasks']
+if 'io_buffer_size' in board.info:
+  bufferSizeIO = board.info['io_buffer_size']
 
-codeOut("#define IOBUFFERMASK "+str(bufferSizeIO-1)+" // (max 255) amount of items in event buffer - events take ~9 bytes each")
-codeOut("#define TXBUFFERMASK "+str(bufferSizeTX-1)+" // (max 255)")
+codeOut("#define IOBUFFERMASK "+str(bufferSizeIO-1)+" // Must be power of 2 - amount of 8 byte blocks in event buffer. Events take 1 block, or one for the first 4 characters and one for each 8 after")
+codeOut("#define TXBUFFERMASK "+str(bufferSizeTX-1)+" // Must be power of 2 - size of each device's transmit buffer")
 codeOut("#define UTILTIMERTASK_TASKS ("+str(bufferSizeTimer)+") // Must be power of 2 - and max 256")
 
 codeOut("");
@@ -0,0 +1,1642 @@
+/*
+ * This file is part of Espruino, a JavaScript interpreter for Microcontrollers
+ *
+ * Copyright (C) 2013 Gordon Williams <gw@pur3.co.uk>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * ----------------------------------------------------------------------------
+ * Compiles functions and loops to bytecode for a simple stack-based VM,
+ * so they don't have to be parsed each time they're run
+ * ----------------------------------------------------------------------------
+ */
+#include "jsbytecode.h"
+#include "jsparse.h"
+#include "jslex.h"
+#include "jsinteractive.h"
+#include "jswrapper.h"
+#include "jsprofile.h"
+
+#ifdef JSPARSE_BYTECODE
+
+/* Bytecode is stored in a flat string. It starts with a header:
+ *
+ *  0: the number of parameters (which are the first local variable slots)
+ *  1: the number of local variable slots
+ *  2: the maximum depth of the stack
+ *
+ * Then there are instructions - a byte for the opcode, then its arguments.
+ * Numbers are little-endian, and names are a length byte, the characters,
+ * then a 0 (so they can be used as C strings). Jumps are to positions from
+ * the start of the bytecode.
+ *
+ * We only compile code that uses the things that the VM can do. Anything
+ * else (functions defined inside, try/catch, switch, for..in, delete,
+ * template literals, eval, arguments) stays with the parser. In functions,
+ * all `var`s and parameters are put in slots, and everything else is looked
+ * up by name. In loops (see jsbcExecuteLoop) everything is looked up by name.
+ */
+#define JSBC_HEADER_SIZE 3
+#define JSBC_MAX_SIZE 0xFFFF ///< So positions fit in 16 bits
+#define JSBC_MAX_SLOTS 255
+#define JSBC_MAX_STACK 255
+#define JSBC_MAX_NESTING 32 ///< How deeply nested statements/expressions can be before we stop compiling
+
+typedef enum {
+  JSBC_POS,              ///< u32 position in the code (for error messages)
+  JSBC_PUSH_UNDEFINED,
+  JSBC_PUSH_NULL,
+  JSBC_PUSH_TRUE,
+  JSBC_PUSH_FALSE,
+  JSBC_PUSH_INT8,        ///< i8
+  JSBC_PUSH_INT,         ///< i32
+  JSBC_PUSH_FLOAT,       ///< JsVarFloat
+  JSBC_PUSH_STRING,      ///< u16 length, characters
+  JSBC_PUSH_THIS,
+  JSBC_POP,
+  JSBC_SWAP,
+  JSBC_GET_LOCAL,        ///< u8 slot
+  JSBC_SET_LOCAL,        ///< u8 slot. [v] -> [v]
+  JSBC_SET_LOCAL_POP,    ///< u8 slot. [v] -> []
+  JSBC_GET_NAME,         ///< name
+  JSBC_SET_NAME,         ///< name. [v] -> [v]
+  JSBC_SET_NAME_POP,     ///< name. [v] -> []
+  JSBC_VAR_NAME,         ///< name. `var name = v` - [v] -> []
+  JSBC_DECLARE_NAME,     ///< name. `var name`
+  JSBC_GET_FIELD,        ///< name. [o] -> [o.name]
+  JSBC_GET_METHOD,       ///< name. [o] -> [o o.name]
+  JSBC_SET_FIELD,        ///< name. [o v] -> [v]
+  JSBC_SET_FIELD_POP,    ///< name. [o v] -> []
+  JSBC_GET_INDEX,        ///< [o k] -> [o[k]]
+  JSBC_GET_INDEX_METHOD, ///< [o k] -> [o o[k]]
+  JSBC_SET_INDEX,        ///< [o k v] -> [v]
+  JSBC_SET_INDEX_POP,    ///< [o k v] -> []
+  JSBC_UPDATE_LOCAL,     ///< u8 slot, u8 op. [v] -> [slot op= v]
+  JSBC_UPDATE_LOCAL_POP, ///< u8 slot, u8 op. [v] -> []
+  JSBC_UPDATE_NAME,      ///< u8 op, name. [v] -> [name op= v]
+  JSBC_UPDATE_FIELD,     ///< u8 op, name. [o v] -> [o.name op= v]
+  JSBC_UPDATE_INDEX,     ///< u8 op. [o k v] -> [o[k] op= v]
+  JSBC_CALL,             ///< u8 argc, u16 position of the function's name (or 0). [this f args...] -> [result]
+  JSBC_NEW,              ///< u8 argc, u16 position of the function's name (or 0). [f args...] -> [result]
+  JSBC_BINOP,            ///< u8 op. [a b] -> [a op b]
+  JSBC_IN,               ///< [a b] -> [a in b]
+  JSBC_INSTANCEOF,       ///< [a b] -> [a instanceof b]
+  JSBC_NOT,
+  JSBC_BITNOT,
+  JSBC_NEG,
+  JSBC_TONUMBER,
+  JSBC_TYPEOF,
+  JSBC_TYPEOF_NAME,      ///< name. `typeof name` - which mustn't throw if name isn't defined
+  JSBC_NEW_OBJECT,
+  JSBC_INIT_FIELD,       ///< name. [o v] -> [o]
+  JSBC_NEW_ARRAY,
+  JSBC_ARRAY_PUSH,       ///< [a v] -> [a]
+  JSBC_JMP,              ///< u16 position
+  JSBC_JMP_IF_FALSE,     ///< u16 position. [v] -> []
+  JSBC_JMP_IF_FALSE_KEEP,///< u16 position. [v] -> [v] if jumping, [] if not
+  JSBC_JMP_IF_TRUE_KEEP, ///< u16 position. [v] -> [v] if jumping, [] if not
+  JSBC_RETURN,           ///< [v] -> return v
+  JSBC_THROW,            ///< [v] -> throw v
+} JsbcOpcode;
+
+/// Operators (as used by jsvMathsOp) are stored in one byte
+#define JSBC_OP_ENCODE(OP) ((OP)<LEX_EQUAL ? (OP) : (128+(OP)-LEX_EQUAL))
+#define JSBC_OP_DECODE(B) ((B)<128 ? (int)(B) : ((int)(B)-128+LEX_EQUAL))
+/// For JSBC_UPDATE_*, `x++` and `x--` - where there's no value on the stack
+#define JSBC_OP_POSTINC 1
+#define JSBC_OP_POSTDEC 2
+
+#define JSBC_U16(P) ((unsigned int)(P)[0] | ((unsigned int)(P)[1]<<8))
+#define JSBC_U32(P) ((uint32_t)JSBC_U16(P) | ((uint32_t)JSBC_U16((P)+2)<<16))
+
+#ifdef JSPARSE_VARIABLE_CACHE_SIZE
+/// Where a variable was found the last time it was looked up from somewhere in some bytecode
+typedef struct {
+  JsVarRef code;      ///< The bytecode it was looked up from (or 0 if unused)
+  uint16_t pos;       ///< Where in the bytecode
+  JsVarRef name;      ///< The name that was found, or 0 if it was a built-in function
+  unsigned int epoch; ///< jsvGetNameEpoch() when this was found
+} JsbcVariableCacheEntry;
+static JsbcVariableCacheEntry jsbcVariableCache[JSPARSE_VARIABLE_CACHE_SIZE];
+
+/// Forget everything in the variable cache - new bytecode may be where some old bytecode was
+static void jsbcVariableCacheClear() {
+  memset(jsbcVariableCache, 0, sizeof(jsbcVariableCache));
+}
+#endif
+
+// ----------------------------------------------------------------------------
+//                                                                     COMPILER
+
+typedef enum {
+  JSBC_COMPILE_LOOP,     ///< A single loop statement
+  JSBC_COMPILE_FUNCTION, ///< The body of a function
+  JSBC_COMPILE_RETURN,   ///< The expression of a function that's just `return ...` (JSV_FUNCTION_RETURN)
+} JsbcCompileType;
+
+typedef struct JsbcLoop {
+  size_t breakChain;     ///< `break` jumps that need pointing at the end of the loop
+  size_t continueChain;  ///< `continue` jumps that need pointing at the next iteration
+  size_t continueTarget; ///< Where `continue` jumps to if we know already (or 0)
+  struct JsbcLoop *parent;
+} JsbcLoop;
+
+typedef struct {
+  JsbcCompileType type;
+  unsigned char *code; ///< Where we write bytecode, or 0 if we're only working out how big it is
+  size_t size;         ///< The most bytecode we can write
+  size_t pos;          ///< Where we are in the bytecode
+  int depth;           ///< How many values are on the stack
+  int maxDepth;        ///< The most values there have been on the stack
+  JsVar *locals;       ///< Object of local variable names -> slots, or 0 if everything is looked up by name
+  int slotCount;       ///< How many local variable slots there are
+  bool findLocals;     ///< Are we adding `var`s to locals?
+  size_t lastOp;       ///< Position of the last instruction if it has a version that pops its result, or 0
+  JsbcLoop *loop;      ///< The innermost loop we're in
+  int nesting;         ///< How deeply nested we are
+  bool failed;         ///< We found something we can't compile
+} JsbcCompiler;
+
+/// What an expression refers to - we don't get its value until we know it's not being assigned to
+typedef enum {
+  JSBC_REF_VALUE, ///< The value is on the stack
+  JSBC_REF_LOCAL, ///< A local variable slot
+  JSBC_REF_NAME,  ///< A variable looked up by name
+  JSBC_REF_FIELD, ///< `o.name` - o is on the stack
+  JSBC_REF_INDEX, ///< `o[k]` - o and k are on the stack
+} JsbcRefType;
+
+typedef struct {
+  JsbcRefType type;
+  int slot;
+  char name[JSLEX_MAX_TOKEN_LENGTH];
+} JsbcRef;
+
+static void jsbcAssignment(JsbcCompiler *c, JsbcRef *ref);
+static void jsbcUnary(JsbcCompiler *c, JsbcRef *ref);
+static void jsbcStatement(JsbcCompiler *c);
+
+static void jsbcFail(JsbcCompiler *c) {
+  c->failed = true;
+}
+
+static void jsbcByte(JsbcCompiler *c, int b) {
+  if (c->pos >= c->size) {
+    jsbcFail(c);
+    return;
+  }
+  if (c->code) c->code[c->pos] = (unsigned char)b;
+  c->pos++;
+}
+
+static void jsbcU16(JsbcCompiler *c, size_t v) {
+  jsbcByte(c, (int)(v&255));
+  jsbcByte(c, (int)((v>>8)&255));
+}
+
+static void jsbcU32(JsbcCompiler *c, uint32_t v) {
+  jsbcU16(c, v&0xFFFF);
+  jsbcU16(c, v>>16);
+}
+
+/// Add an instruction which changes the number of items on the stack by stackChange
+static void jsbcOp(JsbcCompiler *c, JsbcOpcode op, int stackChange) {
+  c->lastOp = 0;
+  jsbcByte(c, op);
+  c->depth += stackChange;
+  if (c->depth > c->maxDepth) c->maxDepth = c->depth;
+}
+
+/// Add an instruction that has a version (the next opcode) which pops its result
+static void jsbcOpPoppable(JsbcCompiler *c, JsbcOpcode op, int stackChange) {
+  size_t pos = c->pos;
+  jsbcOp(c, op, stackChange);
+  c->lastOp = pos;
+}
+
+/// Add a name, and return its position (for JSBC_CALL)
+static size_t jsbcName(JsbcCompiler *c, const char *name) {
+  size_t len = strlen(name);
+  if (len>255) jsbcFail(c);
+  jsbcByte(c, (int)len);
+  size_t pos = c->pos;
+  while (*name) jsbcByte(c, *(name++));
+  jsbcByte(c, 0);
+  return pos;
+}
+
+static void jsbcPop(JsbcCompiler *c) {
+  if (c->lastOp) {
+    // use the version of the last instruction that doesn't leave its result on the stack
+    if (c->code) c->code[c->lastOp]++;
+    c->lastOp = 0;
+    c->depth--;
+  } else
+    jsbcOp(c, JSBC_POP, -1);
+}
+
+/// Add a jump to somewhere we don't know yet, adding it to a chain of jumps to the same place
+static void jsbcJumpForward(JsbcCompiler *c, JsbcOpcode op, int stackChange, size_t *chain) {
+  jsbcOp(c, op, stackChange);
+  size_t pos = c->pos;
+  jsbcU16(c, *chain);
+  *chain = pos;
+}
+
+/// Point all the jumps in the chain at where we are now
+static void jsbcBind(JsbcCompiler *c, size_t chain) {
+  c->lastOp = 0; // something jumps here, so we can't change the last instruction
+  while (chain && c->code) {
+    size_t next = JSBC_U16(&c->code[chain]);
+    c->code[chain] = (unsigned char)(c->pos&255);
+    c->code[chain+1] = (unsigned char)(c->pos>>8);
+    chain = next;
+  }
+}
+
+/// Get where we are now, so we can jump back to it
+static size_t jsbcLabel(JsbcCompiler *c) {
+  c->lastOp = 0;
+  return c->pos;
+}
+
+static void jsbcJumpBack(JsbcCompiler *c, size_t target) {
+  jsbcOp(c, JSBC_JMP, 0);
+  jsbcU16(c, target);
+}
+
+/// Note where in the code we are, so errors can be reported properly
+static void jsbcPosition(JsbcCompiler *c) {
+  jsbcOp(c, JSBC_POS, 0);
+  jsbcU32(c, (uint32_t)(jsvStringIteratorGetIndex(&lex->tokenStart.it)-1));
+}
+
+static bool jsbcMatch(JsbcCompiler *c, int tk) {
+  if (lex->tk!=tk) {
+    jsbcFail(c);
+    return false;
+  }
+  jslGetNextToken();
+  return true;
+}
+
+static void jsbcCopyToken(char *name) {
+  strncpy(name, jslGetTokenValueAsString(), JSLEX_MAX_TOKEN_LENGTH);
+  name[JSLEX_MAX_TOKEN_LENGTH-1] = 0;
+}
+
+/// Get the slot of the local variable with this name, or -1
+static int jsbcFindLocal(JsbcCompiler *c, const char *name) {
+  if (!c->locals) return -1;
+  JsVar *slot = jsvObjectGetChild(c->locals, name, 0);
+  int i = jsvIsInt(slot) ? (int)jsvGetInteger(slot) : -1;
+  jsvUnLock(slot);
+  return i;
+}
+
+/// When finding locals, remember that a name was used before any `var` for it
+static void jsbcNoteName(JsbcCompiler *c, const char *name) {
+  if (!c->findLocals) return;
+  JsVar *existing = jsvObjectGetChild(c->locals, name, 0);
+  if (!existing)
+    jsvObjectSetChildAndUnLock(c->locals, name, jsvNewFromBool(true));
+  jsvUnLock(existing);
+}
+
+static void jsbcAddLocal(JsbcCompiler *c, const char *name) {
+  if (!c->findLocals) return;
+  JsVar *existing = jsvObjectGetChild(c->locals, name, 0);
+  bool isLocal = jsvIsInt(existing);
+  jsvUnLock(existing);
+  if (isLocal) return;
+  /* The parser only makes a variable when it gets to the `var`, so before that
+   * the name refers to something outside the function. We can't do that with
+   * a slot, so leave the function to the parser. */
+  if (existing) {
+    jsbcFail(c);
+    return;
+  }
+  if (c->slotCount >= JSBC_MAX_SLOTS) {
+    jsbcFail(c);
+    return;
+  }
+  jsvObjectSetChildAndUnLock(c->locals, name, jsvNewFromInteger(c->slotCount++));
+}
+
+static void jsbcFloat(JsbcCompiler *c, JsVarFloat f) {
+  unsigned char b[sizeof(JsVarFloat)];
+  memcpy(b, &f, sizeof(b));
+  jsbcOp(c, JSBC_PUSH_FLOAT, 1);
+  unsigned int i;
+  for (i=0;i<sizeof(b);i++) jsbcByte(c, b[i]);
+}
+
+/// Push an integer, like jsvNewFromLongInteger
+static void jsbcInt(JsbcCompiler *c, long long v) {
+  if (v>=-128 && v<=127) {
+    jsbcOp(c, JSBC_PUSH_INT8, 1);
+    jsbcByte(c, (int)(v&255));
+  } else if (v>=-2147483647LL-1 && v<=2147483647LL) {
+    jsbcOp(c, JSBC_PUSH_INT, 1);
+    jsbcU32(c, (uint32_t)v);
+  } else
+    jsbcFloat(c, (JsVarFloat)v);
+}
+
+/// Make sure that the value of what the reference refers to is on the stack. Returns the position of its name if it has one
+static size_t jsbcValue(JsbcCompiler *c, JsbcRef *ref) {
+  size_t namePos = 0;
+  switch (ref->type) {
+    case JSBC_REF_VALUE: break;
+    case JSBC_REF_LOCAL:
+      jsbcOp(c, JSBC_GET_LOCAL, 1);
+      jsbcByte(c, ref->slot);
+      break;
+    case JSBC_REF_NAME:
+      jsbcOp(c, JSBC_GET_NAME, 1);
+      namePos = jsbcName(c, ref->name);
+      break;
+    case JSBC_REF_FIELD:
+      jsbcOp(c, JSBC_GET_FIELD, 0);
+      namePos = jsbcName(c, ref->name);
+      break;
+    case JSBC_REF_INDEX:
+      jsbcOp(c, JSBC_GET_INDEX, -1);
+      break;
+  }
+  ref->type = JSBC_REF_VALUE;
+  return namePos;
+}
+
+/// Like jsbcValue, but for calling - leave [this function] on the stack
+static size_t jsbcCallee(JsbcCompiler *c, JsbcRef *ref) {
+  size_t namePos = 0;
+  switch (ref->type) {
+    case JSBC_REF_VALUE:
+      jsbcOp(c, JSBC_PUSH_UNDEFINED, 1);
+      jsbcOp(c, JSBC_SWAP, 0);
+      break;
+    case JSBC_REF_LOCAL:
+    case JSBC_REF_NAME:
+      jsbcOp(c, JSBC_PUSH_UNDEFINED, 1);
+      namePos = jsbcValue(c, ref);
+      break;
+    case JSBC_REF_FIELD:
+      jsbcOp(c, JSBC_GET_METHOD, 1);
+      namePos = jsbcName(c, ref->name);
+      break;
+    case JSBC_REF_INDEX:
+      jsbcOp(c, JSBC_GET_INDEX_METHOD, 0);
+      break;
+  }
+  ref->type = JSBC_REF_VALUE;
+  return namePos;
+}
+
+/// `ref = value`, where the value is on the stack
+static void jsbcStore(JsbcCompiler *c, JsbcRef *ref) {
+  switch (ref->type) {
+    case JSBC_REF_VALUE: jsbcFail(c); break;
+    case JSBC_REF_LOCAL:
+      jsbcOpPoppable(c, JSBC_SET_LOCAL, 0);
+      jsbcByte(c, ref->slot);
+      break;
+    case JSBC_REF_NAME:
+      jsbcOpPoppable(c, JSBC_SET_NAME, 0);
+      jsbcName(c, ref->name);
+      break;
+    case JSBC_REF_FIELD:
+      jsbcOpPoppable(c, JSBC_SET_FIELD, -1);
+      jsbcName(c, ref->name);
+      break;
+    case JSBC_REF_INDEX:
+      jsbcOpPoppable(c, JSBC_SET_INDEX, -2);
+      break;
+  }
+  ref->type = JSBC_REF_VALUE;
+}
+
+/// `ref op= value` where the value is on the stack (or `ref++`/`ref--` where it isn't)
+static void jsbcUpdate(JsbcCompiler *c, JsbcRef *ref, int op) {
+  int valueCount = (op==JSBC_OP_POSTINC || op==JSBC_OP_POSTDEC) ? 0 : 1;
+  switch (ref->type) {
+    case JSBC_REF_VALUE: jsbcFail(c); break;
+    case JSBC_REF_LOCAL:
+      jsbcOpPoppable(c, JSBC_UPDATE_LOCAL, 1-valueCount);
+      jsbcByte(c, ref->slot);
+      jsbcByte(c, op);
+      break;
+    case JSBC_REF_NAME:
+      jsbcOp(c, JSBC_UPDATE_NAME, 1-valueCount);
+      jsbcByte(c, op);
+      jsbcName(c, ref->name);
+      break;
+    case JSBC_REF_FIELD:
+      jsbcOp(c, JSBC_UPDATE_FIELD, -valueCount);
+      jsbcByte(c, op);
+      jsbcName(c, ref->name);
+      break;
+    case JSBC_REF_INDEX:
+      jsbcOp(c, JSBC_UPDATE_INDEX, -1-valueCount);
+      jsbcByte(c, op);
+      break;
+  }
+  ref->type = JSBC_REF_VALUE;
+}
+
+static void jsbcAssignmentValue(JsbcCompiler *c) {
+  JsbcRef ref;
+  jsbcAssignment(c, &ref);
+  jsbcValue(c, &ref);
+}
+
+/// ',' is allowed to add multiple expressions (like jspeExpression)
+static void jsbcExpression(JsbcCompiler *c) {
+  jsbcAssignmentValue(c);
+  while (!c->failed && lex->tk==',') {
+    jsbcPop(c);
+    jslGetNextToken();
+    jsbcAssignmentValue(c);
+  }
+}
+
+static void jsbcString(JsbcCompiler *c) {
+  JsVar *str = jslGetTokenValueAsVar();
+  size_t len = jsvGetStringLength(str);
+  if (len>0xFFFF) jsbcFail(c);
+  jsbcOp(c, JSBC_PUSH_STRING, 1);
+  jsbcU16(c, len);
+  JsvStringIterator it;
+  jsvStringIteratorNew(&it, str, 0);
+  while (jsvStringIteratorHasChar(&it) && !c->failed) {
+    jsbcByte(c, jsvStringIteratorGetChar(&it));
+    jsvStringIteratorNext(&it);
+  }
+  jsvStringIteratorFree(&it);
+  jsvUnLock(str);
+  jslGetNextToken();
+}
+
+static void jsbcObject(JsbcCompiler *c) {
+  jslGetNextToken();
+  jsbcOp(c, JSBC_NEW_OBJECT, 1);
+  while (!c->failed && lex->tk!='}') {
+    char name[JSLEX_MAX_TOKEN_LENGTH];
+    if (jslIsIDOrReservedWord()) {
+      jsbcCopyToken(name);
+    } else if (lex->tk==LEX_STR) {
+      JsVar *str = jslGetTokenValueAsVar();
+      if (jsvGetStringLength(str) >= sizeof(name) ||
+          jsvGetString(str, name, sizeof(name)) != jsvGetStringLength(str) ||
+          strlen(name) != jsvGetStringLength(str))
+        jsbcFail(c); // too long, or has a 0 in it
+      jsvUnLock(str);
+    } else {
+      jsbcFail(c);
+      return;
+    }
+    jslGetNextToken();
+    jsbcMatch(c, ':');
+    jsbcAssignmentValue(c);
+    jsbcOp(c, JSBC_INIT_FIELD, -1);
+    jsbcName(c, name);
+    if (lex->tk!='}') jsbcMatch(c, ',');
+  }
+  jsbcMatch(c, '}');
+}
+
+static void jsbcArray(JsbcCompiler *c) {
+  jslGetNextToken();
+  jsbcOp(c, JSBC_NEW_ARRAY, 1);
+  while (!c->failed && lex->tk!=']') {
+    if (lex->tk==',') { // `[1,,2]` - leave that to the parser
+      jsbcFail(c);
+      return;
+    }
+    jsbcAssignmentValue(c);
+    jsbcOp(c, JSBC_ARRAY_PUSH, -1);
+    if (lex->tk!=']') jsbcMatch(c, ',');
+  }
+  jsbcMatch(c, ']');
+}
+
+static void jsbcFactor(JsbcCompiler *c, JsbcRef *ref) {
+  ref->type = JSBC_REF_VALUE;
+  int tk = lex->tk;
+  if (tk==LEX_ID) {
+    const char *name = jslGetTokenValueAsString();
+    // these need the function's scope, which we don't make
+    if (!strcmp(name, "arguments") || !strcmp(name, "eval")) {
+      jsbcFail(c);
+      return;
+    }
+    ref->slot = jsbcFindLocal(c, name);
+    if (ref->slot>=0) {
+      ref->type = JSBC_REF_LOCAL;
+    } else {
+      ref->type = JSBC_REF_NAME;
+      jsbcCopyToken(ref->name);
+      jsbcNoteName(c, ref->name);
+    }
+    jslGetNextToken();
+    if (lex->tk==LEX_ARROW_FUNCTION || lex->tk==LEX_TEMPLATE_LITERAL)
+      jsbcFail(c);
+  } else if (tk==LEX_INT) {
+    jsbcInt(c, stringToInt(jslGetTokenValueAsString()));
+    jslGetNextToken();
+  } else if (tk==LEX_FLOAT) {
+    jsbcFloat(c, stringToFloat(jslGetTokenValueAsString()));
+    jslGetNextToken();
+  } else if (tk=='(') {
+    jslGetNextToken();
+    jsbcExpression(c);
+    jsbcMatch(c, ')');
+    if (lex->tk==LEX_ARROW_FUNCTION) jsbcFail(c);
+  } else if (tk==LEX_R_TRUE || tk==LEX_R_FALSE || tk==LEX_R_NULL ||
+             tk==LEX_R_UNDEFINED || tk==LEX_R_THIS) {
+    jsbcOp(c, tk==LEX_R_TRUE ? JSBC_PUSH_TRUE :
+              tk==LEX_R_FALSE ? JSBC_PUSH_FALSE :
+              tk==LEX_R_NULL ? JSBC_PUSH_NULL :
+              tk==LEX_R_THIS ? JSBC_PUSH_THIS : JSBC_PUSH_UNDEFINED, 1);
+    jslGetNextToken();
+  } else if (tk==LEX_STR) {
+    jsbcString(c);
+  } else if (tk=='{') {
+    jsbcObject(c);
+  } else if (tk=='[') {
+    jsbcArray(c);
+  } else if (tk==LEX_R_TYPEOF || tk==LEX_R_VOID) {
+    jslGetNextToken();
+    jsbcUnary(c, ref);
+    if (tk==LEX_R_TYPEOF && ref->type==JSBC_REF_NAME) {
+      jsbcOp(c, JSBC_TYPEOF_NAME, 1);
+      jsbcName(c, ref->name);
+      ref->type = JSBC_REF_VALUE;
+    } else if (tk==LEX_R_TYPEOF) {
+      jsbcValue(c, ref);
+      jsbcOp(c, JSBC_TYPEOF, 0);
+    } else {
+      jsbcValue(c, ref);
+      jsbcPop(c);
+      jsbcOp(c, JSBC_PUSH_UNDEFINED, 1);
+    }
+  } else // functions, delete, template literals, etc
+    jsbcFail(c);
+}
+
+/// `.name` and `[index]` after a factor
+static void jsbcMembers(JsbcCompiler *c, JsbcRef *ref) {
+  while (!c->failed && (lex->tk=='.' || lex->tk=='[')) {
+    if (lex->tk=='.') {
+      jslGetNextToken();
+      if (!jslIsIDOrReservedWord()) {
+        jsbcFail(c);
+        return;
+      }
+      jsbcValue(c, ref);
+      ref->type = JSBC_REF_FIELD;
+      jsbcCopyToken(ref->name);
+      jslGetNextToken();
+    } else {
+      jslGetNextToken();
+      jsbcValue(c, ref);
+      jsbcAssignmentValue(c);
+      jsbcMatch(c, ']');
+      ref->type = JSBC_REF_INDEX;
+    }
+  }
+}
+
+/// Parse a function call's arguments, and return how many there were
+static int jsbcArguments(JsbcCompiler *c) {
+  int argCount = 0;
+  jsbcMatch(c, '(');
+  while (!c->failed && lex->tk!=')') {
+    jsbcAssignmentValue(c);
+    argCount++;
+    if (lex->tk!=')') jsbcMatch(c, ',');
+  }
+  jsbcMatch(c, ')');
+  if (argCount>255) jsbcFail(c);
+  return argCount;
+}
+
+static void jsbcFactorFunctionCall(JsbcCompiler *c, JsbcRef *ref) {
+  if (lex->tk==LEX_R_NEW) {
+    jslGetNextToken();
+    if (lex->tk==LEX_R_NEW) {
+      jsbcFail(c);
+      return;
+    }
+    jsbcFactor(c, ref);
+    jsbcMembers(c, ref);
+    size_t namePos = jsbcValue(c, ref);
+    int argCount = 0;
+    if (lex->tk=='(') argCount = jsbcArguments(c);
+    jsbcOp(c, JSBC_NEW, -argCount);
+    jsbcByte(c, argCount);
+    jsbcU16(c, namePos);
+  } else
+    jsbcFactor(c, ref);
+  jsbcMembers(c, ref);
+  while (!c->failed && lex->tk=='(') {
+    size_t namePos = jsbcCallee(c, ref);
+    int argCount = jsbcArguments(c);
+    jsbcOp(c, JSBC_CALL, -(argCount+1));
+    jsbcByte(c, argCount);
+    jsbcU16(c, namePos);
+    jsbcMembers(c, ref);
+  }
+}
+
+static void jsbcPostfix(JsbcCompiler *c, JsbcRef *ref) {
+  if (lex->tk==LEX_PLUSPLUS || lex->tk==LEX_MINUSMINUS) {
+    int op = lex->tk==LEX_PLUSPLUS ? '+' : '-';
+    jslGetNextToken();
+    jsbcPostfix(c, ref);
+    if (ref->type==JSBC_REF_VALUE) {
+      jsbcFail(c);
+      return;
+    }
+    jsbcInt(c, 1);
+    jsbcUpdate(c, ref, op);
+  } else
+    jsbcFactorFunctionCall(c, ref);
+  while (!c->failed && (lex->tk==LEX_PLUSPLUS || lex->tk==LEX_MINUSMINUS)) {
+    jsbcUpdate(c, ref, lex->tk==LEX_PLUSPLUS ? JSBC_OP_POSTINC : JSBC_OP_POSTDEC);
+    jslGetNextToken();
+  }
+}
+
+static void jsbcUnary(JsbcCompiler *c, JsbcRef *ref) {
+  int tk = lex->tk;
+  if (tk=='!' || tk=='~' || tk=='-' || tk=='+') {
+    jslGetNextToken();
+    if (tk=='-' && (lex->tk==LEX_INT || lex->tk==LEX_FLOAT)) {
+      // negative number - just push it
+      bool isInt = lex->tk==LEX_INT;
+      long long i = isInt ? stringToInt(jslGetTokenValueAsString()) : 0;
+      JsVarFloat f = isInt ? 0 : stringToFloat(jslGetTokenValueAsString());
+      jslGetNextToken();
+      if (lex->tk=='.' || lex->tk=='[' || lex->tk=='(' || lex->tk==LEX_PLUSPLUS || lex->tk==LEX_MINUSMINUS)
+        jsbcFail(c);
+      else if (!isInt) jsbcFloat(c, -f);
+      else if (i>2147483647LL) jsbcFloat(c, -(JsVarFloat)i); // jsvNegate would have got a float
+      else jsbcInt(c, -i);
+      ref->type = JSBC_REF_VALUE;
+      return;
+    }
+    jsbcUnary(c, ref);
+    jsbcValue(c, ref);
+    jsbcOp(c, tk=='!' ? JSBC_NOT : tk=='~' ? JSBC_BITNOT : tk=='-' ? JSBC_NEG : JSBC_TONUMBER, 0);
+  } else
+    jsbcPostfix(c, ref);
+}
+
+static void jsbcBinary(JsbcCompiler *c, JsbcRef *ref, unsigned int lastPrecedence) {
+  // we never compile `for (a in b)`, so `in` is always an operator
+  unsigned int precedence = lex->tk==LEX_R_IN ? 7 : jspeGetBinaryExpressionPrecedence(lex->tk);
+  while (!c->failed && precedence && precedence>lastPrecedence) {
+    int op = lex->tk;
+    JsbcRef b;
+    jsbcValue(c, ref);
+    jslGetNextToken();
+    if (op==LEX_ANDAND || op==LEX_OROR) {
+      // if we know the outcome, jump past the second argument (leaving the first)
+      size_t chain = 0;
+      jsbcJumpForward(c, op==LEX_ANDAND ? JSBC_JMP_IF_FALSE_KEEP : JSBC_JMP_IF_TRUE_KEEP, -1, &chain);
+      jsbcUnary(c, &b);
+      jsbcBinary(c, &b, precedence);
+      jsbcValue(c, &b);
+      jsbcBind(c, chain);
+    } else {
+      jsbcUnary(c, &b);
+      jsbcBinary(c, &b, precedence);
+      jsbcValue(c, &b);
+      if (op==LEX_R_IN) {
+        jsbcOp(c, JSBC_IN, -1);
+      } else if (op==LEX_R_INSTANCEOF) {
+        jsbcOp(c, JSBC_INSTANCEOF, -1);
+      } else {
+        jsbcOp(c, JSBC_BINOP, -1);
+        jsbcByte(c, JSBC_OP_ENCODE(op));
+      }
+    }
+    precedence = lex->tk==LEX_R_IN ? 7 : jspeGetBinaryExpressionPrecedence(lex->tk);
+  }
+}
+
+/// If tk is an assignment, return the operator it uses ('=' for plain assignment), or 0
+static int jsbcAssignmentOp(int tk) {
+  switch (tk) {
+    case '=': return '=';
+    case LEX_PLUSEQUAL: return '+';
+    case LEX_MINUSEQUAL: return '-';
+    case LEX_MULEQUAL: return '*';
+    case LEX_DIVEQUAL: return '/';
+    case LEX_MODEQUAL: return '%';
+    case LEX_ANDEQUAL: return '&';
+    case LEX_OREQUAL: return '|';
+    case LEX_XOREQUAL: return '^';
+    case LEX_RSHIFTEQUAL: return LEX_RSHIFT;
+    case LEX_LSHIFTEQUAL: return LEX_LSHIFT;
+    case LEX_RSHIFTUNSIGNEDEQUAL: return LEX_RSHIFTUNSIGNED;
+    default: return 0;
+  }
+}
+
+static void jsbcAssignment(JsbcCompiler *c, JsbcRef *ref) {
+  if (++c->nesting > JSBC_MAX_NESTING) jsbcFail(c);
+  ref->type = JSBC_REF_VALUE;
+  if (c->failed) return;
+  jsbcUnary(c, ref);
+  jsbcBinary(c, ref, 0);
+  int op = jsbcAssignmentOp(lex->tk);
+  if (lex->tk=='?') {
+    size_t elseChain = 0, endChain = 0;
+    jsbcValue(c, ref);
+    jslGetNextToken();
+    jsbcJumpForward(c, JSBC_JMP_IF_FALSE, -1, &elseChain);
+    jsbcAssignmentValue(c);
+    jsbcJumpForward(c, JSBC_JMP, 0, &endChain);
+    c->depth--; // we only get one of the values
+    jsbcMatch(c, ':');
+    jsbcBind(c, elseChain);
+    jsbcAssignmentValue(c);
+    jsbcBind(c, endChain);
+  } else if (op) {
+    jslGetNextToken();
+    if (ref->type==JSBC_REF_VALUE) {
+      jsbcFail(c);
+    } else {
+      JsbcRef lhs = *ref;
+      jsbcAssignmentValue(c);
+      if (op=='=') jsbcStore(c, &lhs);
+      else jsbcUpdate(c, &lhs, JSBC_OP_ENCODE(op));
+    }
+    ref->type = JSBC_REF_VALUE;
+  }
+  c->nesting--;
+}
+
+// ----------------------------------------------------------------------------
+
+static void jsbcBlock(JsbcCompiler *c) {
+  jsbcMatch(c, '{');
+  while (!c->failed && lex->tk && lex->tk!='}')
+    jsbcStatement(c);
+  jsbcMatch(c, '}');
+}
+
+static void jsbcBlockOrStatement(JsbcCompiler *c) {
+  if (lex->tk=='{') {
+    jsbcBlock(c);
+  } else {
+    jsbcStatement(c);
+    if (lex->tk==';') jslGetNextToken();
+  }
+}
+
+static void jsbcStatementVar(JsbcCompiler *c) {
+  jslGetNextToken();
+  bool hasComma = true;
+  while (!c->failed && hasComma && lex->tk==LEX_ID) {
+    char name[JSLEX_MAX_TOKEN_LENGTH];
+    jsbcCopyToken(name);
+    jsbcAddLocal(c, name);
+    int slot = jsbcFindLocal(c, name);
+    jslGetNextToken();
+    if (lex->tk=='=') {
+      jslGetNextToken();
+      jsbcAssignmentValue(c);
+      if (slot>=0) {
+        jsbcOp(c, JSBC_SET_LOCAL_POP, -1);
+        jsbcByte(c, slot);
+      } else {
+        jsbcOp(c, JSBC_VAR_NAME, -1);
+        jsbcName(c, name);
+      }
+    } else if (slot<0) {
+      jsbcOp(c, JSBC_DECLARE_NAME, 0);
+      jsbcName(c, name);
+    }
+    hasComma = lex->tk==',';
+    if (hasComma) jslGetNextToken();
+  }
+}
+
+static void jsbcStatementIf(JsbcCompiler *c) {
+  size_t elseChain = 0;
+  jslGetNextToken();
+  jsbcMatch(c, '(');
+  jsbcExpression(c);
+  jsbcMatch(c, ')');
+  jsbcJumpForward(c, JSBC_JMP_IF_FALSE, -1, &elseChain);
+  jsbcBlockOrStatement(c);
+  if (lex->tk==LEX_R_ELSE) {
+    size_t endChain = 0;
+    jslGetNextToken();
+    jsbcJumpForward(c, JSBC_JMP, 0, &endChain);
+    jsbcBind(c, elseChain);
+    jsbcBlockOrStatement(c);
+    jsbcBind(c, endChain);
+  } else
+    jsbcBind(c, elseChain);
+}
+
+static void jsbcStatementWhile(JsbcCompiler *c) {
+  JsbcLoop loop;
+  memset(&loop, 0, sizeof(loop));
+  jslGetNextToken();
+  jsbcMatch(c, '(');
+  loop.continueTarget = jsbcLabel(c);
+  jsbcAssignmentValue(c);
+  jsbcMatch(c, ')');
+  jsbcJumpForward(c, JSBC_JMP_IF_FALSE, -1, &loop.breakChain);
+  loop.parent = c->loop;
+  c->loop = &loop;
+  jsbcBlockOrStatement(c);
+  c->loop = loop.parent;
+  jsbcJumpBack(c, loop.continueTarget);
+  jsbcBind(c, loop.breakChain);
+}
+
+static void jsbcStatementDo(JsbcCompiler *c) {
+  JsbcLoop loop;
+  memset(&loop, 0, sizeof(loop));
+  jslGetNextToken();
+  size_t start = jsbcLabel(c);
+  loop.parent = c->loop;
+  c->loop = &loop;
+  jsbcBlockOrStatement(c);
+  c->loop = loop.parent;
+  jsbcMatch(c, LEX_R_WHILE);
+  jsbcMatch(c, '(');
+  jsbcBind(c, loop.continueChain);
+  jsbcAssignmentValue(c);
+  jsbcMatch(c, ')');
+  jsbcJumpForward(c, JSBC_JMP_IF_FALSE, -1, &loop.breakChain);
+  jsbcJumpBack(c, start);
+  jsbcBind(c, loop.breakChain);
+}
+
+static void jsbcStatementFor(JsbcCompiler *c) {
+  JsbcLoop loop;
+  memset(&loop, 0, sizeof(loop));
+  jslGetNextToken();
+  jsbcMatch(c, '(');
+  // initialisation
+  if (lex->tk==LEX_R_VAR || lex->tk==LEX_R_LET || lex->tk==LEX_R_CONST) {
+    jsbcStatementVar(c);
+  } else if (lex->tk!=';') {
+    jsbcExpression(c);
+    jsbcPop(c);
+  }
+  jsbcMatch(c, ';'); // `for (a in b)` fails here
+  // condition
+  size_t start = jsbcLabel(c);
+  if (lex->tk!=';') {
+    jsbcAssignmentValue(c);
+    jsbcJumpForward(c, JSBC_JMP_IF_FALSE, -1, &loop.breakChain);
+  }
+  jsbcMatch(c, ';');
+  if (c->failed) return;
+  // skip the iterator - we put it after the body, and come back for it later
+  JslCharPos iterStart = jslCharPosClone(&lex->tokenStart);
+  int brackets = 0;
+  while (lex->tk && (brackets || lex->tk!=')')) {
+    if (lex->tk=='(') brackets++;
+    if (lex->tk==')') brackets--;
+    jslGetNextToken();
+  }
+  jsbcMatch(c, ')');
+  // body
+  loop.parent = c->loop;
+  c->loop = &loop;
+  jsbcBlockOrStatement(c);
+  c->loop = loop.parent;
+  JslCharPos bodyEnd = jslCharPosClone(&lex->tokenStart);
+  // iterator
+  jsbcBind(c, loop.continueChain);
+  jslSeekToP(&iterStart);
+  if (lex->tk!=')') {
+    jsbcExpression(c);
+    jsbcPop(c);
+  }
+  jslSeekToP(&bodyEnd);
+  jslCharPosFree(&iterStart);
+  jslCharPosFree(&bodyEnd);
+  jsbcJumpBack(c, start);
+  jsbcBind(c, loop.breakChain);
+}
+
+static void jsbcStatement(JsbcCompiler *c) {
+  int tk = lex->tk;
+  if (c->failed) return;
+  if (++c->nesting > JSBC_MAX_NESTING) {
+    jsbcFail(c);
+    return;
+  }
+  if (tk==';') {
+    jslGetNextToken();
+  } else if (tk=='{') {
+    jsbcBlock(c);
+  } else {
+    jsbcPosition(c);
+    if (tk==LEX_ID || tk==LEX_INT || tk==LEX_FLOAT || tk==LEX_STR ||
+        tk==LEX_R_NEW || tk==LEX_R_NULL || tk==LEX_R_UNDEFINED ||
+        tk==LEX_R_TRUE || tk==LEX_R_FALSE || tk==LEX_R_THIS ||
+        tk==LEX_R_TYPEOF || tk==LEX_R_VOID ||
+        tk==LEX_PLUSPLUS || tk==LEX_MINUSMINUS ||
+        tk=='!' || tk=='-' || tk=='+' || tk=='~' || tk=='[' || tk=='(') {
+      jsbcExpression(c);
+      jsbcPop(c);
+    } else if (tk==LEX_R_VAR || tk==LEX_R_LET || tk==LEX_R_CONST) {
+      jsbcStatementVar(c);
+    } else if (tk==LEX_R_IF) {
+      jsbcStatementIf(c);
+    } else if (tk==LEX_R_WHILE) {
+      jsbcStatementWhile(c);
+    } else if (tk==LEX_R_DO) {
+      jsbcStatementDo(c);
+    } else if (tk==LEX_R_FOR) {
+      jsbcStatementFor(c);
+    } else if (tk==LEX_R_RETURN && c->type!=JSBC_COMPILE_LOOP) {
+      jslGetNextToken();
+      if (lex->tk!=';' && lex->tk!='}' && lex->tk!=LEX_EOF)
+        jsbcExpression(c);
+      else
+        jsbcOp(c, JSBC_PUSH_UNDEFINED, 1);
+      jsbcOp(c, JSBC_RETURN, -1);
+    } else if (tk==LEX_R_THROW) {
+      jslGetNextToken();
+      jsbcExpression(c);
+      jsbcOp(c, JSBC_THROW, -1);
+    } else if ((tk==LEX_R_BREAK || tk==LEX_R_CONTINUE) && c->loop) {
+      jslGetNextToken();
+      if (tk==LEX_R_BREAK)
+        jsbcJumpForward(c, JSBC_JMP, 0, &c->loop->breakChain);
+      else if (c->loop->continueTarget)
+        jsbcJumpBack(c, c->loop->continueTarget);
+      else
+        jsbcJumpForward(c, JSBC_JMP, 0, &c->loop->continueChain);
+    } else // function declarations, try, switch, etc
+      jsbcFail(c);
+  }
+  c->nesting--;
+}
+
+/** Compile the code that starts at `start` in the current lexer. locals
+ * should contain the names of the parameters (or be 0 if compiling a loop).
+ * Returns the bytecode or 0 if it couldn't be compiled. The lexer is left
+ * at the end of the code. */
+static JsVar *jsbcCompile(JsbcCompileType type, JsVar *locals, int paramCount, JslCharPos *start) {
+  JsbcCompiler c;
+  JsVar *bytecode = 0;
+  int slotCount = paramCount;
+  /* We go through the code up to 3 times:
+   *  0: find the local variables (if there are any)
+   *  1: work out how big the bytecode is
+   *  2: actually write the bytecode */
+  int pass;
+  for (pass = locals ? 0 : 1; pass<3; pass++) {
+    memset(&c, 0, sizeof(c));
+    c.type = type;
+    c.locals = locals;
+    c.slotCount = slotCount;
+    c.findLocals = pass==0;
+    c.pos = JSBC_HEADER_SIZE;
+    c.size = JSBC_MAX_SIZE;
+    if (pass==2) {
+      c.code = (unsigned char *)jsvGetFlatStringPointer(bytecode);
+      c.size = jsvGetCharactersInVar(bytecode);
+    }
+    jslSeekToP(start);
+    if (type==JSBC_COMPILE_LOOP) {
+      jsbcStatement(&c);
+    } else if (type==JSBC_COMPILE_RETURN) {
+      if (lex->tk!=';' && lex->tk!='}' && lex->tk!=LEX_EOF) {
+        jsbcPosition(&c);
+        jsbcExpression(&c);
+        jsbcOp(&c, JSBC_RETURN, -1);
+      }
+    } else {
+      while (!c.failed && lex->tk!=LEX_EOF)
+        jsbcStatement(&c);
+    }
+    jsbcOp(&c, JSBC_PUSH_UNDEFINED, 1);
+    jsbcOp(&c, JSBC_RETURN, -1);
+    if (c.failed || c.maxDepth>JSBC_MAX_STACK) {
+      jsvUnLock(bytecode);
+      return 0;
+    }
+    slotCount = c.slotCount;
+    if (pass==1) {
+      bytecode = jsvNewFlatStringOfLength((unsigned int)c.pos);
+      if (!bytecode) return 0;
+#ifdef JSPARSE_VARIABLE_CACHE_SIZE
+      jsbcVariableCacheClear();
+#endif
+    }
+  }
+  assert(c.pos == c.size);
+  c.code[0] = (unsigned char)paramCount;
+  c.code[1] = (unsigned char)slotCount;
+  c.code[2] = (unsigned char)c.maxDepth;
+  return bytecode;
+}
+
+JsVar *jsbcCompileFunction(JsVar *function, JsVar *functionCode) {
+  if (!(jsFlags & JSF_BYTECODE)) return 0;
+  JsVar *locals = jsvNewObject();
+  if (!locals) return 0;
+  // Parameters are the first local variables
+  int paramCount = 0;
+  JsvObjectIterator it;
+  jsvObjectIteratorNew(&it, function);
+  while (jsvObjectIteratorHasValue(&it)) {
+    JsVar *param = jsvObjectIteratorGetKey(&it);
+    if (jsvIsFunctionParameter(param)) {
+      char name[JSLEX_MAX_TOKEN_LENGTH+1];
+      jsvGetString(param, name, sizeof(name));
+      JsVar *existing = jsvObjectGetChild(locals, &name[1], 0);
+      if (!existing) // with `function(a,a)` the first one is used
+        jsvObjectSetChildAndUnLock(locals, &name[1], jsvNewFromInteger(paramCount));
+      jsvUnLock(existing);
+      paramCount++;
+    }
+    jsvUnLock(param);
+    jsvObjectIteratorNext(&it);
+  }
+  jsvObjectIteratorFree(&it);
+
+  JsLex newLex;
+  JsLex *oldLex = jslSetLex(&newLex);
+  jslInit(functionCode);
+  JslCharPos start = jslCharPosClone(&lex->tokenStart);
+  JsVar *bytecode = 0;
+  if (paramCount <= JSBC_MAX_SLOTS)
+    bytecode = jsbcCompile(jsvIsFunctionReturn(function) ? JSBC_COMPILE_RETURN : JSBC_COMPILE_FUNCTION, locals, paramCount, &start);
+  jslCharPosFree(&start);
+  jslKill();
+  jslSetLex(oldLex);
+  jsvUnLock(locals);
+
+  // If we couldn't compile it, remember that so we don't try again
+  if (!bytecode) bytecode = jsvNewFromBool(false);
+  jsvObjectSetChild(function, JSPARSE_FUNCTION_BYTECODE_NAME, bytecode);
+  return bytecode;
+}
+
+// ----------------------------------------------------------------------------
+//                                                                           VM
+
+/** Find a variable from bytecode (at `pos`) - like jspGetNamedVariable, or
+ * jspeiFindOnTop if declare is set (for `var`). We remember where we found
+ * it so we don't have to search every scope next time. If a function has
+ * its own scope (hasOwnScope) it's different each time it's called, so we
+ * never remember things found in that. Anything else a function can see
+ * was fixed when it was defined, and we compile each function separately -
+ * so if nothing has been added to or removed from a scope since
+ * (jsvGetNameEpoch) we'll still find the same thing. */
+static JsVar *jsbcGetVariable(JsVar *bytecode, size_t pos, const char *name, bool hasOwnScope, bool declare) {
+#ifdef JSPARSE_VARIABLE_CACHE_SIZE
+  JsVarRef code = jsvGetRef(bytecode);
+  JsbcVariableCacheEntry *e = &jsbcVariableCache[((uint32_t)code*2654435761U + (uint32_t)pos) % JSPARSE_VARIABLE_CACHE_SIZE];
+  if (e->code==code && e->pos==pos && e->epoch==jsvGetNameEpoch()) {
+    if (e->name) return jsvLock(e->name);
+    JsVar *a = jswFindBuiltInFunction(0, name);
+    if (a) return a;
+  }
+  JsVar *a = 0;
+  if (declare) {
+    a = jspeiFindOnTop(name, true);
+    if (hasOwnScope || execInfo.scopeCount) return a;
+  } else {
+    int i = execInfo.scopeCount-1;
+    if (hasOwnScope && i>=0) {
+      a = jsvFindChildFromString(execInfo.scopes[i--], name, false);
+      if (a) return a;
+    }
+    while (i>=0 && !a)
+      a = jsvFindChildFromString(execInfo.scopes[i--], name, false);
+    if (!a)
+      a = jsvFindChildFromString(execInfo.root, name, false);
+    if (!a)
+      a = jspGetNamedVariable(name); // built-in, or a new name
+    if (jsvIsName(a) && !jsvGetRefs(a)) return a; // it doesn't exist yet
+  }
+  if (!a) return 0;
+  e->code = code;
+  e->pos = (uint16_t)pos;
+  e->name = jsvIsName(a) ? jsvGetRef(a) : 0;
+  e->epoch = jsvGetNameEpoch();
+  return a;
+#else
+  NOT_USED(bytecode);
+  NOT_USED(pos);
+  NOT_USED(hasOwnScope);
+  return declare ? jspeiFindOnTop(name, true) : jspGetNamedVariable(name);
+#endif
+}
+
+/// Get the name for `object.name` (like jspeFactorMember). If create, make a new child if it doesn't exist
+static JsVar *jsbcGetFieldName(JsVar *object, const char *name, uint32_t site, bool create) {
+  JsVar *child = 0;
+  if (object)
+#ifdef JSV_PROPERTY_CACHE_SIZE
+    child = jspGetNamedFieldAtSite(object, name, site);
+#else
+    child = jspGetNamedField(object, name, true);
+#endif
+  if (!child) {
+    if (jsvHasChildren(object)) {
+      if (create) {
+        JsVar *nameVar = jsvNewFromString(name);
+        child = jsvCreateNewChild(object, nameVar, 0);
+        jsvUnLock(nameVar);
+      }
+    } else
+      jsExceptionHere(JSET_ERROR, "Field or method \"%s\" does not already exist, and can't create it on %t", name, object);
+  }
+  return child;
+}
+
+/// Get the name for `object[index]` (like jspeFactorMember). index should have had jsvAsArrayIndex called on it
+static JsVar *jsbcGetIndexName(JsVar *object, JsVar *index, bool create) {
+  JsVar *child = 0;
+  /* Making a name from an unreferenced index turns the index itself into that
+   * name. Locals hold their values by lock alone, so if anything else has the
+   * index locked we must give it a copy or we'd change the local too. */
+  bool shared = jsvGetRefs(index)==0 && jsvGetLocks(index)>1;
+  if (object) {
+    if (shared && jsvIsString(object)) {
+      JsVar *indexCopy = jsvCopy(index);
+      child = jspGetVarNamedField(object, indexCopy, true);
+      jsvUnLock(indexCopy);
+    } else
+      child = jspGetVarNamedField(object, index, true);
+  }
+  if (!child) {
+    if (jsvHasChildren(object)) {
+      if (create) {
+        if (shared) {
+          JsVar *indexCopy = jsvCopy(index);
+          child = jsvCreateNewChild(object, indexCopy, 0);
+          jsvUnLock(indexCopy);
+        } else
+          child = jsvCreateNewChild(object, index, 0);
+      }
+    } else
+      jsExceptionHere(JSET_ERROR, "Field or method %q does not already exist, and can't create it on %t", index, object);
+  }
+  return child;
+}
+
+/// `name = value`, like jspeAssignmentExpression
+static void jsbcAssign(JsVar *name, JsVar *value) {
+  if (!name) return;
+  // If we're assigning to something without a parent, add it to the symbol table root
+  if (!jsvGetRefs(name) && jsvIsName(name) &&
+      !jsvIsArrayBufferName(name) && !jsvIsNewChild(name))
+    jsvAddName(execInfo.root, name);
+  jspReplaceWith(name, value);
+}
+
+/** `name op= value` or `name++`/`name--`, like jspeAssignmentExpression/jspePostfixExpression.
+ * Returns the result, or 0 if wantResult is false and it wasn't needed anyway */
+static JsVar *jsbcUpdateName(JsVar *name, JsVar *value, int op, bool wantResult) {
+  if (!name) return 0;
+  // integers that nothing else can see can be changed without allocating
+  if (jsvIsName(name) && (!value || jsvIsSimpleInt(value))) {
+    bool post = op==JSBC_OP_POSTINC || op==JSBC_OP_POSTDEC;
+    int mathsOp = post ? (op==JSBC_OP_POSTINC ? '+' : '-') : JSBC_OP_DECODE(op);
+    JsVarInt oldValue;
+    if (jsvMathsOpIntegerInPlace(name, value ? value->varData.integer : 1, mathsOp, &oldValue)) {
+      if (!wantResult) return 0;
+      return post ? jsvNewFromInteger(oldValue) : jsvSkipName(name);
+    }
+  }
+  if (op==JSBC_OP_POSTINC || op==JSBC_OP_POSTDEC) {
+    JsVar *one = jsvNewFromInteger(1);
+    JsVar *oldValue = jsvAsNumberAndUnLock(jsvSkipName(name)); // keep the old value (but convert to number)
+    JsVar *res = jsvMathsOp(oldValue, one, op==JSBC_OP_POSTINC ? '+' : '-');
+    jspReplaceWith(name, res);
+    jsvUnLock2(res, one);
+    return oldValue;
+  }
+  op = JSBC_OP_DECODE(op);
+  if (op=='+' && jsvIsName(name)) {
+    JsVar *currentValue = jsvSkipName(name);
+    if (jsvIsString(currentValue) && !jsvIsFlatString(currentValue) && jsvGetRefs(currentValue)==1 && value!=currentValue) {
+      // the only use of the string, so append to it rather than copying it
+      JsVar *str = jsvAsString(value, false);
+      jsvAppendStringVarComplete(currentValue, str);
+      jsvUnLock(str);
+      return currentValue;
+    }
+    jsvUnLock(currentValue);
+  }
+  JsVar *res = jsvMathsOpSkipNames(name, value, op);
+  jspReplaceWith(name, res);
+  return res;
+}
+
+/** Run bytecode. If it's a function, params contains the values of its
+ * parameters (see jsbcExecuteFunction) */
+static JsVar *jsbcRun(JsVar *bytecode, JsVar **params, bool hasOwnScope) {
+  unsigned char *code = (unsigned char *)jsvGetFlatStringPointer(bytecode);
+  int paramCount = code[0];
+  int slotCount = code[1];
+  JsVar **slots = (JsVar**)alloca(sizeof(JsVar*)*(size_t)(slotCount+code[2]));
+  int i;
+  // parameters are the first slots
+  for (i=0;i<paramCount;i++)
+    slots[i] = jsvLockAgainSafe(params[i]);
+  for (;i<slotCount;i++)
+    slots[i] = 0;
+  JsVar **stack = &slots[slotCount];
+  JsVar **sp = stack;
+  JsVar *result = 0;
+  // identifies the bytecode for jspGetNamedFieldAtSite
+  uint32_t site = (uint32_t)jsvGetRef(bytecode)*2654435761U;
+  unsigned char *pc = code + JSBC_HEADER_SIZE;
+
+  while (pc && !(execInfo.execute&EXEC_ERROR_MASK)) {
+    JsbcOpcode op = (JsbcOpcode)*(pc++);
+    switch (op) {
+      case JSBC_POS:
+        if (lex) lex->tokenLastStart = JSBC_U32(pc);
+#ifdef JSPROFILE_MAX_FUNCTIONS
+        if (jsprofSampling) jsprofSample(JSBC_U32(pc));
+#endif
+        pc += 4;
+        break;
+      case JSBC_PUSH_UNDEFINED: *(sp++) = 0; break;
+      case JSBC_PUSH_NULL: *(sp++) = jsvNewNull(); break;
+      case JSBC_PUSH_TRUE: *(sp++) = jsvNewFromBool(true); break;
+      case JSBC_PUSH_FALSE: *(sp++) = jsvNewFromBool(false); break;
+      case JSBC_PUSH_INT8: *(sp++) = jsvNewFromInteger((signed char)*(pc++)); break;
+      case JSBC_PUSH_INT:
+        *(sp++) = jsvNewFromInteger((JsVarInt)JSBC_U32(pc));
+        pc += 4;
+        break;
+      case JSBC_PUSH_FLOAT: {
+        JsVarFloat f;
+        memcpy(&f, pc, sizeof(f));
+        pc += sizeof(f);
+        *(sp++) = jsvNewFromFloat(f);
+        break;
+      }
+      case JSBC_PUSH_STRING: {
+        unsigned int len = JSBC_U16(pc);
+        JsVar *str = jsvNewFromEmptyString();
+        if (str) jsvAppendStringBuf(str, (const char*)pc+2, len);
+        pc += 2+len;
+        *(sp++) = str;
+        break;
+      }
+      case JSBC_PUSH_THIS:
+        *(sp++) = jsvLockAgain(execInfo.thisVar ? execInfo.thisVar : execInfo.root);
+        break;
+      case JSBC_POP: jsvUnLock(*(--sp)); break;
+      case JSBC_SWAP: {
+        JsVar *v = sp[-1];
+        sp[-1] = sp[-2];
+        sp[-2] = v;
+        break;
+      }
+      case JSBC_GET_LOCAL: *(sp++) = jsvLockAgainSafe(slots[*(pc++)]); break;
+      case JSBC_SET_LOCAL:
+        jsvUnLock(slots[*pc]);
+        slots[*(pc++)] = jsvLockAgainSafe(sp[-1]);
+        break;
+      case JSBC_SET_LOCAL_POP:
+        jsvUnLock(slots[*pc]);
+        slots[*(pc++)] = *(--sp);
+        break;
+      case JSBC_GET_NAME:
+        *(sp++) = jsvSkipNameAndUnLock(jsbcGetVariable(bytecode, (size_t)(pc-code), (const char*)pc+1, hasOwnScope, false));
+        pc += pc[0]+2;
+        break;
+      case JSBC_SET_NAME:
+      case JSBC_SET_NAME_POP: {
+        JsVar *name = jsbcGetVariable(bytecode, (size_t)(pc-code), (const char*)pc+1, hasOwnScope, false);
+        jsbcAssign(name, sp[-1]);
+        jsvUnLock(name);
+        if (op==JSBC_SET_NAME_POP) jsvUnLock(*(--sp));
+        pc += pc[0]+2;
+        break;
+      }
+      case JSBC_VAR_NAME:
+      case JSBC_DECLARE_NAME: {
+        JsVar *name = jsbcGetVariable(bytecode, (size_t)(pc-code), (const char*)pc+1, hasOwnScope, true);
+        if (op==JSBC_VAR_NAME) {
+          if (name) jspReplaceWith(name, sp[-1]);
+          jsvUnLock(*(--sp));
+        }
+        jsvUnLock(name);
+        pc += pc[0]+2;
+        break;
+      }
+      case JSBC_GET_FIELD: {
+        JsVar *obj = sp[-1];
+        sp[-1] = jsvSkipNameAndUnLock(jsbcGetFieldName(obj, (const char*)pc+1, site+(uint32_t)(pc-code), false));
+        jsvUnLock(obj);
+        pc += pc[0]+2;
+        break;
+      }
+      case JSBC_GET_METHOD:
+        *sp = jsvSkipNameAndUnLock(jsbcGetFieldName(sp[-1], (const char*)pc+1, site+(uint32_t)(pc-code), false));
+        sp++;
+        pc += pc[0]+2;
+        break;
+      case JSBC_SET_FIELD:
+      case JSBC_SET_FIELD_POP: {
+        JsVar *name = jsbcGetFieldName(sp[-2], (const char*)pc+1, site+(uint32_t)(pc-code), true);
+        jsbcAssign(name, sp[-1]);
+        jsvUnLock2(name, sp[-2]);
+        sp[-2] = sp[-1];
+        sp--;
+        if (op==JSBC_SET_FIELD_POP) jsvUnLock(*(--sp));
+        pc += pc[0]+2;
+        break;
+      }
+      case JSBC_GET_INDEX:
+      case JSBC_GET_INDEX_METHOD: {
+        JsVar *obj = sp[-2];
+        JsVar *index = jsvAsArrayIndexAndUnLock(sp[-1]);
+        JsVar *value;
+        if (jsvIsArrayBuffer(obj) && jsvIsInt(index)) // no need to make a name
+          value = jsvArrayBufferGet(obj, (size_t)jsvGetInteger(index));
+        else
+          value = jsvSkipNameAndUnLock(jsbcGetIndexName(obj, index, false));
+        jsvUnLock(index);
+        if (op==JSBC_GET_INDEX) {
+          jsvUnLock(obj);
+          sp[-2] = value;
+          sp--;
+        } else
+          sp[-1] = value;
+        break;
+      }
+      case JSBC_SET_INDEX:
+      case JSBC_SET_INDEX_POP: {
+        JsVar *obj = sp[-3];
+        JsVar *index = jsvAsArrayIndexAndUnLock(sp[-2]);
+        if (jsvIsArrayBuffer(obj) && jsvIsInt(index)) {
+          jsvArrayBufferSet(obj, (size_t)jsvGetInteger(index), sp[-1]);
+        } else {
+          JsVar *name = jsbcGetIndexName(obj, index, true);
+          jsbcAssign(name, sp[-1]);
+          jsvUnLock(name);
+        }
+        jsvUnLock2(index, obj);
+        sp[-3] = sp[-1];
+        sp -= 2;
+        if (op==JSBC_SET_INDEX_POP) jsvUnLock(*(--sp));
+        break;
+      }
+      case JSBC_UPDATE_LOCAL:
+      case JSBC_UPDATE_LOCAL_POP: {
+        JsVar **slot = &slots[pc[0]];
+        int updateOp = pc[1];
+        JsVar *res;
+        pc += 2;
+        bool post = updateOp==JSBC_OP_POSTINC || updateOp==JSBC_OP_POSTDEC;
+        JsVarInt oldValue;
+        if ((post || jsvIsSimpleInt(sp[-1])) && !jsvIsName(*slot) &&
+            jsvMathsOpIntegerInPlace(*slot, post ? 1 : sp[-1]->varData.integer,
+                post ? (updateOp==JSBC_OP_POSTINC ? '+' : '-') : JSBC_OP_DECODE(updateOp), &oldValue)) {
+          // the slot held the only lock on an integer, so we changed it directly
+          if (!post) jsvUnLock(*(--sp));
+          if (op==JSBC_UPDATE_LOCAL)
+            *(sp++) = post ? jsvNewFromInteger(oldValue) : jsvLockAgain(*slot);
+          break;
+        }
+        if (post) {
+          JsVar *one = jsvNewFromInteger(1);
+          res = jsvAsNumber(*slot); // we return the old value (converted to a number)
+          JsVar *newValue = jsvMathsOp(res, one, updateOp==JSBC_OP_POSTINC ? '+' : '-');
+          jsvUnLock2(*slot, one);
+          *slot = newValue;
+        } else {
+          JsVar *value = *(--sp);
+          updateOp = JSBC_OP_DECODE(updateOp);
+          if (updateOp=='+' && jsvIsString(*slot) && !jsvIsFlatString(*slot) && !jsvIsNativeString(*slot) &&
+              jsvGetRefs(*slot)==0 && jsvGetLocks(*slot)==1 && value!=*slot) {
+            // nothing else uses the string, so append to it rather than copying it
+            JsVar *str = jsvAsString(value, false);
+            jsvAppendStringVarComplete(*slot, str);
+            jsvUnLock(str);
+            res = jsvLockAgain(*slot);
+          } else {
+            res = jsvMathsOp(*slot, value, updateOp);
+            jsvUnLock(*slot);
+            *slot = jsvLockAgainSafe(res);
+          }
+          jsvUnLock(value);
+        }
+        if (op==JSBC_UPDATE_LOCAL) *(sp++) = res;
+        else jsvUnLock(res);
+        break;
+      }
+      case JSBC_UPDATE_NAME:
+      case JSBC_UPDATE_FIELD:
+      case JSBC_UPDATE_INDEX: {
+        int updateOp = *(pc++);
+        JsVar *value = 0;
+        if (updateOp!=JSBC_OP_POSTINC && updateOp!=JSBC_OP_POSTDEC)
+          value = *(--sp);
+        JsVar *name;
+        if (op==JSBC_UPDATE_NAME) {
+          name = jsbcGetVariable(bytecode, (size_t)(pc-code), (const char*)pc+1, hasOwnScope, false);
+          pc += pc[0]+2;
+        } else if (op==JSBC_UPDATE_FIELD) {
+          name = jsbcGetFieldName(sp[-1], (const char*)pc+1, site+(uint32_t)(pc-code), true);
+          jsvUnLock(*(--sp));
+          pc += pc[0]+2;
+        } else {
+          JsVar *index = jsvAsArrayIndexAndUnLock(sp[-1]);
+          name = jsbcGetIndexName(sp[-2], index, true);
+          jsvUnLock2(index, sp[-2]);
+          sp -= 2;
+        }
+        if (*pc==JSBC_POP) { // result isn't used, so don't bother making it
+          pc++;
+          jsvUnLock(jsbcUpdateName(name, value, updateOp, false));
+        } else
+          *(sp++) = jsbcUpdateName(name, value, updateOp, true);
+        jsvUnLock2(name, value);
+        break;
+      }
+      case JSBC_CALL:
+      case JSBC_NEW: {
+        int argCount = pc[0];
+        unsigned int namePos = JSBC_U16(&pc[1]);
+        pc += 3;
+        JsVar **args = sp - argCount;
+        JsVar *func = args[-1];
+        // We only need the name for errors, or for the stack trace of non-native functions
+        JsVar *funcName = 0;
+        if (namePos && (!func || (jsvIsFunction(func) && !jsvIsNative(func))))
+          funcName = jsvNewFromString((const char*)&code[namePos]);
+        JsVar *res;
+        if (op==JSBC_CALL) {
+          res = jspeFunctionCall(func, funcName, args[-2], false, argCount, args);
+        } else if (!func) {
+          jsExceptionHere(JSET_ERROR, "Constructor should be a function, but is %t", func);
+          res = 0;
+        } else
+          res = jspConstruct(func, funcName, argCount, args);
+        jsvUnLock(funcName);
+        while (sp > args) jsvUnLock(*(--sp));
+        jsvUnLock(*(--sp)); // function
+        if (op==JSBC_CALL) jsvUnLock(*(--sp)); // this
+        *(sp++) = jsvSkipNameAndUnLock(res);
+        break;
+      }
+      case JSBC_BINOP: {
+        int binOp = *(pc++);
+        if (*pc==JSBC_JMP_IF_FALSE && jsvIsSimpleInt(sp[-2]) && jsvIsSimpleInt(sp[-1])) {
+          // integer comparison followed by a conditional jump (eg. a loop) - don't allocate the boolean
+          JsVarInt a = sp[-2]->varData.integer, b = sp[-1]->varData.integer;
+          int cond = -1;
+          switch (JSBC_OP_DECODE(binOp)) {
+          case '<': cond = a<b; break;
+          case LEX_LEQUAL: cond = a<=b; break;
+          case '>': cond = a>b; break;
+          case LEX_GEQUAL: cond = a>=b; break;
+          case LEX_EQUAL: case LEX_TYPEEQUAL: cond = a==b; break;
+          case LEX_NEQUAL: case LEX_NTYPEEQUAL: cond = a!=b; break;
+          }
+          if (cond>=0) {
+            jsvUnLock2(sp[-2], sp[-1]);
+            sp -= 2;
+            if (cond) pc += 3;
+            else pc = code + JSBC_U16(pc+1);
+            break;
+          }
+        }
+        JsVar *res = jsvMathsOp(sp[-2], sp[-1], JSBC_OP_DECODE(binOp));
+        jsvUnLock2(sp[-2], sp[-1]);
+        sp[-2] = res;
+        sp--;
+        break;
+      }
+      case JSBC_IN:
+      case JSBC_INSTANCEOF: {
+        JsVar *res = (op==JSBC_IN) ? jspIn(sp[-2], sp[-1]) : jsvNewFromBool(jspInstanceOf(sp[-2], sp[-1]));
+        jsvUnLock2(sp[-2], sp[-1]);
+        sp[-2] = res;
+        sp--;
+        break;
+      }
+      case JSBC_NOT: sp[-1] = jsvNewFromBool(!jsvGetBoolAndUnLock(sp[-1])); break;
+      case JSBC_BITNOT: sp[-1] = jsvNewFromInteger(~jsvGetIntegerAndUnLock(sp[-1])); break;
+      case JSBC_NEG: sp[-1] = jsvNegateAndUnLock(sp[-1]); break;
+      case JSBC_TONUMBER: sp[-1] = jsvAsNumberAndUnLock(sp[-1]); break;
+      case JSBC_TYPEOF: {
+        JsVar *res = jsvNewFromString(jsvGetTypeOf(sp[-1]));
+        jsvUnLock(sp[-1]);
+        sp[-1] = res;
+        break;
+      }
+      case JSBC_TYPEOF_NAME: {
+        JsVar *a = jsbcGetVariable(bytecode, (size_t)(pc-code), (const char*)pc+1, hasOwnScope, false);
+        if (jsvIsVariableDefined(a)) {
+          a = jsvSkipNameAndUnLock(a);
+          *(sp++) = jsvNewFromString(jsvGetTypeOf(a));
+        } else
+          *(sp++) = jsvNewFromString("undefined");
+        jsvUnLock(a);
+        pc += pc[0]+2;
+        break;
+      }
+      case JSBC_NEW_OBJECT: *(sp++) = jsvNewObject(); break;
+      case JSBC_INIT_FIELD: {
+        JsVar *obj = sp[-2];
+        JsVar *name = jsvAsArrayIndexAndUnLock(jsvNewFromString((const char*)pc+1));
+        JsVar *child = obj ? jsvFindChildFromVar(obj, name, true) : 0;
+        if (child) jsvSetValueOfName(child, sp[-1]);
+        jsvUnLock3(child, name, *(--sp));
+        pc += pc[0]+2;
+        break;
+      }
+      case JSBC_NEW_ARRAY: *(sp++) = jsvNewEmptyArray(); break;
+      case JSBC_ARRAY_PUSH:
+        if (sp[-2]) jsvArrayPush(sp[-2], sp[-1]);
+        jsvUnLock(*(--sp));
+        break;
+      case JSBC_JMP:
+        pc = code + JSBC_U16(pc);
+        break;
+      case JSBC_JMP_IF_FALSE:
+        if (jsvGetBoolAndUnLock(*(--sp))) pc += 2;
+        else pc = code + JSBC_U16(pc);
+        break;
+      case JSBC_JMP_IF_FALSE_KEEP:
+      case JSBC_JMP_IF_TRUE_KEEP:
+        if (jsvGetBool(sp[-1]) == (op==JSBC_JMP_IF_TRUE_KEEP)) {
+          pc = code + JSBC_U16(pc);
+        } else {
+          jsvUnLock(*(--sp));
+          pc += 2;
+        }
+        break;
+      case JSBC_RETURN:
+        result = *(--sp);
+        pc = 0;
+        break;
+      case JSBC_THROW:
+        jspSetException(sp[-1]);
+        jsvUnLock(*(--sp));
+        break;
+      default:
+        assert(0);
+        jsExceptionHere(JSET_INTERNALERROR, "Unknown bytecode %d", op);
+        break;
+    }
+  }
+
+  while (sp > stack) jsvUnLock(*(--sp));
+  jsvUnLockMany((unsigned int)slotCount, slots);
+  // Like jspeBlockNoBrackets - say where the error was if nobody else has
+  if ((execInfo.execute&EXEC_ERROR_MASK) && lex && !(execInfo.execute&EXEC_ERROR_LINE_REPORTED)) {
+    execInfo.execute = (JsExecFlags)(execInfo.execute | EXEC_ERROR_LINE_REPORTED);
+    JsVar *stackTrace = jsvObjectGetChild(execInfo.hiddenRoot, JSPARSE_STACKTRACE_VAR, JSV_STRING_0);
+    if (stackTrace) {
+      jsvAppendPrintf(stackTrace, "at ");
+      jspAppendStackTrace(stackTrace);
+      jsvUnLock(stackTrace);
+    }
+  }
+  return result;
+}
+
+JsVar *jsbcExecuteFunction(JsVar *bytecode, JsVar **params, int paramCount, bool hasOwnScope) {
+  assert(paramCount == ((unsigned char*)jsvGetFlatStringPointer(bytecode))[0]);
+  NOT_USED(paramCount);
+  return jsbcRun(bytecode, params, hasOwnScope);
+}
+
+bool jsbcExecuteLoop() {
+  if (!(jsFlags & JSF_BYTECODE) || execInfo.scopeCount ||
+      (execInfo.execute&(EXEC_RUN_MASK|EXEC_IN_LOOP|EXEC_IN_SWITCH|EXEC_FOR_INIT))!=EXEC_YES)
+    return false;
+#ifdef USE_DEBUGGER
+  if (execInfo.execute&EXEC_DEBUGGER_MASK) return false;
+#endif
+  JslCharPos start = jslCharPosClone(&lex->tokenStart);
+  JsVar *bytecode = jsbcCompile(JSBC_COMPILE_LOOP, 0, 0, &start);
+  if (bytecode)
+    jsvUnLock2(jsbcRun(bytecode, 0, false), bytecode);
+  else
+    jslSeekToP(&start);
+  jslCharPosFree(&start);
+  return bytecode!=0;
+}
+
+#endif
@@ -0,0 +1,45 @@
+/*
+ * This file is part of Espruino, a JavaScript interpreter for Microcontrollers
+ *
+ * Copyright (C) 2013 Gordon Williams <gw@pur3.co.uk>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * ----------------------------------------------------------------------------
+ * Compiles functions and loops to bytecode for a simple stack-based VM,
+ * so they don't have to be parsed each time they're run
+ * ----------------------------------------------------------------------------
+ */
+#ifndef JSBYTECODE_H_
+#define JSBYTECODE_H_
+
+#include "jsutils.h"
+#include "jsvar.h"
+
+#ifdef JSPARSE_BYTECODE
+
+/** Compile the given function (which has the code given) to bytecode, and
+ * store it in the function as JSPARSE_FUNCTION_BYTECODE_NAME. If it can't
+ * be compiled (because it uses something the VM can't do), we store `false`
+ * so we don't try again.
+ * Returns whatever was stored - only a flat string is something we can run */
+JsVar *jsbcCompileFunction(JsVar *function, JsVar *functionCode);
+
+/** Run compiled function code (from jsbcCompileFunction), with the scopes
+ * and `this` already set up. params contains the value of each of the
+ * function's parameters (paramCount must be how many it has). hasOwnScope
+ * should be set if the function's own scope has been added as the top
+ * scope. Returns the function's return value. */
+JsVar *jsbcExecuteFunction(JsVar *bytecode, JsVar **params, int paramCount, bool hasOwnScope);
+
+/** If the lexer is on a `for`/`while`/`do` loop in code that's only run
+ * once (not in a function or another loop), try and compile it and run it.
+ * Returns true if it was run (and the lexer is now after it) or false
+ * if it has to be parsed as normal (and the lexer hasn't moved). */
+bool jsbcExecuteLoop();
+
+#endif
+
+#endif /* JSBYTECODE_H_ */
@@ -30,23 +30,40 @@ JshEventCallbackCallback jshEventCallbacks[EV_EXTI_MAX+1-EV_EXTI0];
 // ----------------------------------------------------------------------------
 //                                                         DATA TRANSMIT BUFFER
 
-/**
- * A single character to be transmitted.
- */
+/* Each device we can transmit on has its own ring buffer, so the data for
+ * a device can be sent in contiguous blocks (one write() on Linux, or one
+ * DMA transfer) and one slow device can't hold up the others. Only the main
+ * loop adds data (at head) and only the device's IRQ (or thread on Linux)
+ * takes it (from tail) - except that the main loop can clear a device, so
+ * tail is moved on with a compare-and-swap. */
 typedef struct {
-  IOEventFlags flags; //!< Where this data should be transmitted
-  unsigned char data; //!< data to transmit
-} PACKED_FLAGS TxBufferItem;
-
-/**
- * An array of items to transmit.
- */
-volatile TxBufferItem txBuffer[TXBUFFERMASK+1];
-
-/**
- * The head and tail of the list.
- */
-volatile unsigned char txHead=0, txTail=0;
+  volatile uint32_t head, tail; ///< These count bytes, and wrap at 2^32
+  unsigned char *data; ///< In txBufferData
+  uint16_t mask;       ///< The size of data-1 (a power of 2)
+} TxBuffer;
+
+/// Devices that have a transmit buffer (Loopback doesn't need one, and the console on Linux goes straight to stdout)
+#define DEVICE_HAS_TXBUFFER(X) (((X)>=EV_LIMBO) && ((X)<EV_SERIAL1+USART_COUNT))
+#define TXBUFFER_DEVICES (EV_SERIAL1+USART_COUNT-EV_LIMBO)
+#ifdef LINUX
+#define TXBUFFER_SIZE_FOR(X) (TXBUFFERMASK+1)
+#define TXBUFFER_TOTAL ((TXBUFFERMASK+1)*TXBUFFER_DEVICES)
+#else
+/* RAM is short, so only the devices the console normally uses get the full
+ * TXBUFFERMASK+1 bytes. Limbo only holds what's printed before the console is
+ * set up, and other USARTs just wait for space a bit sooner. */
+#define TXBUFFER_SMALL (((TXBUFFERMASK+1)/4 < 16) ? 16 : (TXBUFFERMASK+1)/4)
+#define TXBUFFER_SIZE_FOR(X) (((X)==EV_LIMBO || (X)>EV_SERIAL1) ? TXBUFFER_SMALL : (TXBUFFERMASK+1))
+#define TXBUFFER_SMALL_COUNT (1 + ((USART_COUNT>1) ? USART_COUNT-1 : 0)) // Limbo, and USARTs after the first
+#define TXBUFFER_TOTAL ((TXBUFFERMASK+1)*(TXBUFFER_DEVICES-TXBUFFER_SMALL_COUNT) + TXBUFFER_SMALL*TXBUFFER_SMALL_COUNT)
+#endif
+
+TxBuffer txBuffers[TXBUFFER_DEVICES];
+unsigned char txBufferData[TXBUFFER_TOTAL];
+/// Which of txBuffers each device uses. jshTransmitMove can swap them over if they're the same size
+volatile unsigned char txBufferForDevice[TXBUFFER_DEVICES];
+#define TXBUFFER(DEVICE) (&txBuffers[txBufferForDevice[(DEVICE)-EV_LIMBO]])
+#define TXBUFFER_USED(BUF) ((BUF)->head - (BUF)->tail)
 
 typedef enum {
   SDS_NONE,
@@ -54,6 +71,7 @@ typedef enum {
   SDS_XON_PENDING = 2,
   SDS_XOFF_SENT = 4, // sending XON clears this
   SDS_FLOW_CONTROL_XON_XOFF = 8, // flow control enabled
+  SDS_SENDING_FLOW_CONTROL = 16, // jshGetDataToTransmit returned XON/XOFF rather than data from the buffer
 } PACKED_FLAGS JshSerialDeviceState;
 JshSerialDeviceState jshSerialDeviceStates[EV_SERIAL1+USART_COUNT-EV_SERIAL_START];
 /// Device clear to send hardware flow control pins (PIN_UNDEFINED if not used)
@@ -62,8 +80,58 @@ Pin jshSerialDeviceCTSPins[EV_SERIAL1+USART_COUNT-EV_SERIAL_START];
 
 // ----------------------------------------------------------------------------
 //                                                              IO EVENT BUFFER
-volatile IOEvent ioBuffer[IOBUFFERMASK+1];
-volatile unsigned char ioHead=0, ioTail=0;
+/* Events are stored as records of one or more 8 byte blocks. The first
+ * block starts with a header (see IOBUF_HEADER) followed by the event's data
+ * (characters, or the time for other events), which carries on into as many
+ * blocks as it needs. The last character record can be added to (so
+ * characters that arrive one at a time don't need a record each).
+ *
+ * Events can be pushed from more than one place at once (IRQs, or other
+ * threads on Linux), but only read from the main loop. Space is reserved by
+ * moving ioHead on with a compare-and-swap, and the header is written last
+ * to show the record is ready. To add to a record, a producer sets
+ * IOBUF_BUSY in its header, and the main loop sets IOBUF_SEALED before it
+ * reads one, so the two can never happen at once. Free blocks always
+ * have a header of 0. */
+typedef union {
+  volatile uint32_t header; ///< In the first block of a record
+  volatile char chars[8];   ///< Data - chars 4-7 in the first block, or all of them after that
+} IOBufferBlock;
+
+#define IOBUF_COMMITTED 0x01000000 ///< The record has been written
+#define IOBUF_SEALED    0x02000000 ///< The record is being read (or was removed), so nothing can be added to it
+#define IOBUF_BUSY      0x04000000 ///< Something is adding data to the record
+#define IOBUF_HEADER(FLAGS, LEN) (IOBUF_COMMITTED | ((uint32_t)(LEN)<<8) | (uint32_t)(FLAGS))
+#define IOBUF_HEADER_FLAGS(HEADER) ((IOEventFlags)((HEADER)&0xFF))
+#define IOBUF_HEADER_LENGTH(HEADER) ((unsigned int)((HEADER)>>8)&0xFFFF)
+#define IOBUF_BLOCKS(LEN) (((uint32_t)(LEN)+4+7)>>3) ///< How many blocks a record of LEN bytes needs
+#define IOBUF_BLOCK(POS) (&ioBuffer[(POS)&IOBUFFERMASK])
+
+IOBufferBlock ioBuffer[IOBUFFERMASK+1];
+/// Where the next record goes, and where the first one we haven't read is. These count blocks, and wrap at 2^32
+volatile uint32_t ioHead=0, ioTail=0;
+/// Where the last record we added was, so we can add characters to it
+volatile uint32_t ioLast=0;
+
+#ifdef LINUX
+// jshInputThread pushes events at the same time as the main thread, so we need proper atomics
+#define IOBUF_LOAD(X) __atomic_load_n(&(X), __ATOMIC_ACQUIRE)
+#define IOBUF_STORE(X,V) __atomic_store_n(&(X), (V), __ATOMIC_RELEASE)
+#define IOBUF_CAS(X,EXPECTED,V) __atomic_compare_exchange_n(&(X), &(EXPECTED), (V), false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)
+#else
+// Single core - we only need to make sure an IRQ can't happen in the middle of a compare-and-swap
+static bool CALLED_FROM_INTERRUPT ioBufCompareAndSwap(volatile uint32_t *x, uint32_t *expected, uint32_t v) {
+  jshInterruptOff();
+  bool swapped = *x == *expected;
+  if (swapped) *x = v;
+  else *expected = *x;
+  jshInterruptOn();
+  return swapped;
+}
+#define IOBUF_LOAD(X) (X)
+#define IOBUF_STORE(X,V) ((X)=(V))
+#define IOBUF_CAS(X,EXPECTED,V) ioBufCompareAndSwap(&(X), &(EXPECTED), (V))
+#endif
 
 // ----------------------------------------------------------------------------
 
@@ -71,6 +139,16 @@ volatile unsigned char ioHead=0, ioTail=0;
 /** Initialize any device-specific structures, like flow control states.
  * Called from jshInit */
 void jshInitDevices() {
+  unsigned int i, offset = 0;
+  for (i=0;i<TXBUFFER_DEVICES;i++) {
+    unsigned int size = TXBUFFER_SIZE_FOR(EV_LIMBO+i);
+    txBuffers[i].head = txBuffers[i].tail = 0;
+    txBuffers[i].data = &txBufferData[offset];
+    txBuffers[i].mask = (uint16_t)(size-1);
+    offset += size;
+    txBufferForDevice[i] = (unsigned char)i;
+  }
+  assert(offset == TXBUFFER_TOTAL);
   jshResetDevices();
 }
 
@@ -109,15 +187,28 @@ void jshTransmit(
     IOEventFlags device, //!< The device to be used for transmission.
     unsigned char data   //!< The character to transmit.
   ) {
+  jshTransmitBuffer(device, &data, 1);
+}
+
+/**
+ * Queue data for transmission. If there isn't space in the device's buffer,
+ * this waits until there is.
+ */
+void jshTransmitBuffer(
+    IOEventFlags device,       //!< The device to be used for transmission.
+    const unsigned char *data, //!< The data to transmit.
+    size_t len                 //!< How many bytes there are.
+  ) {
+  if (!len) return;
   if (device==EV_LOOPBACKA || device==EV_LOOPBACKB) {
-    jshPushIOCharEvent(device==EV_LOOPBACKB ? EV_LOOPBACKA : EV_LOOPBACKB, (char)data);
+    jshPushIOCharEvents(device==EV_LOOPBACKB ? EV_LOOPBACKA : EV_LOOPBACKB, (char*)data, (unsigned int)len);
     return;
   }
 #ifdef USE_TELNET
   if (device == EV_TELNET) {
     // gross hack to avoid deadlocking on the network here
     extern void telnetSendChar(char c);
-    telnetSendChar(data);
+    while (len--) telnetSendChar((char)*(data++));
     return;
   }
 #endif
@@ -130,60 +221,72 @@ void jshTransmit(
 #endif
 #else // if PC, just put to stdout
   if (device==DEFAULT_CONSOLE_DEVICE) {
-    fputc(data, stdout);
+    fwrite(data, 1, len, stdout);
     fflush(stdout);
     return;
   }
 #endif
-  // If the device is EV_NONE then there is nowhere to send the data.
-  if (device==EV_NONE) return;
-
-  // The txHead global points to the current item in the txBuffer.  Since we are adding a new
-  // character, we increment the head pointer.   If it has caught up with the tail, then that means
-  // we have filled the array backing the list.  What we do next is to wait for space to free up.
-  unsigned char txHeadNext = (unsigned char)((txHead+1)&TXBUFFERMASK);
-  if (txHeadNext==txTail) {
-    jsiSetBusy(BUSY_TRANSMIT, true);
-    bool wasConsoleLimbo = device==EV_LIMBO && jsiGetConsoleDevice()==EV_LIMBO;
-    while (txHeadNext==txTail) {
-      // wait for send to finish as buffer is about to overflow
+  // If the device has no buffer (eg. EV_NONE) then there is nowhere to send the data.
+  if (!DEVICE_HAS_TXBUFFER(device)) return;
+
+  while (len) {
+    TxBuffer *buf = TXBUFFER(device);
+    uint32_t head = buf->head;
+    uint32_t space = (uint32_t)buf->mask+1 - (head - IOBUF_LOAD(buf->tail));
+    if (!space) {
+      // The buffer is full - wait for some of it to be sent
+      jsiSetBusy(BUSY_TRANSMIT, true);
+      bool wasConsoleLimbo = device==EV_LIMBO && jsiGetConsoleDevice()==EV_LIMBO;
+      jshUSARTKick(device);
+      while (TXBUFFER_USED(TXBUFFER(device)) > TXBUFFER(device)->mask) {
+        // wait for send to finish as buffer is about to overflow
 #ifdef USB
-      // just in case USB was unplugged while we were waiting!
-      if (!jshIsUSBSERIALConnected()) jshTransmitClearDevice(EV_USBSERIAL);
+        // just in case USB was unplugged while we were waiting!
+        if (!jshIsUSBSERIALConnected()) jshTransmitClearDevice(EV_USBSERIAL);
 #endif
+      }
+      if (wasConsoleLimbo && jsiGetConsoleDevice()!=EV_LIMBO) {
+        /* It was 'Limbo', but now it's not - see jsiOneSecondAfterStartup.
+        Basically we must have printed a bunch of stuff to LIMBO and blocked
+        with our output buffer full. But then jsiOneSecondAfterStartup
+        switches to the right console device and swaps everything we wrote
+        over to that device too. Only we're now here, still writing to the
+        old device when really we should be writing to the new one. */
+        device = jsiGetConsoleDevice();
+        if (!DEVICE_HAS_TXBUFFER(device)) {
+          jsiSetBusy(BUSY_TRANSMIT, false);
+          jshTransmitBuffer(device, data, len);
+          return;
+        }
+      }
+      jsiSetBusy(BUSY_TRANSMIT, false);
+      continue;
     }
-    if (wasConsoleLimbo && jsiGetConsoleDevice()!=EV_LIMBO) {
-      /* It was 'Limbo', but now it's not - see jsiOneSecondAfterStartup.
-      Basically we must have printed a bunch of stuff to LIMBO and blocked
-      with our output buffer full. But then jsiOneSecondAfterStartup
-      switches to the right console device and swaps everything we wrote
-      over to that device too. Only we're now here, still writing to the
-      old device when really we should be writing to the new one. */
-      device = jsiGetConsoleDevice();
-    }
-    jsiSetBusy(BUSY_TRANSMIT, false);
+    // Copy as much as we can in one go - up to the end of the buffer
+    uint32_t offset = head & buf->mask;
+    uint32_t n = (uint32_t)buf->mask+1 - offset;
+    if (n > space) n = space;
+    if (n > len) n = (uint32_t)len;
+    memcpy(&buf->data[offset], data, n);
+    IOBUF_STORE(buf->head, head + n);
+    data += n;
+    len -= n;
+    jshUSARTKick(device); // set up interrupts if required
   }
-  // Save the device and data for the new character to be transmitted.
-  txBuffer[txHead].flags = device;
-  txBuffer[txHead].data = data;
-  txHead = txHeadNext;
-
-  jshUSARTKick(device); // set up interrupts if required
 }
 
-// Return the device at the top of the transmit queue (or EV_NONE)
+// Return a device that has data waiting to be transmitted (or EV_NONE)
 IOEventFlags jshGetDeviceToTransmit() {
-  if (!jshHasTransmitData()) return EV_NONE;
-  return IOEVENTFLAGS_GETTYPE(txBuffer[txTail].flags);
+  int i;
+  for (i=0;i<TXBUFFER_DEVICES;i++) {
+    IOEventFlags device = (IOEventFlags)(EV_LIMBO+i);
+    if (TXBUFFER_USED(TXBUFFER(device))) return device;
+  }
+  return EV_NONE;
 }
 
-/**
- * Try and get a character for transmission.
- * \return The next byte to transmit or -1 if there is none.
- */
-int jshGetCharToTransmit(
-    IOEventFlags device // The device being looked at for a transmission.
-  ) {
+/// If the device has an XON or XOFF to send, return it (and mark it as sent) - or return -1
+static int jshGetFlowControlCharToTransmit(IOEventFlags device) {
   if (DEVICE_IS_USART(device)) {
     JshSerialDeviceState *deviceState = &jshSerialDeviceStates[TO_SERIAL_DEVICE_STATE(device)];
     if ((*deviceState)&SDS_XOFF_PENDING) {
@@ -195,27 +298,78 @@ int jshGetCharToTransmit(
       return 17/*XON*/;
     }
   }
+  return -1;
+}
 
-  unsigned char tempTail = txTail;
-  while (txHead != tempTail) {
-    if (IOEVENTFLAGS_GETTYPE(txBuffer[tempTail].flags) == device) {
-      unsigned char data = txBuffer[tempTail].data;
-      if (tempTail != txTail) { // so we weren't right at the back of the queue
-        // we need to work back from tempTail (until we hit tail), shifting everything forwards
-        unsigned char this = tempTail;
-        unsigned char last = (unsigned char)((this+TXBUFFERMASK)&TXBUFFERMASK);
-        while (this!=txTail) { // if this==txTail, then last is before it, so stop here
-          txBuffer[this] = txBuffer[last];
-          this = last;
-          last = (unsigned char)((this+TXBUFFERMASK)&TXBUFFERMASK);
-        }
-      }
-      txTail = (unsigned char)((txTail+1)&TXBUFFERMASK); // advance the tail
-      return data; // return data
+/**
+ * Try and get a character for transmission.
+ * \return The next byte to transmit or -1 if there is none.
+ */
+int jshGetCharToTransmit(
+    IOEventFlags device // The device being looked at for a transmission.
+  ) {
+  int flowControlChar = jshGetFlowControlCharToTransmit(device);
+  if (flowControlChar>=0) return flowControlChar;
+  if (!DEVICE_HAS_TXBUFFER(device)) return -1;
+
+  TxBuffer *buf = TXBUFFER(device);
+  while (true) {
+    uint32_t tail = IOBUF_LOAD(buf->tail);
+    if (tail == IOBUF_LOAD(buf->head)) return -1; // no data :(
+    unsigned char data = buf->data[tail & buf->mask];
+    if (IOBUF_CAS(buf->tail, tail, tail+1))
+      return data;
+    // else the device was cleared while we were looking - try again
+  }
+}
+
+/**
+ * Get a block of data waiting to be sent to a device, so it can all be sent
+ * at once (one write() on Linux, or one DMA transfer). Once it's been sent,
+ * call jshTransmitDataSent with how many bytes actually went. If an XON/XOFF
+ * has to be sent, that's returned on its own first.
+ * \return How many bytes are at *data (or 0 if there are none)
+ */
+unsigned int jshGetDataToTransmit(
+    IOEventFlags device,  // The device being looked at for a transmission.
+    unsigned char **data  // Set to point at the data
+  ) {
+  static const unsigned char flowControlChars[2] = { 17/*XON*/, 19/*XOFF*/ };
+  if (DEVICE_IS_USART(device)) {
+    JshSerialDeviceState *deviceState = &jshSerialDeviceStates[TO_SERIAL_DEVICE_STATE(device)];
+    if (!((*deviceState)&SDS_SENDING_FLOW_CONTROL) && jshGetFlowControlCharToTransmit(device)>=0)
+      (*deviceState) |= SDS_SENDING_FLOW_CONTROL;
+    if ((*deviceState)&SDS_SENDING_FLOW_CONTROL) {
+      // it goes on its own, and keeps being returned until jshTransmitDataSent says it has gone
+      *data = (unsigned char*)&flowControlChars[((*deviceState)&SDS_XOFF_SENT) ? 1 : 0];
+      return 1;
+    }
+  }
+  if (!DEVICE_HAS_TXBUFFER(device)) return 0;
+  TxBuffer *buf = TXBUFFER(device);
+  uint32_t tail = IOBUF_LOAD(buf->tail);
+  uint32_t used = IOBUF_LOAD(buf->head) - tail;
+  uint32_t offset = tail & buf->mask;
+  // only up to the end of the buffer - the rest can go next time
+  if (used > (uint32_t)buf->mask+1-offset) used = (uint32_t)buf->mask+1-offset;
+  *data = &buf->data[offset];
+  return used;
+}
+
+/// Say that count bytes of what jshGetDataToTransmit returned have been sent
+void jshTransmitDataSent(IOEventFlags device, unsigned int count) {
+  if (!count) return;
+  if (DEVICE_IS_USART(device)) {
+    JshSerialDeviceState *deviceState = &jshSerialDeviceStates[TO_SERIAL_DEVICE_STATE(device)];
+    if ((*deviceState)&SDS_SENDING_FLOW_CONTROL) {
+      (*deviceState) &= ~SDS_SENDING_FLOW_CONTROL;
+      return;
     }
-    tempTail = (unsigned char)((tempTail+1)&TXBUFFERMASK);
   }
-  return -1; // no data :(
+  if (!DEVICE_HAS_TXBUFFER(device)) return;
+  TxBuffer *buf = TXBUFFER(device);
+  uint32_t tail = IOBUF_LOAD(buf->tail);
+  IOBUF_CAS(buf->tail, tail, tail+count); // fails if the device was cleared in the mean time - which is fine
 }
 
 void jshTransmitFlush() {
@@ -230,32 +384,42 @@ void jshTransmitFlush() {
 void jshTransmitClearDevice(
     IOEventFlags device //!< The device to be cleared.
   ) {
-  // Keep requesting a character to transmit until there are no further characters.
-  while (jshGetCharToTransmit(device)>=0);
+  if (!DEVICE_HAS_TXBUFFER(device)) return;
+  TxBuffer *buf = TXBUFFER(device);
+  uint32_t tail = IOBUF_LOAD(buf->tail);
+  while (!IOBUF_CAS(buf->tail, tail, IOBUF_LOAD(buf->head)));
 }
 
 /// Move all output from one device to another
 void jshTransmitMove(IOEventFlags from, IOEventFlags to) {
-  if (to==EV_LOOPBACKA || to==EV_LOOPBACKB) {
-    // Loopback is special :(
-    IOEventFlags device = (to==EV_LOOPBACKB) ? EV_LOOPBACKA : EV_LOOPBACKB;
-    int c = jshGetCharToTransmit(from);
-    while (c>=0) {
-      jshPushIOCharEvent(device, (char)c);
-      c = jshGetCharToTransmit(from);
-    }
-  } else {
-    // Otherwise just rename the contents of the buffer
+  if (!DEVICE_HAS_TXBUFFER(from)) return;
+  if (DEVICE_HAS_TXBUFFER(to)) {
     jshInterruptOff();
-    unsigned char tempTail = txTail;
-    while (tempTail != txHead) {
-      if (IOEVENTFLAGS_GETTYPE(txBuffer[tempTail].flags) == from) {
-        txBuffer[tempTail].flags = (txBuffer[tempTail].flags&~EV_TYPE_MASK) | to;
+    TxBuffer *fromBuf = TXBUFFER(from);
+    TxBuffer *toBuf = TXBUFFER(to);
+    if (!TXBUFFER_USED(toBuf) && fromBuf->mask==toBuf->mask) {
+      // Nothing waiting to go to 'to', so just swap the buffers over
+      unsigned char t = txBufferForDevice[from-EV_LIMBO];
+      txBufferForDevice[from-EV_LIMBO] = txBufferForDevice[to-EV_LIMBO];
+      txBufferForDevice[to-EV_LIMBO] = t;
+    } else {
+      // Otherwise copy what we can over
+      while (TXBUFFER_USED(fromBuf) && TXBUFFER_USED(toBuf) <= toBuf->mask) {
+        toBuf->data[toBuf->head & toBuf->mask] = fromBuf->data[fromBuf->tail & fromBuf->mask];
+        IOBUF_STORE(toBuf->head, toBuf->head+1);
+        IOBUF_STORE(fromBuf->tail, fromBuf->tail+1);
       }
-      tempTail = (unsigned char)((tempTail+1)&TXBUFFERMASK);
     }
     jshInterruptOn();
   }
+  /* Anything left (or everything, for Loopback or the console on Linux) goes
+   * with jshTransmitBuffer, which waits for 'to' to have space */
+  unsigned char *data;
+  unsigned int len;
+  while ((len = jshGetDataToTransmit(from, &data))) {
+    jshTransmitBuffer(to, data, len);
+    jshTransmitDataSent(from, len);
+  }
 }
 
 /**
@@ -263,7 +427,7 @@ void jshTransmitMove(IOEventFlags from, IOEventFlags to) {
  * \return True if we have data to transmit and false otherwise.
  */
 bool jshHasTransmitData() {
-  return txHead != txTail;
+  return jshGetDeviceToTransmit() != EV_NONE;
 }
 
 /**
@@ -275,6 +439,101 @@ void CALLED_FROM_INTERRUPT jshIOEventOverflowed() {
 }
 
 
+/// Copy data into the record starting at block 'record', 'offset' bytes into its data
+static void CALLED_FROM_INTERRUPT ioBufWrite(uint32_t record, unsigned int offset, const char *data, unsigned int len) {
+  unsigned int pos = 4+offset;
+  while (len--) {
+    IOBUF_BLOCK(record + (pos>>3))->chars[pos&7] = *(data++);
+    pos++;
+  }
+}
+
+/// Add a new record to the buffer. Returns false if there's no space
+static bool CALLED_FROM_INTERRUPT ioBufPush(IOEventFlags flags, const char *data, unsigned int len) {
+  uint32_t blocks = IOBUF_BLOCKS(len);
+  uint32_t head = IOBUF_LOAD(ioHead);
+  do {
+    if (head + blocks - IOBUF_LOAD(ioTail) > IOBUFFERMASK+1)
+      return false; // queue full
+  } while (!IOBUF_CAS(ioHead, head, head+blocks));
+  // the blocks are ours now - fill them in, and then say they're ready
+  ioBufWrite(head, 0, data, len);
+  IOBUF_STORE(IOBUF_BLOCK(head)->header, IOBUF_HEADER(flags, len));
+  IOBUF_STORE(ioLast, head);
+  return true;
+}
+
+/** Try and add characters to the last record, if it's for the same device
+ * and we haven't started reading it. Returns how many were added */
+static unsigned int CALLED_FROM_INTERRUPT ioBufAppend(IOEventFlags channel, const char *data, unsigned int len) {
+  uint32_t last = IOBUF_LOAD(ioLast);
+  volatile uint32_t *headerPtr = &IOBUF_BLOCK(last)->header;
+  uint32_t header = IOBUF_LOAD(*headerPtr);
+  if ((header & (IOBUF_COMMITTED|IOBUF_SEALED|IOBUF_BUSY)) != IOBUF_COMMITTED ||
+      IOBUF_HEADER_FLAGS(header) != channel)
+    return 0;
+  unsigned int oldLen = IOBUF_HEADER_LENGTH(header);
+  if (len > IOEVENT_MAXCHARS-oldLen) len = IOEVENT_MAXCHARS-oldLen;
+  uint32_t end = last + IOBUF_BLOCKS(oldLen);
+  uint32_t newEnd = last + IOBUF_BLOCKS(oldLen+len);
+  // It must still be the last record, and not read yet
+  if (!len || IOBUF_LOAD(ioHead)!=end || (int32_t)(last - IOBUF_LOAD(ioTail))<0)
+    return 0;
+  // Stop it being read while we add to it
+  if (!IOBUF_CAS(*headerPtr, header, header|IOBUF_BUSY))
+    return 0;
+  if (newEnd != end) { // we need more blocks
+    uint32_t head = end;
+    if (newEnd - IOBUF_LOAD(ioTail) > IOBUFFERMASK+1 ||
+        !IOBUF_CAS(ioHead, head, newEnd)) {
+      IOBUF_STORE(*headerPtr, header); // no space, or another record was added after this one
+      return 0;
+    }
+  }
+  ioBufWrite(last, oldLen, data, len);
+  IOBUF_STORE(*headerPtr, IOBUF_HEADER(channel, oldLen+len));
+  return len;
+}
+
+/** Seal the record at 'record' so nothing more gets added to it, and copy
+ * it into result. Returns the header */
+static uint32_t ioBufRead(uint32_t record, IOEvent *result) {
+  volatile uint32_t *headerPtr = &IOBUF_BLOCK(record)->header;
+  uint32_t header;
+  do {
+    do { // wait for anything adding to it to finish
+      header = IOBUF_LOAD(*headerPtr);
+    } while (header & IOBUF_BUSY);
+  } while (!IOBUF_CAS(*headerPtr, header, header|IOBUF_SEALED));
+  unsigned int i, len = IOBUF_HEADER_LENGTH(header);
+  result->flags = IOBUF_HEADER_FLAGS(header);
+  result->charCount = (unsigned char)len;
+  for (i=0;i<len;i++)
+    result->data.chars[i] = IOBUF_BLOCK(record + ((i+4)>>3))->chars[(i+4)&7];
+  return header|IOBUF_SEALED;
+}
+
+/// Free the record at ioTail (which has the given header) so the blocks can be reused
+static void ioBufFreeTop(uint32_t header) {
+  uint32_t tail = ioTail;
+  uint32_t i, blocks = IOBUF_BLOCKS(IOBUF_HEADER_LENGTH(header));
+  for (i=0;i<blocks;i++)
+    IOBUF_BLOCK(tail+i)->header = 0;
+  IOBUF_STORE(ioTail, tail+blocks);
+}
+
+/** Get the header of the first record that's ready to read (freeing any
+ * that jshPopIOEventOfType removed), or 0 if there isn't one */
+static uint32_t ioBufGetTop() {
+  while (ioTail != IOBUF_LOAD(ioHead)) {
+    uint32_t header = IOBUF_LOAD(IOBUF_BLOCK(ioTail)->header);
+    if (!(header & IOBUF_COMMITTED)) return 0; // space reserved, but not written yet
+    if (IOBUF_HEADER_FLAGS(header)!=EV_NONE) return header;
+    ioBufFreeTop(header);
+  }
+  return 0;
+}
+
 /**
  * Send a character to the specified device.
  */
@@ -282,50 +541,46 @@ void jshPushIOCharEvent(
     IOEventFlags channel, // !< The device to target for output.
     char charData         // !< The character to send to the device.
   ) {
+  jshPushIOCharEvents(channel, &charData, 1);
+}
+
+/**
+ * Send characters to the specified device, as few events as possible
+ */
+void jshPushIOCharEvents(
+    IOEventFlags channel, // !< The device to target for output.
+    char *data,           // !< The characters to send to the device.
+    unsigned int count    // !< How many characters there are
+  ) {
   // Check for a CTRL+C
-  if (charData==3 && channel==jsiGetConsoleDevice()) {
-    jsiCtrlC(); // Ctrl-C - force interrupt of execution
-    return;
-  }
-  // Check for existing buffer (we must have at least 2 in the queue to avoid dropping chars though!)
-#ifndef LINUX // no need for this on linux, and also potentially dodgy when multi-threading
-  unsigned char lastHead = (unsigned char)((ioHead+IOBUFFERMASK) & IOBUFFERMASK); // one behind head
-  if (ioHead!=ioTail && lastHead!=ioTail) {
-    // we can do this because we only read in main loop, and we're in an interrupt here
-    if (IOEVENTFLAGS_GETTYPE(ioBuffer[lastHead].flags) == channel) {
-      unsigned char c = (unsigned char)IOEVENTFLAGS_GETCHARS(ioBuffer[lastHead].flags);
-      if (c < IOEVENT_MAXCHARS) {
-        // last event was for this event type, and it has chars left
-        ioBuffer[lastHead].data.chars[c] = charData;
-        IOEVENTFLAGS_SETCHARS(ioBuffer[lastHead].flags, c+1);
-        return; // char added, job done
+  if (channel==jsiGetConsoleDevice()) {
+    unsigned int i;
+    for (i=0;i<count;i++) {
+      if (data[i]==3) {
+        jshPushIOCharEvents(channel, data, i);
+        jsiCtrlC(); // Ctrl-C - force interrupt of execution
+        jshPushIOCharEvents(channel, &data[i+1], count-(i+1));
+        return;
       }
     }
   }
-#endif
-  // Set flow control (as we're going to use more data)
-  if (DEVICE_IS_USART(channel) && jshGetEventsUsed() > IOBUFFER_XOFF)
-    jshSetFlowControlXON(channel, false);
-
-  /* Make new buffer
-   *
-   * We're disabling IRQs for this bit because it's actually quite likely for
-   * USB and USART data to be coming in at the same time, and it can trip
-   * things up if one IRQ interrupts another. */
-  jshInterruptOff();
-  unsigned char nextHead = (unsigned char)((ioHead+1) & IOBUFFERMASK);
-  if (ioTail == nextHead) {
-    jshInterruptOn();
-    jshIOEventOverflowed();
-    return; // queue full - dump this event!
+  while (count) {
+    // Add to the last event if we can...
+    unsigned int n = ioBufAppend(channel, data, count);
+    if (!n) {
+      // Set flow control (as we're going to use more data)
+      if (DEVICE_IS_USART(channel) && jshGetEventsUsed() > IOBUFFER_XOFF)
+        jshSetFlowControlXON(channel, false);
+      // ...or make a new one
+      n = (count < IOEVENT_MAXCHARS) ? count : IOEVENT_MAXCHARS;
+      if (!ioBufPush(channel, data, n)) {
+        jshIOEventOverflowed();
+        return; // queue full - dump the data!
+      }
+    }
+    data += n;
+    count -= n;
   }
-  unsigned char oldHead = ioHead;
-  ioHead = nextHead;
-  ioBuffer[oldHead].flags = channel;
-  // once channel is set we're safe - another IRQ won't touch this
-  jshInterruptOn();
-  IOEVENTFLAGS_SETCHARS(ioBuffer[oldHead].flags, 1);
-  ioBuffer[oldHead].data.chars[0] = charData;
 }
 
 /**
@@ -364,51 +619,37 @@ void CALLED_FROM_INTERRUPT jshPushIOEvent(
     IOEventFlags channel, //!< The event to add to the queue.
     JsSysTime time        //!< The time that the event is thought to have happened.
   ) {
-  unsigned char nextHead = (unsigned char)((ioHead+1) & IOBUFFERMASK);
-  if (ioTail == nextHead) {
-    jshIOEventOverflowed();
-    return; // queue full - dump this event!
-  }
-  ioBuffer[ioHead].flags = channel;
-  ioBuffer[ioHead].data.time = (unsigned int)time;
-  ioHead = nextHead;
+  unsigned int eventTime = (unsigned int)time;
+  if (!ioBufPush(channel, (char*)&eventTime, sizeof(eventTime)))
+    jshIOEventOverflowed(); // queue full - dump this event!
 }
 
 // returns true on success
 bool jshPopIOEvent(IOEvent *result) {
-  if (ioHead==ioTail) return false;
-  *result = ioBuffer[ioTail];
-  ioTail = (unsigned char)((ioTail+1) & IOBUFFERMASK);
+  uint32_t header = ioBufGetTop();
+  if (!header) return false;
+  ioBufFreeTop(ioBufRead(ioTail, result));
   return true;
 }
 
 // returns true on success
 bool jshPopIOEventOfType(IOEventFlags eventType, IOEvent *result) {
-  // Special case for top - it's easier!
-  if (IOEVENTFLAGS_GETTYPE(ioBuffer[ioTail].flags) == eventType)
-    return jshPopIOEvent(result);
-  // Now check non-top
-  unsigned char i = ioTail;
-  while (ioHead!=i) {
-    if (IOEVENTFLAGS_GETTYPE(ioBuffer[i].flags) == eventType) {
-      /* We need IRQ off for this, because if we get data it's possible
-      that the IRQ will push data and will try and add characters to this
-      exact position in the buffer */
-      jshInterruptOff();
-      *result = ioBuffer[i];
-      // work back and shift all items in out queue
-      unsigned char n = (unsigned char)((i+IOBUFFERMASK) & IOBUFFERMASK);
-      while (n!=ioTail) {
-        ioBuffer[i] = ioBuffer[n];
-        i = n;
-        n = (unsigned char)((n+IOBUFFERMASK) & IOBUFFERMASK);
-      }
-      // finally update the tail pointer, and return
-      ioTail = (unsigned char)((ioTail+1) & IOBUFFERMASK);
-      jshInterruptOn();
+  uint32_t record = ioTail;
+  uint32_t head = IOBUF_LOAD(ioHead);
+  while (record != head) {
+    uint32_t header = IOBUF_LOAD(IOBUF_BLOCK(record)->header);
+    if (!(header & IOBUF_COMMITTED)) return false; // not written yet, so we can't see past it
+    if (IOBUF_HEADER_FLAGS(header)!=EV_NONE &&
+        IOEVENTFLAGS_GETTYPE(IOBUF_HEADER_FLAGS(header)) == eventType) {
+      if (record == ioTail)
+        return jshPopIOEvent(result);
+      /* We can't move the records after it as they might be added to, so just
+       * set the device to EV_NONE and ioBufGetTop will free it later */
+      header = ioBufRead(record, result);
+      IOBUF_STORE(IOBUF_BLOCK(record)->header, header & ~(uint32_t)0xFF);
       return true;
     }
-    i = (unsigned char)((i+1) & IOBUFFERMASK);
+    record += IOBUF_BLOCKS(IOBUF_HEADER_LENGTH(header));
   }
   return false;
 }
@@ -418,24 +659,23 @@ bool jshPopIOEventOfType(IOEventFlags eventType, IOEvent *result) {
  * \return True if there are I/O events to be processed.
  */
 bool jshHasEvents() {
-  return ioHead!=ioTail;
+  return IOBUF_LOAD(ioHead)!=ioTail;
 }
 
 /// Check if the top event is for the given device
 bool jshIsTopEvent(IOEventFlags eventType) {
-  if (ioHead==ioTail) return false;
-  return IOEVENTFLAGS_GETTYPE(ioBuffer[ioTail].flags) == eventType;
+  uint32_t header = ioBufGetTop();
+  return header && IOEVENTFLAGS_GETTYPE(IOBUF_HEADER_FLAGS(header)) == eventType;
 }
 
 int jshGetEventsUsed() {
-  int spaceUsed = (ioHead >= ioTail) ? ((int)ioHead-(int)ioTail) : /*or rolled*/((int)ioHead+IOBUFFERMASK+1-(int)ioTail);
-  return spaceUsed;
+  return (int)(IOBUF_LOAD(ioHead) - IOBUF_LOAD(ioTail));
 }
 
 bool jshHasEventSpaceForChars(int n) {
-  int spacesNeeded = 4 + (n/IOEVENT_MAXCHARS); // be sensible - leave a little spare
-  int spaceUsed = jshGetEventsUsed();
-  int spaceLeft = IOBUFFERMASK+1-spaceUsed;
+  int records = 1 + (n/IOEVENT_MAXCHARS);
+  int spacesNeeded = 4 + (int)IOBUF_BLOCKS(n + (records-1)*4) + records; // be sensible - leave a little spare
+  int spaceLeft = IOBUFFERMASK+1-jshGetEventsUsed();
   return spaceLeft > spacesNeeded;
 }
 
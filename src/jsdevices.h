@@ -89,10 +89,6 @@ typedef enum {
   EV_DEVICE_MAX = EV_SERIAL_STATUS_MAX,
   // EV_DEVICE_MAX should not be >64 - see DEVICE_INITIALISED_FLAGS
   EV_TYPE_MASK = NEXT_POWER_2(EV_DEVICE_MAX) - 1,
-  // ----------------------------------------- CHARACTERS RECEIVED
-  EV_CHARS_ONE = EV_TYPE_MASK+1,
-  EV_CHARS_SHIFT = GET_BIT_NUMBER(EV_CHARS_ONE),
-  EV_CHARS_MASK = 3 * EV_CHARS_ONE, // see IOEVENT_MAXCHARS
   // ----------------------------------------- SERIAL STATUS
   EV_SERIAL_STATUS_FRAMING_ERR = EV_TYPE_MASK+1,
   EV_SERIAL_STATUS_PARITY_ERR = EV_SERIAL_STATUS_FRAMING_ERR<<1,
@@ -116,31 +112,32 @@ typedef enum {
 #define IOEVENTFLAGS_SERIAL_STATUS_TO_SERIAL(X) ((X) + EV_SERIAL1 - EV_SERIAL1_STATUS)
 
 #define IOEVENTFLAGS_GETTYPE(X) ((X)&EV_TYPE_MASK)
-#define IOEVENTFLAGS_GETCHARS(X) ((((X)&EV_CHARS_MASK)>>EV_CHARS_SHIFT)+1)
-#define IOEVENTFLAGS_SETCHARS(X,CHARS) ((X)=(((X)&(IOEventFlags)~EV_CHARS_MASK) | (((CHARS)-1)<<EV_CHARS_SHIFT)))
-#define IOEVENT_MAXCHARS 4 // See EV_CHARS_MASK
+#ifndef IOEVENT_MAXCHARS
+#ifdef LINUX
+#define IOEVENT_MAXCHARS 252 // Most characters in one event (so with its header it's 32 blocks of the IO buffer)
+#else
+#define IOEVENT_MAXCHARS 20 // Most characters in one event (so with its header it's 3 blocks of the IO buffer)
+#endif
+#endif
 
 typedef union {
   unsigned int time; ///< BOTTOM 32 BITS of time the event occurred
   char chars[IOEVENT_MAXCHARS]; ///< Characters received
 } PACKED_FLAGS IOEventData;
 
-// IO Events - these happen when a pin changes
+// IO Events - these happen when a pin changes, or characters are received
 typedef struct IOEvent {
-  IOEventFlags flags; //!< Where this came from, and # of chars in it
+  IOEventFlags flags; //!< Where this came from
+  unsigned char charCount; //!< How many characters are in data.chars
   IOEventData data;
 } PACKED_FLAGS IOEvent;
 
 void jshPushIOEvent(IOEventFlags channel, JsSysTime time);
 void jshPushIOWatchEvent(IOEventFlags channel); // push an even when a pin changes state
-/// Push a single character event (for example USART RX)
+/// Push a single character event (for example USART RX). This is added to the last event if it was for the same device
 void jshPushIOCharEvent(IOEventFlags channel, char charData);
-/// Push many character events at once (for example USB RX)
-static inline void jshPushIOCharEvents(IOEventFlags channel, char *data, unsigned int count) {
-  // TODO: optimise me!
-  unsigned int i;
-  for (i=0;i<count;i++) jshPushIOCharEvent(channel, data[i]);
-}
+/// Push many characters at once (for example USB RX) - using as few events as possible
+void jshPushIOCharEvents(IOEventFlags channel, char *data, unsigned int count);
 bool jshPopIOEvent(IOEvent *result); ///< returns true on success
 bool jshPopIOEventOfType(IOEventFlags eventType, IOEvent *result); ///< returns true on success
 /// Do we have any events pending? Will jshPopIOEvent return true?
@@ -148,7 +145,7 @@ bool jshHasEvents();
 /// Check if the top event is for the given device
 bool jshIsTopEvent(IOEventFlags eventType);
 
-/// How many event blocks are left? compare this to IOBUFFERMASK
+/// How many blocks of the IO buffer are used? compare this to IOBUFFERMASK
 int jshGetEventsUsed();
 
 /// Do we have enough space for N characters?
@@ -164,6 +161,8 @@ JsVar *jshGetDeviceObject(IOEventFlags device);
 //                                                         DATA TRANSMIT BUFFER
 /// Queue a character for transmission
 void jshTransmit(IOEventFlags device, unsigned char data);
+/// Queue data for transmission (waits if there isn't space)
+void jshTransmitBuffer(IOEventFlags device, const unsigned char *data, size_t len);
 /// Wait for transmit to finish
 void jshTransmitFlush();
 /// Clear everything from a device
@@ -172,10 +171,15 @@ void jshTransmitClearDevice(IOEventFlags device);
 void jshTransmitMove(IOEventFlags from, IOEventFlags to);
 /// Do we have anything we need to send?
 bool jshHasTransmitData();
-// Return the device at the top of the transmit queue (or EV_NONE)
+// Return a device that has data waiting to be transmitted (or EV_NONE)
 IOEventFlags jshGetDeviceToTransmit();
 /// Try and get a character for transmission - could just return -1 if nothing
 int jshGetCharToTransmit(IOEventFlags device);
+/** Get a contiguous block of data to transmit (eg. for one write() or DMA transfer).
+ * Returns the number of bytes at *data, and jshTransmitDataSent must be called once they've gone */
+unsigned int jshGetDataToTransmit(IOEventFlags device, unsigned char **data);
+/// Say how many of the bytes from jshGetDataToTransmit were actually sent
+void jshTransmitDataSent(IOEventFlags device, unsigned int count);
 
 
 /// Set whether the host should transmit or not
@@ -28,6 +28,9 @@
 
 #ifdef LINUX
 #include <inttypes.h>
+#ifdef __linux__
+#define LINUX_EPOLL ///< jshSleep waits on an epoll set, so it wakes the moment there's something to do
+#endif
 #endif
 
 
@@ -52,6 +55,12 @@ void jshIdle();
  */
 bool jshSleep(JsSysTime timeUntilWake);
 
+#ifdef LINUX_EPOLL
+/** Make jshSleep return as soon as this file descriptor (eg. a socket) can be
+ * read from or written to. It's forgotten about automatically when it is closed. */
+void jshSleepWakeOnFd(int fd);
+#endif
+
 /** Clean up ready to stop Espruino. Unused on embedded targets, but used on Linux,
  * where GPIO that have been exported may need unexporting, and so on. */
 void jshKill();
@@ -54,6 +54,49 @@ typedef enum {
 JsVar *events = 0; // Array of events to execute
 JsVarRef timerArray = 0; // Linked List of timers to check and run
 JsVarRef watchArray = 0; // Linked List of input watches to check and run
+#ifdef JSI_TIMER_HEAP_INITIAL
+/* Timers are kept in a min-heap of when they're due, so that jsiIdle only
+ * has to look at the timers that have expired. Each entry has the refs of the
+ * timer and of its name in timerArray. The refs don't count as references,
+ * so everything that removes a timer must remove it from here too (or call
+ * jsiTimersChanged, which makes us rebuild the heap from timerArray).
+ * Getting the next timer is O(1) and adding one is O(log n), but removing or
+ * changing a particular timer has to search the heap for it first, so is O(n)
+ * (although without looking at any vars, unlike searching timerArray). */
+typedef struct {
+  JsSysTime time;  ///< When the timer is due (the same as its "time")
+  JsVarRef name;   ///< The timer's name in timerArray
+  JsVarRef timer;  ///< The timer itself
+} PACKED_FLAGS JsiTimerHeapEntry;
+
+static JsVar *timerHeap = 0; ///< Flat string of JsiTimerHeapEntry - kept locked (like events) so it isn't moved or freed
+static unsigned int timerHeapCount = 0; ///< How many entries are used in timerHeap
+static bool timerHeapValid = false; ///< If false, timerHeap needs rebuilding from timerArray
+#endif
+static JsVarRef timerExecuting = 0; ///< The name of the timer jsiIdle is running (which isn't in the heap)
+/* When a pin changes, jsiIdle looks up the watches for its EXTI channel here
+ * rather than checking every watch in watchArray. Entries are sorted by channel,
+ * and the watches in them are kept locked so they can't be moved or freed.
+ * This is rebuilt by jsiWatchesChanged whenever watchArray changes. */
+typedef struct {
+  JsVarRef watch;     ///< The watch object
+  Pin pin;
+  unsigned char channel; ///< The EXTI channel, from EV_EXTI0
+  signed char edge;   ///< 0 = both, 1 = rising, -1 = falling
+  bool recur;         ///< Keep the watch after it has been called?
+  bool pending;       ///< Debouncing, and we'll call the callback at 'due' (if the pin hasn't changed again)
+  bool state;         ///< The pin state we'll report when we're done debouncing
+  JsSysTime debounce; ///< How long to debounce for (or 0)
+  JsSysTime due;      ///< When we're done debouncing (if pending)
+} PACKED_FLAGS JsiWatchEntry;
+
+#define JSI_WATCH_CHANNELS (EV_EXTI_MAX+1-EV_EXTI0)
+static JsVar *watchTable = 0; ///< Flat string of JsiWatchEntry - kept locked (like events) so it isn't moved or freed
+static uint16_t watchTableStart[JSI_WATCH_CHANNELS+1]; ///< Index in watchTable of the first watch for each channel (and the count at the end)
+static unsigned int watchTableDebounced = 0; ///< How many watches in watchTable have a debounce time
+static bool watchTableMissing = false; ///< There are watches, but not enough memory for watchTable - so scan watchArray (and try again when idle)
+static JsVar *jsiTimerGetNext(JsSysTime *timerTime, bool remove);
+static void jsiTimerReschedule(JsVar *timerName, JsVar *timerPtr, JsSysTime time);
 // ----------------------------------------------------------------------------
 IOEventFlags consoleDevice = DEFAULT_CONSOLE_DEVICE; ///< The console device for user interaction
 Pin pinBusyIndicator = DEFAULT_BUSY_PIN_INDICATOR;
@@ -195,8 +238,13 @@ NO_INLINE void jsiConsolePrintChar(char data) {
  */
 NO_INLINE void jsiConsolePrintString(const char *str) {
   while (*str) {
-    if (*str == '\n') jsiConsolePrintChar('\r');
-    jsiConsolePrintChar(*(str++));
+    // send everything up to the next newline in one go
+    const char *end = str;
+    while (*end && *end!='\n') end++;
+    jshTransmitBuffer(consoleDevice, (const unsigned char*)str, (size_t)(end-str));
+    if (!*end) break;
+    jshTransmitBuffer(consoleDevice, (const unsigned char*)"\r\n", 2);
+    str = end+1;
   }
 }
 
@@ -256,16 +304,23 @@ void jsiConsolePrintStringVarUntilEOL(JsVar *v, size_t fromCharacter, size_t max
 /** Print the contents of a string var - directly - starting from the given character, and
  * using newLineCh to prefix new lines (if it is not 0). */
 void jsiConsolePrintStringVarWithNewLineChar(JsVar *v, size_t fromCharacter, char newLineCh) {
+  unsigned char buf[32]; // so we can send it in chunks with jshTransmitBuffer
+  size_t len = 0;
   JsvStringIterator it;
   jsvStringIteratorNew(&it, v, fromCharacter);
   while (jsvStringIteratorHasChar(&it)) {
+    if (len > sizeof(buf)-3) {
+      jshTransmitBuffer(consoleDevice, buf, len);
+      len = 0;
+    }
     char ch = jsvStringIteratorGetChar(&it);
-    if (ch == '\n') jsiConsolePrintChar('\r');
-    jsiConsolePrintChar(ch);
-    if (ch == '\n' && newLineCh) jsiConsolePrintChar(newLineCh);
+    if (ch == '\n') buf[len++] = '\r';
+    buf[len++] = (unsigned char)ch;
+    if (ch == '\n' && newLineCh) buf[len++] = (unsigned char)newLineCh;
     jsvStringIteratorNext(&it);
   }
   jsvStringIteratorFree(&it);
+  jshTransmitBuffer(consoleDevice, buf, len);
 }
 
 /**
@@ -470,6 +525,9 @@ void jsiSoftInit(bool hasBeenReset) {
   // when adding an interval from onInit (called below)
   jsiLastIdleTime = jshGetSystemTime();
   jsiTimeSinceCtrlC = 0xFFFFFFFF;
+  // Timers are saved with the time until they're due, so make that the time they're due
+  jsiTimersShift(jsiLastIdleTime);
+  jsiTimersChanged(); // build the heap of timers when we first need it
 
   // Run wrapper initialisation stuff
   jswInit();
@@ -499,9 +557,8 @@ void jsiSoftInit(bool hasBeenReset) {
     jsvObjectIteratorFree(&it);
     jsvUnLock(watchArrayPtr);
   }
+  jsiWatchesChanged(); // now the pins are watched, work out which watches are for which channels
 
-  // Timers are stored by time in the future now, so no need
-  // to fiddle with them.
 
   // And look for onInit function
   JsVar *onInit = jsvObjectGetChild(execInfo.root, JSI_ONINIT_NAME, 0);
@@ -714,9 +771,17 @@ void jsiSoftKill() {
     events=0;
   }
   if (timerArray) {
+    // Store the time until each timer is due, as the system time may be different when we start again
+    jsiTimersShift(-jsiLastIdleTime);
     jsvUnRefRef(timerArray);
     timerArray=0;
   }
+#ifdef JSI_TIMER_HEAP_INITIAL
+  jsvUnLock(timerHeap);
+  timerHeap = 0;
+  timerHeapCount = 0;
+  timerHeapValid = false;
+#endif
   if (watchArray) {
     // Check any existing watches and disable interrupts for them
     JsVar *watchArrayPtr = jsvLock(watchArray);
@@ -734,6 +799,7 @@ void jsiSoftKill() {
     jsvUnLock(watchArrayPtr);
     watchArray=0;
   }
+  jsiWatchesChanged(); // no watches now, so this frees watchTable
   // Save initialisation information
   JsVar *initCode = jsvNewFromEmptyString();
   if (initCode) { // out of memory
@@ -753,6 +819,7 @@ void jsiSemiInit(bool autoLoad) {
 
   // Set state
   interruptedDuringEvent = false;
+  loopsIdling = 0;
   // Set defaults
   jsiStatus &= ~JSIS_SOFTINIT_MASK;
   pinBusyIndicator = DEFAULT_BUSY_PIN_INDICATOR;
@@ -1657,9 +1724,8 @@ bool jsiHasTimers() {
   return hasTimers;
 }
 
-/// Is the given watch object meant to be executed when the current value of the pin is pinIsHigh
-bool jsiShouldExecuteWatch(JsVar *watchPtr, bool pinIsHigh) {
-  int watchEdge = (int)jsvGetIntegerAndUnLock(jsvObjectGetChild(watchPtr, "edge", 0));
+/// Is a watch for the given edge meant to be executed when the current value of the pin is pinIsHigh
+static bool jsiShouldExecuteWatch(int watchEdge, bool pinIsHigh) {
   return watchEdge==0 || // any edge
       (pinIsHigh && watchEdge>0) || // rising edge
       (!pinIsHigh && watchEdge<0); // falling edge
@@ -1683,6 +1749,264 @@ bool jsiIsWatchingPin(Pin pin) {
   return isWatched;
 }
 
+/// Get the EXTI channel (from EV_EXTI0) that events for the given pin arrive on, or -1 if there isn't one
+static int jsiGetWatchChannel(Pin pin) {
+  IOEvent event;
+  int channel;
+  for (channel=0;channel<JSI_WATCH_CHANNELS;channel++) {
+    event.flags = (IOEventFlags)(EV_EXTI0+channel);
+    if (jshIsEventForPin(&event, pin)) return channel;
+  }
+  return -1;
+}
+
+/// Fill in a JsiWatchEntry from a watch object, and return its EXTI channel (or -1 if it hasn't got one)
+static int jsiWatchEntryFromVar(JsVar *watchPtr, JsiWatchEntry *entry) {
+  Pin pin = jshGetPinFromVarAndUnLock(jsvObjectGetChild(watchPtr, "pin", 0));
+  int channel = jsiGetWatchChannel(pin);
+  if (channel<0) return -1;
+  entry->watch = jsvGetRef(watchPtr);
+  entry->pin = pin;
+  entry->channel = (unsigned char)channel;
+  entry->edge = (signed char)jsvGetIntegerAndUnLock(jsvObjectGetChild(watchPtr, "edge", 0));
+  entry->recur = jsvGetBoolAndUnLock(jsvObjectGetChild(watchPtr, "recur", 0));
+  entry->pending = false;
+  entry->state = false;
+  entry->debounce = (JsSysTime)jsvGetLongIntegerAndUnLock(jsvObjectGetChild(watchPtr, "debounce", 0));
+  entry->due = 0;
+  return channel;
+}
+
+void jsiWatchesChanged() {
+  JsVar *oldTable = watchTable;
+  unsigned int oldCount = watchTableStart[JSI_WATCH_CHANNELS];
+  watchTable = 0;
+  memset(watchTableStart, 0, sizeof(watchTableStart));
+  watchTableDebounced = 0;
+
+  JsVar *watchArrayPtr = watchArray ? jsvLock(watchArray) : 0;
+  int watchCount = watchArrayPtr ? jsvGetChildren(watchArrayPtr) : 0;
+  if (watchCount) {
+    watchTable = jsvNewFlatStringOfLength((unsigned int)watchCount*(unsigned int)sizeof(JsiWatchEntry));
+    if (!watchTable && !watchTableMissing)
+      jsWarn("Not enough memory to index watches - they will be slower, and won't be debounced");
+  }
+  watchTableMissing = watchCount && !watchTable;
+  if (watchTable) {
+    JsiWatchEntry *table = (JsiWatchEntry*)jsvGetFlatStringPointer(watchTable);
+    JsiWatchEntry *oldEntries = oldTable ? (JsiWatchEntry*)jsvGetFlatStringPointer(oldTable) : 0;
+    unsigned int count = 0, i;
+    JsvObjectIterator it;
+    jsvObjectIteratorNew(&it, watchArrayPtr);
+    while (jsvObjectIteratorHasValue(&it)) {
+      JsVar *watchPtr = jsvObjectIteratorGetValue(&it);
+      JsiWatchEntry entry;
+      int channel = jsiWatchEntryFromVar(watchPtr, &entry);
+      if (channel>=0) {
+        jsvLockAgain(watchPtr); // stays locked while it's in the table
+        if (entry.debounce>0) watchTableDebounced++;
+        // If we were already debouncing this watch, carry on
+        for (i=0;i<oldCount;i++) {
+          if (oldEntries[i].watch == entry.watch) {
+            entry.pending = oldEntries[i].pending;
+            entry.state = oldEntries[i].state;
+            entry.due = oldEntries[i].due;
+          }
+        }
+        // Insert sorted by channel, after any we already have for the channel (so they're called in the order they were added)
+        i = count++;
+        while (i && table[i-1].channel > entry.channel) {
+          table[i] = table[i-1];
+          i--;
+        }
+        table[i] = entry;
+        watchTableStart[channel+1]++;
+      }
+      jsvUnLock(watchPtr);
+      jsvObjectIteratorNext(&it);
+    }
+    jsvObjectIteratorFree(&it);
+    int channel;
+    for (channel=0;channel<JSI_WATCH_CHANNELS;channel++)
+      watchTableStart[channel+1] = (uint16_t)(watchTableStart[channel+1] + watchTableStart[channel]);
+    if (!count) {
+      jsvUnLock(watchTable);
+      watchTable = 0;
+    }
+  }
+  jsvUnLock(watchArrayPtr);
+
+  // Now let go of the watches from the old table
+  if (oldTable) {
+    JsiWatchEntry *oldEntries = (JsiWatchEntry*)jsvGetFlatStringPointer(oldTable);
+    unsigned int i;
+    for (i=0;i<oldCount;i++)
+      jsvUnLock(_jsvGetAddressOf(oldEntries[i].watch));
+    jsvUnLock(oldTable);
+  }
+}
+
+/// Find a watch in watchTable (which may have been rebuilt since we last looked), or return 0 if it's not there
+static JsiWatchEntry *jsiWatchFind(JsVarRef watch, unsigned int channel) {
+  if (!watchTable) return 0;
+  JsiWatchEntry *table = (JsiWatchEntry*)jsvGetFlatStringPointer(watchTable);
+  unsigned int i;
+  for (i=watchTableStart[channel];i<watchTableStart[channel+1];i++)
+    if (table[i].watch == watch) return &table[i];
+  return 0;
+}
+
+/** Call a watch's callback (if it's for this edge) and remove the watch if it
+ * doesn't repeat. This may change watchTable, so 'watch' must be a copy. */
+static void jsiExecuteWatch(JsVar *watchPtr, const JsiWatchEntry *watch, bool pinIsHigh, JsSysTime time) {
+  JsVar *timePtr = jsvNewFromFloat(jshGetMillisecondsFromTime(time)/1000);
+  if (jsiShouldExecuteWatch(watch->edge, pinIsHigh)) { // edge triggering
+    JsVar *watchCallback = jsvObjectGetChild(watchPtr, "callback", 0);
+    bool watchRecurring = watch->recur;
+    JsVar *data = jsvNewObject();
+    if (data) {
+      jsvObjectSetChildAndUnLock(data, "lastTime", jsvObjectGetChild(watchPtr, "lastTime", 0));
+      // set both data.time, and watch.lastTime in one go
+      jsvObjectSetChild(data, "time", timePtr); // no unlock
+      jsvObjectSetChildAndUnLock(data, "pin", jsvNewFromPin(watch->pin));
+      jsvObjectSetChildAndUnLock(data, "state", jsvNewFromBool(pinIsHigh));
+    }
+    if (!jsiExecuteEventCallback(0, watchCallback, 1, &data) && watchRecurring) {
+      jsError("Ctrl-C while processing watch - removing it.");
+      jsErrorFlags |= JSERR_CALLBACK;
+      watchRecurring = false;
+    }
+    jsvUnLock(data);
+    if (!watchRecurring) {
+      JsVar *watchArrayPtr = jsvLock(watchArray);
+      JsVar *watchNamePtr = jsvGetIndexOf(watchArrayPtr, watchPtr, true);
+      if (watchNamePtr) { // the callback may have cleared it already
+        jsvRemoveChild(watchArrayPtr, watchNamePtr);
+        jsvUnLock(watchNamePtr);
+        if (!jsiIsWatchingPin(watch->pin))
+          jshPinWatch(watch->pin, false);
+        jsiWatchesChanged();
+      }
+      jsvUnLock(watchArrayPtr);
+    }
+    jsvUnLock(watchCallback);
+  }
+  jsvObjectSetChildAndUnLock(watchPtr, "lastTime", timePtr);
+}
+
+/** If we couldn't allocate watchTable, check every watch in watchArray for
+ * ones on this channel and call them. There's nowhere to keep the debounce
+ * state, so they are called right away. */
+static void jsiHandleWatchEventUnindexed(unsigned int channel, bool pinIsHigh, JsSysTime eventTime) {
+  JsVar *watchArrayPtr = jsvLock(watchArray);
+  // lock the watches first, as callbacks may change watchArray
+  int watchCount = jsvGetChildren(watchArrayPtr);
+  JsVar **watches = (JsVar**)alloca(sizeof(JsVar*)*(size_t)watchCount);
+  int count = 0, i;
+  JsvObjectIterator it;
+  jsvObjectIteratorNew(&it, watchArrayPtr);
+  while (jsvObjectIteratorHasValue(&it) && count<watchCount) {
+    watches[count++] = jsvObjectIteratorGetValue(&it);
+    jsvObjectIteratorNext(&it);
+  }
+  jsvObjectIteratorFree(&it);
+  for (i=0;i<count;i++) {
+    JsiWatchEntry watch;
+    JsVar *watchName = jsvGetIndexOf(watchArrayPtr, watches[i], true);
+    if (watchName && jsiWatchEntryFromVar(watches[i], &watch)==(int)channel)
+      jsiExecuteWatch(watches[i], &watch, pinIsHigh, eventTime);
+    jsvUnLock2(watchName, watches[i]);
+  }
+  jsvUnLock(watchArrayPtr);
+}
+
+/// Handle an EXTI event by calling (or starting to debounce) each watch for its channel
+static void jsiHandleWatchEvent(IOEvent *event) {
+  unsigned int channel = (unsigned int)(IOEVENTFLAGS_GETTYPE(event->flags) - EV_EXTI0);
+  unsigned int first = watchTableStart[channel];
+  unsigned int count = watchTableStart[channel+1] - first;
+  if (!count && !watchTableMissing) return;
+
+  /** Work out event time. Events time is only stored in 32 bits, so we need to
+   * use the correct 'high' 32 bits from the current time.
+   *
+   * We know that the current time is always newer than the event time, so
+   * if the bottom 32 bits of the current time is less than the bottom
+   * 32 bits of the event time, we need to subtract a full 32 bits worth
+   * from the current time.
+   */
+  JsSysTime time = jshGetSystemTime();
+  if (((unsigned int)time) < (unsigned int)event->data.time)
+    time = time - 0x100000000LL;
+  // finally, mask in the event's time
+  JsSysTime eventTime = (time & ~0xFFFFFFFFLL) | (JsSysTime)event->data.time;
+  bool pinIsHigh = (event->flags&EV_EXTI_IS_HIGH)!=0;
+
+  if (watchTableMissing) {
+    jsiHandleWatchEventUnindexed(channel, pinIsHigh, eventTime);
+    return;
+  }
+
+  /* Callbacks may add or remove watches (which rebuilds watchTable), so lock
+   * all the watches for this channel now, and look each one up again before
+   * we use it. Watches added by a callback won't be called for this event. */
+  JsVar **watches = (JsVar**)alloca(sizeof(JsVar*)*count);
+  JsiWatchEntry *table = (JsiWatchEntry*)jsvGetFlatStringPointer(watchTable);
+  unsigned int i;
+  for (i=0;i<count;i++)
+    watches[i] = jsvLock(table[first+i].watch);
+  for (i=0;i<count;i++) {
+    JsiWatchEntry *entry = jsiWatchFind(jsvGetRef(watches[i]), channel);
+    if (entry) {
+      JsiWatchEntry watch = *entry;
+      bool executeNow = true;
+      bool state = pinIsHigh;
+      JsSysTime watchTime = eventTime;
+      if (entry->debounce>0) {
+        /* Debouncing - we only call the callback when the pin has stayed the
+         * same for the debounce time (see jsiWatchesDebounceIdle). If we're
+         * already past when we should have called it, do it now with the old state */
+        executeNow = entry->pending && eventTime > entry->due;
+        if (executeNow) {
+          state = entry->state;
+          watchTime = entry->due - entry->debounce;
+        }
+        entry->pending = true;
+        entry->state = pinIsHigh;
+        entry->due = eventTime + entry->debounce;
+      }
+      if (executeNow)
+        jsiExecuteWatch(watches[i], &watch, state, watchTime);
+    }
+    jsvUnLock(watches[i]);
+  }
+}
+
+/** Call any watches that have finished debouncing. Returns true if any were
+ * called, and sets minTimeUntilNext if we need to check again before then */
+static bool jsiWatchesDebounceIdle(JsSysTime *minTimeUntilNext) {
+  bool called = false;
+  unsigned int i = 0;
+  while (watchTable && i<watchTableStart[JSI_WATCH_CHANNELS]) {
+    JsiWatchEntry *entry = &((JsiWatchEntry*)jsvGetFlatStringPointer(watchTable))[i++];
+    if (!entry->pending) continue;
+    JsSysTime timeUntilDue = entry->due - jsiLastIdleTime;
+    if (timeUntilDue > 0) {
+      if (timeUntilDue < *minTimeUntilNext)
+        *minTimeUntilNext = timeUntilDue;
+      continue;
+    }
+    entry->pending = false;
+    JsiWatchEntry watch = *entry;
+    JsVar *watchPtr = jsvLock(watch.watch);
+    jsiExecuteWatch(watchPtr, &watch, watch.state, watch.due - watch.debounce);
+    jsvUnLock(watchPtr);
+    called = true;
+    i = 0; // the callback may have changed watchTable, so start again
+  }
+  return called;
+}
+
 void jsiCtrlC() {
   // If password protected, don't let Ctrl-C break out of running code!
   if (jsiPasswordProtected())
@@ -1712,7 +2036,7 @@ int jsiHandleIOEventForUSART(JsVar *usartClass, IOEvent *event) {
     JsvStringIterator it;
     jsvStringIteratorNew(&it, stringData, 0);
 
-    int i, chars = IOEVENTFLAGS_GETCHARS(event->flags);
+    int i, chars = event->charCount;
     while (chars) {
       for (i=0;i<chars;i++) {
         char ch = (char)(event->data.chars[i] & ((1<<bytesize)-1)); // mask
@@ -1722,7 +2046,7 @@ int jsiHandleIOEventForUSART(JsVar *usartClass, IOEvent *event) {
       if (jshIsTopEvent(IOEVENTFLAGS_GETTYPE(event->flags))) {
         jshPopIOEvent(event);
         eventsHandled++;
-        chars = IOEVENTFLAGS_GETCHARS(event->flags);
+        chars = event->charCount;
       } else
         chars = 0;
     }
@@ -1736,7 +2060,7 @@ int jsiHandleIOEventForUSART(JsVar *usartClass, IOEvent *event) {
 }
 
 void jsiHandleIOEventForConsole(IOEvent *event) {
-  int i, c = IOEVENTFLAGS_GETCHARS(event->flags);
+  int i, c = event->charCount;
   jsiSetBusy(BUSY_INTERACTIVE, true);
   for (i=0;i<c;i++) jsiHandleChar(event->data.chars[i]);
   jsiSetBusy(BUSY_INTERACTIVE, false);
@@ -1783,110 +2107,7 @@ void jsiIdle() {
       }
       jsvUnLock(usartClass);
     } else if (DEVICE_IS_EXTI(eventType)) { // ---------------------------------------------------------------- PIN WATCH
-      // we have an event... find out what it was for...
-      // Check everything in our Watch array
-      JsVar *watchArrayPtr = jsvLock(watchArray);
-      JsvObjectIterator it;
-      jsvObjectIteratorNew(&it, watchArrayPtr);
-      while (jsvObjectIteratorHasValue(&it)) {
-        bool hasDeletedWatch = false;
-        JsVar *watchPtr = jsvObjectIteratorGetValue(&it);
-        Pin pin = jshGetPinFromVarAndUnLock(jsvObjectGetChild(watchPtr, "pin", 0));
-
-        if (jshIsEventForPin(&event, pin)) {
-          /** Work out event time. Events time is only stored in 32 bits, so we need to
-           * use the correct 'high' 32 bits from the current time.
-           *
-           * We know that the current time is always newer than the event time, so
-           * if the bottom 32 bits of the current time is less than the bottom
-           * 32 bits of the event time, we need to subtract a full 32 bits worth
-           * from the current time.
-           */
-          JsSysTime time = jshGetSystemTime();
-          if (((unsigned int)time) < (unsigned int)event.data.time)
-            time = time - 0x100000000LL;
-          // finally, mask in the event's time
-          JsSysTime eventTime = (time & ~0xFFFFFFFFLL) | (JsSysTime)event.data.time;
-
-          // Now actually process the event
-          bool pinIsHigh = (event.flags&EV_EXTI_IS_HIGH)!=0;
-
-          bool executeNow = false;
-          JsVarInt debounce = jsvGetIntegerAndUnLock(jsvObjectGetChild(watchPtr, "debounce", 0));
-          if (debounce<=0) {
-            executeNow = true;
-          } else { // Debouncing - use timeouts to ensure we only fire at the right time
-            // store the current state of the pin
-            bool oldWatchState = jsvGetBoolAndUnLock(jsvObjectGetChild(watchPtr, "state",0));
-            jsvObjectSetChildAndUnLock(watchPtr, "state", jsvNewFromBool(pinIsHigh));
-
-            JsVar *timeout = jsvObjectGetChild(watchPtr, "timeout", 0);
-            if (timeout) { // if we had a timeout, update the callback time
-              JsSysTime timeoutTime = jsiLastIdleTime + (JsSysTime)jsvGetLongIntegerAndUnLock(jsvObjectGetChild(timeout, "time", 0));
-              jsvUnLock(jsvObjectSetChild(timeout, "time", jsvNewFromLongInteger((JsSysTime)(eventTime - jsiLastIdleTime) + debounce)));
-              if (eventTime > timeoutTime) {
-                // timeout should have fired, but we didn't get around to executing it!
-                // Do it now (with the old timeout time)
-                executeNow = true;
-                eventTime = timeoutTime - debounce;
-                pinIsHigh = oldWatchState;
-              }
-            } else { // else create a new timeout
-              timeout = jsvNewObject();
-              if (timeout) {
-                jsvObjectSetChild(timeout, "watch", watchPtr); // no unlock
-                jsvObjectSetChildAndUnLock(timeout, "time", jsvNewFromLongInteger((JsSysTime)(eventTime - jsiLastIdleTime) + debounce));
-                jsvObjectSetChildAndUnLock(timeout, "callback", jsvObjectGetChild(watchPtr, "callback", 0));
-                jsvObjectSetChildAndUnLock(timeout, "lastTime", jsvObjectGetChild(watchPtr, "lastTime", 0));
-                jsvObjectSetChildAndUnLock(timeout, "pin", jsvNewFromPin(pin));
-                // Add to timer array
-                jsiTimerAdd(timeout);
-                // Add to our watch
-                jsvObjectSetChild(watchPtr, "timeout", timeout); // no unlock
-              }
-            }
-            jsvUnLock(timeout);
-          }
-
-          // If we want to execute this watch right now...
-          if (executeNow) {
-            JsVar *timePtr = jsvNewFromFloat(jshGetMillisecondsFromTime(eventTime)/1000);
-            if (jsiShouldExecuteWatch(watchPtr, pinIsHigh)) { // edge triggering
-              JsVar *watchCallback = jsvObjectGetChild(watchPtr, "callback", 0);
-              bool watchRecurring = jsvGetBoolAndUnLock(jsvObjectGetChild(watchPtr,  "recur", 0));
-              JsVar *data = jsvNewObject();
-              if (data) {
-                jsvObjectSetChildAndUnLock(data, "lastTime", jsvObjectGetChild(watchPtr, "lastTime", 0));
-                // set both data.time, and watch.lastTime in one go
-                jsvObjectSetChild(data, "time", timePtr); // no unlock
-                jsvObjectSetChildAndUnLock(data, "pin", jsvNewFromPin(pin));
-                jsvObjectSetChildAndUnLock(data, "state", jsvNewFromBool(pinIsHigh));
-              }
-              if (!jsiExecuteEventCallback(0, watchCallback, 1, &data) && watchRecurring) {
-                jsError("Ctrl-C while processing watch - removing it.");
-                jsErrorFlags |= JSERR_CALLBACK;
-                watchRecurring = false;
-              }
-              jsvUnLock(data);
-              if (!watchRecurring) {
-                // free all
-                jsvObjectIteratorRemoveAndGotoNext(&it, watchArrayPtr);
-                hasDeletedWatch = true;
-                if (!jsiIsWatchingPin(pin))
-                  jshPinWatch(pin, false);
-              }
-              jsvUnLock(watchCallback);
-            }
-            jsvObjectSetChildAndUnLock(watchPtr, "lastTime", timePtr);
-          }
-        }
-
-        jsvUnLock(watchPtr);
-        if (!hasDeletedWatch)
-          jsvObjectIteratorNext(&it);
-      }
-      jsvObjectIteratorFree(&it);
-      jsvUnLock(watchArrayPtr);
+      jsiHandleWatchEvent(&event);
     }
   }
 
@@ -1909,111 +2130,61 @@ void jsiIdle() {
   if (oldTimeSinceCtrlC > jsiTimeSinceCtrlC)
     jsiTimeSinceCtrlC = 0xFFFFFFFF;
 
-  jsiStatus = jsiStatus & ~JSIS_TIMERS_CHANGED;
-  JsVar *timerArrayPtr = jsvLock(timerArray);
-  JsvObjectIterator it;
-  jsvObjectIteratorNew(&it, timerArrayPtr);
-  while (jsvObjectIteratorHasValue(&it) && !(jsiStatus & JSIS_TIMERS_CHANGED)) {
-    bool hasDeletedTimer = false;
-    JsVar *timerPtr = jsvObjectIteratorGetValue(&it);
-    JsSysTime timerTime = (JsSysTime)jsvGetLongIntegerAndUnLock(jsvObjectGetChild(timerPtr, "time", 0));
-    JsSysTime timeUntilNext = timerTime - timePassed;
-
-    if (timeUntilNext<=0) {
-      // we're now doing work
-      jsiSetBusy(BUSY_INTERACTIVE, true);
-      wasBusy = true;
-      JsVar *timerCallback = jsvObjectGetChild(timerPtr, "callback", 0);
-      JsVar *watchPtr = jsvObjectGetChild(timerPtr, "watch", 0); // for debounce - may be undefined
-      bool exec = true;
-      JsVar *data = 0;
-      if (watchPtr) {
-        data = jsvNewObject();
-        // if we were from a watch then we were delayed by the debounce time...
-        if (data) {
-          JsVarInt delay = jsvGetIntegerAndUnLock(jsvObjectGetChild(watchPtr, "debounce", 0));
-          // Create the 'time' variable that will be passed to the user
-          JsVar *timePtr = jsvNewFromFloat(jshGetMillisecondsFromTime(jsiLastIdleTime+timeUntilNext-delay)/1000);
-          // if it was a watch, set the last state up
-          bool state = jsvGetBoolAndUnLock(jsvObjectSetChild(data, "state", jsvObjectGetChild(watchPtr, "state", 0)));
-          exec = jsiShouldExecuteWatch(watchPtr, state);
-          // set up the lastTime variable of data to what was in the watch
-          jsvObjectSetChildAndUnLock(data, "lastTime", jsvObjectGetChild(watchPtr, "lastTime", 0));
-          // set up the watches lastTime to this one
-          jsvObjectSetChild(watchPtr, "lastTime", timePtr); // don't unlock
-          jsvObjectSetChildAndUnLock(data, "time", timePtr);
-        }
-      }
-      JsVar *interval = jsvObjectGetChild(timerPtr, "interval", 0);
-      if (exec) {
-        bool execResult;
-        if (data) {
-          execResult = jsiExecuteEventCallback(0, timerCallback, 1, &data);
-        } else {
-          JsVar *argsArray = jsvObjectGetChild(timerPtr, "args", 0);
-          execResult = jsiExecuteEventCallbackArgsArray(0, timerCallback, argsArray);
-          jsvUnLock(argsArray);
-        }
-        if (!execResult && interval) {
-          jsError("Ctrl-C while processing interval - removing it.");
-          jsErrorFlags |= JSERR_CALLBACK;
-          // by setting interval to 0, we now think we've for a Timeout,
-          // which will get removed.
-          jsvUnLock(interval);
-          interval = 0;
-        }
-      }
-      jsvUnLock(data);
-      if (watchPtr) { // if we had a watch pointer, be sure to remove us from it
-        jsvObjectRemoveChild(watchPtr, "timeout");
-        // Deal with non-recurring watches
-        if (exec) {
-          bool watchRecurring = jsvGetBoolAndUnLock(jsvObjectGetChild(watchPtr,  "recur", 0));
-          if (!watchRecurring) {
-            JsVar *watchArrayPtr = jsvLock(watchArray);
-            JsVar *watchNamePtr = jsvGetIndexOf(watchArrayPtr, watchPtr, true);
-            if (watchNamePtr) {
-              jsvRemoveChild(watchArrayPtr, watchNamePtr);
-              jsvUnLock(watchNamePtr);
-            }
-            jsvUnLock(watchArrayPtr);
-            Pin pin = jshGetPinFromVarAndUnLock(jsvObjectGetChild(watchPtr, "pin", 0));
-            if (!jsiIsWatchingPin(pin))
-              jshPinWatch(pin, false);
-          }
-        }
-        jsvUnLock(watchPtr);
-      }
-
-      if (interval) {
-        timeUntilNext = timeUntilNext + jsvGetLongIntegerAndUnLock(interval);
-      } else {
-        // free
-        // Beware... may have already been removed!
-        jsvObjectIteratorRemoveAndGotoNext(&it, timerArrayPtr);
-        hasDeletedTimer = true;
-        timeUntilNext = -1;
-      }
-      jsvUnLock(timerCallback);
-
-    }
-    // update the time until the next timer
-    if (timeUntilNext>=0 && timeUntilNext < minTimeUntilNext)
+  /* Timers are stored with the time they're due. We only look at the ones
+   * that have expired - getting each from the heap as we need it, as running
+   * one may add or remove others */
+  JsSysTime timerTime;
+  JsVar *timerName;
+  while ((timerName = jsiTimerGetNext(&timerTime, false))) {
+    JsSysTime timeUntilNext = timerTime - jsiLastIdleTime;
+    if (timeUntilNext>0) {
       minTimeUntilNext = timeUntilNext;
-    // update the timer's time
-    if (!hasDeletedTimer) {
-      jsvObjectSetChildAndUnLock(timerPtr, "time", jsvNewFromLongInteger(timeUntilNext));
-      jsvObjectIteratorNext(&it);
+      jsvUnLock(timerName);
+      break;
     }
-    jsvUnLock(timerPtr);
+    jsvUnLock(jsiTimerGetNext(&timerTime, true)); // take it out of the heap while we run it
+    timerExecuting = jsvGetRef(timerName);
+    JsVar *timerPtr = jsvSkipName(timerName);
+    // we're now doing work
+    jsiSetBusy(BUSY_INTERACTIVE, true);
+    wasBusy = true;
+    JsVar *timerCallback = jsvObjectGetChild(timerPtr, "callback", 0);
+    JsVar *interval = jsvObjectGetChild(timerPtr, "interval", 0);
+    JsVar *argsArray = jsvObjectGetChild(timerPtr, "args", 0);
+    bool execResult = jsiExecuteEventCallbackArgsArray(0, timerCallback, argsArray);
+    jsvUnLock(argsArray);
+    if (!execResult && interval) {
+      jsError("Ctrl-C while processing interval - removing it.");
+      jsErrorFlags |= JSERR_CALLBACK;
+      // by setting interval to 0, we now think we've for a Timeout,
+      // which will get removed.
+      jsvUnLock(interval);
+      interval = 0;
+    }
+
+    timerExecuting = 0;
+    // The callback may have cleared this timer already - if so, it's not in timerArray any more
+    bool stillExists = jsvGetRefs(timerName)>0;
+    bool isLate = false;
+    if (interval) {
+      timerTime += jsvGetLongIntegerAndUnLock(interval);
+      if (stillExists) jsiTimerReschedule(timerName, timerPtr, timerTime);
+      // If it's due again already, don't run it again until we've been around the idle loop
+      isLate = timerTime <= jsiLastIdleTime;
+      if (isLate) minTimeUntilNext = 0;
+    } else if (stillExists) {
+      jsiTimerRemove(timerName);
+    }
+    jsvUnLock3(timerCallback, timerPtr, timerName);
+    if (isLate) break;
   }
-  jsvObjectIteratorFree(&it);
-  jsvUnLock(timerArrayPtr);
-  /* We might have left the timers loop with stuff to do because the contents of it
-   * changed. It's not a big deal because it could only have changed because a timer
-   * got executed - so `wasBusy` got set and we know we're going to go around the
-   * loop again before sleeping.
-   */
+
+  // If we couldn't index the watches before, try again now
+  if (watchTableMissing)
+    jsiWatchesChanged();
+  // Call any watches that have finished debouncing
+  if (watchTableDebounced && jsiWatchesDebounceIdle(&minTimeUntilNext))
+    wasBusy = true;
 
   // Check for events that might need to be processed from other libraries
   if (jswIdle()) wasBusy = true;
@@ -2080,6 +2251,16 @@ void jsiIdle() {
   /* if we've been around this loop, there is nothing to do, and
    * we have a spare 10ms then let's do some Garbage Collection
    * if we think we need to */
+#ifdef JSV_GC_GRAY_STACK_SIZE
+  /* If incremental GC is enabled, do a bit of it each time we're idle,
+   * starting a bit earlier than we would otherwise */
+  if (jsvGetGCBudget() &&
+      (jsvIsGarbageCollecting() ||
+       (loopsIdling==1 && !jsvMoreFreeVariablesThan(JS_VARS_BEFORE_IDLE_INCREMENTAL_GC)))) {
+    if (jsvGarbageCollectIncremental())
+      loopsIdling = 0; // don't sleep - we've got more to do
+  } else
+#endif
   if (loopsIdling==1 &&
       minTimeUntilNext > jshGetTimeFromMilliseconds(10) &&
       !jsvMoreFreeVariablesThan(JS_VARS_BEFORE_IDLE_GC)) {
@@ -2087,6 +2268,15 @@ void jsiIdle() {
     jsvGarbageCollect();
     jsiSetBusy(BUSY_INTERACTIVE, false);
   }
+#ifdef JSV_DEFRAG_BATCH_SIZE
+  // If a flat string couldn't be allocated because memory was fragmented, compact it
+  if (loopsIdling==1 && jsvIsDefragmentNeeded()) {
+    jsiSetBusy(BUSY_INTERACTIVE, true);
+    jsvDefragment(0);
+    jsiTimersChanged(); // the timer heap has references to vars that may have moved
+    jsiSetBusy(BUSY_INTERACTIVE, false);
+  }
+#endif
 
   // Kick the WatchDog if needed
   if (jsiStatus & JSIS_WATCHDOG_AUTO)
@@ -2200,7 +2390,7 @@ void jsiDumpState(vcbprintf_callback user_callback, void *user_data) {
     JsVar *timerInterval = jsvObjectGetChild(timer, "interval", 0);
     user_callback(timerInterval ? "setInterval(" : "setTimeout(", user_data);
     jsiDumpJSON(user_callback, user_data, timerCallback, 0);
-    cbprintf(user_callback, user_data, ", %f);\n", jshGetMillisecondsFromTime(timerInterval ? jsvGetLongInteger(timerInterval) : jsvGetLongIntegerAndUnLock(jsvObjectGetChild(timer, "time", 0))));
+    cbprintf(user_callback, user_data, ", %f);\n", jshGetMillisecondsFromTime(timerInterval ? jsvGetLongInteger(timerInterval) : (jsvGetLongIntegerAndUnLock(jsvObjectGetChild(timer, "time", 0)) - jsiLastIdleTime)));
     jsvUnLock2(timerInterval, timerCallback);
     // next
     jsvUnLock(timer);
@@ -2245,15 +2435,230 @@ void jsiDumpState(vcbprintf_callback user_callback, void *user_data) {
   }
 }
 
-JsVarInt jsiTimerAdd(JsVar *timerPtr) {
+#ifdef JSI_TIMER_HEAP_INITIAL
+static void jsiTimerHeapSiftUp(JsiTimerHeapEntry *heap, unsigned int i) {
+  JsiTimerHeapEntry e = heap[i];
+  while (i) {
+    unsigned int parent = (i-1)/2;
+    if (heap[parent].time <= e.time) break;
+    heap[i] = heap[parent];
+    i = parent;
+  }
+  heap[i] = e;
+}
+
+static void jsiTimerHeapSiftDown(JsiTimerHeapEntry *heap, unsigned int i) {
+  JsiTimerHeapEntry e = heap[i];
+  while (true) {
+    unsigned int child = i*2+1;
+    if (child >= timerHeapCount) break;
+    if (child+1 < timerHeapCount && heap[child+1].time < heap[child].time)
+      child++;
+    if (e.time <= heap[child].time) break;
+    heap[i] = heap[child];
+    i = child;
+  }
+  heap[i] = e;
+}
+
+/// Add a timer to the heap, returns false if there wasn't enough memory
+static bool jsiTimerHeapPush(JsVarRef name, JsVarRef timer, JsSysTime time) {
+  unsigned int capacity = timerHeap ? (unsigned int)(jsvGetStringLength(timerHeap) / sizeof(JsiTimerHeapEntry)) : 0;
+  if (timerHeapCount >= capacity) {
+    capacity = capacity ? capacity*2 : JSI_TIMER_HEAP_INITIAL;
+    JsVar *newHeap = jsvNewFlatStringOfLength((unsigned int)(capacity*sizeof(JsiTimerHeapEntry)));
+    if (!newHeap) return false;
+    if (timerHeap) {
+      memcpy(jsvGetFlatStringPointer(newHeap), jsvGetFlatStringPointer(timerHeap), timerHeapCount*sizeof(JsiTimerHeapEntry));
+      jsvUnLock(timerHeap);
+    }
+    timerHeap = newHeap;
+  }
+  JsiTimerHeapEntry *heap = (JsiTimerHeapEntry*)jsvGetFlatStringPointer(timerHeap);
+  heap[timerHeapCount].time = time;
+  heap[timerHeapCount].name = name;
+  heap[timerHeapCount].timer = timer;
+  jsiTimerHeapSiftUp(heap, timerHeapCount++);
+  return true;
+}
+
+static void jsiTimerHeapRemoveAt(unsigned int i) {
+  JsiTimerHeapEntry *heap = (JsiTimerHeapEntry*)jsvGetFlatStringPointer(timerHeap);
+  timerHeapCount--;
+  if (i == timerHeapCount) return;
+  heap[i] = heap[timerHeapCount];
+  jsiTimerHeapSiftDown(heap, i);
+  jsiTimerHeapSiftUp(heap, i);
+}
+
+/// Find the heap entry for the given timer (or name), or return -1. This is a linear search
+static int jsiTimerHeapFind(JsVarRef ref, bool isName) {
+  if (!timerHeapValid || !timerHeapCount) return -1;
+  JsiTimerHeapEntry *heap = (JsiTimerHeapEntry*)jsvGetFlatStringPointer(timerHeap);
+  unsigned int i;
+  for (i=0;i<timerHeapCount;i++)
+    if ((isName ? heap[i].name : heap[i].timer) == ref)
+      return (int)i;
+  return -1;
+}
+
+/// Make the heap from everything in timerArray, returns false if there wasn't enough memory
+static bool jsiTimerHeapRebuild() {
+  timerHeapCount = 0;
+  timerHeapValid = false;
+  JsVar *timerArrayPtr = jsvLock(timerArray);
+  JsvObjectIterator it;
+  jsvObjectIteratorNew(&it, timerArrayPtr);
+  bool ok = true;
+  while (ok && jsvObjectIteratorHasValue(&it)) {
+    JsVar *timerName = jsvObjectIteratorGetKey(&it);
+    if (jsvGetRef(timerName) != timerExecuting) {
+      JsVar *timerPtr = jsvObjectIteratorGetValue(&it);
+      JsSysTime timerTime = (JsSysTime)jsvGetLongIntegerAndUnLock(jsvObjectGetChild(timerPtr, "time", 0));
+      ok = jsiTimerHeapPush(jsvGetRef(timerName), jsvGetRef(timerPtr), timerTime);
+      jsvUnLock(timerPtr);
+    }
+    jsvUnLock(timerName);
+    jsvObjectIteratorNext(&it);
+  }
+  jsvObjectIteratorFree(&it);
+  jsvUnLock(timerArrayPtr);
+  timerHeapValid = ok;
+  return ok;
+}
+#endif
+
+/** Get the name (in timerArray) of the timer that is due next, and when it's
+ * due, or return 0 if there are no timers. If 'remove' is set, the timer is
+ * taken out of the heap (it's still in timerArray). */
+static JsVar *jsiTimerGetNext(JsSysTime *timerTime, bool remove) {
+#ifdef JSI_TIMER_HEAP_INITIAL
+  if (jsiStatus & JSIS_TIMERS_CHANGED) {
+    jsiStatus &= ~JSIS_TIMERS_CHANGED;
+    jsiTimerHeapRebuild();
+  }
+  if (timerHeapValid) {
+    if (!timerHeapCount) return 0;
+    JsiTimerHeapEntry *heap = (JsiTimerHeapEntry*)jsvGetFlatStringPointer(timerHeap);
+    *timerTime = heap[0].time;
+    JsVar *timerName = jsvLock(heap[0].name);
+    if (remove) jsiTimerHeapRemoveAt(0);
+    return timerName;
+  }
+#else
+  NOT_USED(remove);
+#endif
+  // No heap (or not enough memory for one) - just search all the timers
+  JsVar *next = 0;
   JsVar *timerArrayPtr = jsvLock(timerArray);
-  JsVarInt itemIndex = jsvArrayAddToEnd(timerArrayPtr, timerPtr, 1) - 1;
+  JsvObjectIterator it;
+  jsvObjectIteratorNew(&it, timerArrayPtr);
+  while (jsvObjectIteratorHasValue(&it)) {
+    JsVar *timerPtr = jsvObjectIteratorGetValue(&it);
+    JsSysTime t = (JsSysTime)jsvGetLongIntegerAndUnLock(jsvObjectGetChild(timerPtr, "time", 0));
+    jsvUnLock(timerPtr);
+    if (!next || t < *timerTime) {
+      jsvUnLock(next);
+      next = jsvObjectIteratorGetKey(&it);
+      *timerTime = t;
+    }
+    jsvObjectIteratorNext(&it);
+  }
+  jsvObjectIteratorFree(&it);
   jsvUnLock(timerArrayPtr);
+  return next;
+}
+
+JsVarInt jsiTimerAdd(JsVar *timerPtr) {
+  JsVar *timerArrayPtr = jsvLock(timerArray);
+  JsVarInt itemIndex = 1;
+  if (jsvGetLastChild(timerArrayPtr)) {
+    JsVar *last = jsvLock(jsvGetLastChild(timerArrayPtr));
+    itemIndex = jsvGetInteger(last)+1;
+    jsvUnLock(last);
+  }
+  JsVar *timerName = jsvMakeIntoVariableName(jsvNewFromInteger(itemIndex), timerPtr);
+  if (!timerName) {
+    jsvUnLock(timerArrayPtr);
+    jsWarn("Out of memory while adding timer");
+    return 0;
+  }
+  jsvAddName(timerArrayPtr, timerName);
+#ifdef JSI_TIMER_HEAP_INITIAL
+  if (timerHeapValid) {
+    JsSysTime timerTime = (JsSysTime)jsvGetLongIntegerAndUnLock(jsvObjectGetChild(timerPtr, "time", 0));
+    if (!jsiTimerHeapPush(jsvGetRef(timerName), jsvGetRef(timerPtr), timerTime))
+      jsiTimersChanged(); // not enough memory - we'll search timerArray until the heap can be rebuilt
+  }
+#endif
+  jsvUnLock2(timerName, timerArrayPtr);
   return itemIndex;
 }
 
+void jsiTimerSetTime(JsVar *timerPtr, JsSysTime time) {
+  jsvObjectSetChildAndUnLock(timerPtr, "time", jsvNewFromLongInteger(time));
+#ifdef JSI_TIMER_HEAP_INITIAL
+  int i = jsiTimerHeapFind(jsvGetRef(timerPtr), false);
+  if (i>=0) {
+    JsiTimerHeapEntry *heap = (JsiTimerHeapEntry*)jsvGetFlatStringPointer(timerHeap);
+    heap[i].time = time;
+    jsiTimerHeapSiftDown(heap, (unsigned int)i);
+    jsiTimerHeapSiftUp(heap, (unsigned int)i);
+  }
+#endif
+}
+
+/// Set the time of a timer that jsiTimerGetNext removed from the heap, and put it back
+static void jsiTimerReschedule(JsVar *timerName, JsVar *timerPtr, JsSysTime time) {
+  jsvObjectSetChildAndUnLock(timerPtr, "time", jsvNewFromLongInteger(time));
+#ifdef JSI_TIMER_HEAP_INITIAL
+  if (timerHeapValid && !jsiTimerHeapPush(jsvGetRef(timerName), jsvGetRef(timerPtr), time))
+    jsiTimersChanged(); // not enough memory - we'll search timerArray until the heap can be rebuilt
+#else
+  NOT_USED(timerName);
+#endif
+}
+
+void jsiTimerRemove(JsVar *timerName) {
+#ifdef JSI_TIMER_HEAP_INITIAL
+  int i = jsiTimerHeapFind(jsvGetRef(timerName), true);
+  if (i>=0) jsiTimerHeapRemoveAt((unsigned int)i);
+#endif
+  JsVar *timerArrayPtr = jsvLock(timerArray);
+  jsvRemoveChild(timerArrayPtr, timerName);
+  jsvUnLock(timerArrayPtr);
+}
+
+void jsiTimersShift(JsSysTime diff) {
+  if (!timerArray) return;
+  JsVar *timerArrayPtr = jsvLock(timerArray);
+  JsvObjectIterator it;
+  jsvObjectIteratorNew(&it, timerArrayPtr);
+  while (jsvObjectIteratorHasValue(&it)) {
+    JsVar *timerPtr = jsvObjectIteratorGetValue(&it);
+    JsSysTime timerTime = (JsSysTime)jsvGetLongIntegerAndUnLock(jsvObjectGetChild(timerPtr, "time", 0));
+    jsvObjectSetChildAndUnLock(timerPtr, "time", jsvNewFromLongInteger(timerTime + diff));
+    jsvUnLock(timerPtr);
+    jsvObjectIteratorNext(&it);
+  }
+  jsvObjectIteratorFree(&it);
+  jsvUnLock(timerArrayPtr);
+#ifdef JSI_TIMER_HEAP_INITIAL
+  // everything moves by the same amount, so the heap stays in order
+  if (timerHeapValid && timerHeapCount) {
+    JsiTimerHeapEntry *heap = (JsiTimerHeapEntry*)jsvGetFlatStringPointer(timerHeap);
+    unsigned int i;
+    for (i=0;i<timerHeapCount;i++)
+      heap[i].time += diff;
+  }
+#endif
+}
+
 void jsiTimersChanged() {
   jsiStatus |= JSIS_TIMERS_CHANGED;
+#ifdef JSI_TIMER_HEAP_INITIAL
+  timerHeapValid = false; // don't use it until it's rebuilt
+#endif
 }
 
 #ifdef USE_DEBUGGER
@@ -41,6 +41,7 @@ bool jsiFreeMoreMemory();
 
 bool jsiHasTimers(); // are there timers still left to run?
 bool jsiIsWatchingPin(Pin pin); // are there any watches for the given pin?
+void jsiWatchesChanged(); ///< Call when watchArray changes, so we can work out which watches to call for each EXTI channel
 
 void jsiCtrlC(); // Ctrl-C - force interrupt of execution
 
@@ -131,7 +132,7 @@ typedef enum {
   JSIS_ECHO_OFF = 1, ///< do we provide any user feedback? OFF=no
   JSIS_ECHO_OFF_FOR_LINE = 2, ///< Echo is off just for one line, then back on
   JSIS_ALLOW_DEEP_SLEEP = 4, ///< can we go into proper deep sleep?
-  JSIS_TIMERS_CHANGED = 8,
+  JSIS_TIMERS_CHANGED = 8, ///< Timers were changed without updating the heap of timers (see jsiTimersChanged)
 #ifdef USE_DEBUGGER
   JSIS_IN_DEBUGGER = 16, ///< We're inside the debug loop
   JSIS_EXIT_DEBUGGER = 32, ///< we've been asked to exit the debug loop
@@ -161,8 +162,14 @@ void jsiDumpState(vcbprintf_callback user_callback, void *user_data);
 extern JsVarRef timerArray; // Linked List of timers to check and run
 extern JsVarRef watchArray; // Linked List of input watches to check and run
 
-extern JsVarInt jsiTimerAdd(JsVar *timerPtr);
-extern void jsiTimersChanged(); // Flag timers changed so we can skip out of the loop if needed
+/* Timers are objects in timerArray, with "time" set to the system time they're due
+ * (or the time until they're due, while saved). They're also kept in a heap
+ * (see jsiTimerGetNext), so use these functions to change them */
+extern JsVarInt jsiTimerAdd(JsVar *timerPtr); ///< Add a timer (with "time" already set), and return its ID
+extern void jsiTimerSetTime(JsVar *timerPtr, JsSysTime time); ///< Change the time a timer is due
+extern void jsiTimerRemove(JsVar *timerName); ///< Remove a timer, given its name in timerArray
+extern void jsiTimersShift(JsSysTime diff); ///< Add diff to the time of every timer (if the system time changes)
+extern void jsiTimersChanged(); // Flag timers changed some other way, so the heap of timers must be rebuilt
 // end for jswrap_interactive/io.c ------------------------------------------------
 
 #ifdef USE_DEBUGGER
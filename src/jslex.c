@@ -252,6 +252,15 @@ void jslGetNextToken() {
   // tokens
   if (((unsigned char)lex->currCh) < jslJumpTableStart ||
       ((unsigned char)lex->currCh) > jslJumpTableEnd) {
+#ifdef JSLEX_PRETOKENISE
+    if (((unsigned char)lex->currCh) >= LEX_TOKENISED_START &&
+        ((unsigned char)lex->currCh) < LEX_TOKENISED_END) {
+      // an operator or reserved word from pretokenised code
+      lex->tk = (short)(LEX_EQUAL + ((unsigned char)lex->currCh) - LEX_TOKENISED_START);
+      jslGetNextCh();
+      return;
+    }
+#endif
     // if unhandled by the jump table, just pass it through as a single character
     jslSingleChar();
   } else {
@@ -341,6 +350,11 @@ void jslGetNextToken() {
             jslTokenAppendChar(lex->currCh);
             jslGetNextCh();
           }
+#ifdef FLOAT_ROUNDTRIP
+          // may be too big for a 64 bit integer - read it as a (correctly rounded) float instead
+          if (canBeFloating && lex->tokenl > 18)
+            lex->tk = LEX_FLOAT;
+#endif
           if (canBeFloating && lex->currCh=='.') {
             lex->tk = LEX_FLOAT;
             jslTokenAppendChar('.');
@@ -670,7 +684,7 @@ void jslTokenAsString(int token, char *str, size_t len) {
         /*LEX_R_DO :       */ "do\0"
         /*LEX_R_WHILE :    */ "while\0"
         /*LEX_R_FOR :      */ "for\0"
-        /*LEX_R_BREAK :    */ "return\0"
+        /*LEX_R_BREAK :    */ "break\0"
         /*LEX_R_CONTINUE   */ "continue\0"
         /*LEX_R_FUNCTION   */ "function\0"
         /*LEX_R_RETURN     */ "return\0"
@@ -727,13 +741,30 @@ void jslGetTokenString(char *str, size_t len) {
     jslTokenAsString(lex->tk, str, len);
 }
 
+#ifdef JSLEX_PRETOKENISE
+/** Reserved words from pretokenised code don't have their text in lex->token
+ * (as it's rarely needed) - so add it if it's asked for */
+static void jslFillReservedWordToken() {
+  if (!lex->tokenl && lex->tk>=LEX_R_LIST_START && lex->tk<LEX_R_LIST_END) {
+    jslTokenAsString(lex->tk, lex->token, JSLEX_MAX_TOKEN_LENGTH);
+    lex->tokenl = (unsigned char)strlen(lex->token);
+  }
+}
+#endif
+
 char *jslGetTokenValueAsString() {
+#ifdef JSLEX_PRETOKENISE
+  jslFillReservedWordToken();
+#endif
   assert(lex->tokenl < JSLEX_MAX_TOKEN_LENGTH);
   lex->token[lex->tokenl]  = 0; // add final null
   return lex->token;
 }
 
 int jslGetTokenLength() {
+#ifdef JSLEX_PRETOKENISE
+  jslFillReservedWordToken();
+#endif
   return lex->tokenl;
 }
 
@@ -741,6 +772,9 @@ JsVar *jslGetTokenValueAsVar() {
   if (lex->tokenValue) {
     return jsvLockAgain(lex->tokenValue);
   } else {
+#ifdef JSLEX_PRETOKENISE
+    jslFillReservedWordToken();
+#endif
     assert(lex->tokenl < JSLEX_MAX_TOKEN_LENGTH);
     lex->token[lex->tokenl]  = 0; // add final null
     return jsvNewFromString(lex->token);
@@ -831,6 +865,219 @@ JsVar *jslNewFromLexer(JslCharPos *charFrom, size_t charTo) {
   return var;
 }
 
+#ifdef JSLEX_PRETOKENISE
+/// Is this a character that can be in an identifier or number (so two of them can't be next to each other without a space)
+static bool jslIsIDChar(char ch) {
+  return isAlpha(ch) || isNumeric(ch) || ch=='$';
+}
+
+/// Would the single-character tokens c1 then c2 be lexed as something else if there was no space between them?
+static bool jslSingleCharsJoin(char c1, char c2) {
+  if (!c1) return false;
+  if (c2=='=') return strchr("!=<>+-*/%&|^", c1)!=0;
+  if (c1==c2) return strchr("+-<>&|/", c1)!=0;
+  return (c1=='=' && c2=='>') || (c1=='/' && c2=='*');
+}
+
+/// Where jslTokenise writes to - if both ptr and it.var are 0, we just count the characters
+typedef struct {
+  char *ptr; ///< pointer into a flat string
+  JsvStringIterator it; ///< or an iterator to append to a normal string
+  size_t length; ///< how many characters we've written
+} JslTokeniseOutput;
+
+static void jslTokeniseAppend(JslTokeniseOutput *out, char ch) {
+  out->length++;
+  if (out->ptr) *(out->ptr++) = ch;
+  else if (out->it.var) jsvStringIteratorAppend(&out->it, ch);
+}
+
+/// Tokenise the code in sourceVar from charFrom up to charTo into 'out'
+static void jslTokenise(JsVar *sourceVar, JslCharPos *charFrom, size_t charTo, JslTokeniseOutput *out) {
+  JsLex newLex;
+  JsLex *oldLex = jslSetLex(&newLex);
+  jslInit(sourceVar);
+  jslSeekToP(charFrom);
+  // 'it' follows along behind the lexer, so we can copy newlines and the text of tokens
+  size_t itIdx = jsvStringIteratorGetIndex(&charFrom->it)-1;
+  JsvStringIterator it;
+  jsvStringIteratorNew(&it, sourceVar, itIdx);
+  char lastCh = 0; // the last character that we output
+  int lastTk = LEX_EOF;
+  while (lex->tk!=LEX_EOF) {
+    size_t tokenStart = jsvStringIteratorGetIndex(&lex->tokenStart.it)-1;
+    size_t tokenEnd = jsvStringIteratorGetIndex(&lex->it)-1;
+    if (tokenStart >= charTo) break;
+    // copy any newlines between the last token and this one, so line numbers stay the same
+    while (itIdx < tokenStart) {
+      if (jsvStringIteratorGetChar(&it)=='\n') {
+        lastCh = '\n';
+        jslTokeniseAppend(out, lastCh);
+      }
+      jsvStringIteratorNext(&it);
+      itIdx++;
+    }
+    if (lex->tk>=LEX_EQUAL && lex->tk<LEX_R_LIST_END) {
+      // operators and reserved words - these can't join onto what's around them
+      lastCh = (char)(LEX_TOKENISED_START + lex->tk - LEX_EQUAL);
+      jslTokeniseAppend(out, lastCh);
+    } else {
+      // IDs, numbers, strings and single characters - copy the original text, with a space if it'd join onto the last token
+      char firstCh = jsvStringIteratorGetChar(&it);
+      bool lastWasNumber = lastTk==LEX_INT || lastTk==LEX_FLOAT;
+      if ((jslIsIDChar(lastCh) && jslIsIDChar(firstCh)) ||
+          (lastWasNumber && firstCh=='.') ||
+          (lastCh=='.' && isNumeric(firstCh)) ||
+          (lastTk<LEX_ID && lex->tk<LEX_ID && jslSingleCharsJoin(lastCh, firstCh)))
+        jslTokeniseAppend(out, ' ');
+      while (itIdx < tokenEnd) {
+        lastCh = jsvStringIteratorGetChar(&it);
+        jslTokeniseAppend(out, lastCh);
+        jsvStringIteratorNext(&it);
+        itIdx++;
+      }
+    }
+    lastTk = lex->tk;
+    jslGetNextToken();
+  }
+  jsvStringIteratorFree(&it);
+  jslKill();
+  jslSetLex(oldLex);
+}
+
+/** Create a new STRING from part of the lexer (like jslNewFromLexer) - but
+ * where operators and reserved words are replaced by single characters, and
+ * whitespace and comments are removed (apart from newlines, so line numbers
+ * stay the same). This is much faster for the lexer to handle each time the
+ * function is called. */
+JsVar *jslNewTokenisedStringFromLexer(JslCharPos *charFrom, size_t charTo) {
+  // Work out how long the string will be first
+  JslTokeniseOutput out;
+  out.ptr = 0;
+  out.it.var = 0;
+  out.length = 0;
+  jslTokenise(lex->sourceVar, charFrom, charTo, &out);
+  size_t length = out.length;
+  // Now create a var and write into it (flat if it's big enough)
+  JsVar *var = 0;
+  out.length = 0;
+  if (length > JSV_FLAT_STRING_BREAK_EVEN) {
+    var = jsvNewFlatStringOfLength((unsigned int)length);
+    if (var) out.ptr = jsvGetFlatStringPointer(var);
+  }
+  if (!var) {
+    var = jsvNewFromEmptyString();
+    if (!var) return 0; // out of memory
+    jsvStringIteratorNew(&out.it, var, 0);
+  }
+  jslTokenise(lex->sourceVar, charFrom, charTo, &out);
+  if (!out.ptr) jsvStringIteratorFree(&out.it);
+  // Just make sure we only assert if there's a bug here. If we just ran out of memory it's ok
+  assert((length == jsvGetStringLength(var)) || (jsErrorFlags&JSERR_MEMORY));
+  return var;
+}
+
+/// Could this character join onto an operator next to it?
+static bool jslIsOperatorChar(char ch) {
+  return ch && strchr("!=<>+-*/%&|^", ch)!=0;
+}
+
+/// State for printing code that may have been pretokenised (see jslPrintTokenisedChar)
+typedef struct {
+  vcbprintf_callback user_callback;
+  void *user_data;
+  char lastCh; ///< the last character we printed
+  char quote; ///< if we're in a string, the character that ends it
+  char comment; ///< if we're in a comment, '/' or '*' for the type of comment
+  bool escape; ///< the last character was a backslash in a string
+  bool canStartComment; ///< the last character was a '/' that could start a comment
+  int lastTk; ///< if the last thing we printed was an expanded operator or reserved word, what it was
+  size_t chars; ///< how many characters we've printed
+} JslPrintState;
+
+static void jslPrintStateInit(JslPrintState *s, vcbprintf_callback user_callback, void *user_data) {
+  s->user_callback = user_callback;
+  s->user_data = user_data;
+  s->lastCh = 0;
+  s->quote = 0;
+  s->comment = 0;
+  s->escape = false;
+  s->canStartComment = false;
+  s->lastTk = 0;
+  s->chars = 0;
+}
+
+static void jslPrintStateOutput(JslPrintState *s, const char *str) {
+  size_t l = strlen(str);
+  if (!l) return;
+  s->user_callback(str, s->user_data);
+  s->chars += l;
+  s->lastCh = str[l-1];
+}
+
+/** Print a character of code that may have been pretokenised, expanding
+ * operators and reserved words and putting spaces back in where they're needed.
+ * Strings and comments are passed through as-is. */
+static void jslPrintTokenisedChar(JslPrintState *s, char ch) {
+  char buf[JSLEX_MAX_TOKEN_LENGTH];
+  bool wasSlash = s->canStartComment;
+  s->canStartComment = false;
+  if (s->quote) { // in a string
+    if (s->escape) s->escape = false;
+    else if (ch=='\\') s->escape = true;
+    else if (ch==s->quote || (ch=='\n' && s->quote!='`')) s->quote = 0;
+  } else if (s->comment) { // in a comment
+    if ((s->comment=='/' && ch=='\n') ||
+        (s->comment=='*' && ch=='/' && s->lastCh=='*'))
+      s->comment = 0;
+  } else if (((unsigned char)ch)>=LEX_TOKENISED_START && ((unsigned char)ch)<LEX_TOKENISED_END) {
+    int tk = LEX_EQUAL + ((unsigned char)ch) - LEX_TOKENISED_START;
+    jslTokenAsString(tk, buf, sizeof(buf));
+    // put a space in if it'd join onto the last thing we printed
+    if ((tk>=LEX_R_LIST_START) ? jslIsIDChar(s->lastCh) : jslIsOperatorChar(s->lastCh))
+      jslPrintStateOutput(s, " ");
+    jslPrintStateOutput(s, buf);
+    s->lastTk = tk;
+    return;
+  } else {
+    // put a space in if this would join onto an operator or reserved word we printed
+    if (s->lastTk && ((s->lastTk>=LEX_R_LIST_START) ? jslIsIDChar(ch) : jslIsOperatorChar(ch)))
+      jslPrintStateOutput(s, " ");
+    if (ch=='"' || ch=='\'' || ch=='`') {
+      s->quote = ch;
+    } else if (wasSlash && (ch=='/' || ch=='*')) {
+      s->comment = ch;
+      s->canStartComment = false;
+      wasSlash = true; // so the '*' in '/*' doesn't count towards ending the comment
+    } else if (ch=='/') {
+      s->canStartComment = true;
+    }
+  }
+  s->lastTk = 0;
+  buf[0] = ch;
+  buf[1] = 0;
+  jslPrintStateOutput(s, buf);
+  if (s->comment=='*' && wasSlash) s->lastCh = 0; // so '/*/' doesn't end the comment
+}
+
+/// Print code (which may have been pretokenised) as JavaScript
+void jslPrintTokenisedString(JsVar *code, vcbprintf_callback user_callback, void *user_data) {
+  JslPrintState s;
+  jslPrintStateInit(&s, user_callback, user_data);
+  JsvStringIterator it;
+  jsvStringIteratorNew(&it, code, 0);
+  while (jsvStringIteratorHasChar(&it)) {
+    jslPrintTokenisedChar(&s, jsvStringIteratorGetChar(&it));
+    jsvStringIteratorNext(&it);
+  }
+  jsvStringIteratorFree(&it);
+}
+#else
+void jslPrintTokenisedString(JsVar *code, vcbprintf_callback user_callback, void *user_data) {
+  cbprintf(user_callback, user_data, "%v", code);
+}
+#endif
+
 /// Return the line number at the current character position (this isn't fast as it searches the string)
 unsigned int jslGetLineNumber() {
   size_t line;
@@ -872,15 +1119,27 @@ void jslPrintTokenLineMarker(vcbprintf_callback user_callback, void *user_data,
 
   // print the string until the end of the line, or 60 chars (whichever is lesS)
   int chars = 0;
+#ifdef JSLEX_PRETOKENISE
+  // the code may be pretokenised, so work out the column from what we actually print
+  size_t colOffset = col + startOfLine - tokenPos;
+  JslPrintState s;
+  jslPrintStateInit(&s, user_callback, user_data);
+#endif
   JsvStringIterator it;
   jsvStringIteratorNew(&it, lex->sourceVar, startOfLine);
   while (jsvStringIteratorHasChar(&it) && chars<60) {
     char ch = jsvStringIteratorGetChar(&it);
     if (ch == '\n') break;
+#ifdef JSLEX_PRETOKENISE
+    if (jsvStringIteratorGetIndex(&it) == tokenPos)
+      col = colOffset + s.chars;
+    jslPrintTokenisedChar(&s, ch);
+#else
     char buf[2];
     buf[0] = ch;
     buf[1] = 0;
     user_callback(buf, user_data);
+#endif
     chars++;
     jsvStringIteratorNext(&it);
   }
@@ -91,6 +91,14 @@ typedef enum LEX_TYPES {
     LEX_R_LIST_END /* always the last entry */
 } LEX_TYPES;
 
+#ifdef JSLEX_PRETOKENISE
+/* In pretokenised function code (see jslNewTokenisedStringFromLexer), operators
+ * and reserved words (LEX_EQUAL onwards) are stored as a single character
+ * of LEX_TOKENISED_START or more */
+#define LEX_TOKENISED_START 176 // 0xB0 - above 0xA0, which is whitespace (non-breaking space)
+#define LEX_TOKENISED_END (LEX_TOKENISED_START + LEX_R_LIST_END - LEX_EQUAL)
+#endif
+
 typedef struct JslCharPos {
   JsvStringIterator it;
   char currCh;
@@ -149,6 +157,11 @@ void jslSeek(JslCharPos seekToChar); // like jslSeekTo, but doesn't pre-fill cha
 void jslGetNextToken(); ///< Get the text token from our text string
 
 JsVar *jslNewFromLexer(JslCharPos *charFrom, size_t charTo); // Create a new STRING from part of the lexer
+#ifdef JSLEX_PRETOKENISE
+JsVar *jslNewTokenisedStringFromLexer(JslCharPos *charFrom, size_t charTo); // Create a new STRING of pretokenised code from part of the lexer
+#endif
+/// Print code (which may have been pretokenised) as JavaScript
+void jslPrintTokenisedString(JsVar *code, vcbprintf_callback user_callback, void *user_data);
 
 /// Return the line number at the current character position (this isn't fast as it searches the string)
 unsigned int jslGetLineNumber();
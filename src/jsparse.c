@@ -19,6 +19,8 @@
 #include "jswrap_functions.h" // insane check for eval in jspeFunctionCall
 #include "jswrap_json.h" // for jsfPrintJSON
 #include "jswrap_espruino.h" // for jswrap_espruino_memoryArea
+#include "jsbytecode.h"
+#include "jsprofile.h"
 
 /* Info about execution when Parsing - this saves passing it on the stack
  * for each call */
@@ -413,7 +415,12 @@ NO_INLINE bool jspeFunctionDefinitionInternal(JsVar *funcVar, bool expressionOnl
         funcCodeVar->varData.nativeStr.len = (uint16_t)(lastTokenEnd - s);
       }
     } else {
-      funcCodeVar = jslNewFromLexer(&funcBegin, (size_t)lastTokenEnd);
+#ifdef JSLEX_PRETOKENISE
+      if (jsFlags & JSF_PRETOKENISE)
+        funcCodeVar = jslNewTokenisedStringFromLexer(&funcBegin, (size_t)lastTokenEnd);
+      else
+#endif
+        funcCodeVar = jslNewFromLexer(&funcBegin, (size_t)lastTokenEnd);
     }
     jsvUnLock2(jsvAddNamedChild(funcVar, funcCodeVar, JSPARSE_FUNCTION_CODE_NAME), funcCodeVar);
     // scope var
@@ -488,6 +495,153 @@ NO_INLINE bool jspeParseFunctionCallBrackets() {
   return 0;
 }
 
+/// Add "in function ... called from ..." to the stack trace after an error in a function
+static void jspeAppendCallerToStackTrace(JsVar *functionName) {
+  JsVar *stackTrace = jsvObjectGetChild(execInfo.hiddenRoot, JSPARSE_STACKTRACE_VAR, JSV_STRING_0);
+  if (stackTrace) {
+    jsvAppendPrintf(stackTrace, jsvIsString(functionName)?"in function %q called from ":
+        "in function called from ", functionName);
+    if (lex) {
+      jspAppendStackTrace(stackTrace);
+    } else
+      jsvAppendPrintf(stackTrace, "system\n");
+    jsvUnLock(stackTrace);
+  }
+}
+
+#ifdef JSPARSE_BYTECODE
+/// Get a function's bytecode (compiling it the first time it's called), or 0 if it has to be parsed
+static JsVar *jspeGetFunctionBytecode(JsVar *function) {
+  if (!(jsFlags & JSF_BYTECODE)) return 0;
+#ifdef USE_DEBUGGER
+  if (execInfo.execute&EXEC_DEBUGGER_MASK) return 0;
+#endif
+  JsVar *bytecode = jsvObjectGetChild(function, JSPARSE_FUNCTION_BYTECODE_NAME, 0);
+  if (!bytecode) {
+    JsVar *functionCode = jsvObjectGetChild(function, JSPARSE_FUNCTION_CODE_NAME, 0);
+    if (functionCode) bytecode = jsbcCompileFunction(function, functionCode);
+    jsvUnLock(functionCode);
+  }
+  if (!jsvIsFlatString(bytecode)) {
+    jsvUnLock(bytecode);
+    return 0;
+  }
+  return bytecode;
+}
+
+/** Call a function that has been compiled to bytecode. The bytecode keeps
+ * parameters and variables in slots, so unlike jspeFunctionCall we don't
+ * make a scope full of names for them - we just work out what each
+ * parameter's value is. Functions only get a scope if they have their own
+ * name to go in it (so they can call themselves). */
+static NO_INLINE JsVar *jspeFunctionCallBytecode(JsVar *function, JsVar *functionName, JsVar *bytecode, JsVar *thisVar, int argCount, JsVar **argPtr) {
+  JsVar *returnVar = 0;
+  int paramCount = (unsigned char)jsvGetFlatStringPointer(bytecode)[0];
+  JsVar **params = (JsVar**)alloca(sizeof(JsVar*)*(size_t)(paramCount+1));
+  int param = 0, boundArgs = 0;
+  bool isBound = true; // parameters with values at the start were set with 'bind'
+  JsVar *functionScope = 0;
+  JsVar *functionCode = 0;
+  JsVar *functionInternalName = 0;
+  JsVar *boundThis = 0;
+  uint16_t functionLineNumber = 0;
+
+  JsvObjectIterator it;
+  jsvObjectIteratorNew(&it, function);
+  while (jsvObjectIteratorHasValue(&it)) {
+    JsVar *key = jsvObjectIteratorGetKey(&it);
+    if (jsvIsFunctionParameter(key)) {
+      JsVar *value = jsvSkipName(key);
+      if (isBound && value) {
+        boundArgs++;
+      } else {
+        isBound = false;
+        if (param-boundArgs < argCount) {
+          jsvUnLock(value); // it was a default value
+          value = jsvLockAgainSafe(argPtr[param-boundArgs]);
+        }
+      }
+      if (param<paramCount) params[param++] = value;
+      else jsvUnLock(value);
+    } else if (jsvIsString(key)) {
+      if (jsvIsStringEqual(key, JSPARSE_FUNCTION_SCOPE_NAME)) functionScope = jsvSkipName(key);
+      else if (jsvIsStringEqual(key, JSPARSE_FUNCTION_CODE_NAME)) functionCode = jsvSkipName(key);
+      else if (jsvIsStringEqual(key, JSPARSE_FUNCTION_NAME_NAME)) functionInternalName = jsvSkipName(key);
+      else if (jsvIsStringEqual(key, JSPARSE_FUNCTION_THIS_NAME)) boundThis = jsvSkipName(key);
+      else if (jsvIsStringEqual(key, JSPARSE_FUNCTION_LINENUMBER_NAME)) functionLineNumber = (uint16_t)jsvGetIntegerAndUnLock(jsvSkipName(key));
+    }
+    jsvUnLock(key);
+    jsvObjectIteratorNext(&it);
+  }
+  jsvObjectIteratorFree(&it);
+  while (param<paramCount) params[param++] = 0;
+  if (boundThis) thisVar = boundThis;
+
+  // a scope for the function's own name
+  JsVar *functionRoot = 0;
+  if (functionInternalName) {
+    functionRoot = jsvNewWithFlags(JSV_FUNCTION);
+    JsVar *name = jsvMakeIntoVariableName(jsvNewFromStringVar(functionInternalName,0,JSVAPPENDSTRINGVAR_MAXLENGTH), function);
+    if (functionRoot && name) jsvAddName(functionRoot, name);
+    else jspSetError(false); // out of memory
+    jsvUnLock2(name, functionInternalName);
+  }
+
+  // save old scopes, and load up the function's ones
+  JsVar *oldScopes[JSPARSE_MAX_SCOPES];
+  int oldScopeCount = execInfo.scopeCount;
+  int i;
+  for (i=0;i<execInfo.scopeCount;i++)
+    oldScopes[i] = execInfo.scopes[i];
+  if (functionScope) {
+    jspeiLoadScopesFromVar(functionScope);
+    jsvUnLock(functionScope);
+  } else
+    execInfo.scopeCount = 0;
+
+  if (!JSP_HAS_ERROR && (!functionRoot || jspeiAddScope(functionRoot))) {
+    JsVar *oldThisVar = execInfo.thisVar;
+    execInfo.thisVar = jsvRef(thisVar ? thisVar : execInfo.root); // 'this' should always default to root
+    // We keep a lexer for the function's code so we can report errors
+    JsLex newLex;
+    JsLex *oldLex = jslSetLex(&newLex);
+    jslInit(functionCode);
+    newLex.lineNumberOffset = functionLineNumber;
+    JSP_SAVE_EXECUTE();
+    execInfo.execute = EXEC_YES | (execInfo.execute&(EXEC_CTRL_C_MASK|EXEC_ERROR_MASK));
+#ifdef JSPROFILE_MAX_FUNCTIONS
+    if (jsprofRunning) jsprofFunctionEnter(function, functionName);
+#endif
+    returnVar = jsbcExecuteFunction(bytecode, params, paramCount, functionRoot!=0);
+#ifdef JSPROFILE_MAX_FUNCTIONS
+    if (jsprofRunning) jsprofFunctionExit();
+#endif
+    JsExecFlags hasError = execInfo.execute&(EXEC_ERROR_MASK|EXEC_CTRL_C_MASK);
+    JSP_RESTORE_EXECUTE();
+    jslKill();
+    jslSetLex(oldLex);
+    if (hasError) {
+      execInfo.execute |= hasError; // propogate error
+      jspeAppendCallerToStackTrace(functionName);
+    }
+    jsvUnRef(execInfo.thisVar);
+    execInfo.thisVar = oldThisVar;
+    if (functionRoot) jspeiRemoveScope();
+  }
+
+  // restore the old scopes
+  for (i=0;i<execInfo.scopeCount;i++)
+    jsvUnLock(execInfo.scopes[i]);
+  for (i=0;i<oldScopeCount;i++)
+    execInfo.scopes[i] = oldScopes[i];
+  execInfo.scopeCount = oldScopeCount;
+
+  jsvUnLockMany((unsigned int)paramCount, params);
+  jsvUnLock3(functionRoot, functionCode, boundThis);
+  return returnVar;
+}
+#endif
+
 /** Handle a function call (assumes we've parsed the function name and we're
  * on the start bracket). 'thisArg' is the value of the 'this' variable when the
  * function is executed (it's usually the parent object)
@@ -615,7 +769,13 @@ NO_INLINE JsVar *jspeFunctionCall(JsVar *function, JsVar *functionName, JsVar *t
 
 
       if (nativePtr && !JSP_HAS_ERROR) {
+#ifdef JSPROFILE_MAX_FUNCTIONS
+        if (jsprofRunning) jsprofFunctionEnter(function, functionName);
+#endif
         returnVar = jsnCallFunction(nativePtr, function->varData.native.argTypes, thisVar, argPtr, argCount);
+#ifdef JSPROFILE_MAX_FUNCTIONS
+        if (jsprofRunning) jsprofFunctionExit();
+#endif
       } else {
         returnVar = 0;
       }
@@ -628,6 +788,35 @@ NO_INLINE JsVar *jspeFunctionCall(JsVar *function, JsVar *functionName, JsVar *t
       execInfo.thisVar = oldThisVar;
 
     } else { // ----------------------------------------------------- NOT NATIVE
+#ifdef JSPARSE_BYTECODE
+      JsVar *functionBytecode = jspeGetFunctionBytecode(function);
+      if (functionBytecode) {
+        int allocatedArgCount = 0;
+        if (isParsing) {
+          // parse the arguments into an array
+          unsigned int argPtrSize = 0;
+          argCount = 0;
+          while (!JSP_HAS_ERROR && lex->tk!=')' && lex->tk!=LEX_EOF) {
+            if ((unsigned)argCount>=argPtrSize) {
+              unsigned int newArgPtrSize = argPtrSize?argPtrSize*4:8;
+              JsVar **newArgPtr = (JsVar**)alloca(sizeof(JsVar*)*newArgPtrSize);
+              memcpy(newArgPtr, argPtr, (unsigned)argCount*sizeof(JsVar*));
+              argPtr = newArgPtr;
+              argPtrSize = newArgPtrSize;
+            }
+            argPtr[argCount++] = jsvSkipNameAndUnLock(jspeAssignmentExpression());
+            if (lex->tk!=')') JSP_MATCH_WITH_CLEANUP_AND_RETURN(',',jsvUnLockMany((unsigned)argCount, argPtr);jsvUnLock2(thisVar, functionBytecode);, 0);
+          }
+          JSP_MATCH_WITH_CLEANUP_AND_RETURN(')',jsvUnLockMany((unsigned)argCount, argPtr);jsvUnLock2(thisVar, functionBytecode);, 0);
+          allocatedArgCount = argCount;
+        }
+        if (!JSP_HAS_ERROR)
+          returnVar = jspeFunctionCallBytecode(function, functionName, functionBytecode, thisVar, argCount, argPtr);
+        jsvUnLockMany((unsigned)allocatedArgCount, argPtr);
+        jsvUnLock2(thisVar, functionBytecode);
+        return returnVar;
+      }
+#endif
       // create a new symbol table entry for execution of this function
       // OPT: can we cache this function execution environment + param variables?
       // OPT: Probably when calling a function ONCE, use it, otherwise when recursing, make new?
@@ -806,6 +995,9 @@ NO_INLINE JsVar *jspeFunctionCall(JsVar *function, JsVar *functionName, JsVar *t
             JsLex *oldLex = jslSetLex(&newLex);
             jslInit(functionCode);
             newLex.lineNumberOffset = functionLineNumber;
+#ifdef JSPROFILE_MAX_FUNCTIONS
+            if (jsprofRunning) jsprofFunctionEnter(function, functionName);
+#endif
             JSP_SAVE_EXECUTE();
             // force execute without any previous state
 #ifdef USE_DEBUGGER
@@ -853,22 +1045,16 @@ NO_INLINE JsVar *jspeFunctionCall(JsVar *function, JsVar *functionName, JsVar *t
             if (hadDebuggerNextLineOnly && !calledDebugger)
               execInfo.execute |= EXEC_DEBUGGER_NEXT_LINE;
 #endif
+#ifdef JSPROFILE_MAX_FUNCTIONS
+            if (jsprofRunning) jsprofFunctionExit();
+#endif
 
             jslKill();
             jslSetLex(oldLex);
 
             if (hasError) {
               execInfo.execute |= hasError; // propogate error
-              JsVar *stackTrace = jsvObjectGetChild(execInfo.hiddenRoot, JSPARSE_STACKTRACE_VAR, JSV_STRING_0);
-              if (stackTrace) {
-                jsvAppendPrintf(stackTrace, jsvIsString(functionName)?"in function %q called from ":
-                    "in function called from ", functionName);
-                if (lex) {
-                  jspAppendStackTrace(stackTrace);
-                } else
-                  jsvAppendPrintf(stackTrace, "system\n");
-                jsvUnLock(stackTrace);
-              }
+              jspeAppendCallerToStackTrace(functionName);
             }
           }
 
@@ -930,17 +1116,9 @@ JsVar *jspGetNamedVariable(const char *tokenName) {
   return a;
 }
 
-/// Used by jspGetNamedField / jspGetVarNamedField
-static NO_INLINE JsVar *jspGetNamedFieldInParents(JsVar *object, const char* name, bool returnName) {
-  // Now look in prototypes
-  JsVar * child = jspeiFindChildFromStringInParents(object, name);
-
-  /* Check for builtins via separate function
-   * This way we save on RAM for built-ins because everything comes out of program code */
-  if (!child) {
-    child = jswFindBuiltInFunction(object, name);
-  }
-
+/** Used by jspGetNamedFieldInParents. Given something we found in an object's
+ * prototypes or built-in functions, make a name for it on the object itself */
+static JsVar *jspNewChildFromParentField(JsVar *object, const char* name, JsVar *child) {
   /* We didn't get here if we found a child in the object itself, so
    * if we're here then we probably have the wrong name - so for example
    * with `a.b = c;` could end up setting `a.prototype.b` (bug #360)
@@ -949,33 +1127,52 @@ static NO_INLINE JsVar *jspGetNamedFieldInParents(JsVar *object, const char* nam
    * anyway - so in both cases, strip the name if it is there, and create
    * a new name.
    */
-  if (child && returnName) {
-    // Get rid of existing name
-    child = jsvSkipNameAndUnLock(child);
-    // create a new name
-    JsVar *nameVar = jsvNewFromString(name);
-    JsVar *newChild = jsvCreateNewChild(object, nameVar, child);
-    jsvUnLock2(nameVar, child);
-    child = newChild;
-  }
+  // Get rid of existing name
+  child = jsvSkipNameAndUnLock(child);
+  // create a new name
+  JsVar *nameVar = jsvNewFromString(name);
+  JsVar *newChild = jsvCreateNewChild(object, nameVar, child);
+  jsvUnLock2(nameVar, child);
+  return newChild;
+}
 
+/// Used by jspGetNamedFieldInParents when a field couldn't be found anywhere
+static JsVar *jspGetMissingField(JsVar *object, const char* name) {
+  JsVar *child = 0;
   // If not found and is the prototype, create it
-  if (!child) {
-    if (jsvIsFunction(object) && strcmp(name, JSPARSE_PROTOTYPE_VAR)==0) {
-      // prototype is supposed to be an object
-      JsVar *proto = jsvNewObject();
-      // make sure it has a 'constructor' variable that points to the object it was part of
-      jsvObjectSetChild(proto, JSPARSE_CONSTRUCTOR_VAR, object);
-      child = jsvAddNamedChild(object, proto, JSPARSE_PROTOTYPE_VAR);
-      jspEnsureIsPrototype(object, child);
-      jsvUnLock(proto);
-    } else if (strcmp(name, JSPARSE_INHERITS_VAR)==0) {
-      const char *objName = jswGetBasicObjectName(object);
-      if (objName) {
-        child = jspNewPrototype(objName);
-      }
+  if (jsvIsFunction(object) && strcmp(name, JSPARSE_PROTOTYPE_VAR)==0) {
+    // prototype is supposed to be an object
+    JsVar *proto = jsvNewObject();
+    // make sure it has a 'constructor' variable that points to the object it was part of
+    jsvObjectSetChild(proto, JSPARSE_CONSTRUCTOR_VAR, object);
+    child = jsvAddNamedChild(object, proto, JSPARSE_PROTOTYPE_VAR);
+    jspEnsureIsPrototype(object, child);
+    jsvUnLock(proto);
+  } else if (strcmp(name, JSPARSE_INHERITS_VAR)==0) {
+    const char *objName = jswGetBasicObjectName(object);
+    if (objName) {
+      child = jspNewPrototype(objName);
     }
   }
+  return child;
+}
+
+/// Used by jspGetNamedField / jspGetVarNamedField
+static NO_INLINE JsVar *jspGetNamedFieldInParents(JsVar *object, const char* name, bool returnName) {
+  // Now look in prototypes
+  JsVar * child = jspeiFindChildFromStringInParents(object, name);
+
+  /* Check for builtins via separate function
+   * This way we save on RAM for built-ins because everything comes out of program code */
+  if (!child) {
+    child = jswFindBuiltInFunction(object, name);
+  }
+
+  if (child && returnName)
+    child = jspNewChildFromParentField(object, name, child);
+
+  if (!child)
+    child = jspGetMissingField(object, name);
 
   return child;
 }
@@ -1009,6 +1206,52 @@ JsVar *jspGetNamedField(JsVar *object, const char* name, bool returnName) {
   else return jsvSkipNameAndUnLock(child);
 }
 
+#ifdef JSV_PROPERTY_CACHE_SIZE
+/** jspGetNamedField(object, name, true) for `object.name`, where `site`
+ * identifies the bit of code that's doing it. We remember where we found it,
+ * so that next time this code is run we don't have to search for it again. */
+NO_INLINE JsVar *jspGetNamedFieldAtSite(JsVar *object, const char* name, uint32_t site) {
+  if (!jsvHasChildren(object)) return jspGetNamedField(object, name, true);
+  // Identify what we're looking for
+  uint32_t key = site;
+  const char *c = name;
+  while (*c) key = key*31 + (unsigned char)*(c++);
+  if (!key) key = 1; // 0 means unused
+  JsVar *child = 0;
+  switch (jsvPropertyCacheGet(key, object, name, &child)) {
+    case JSVPC_OWN: return child;
+    case JSVPC_INHERITED: return jspNewChildFromParentField(object, name, child);
+    case JSVPC_BUILTIN:
+      child = jswFindBuiltInFunction(object, name);
+      if (child) return jspNewChildFromParentField(object, name, child);
+      break;
+    case JSVPC_NONE: break;
+  }
+  // Not remembered - so search like jspGetNamedField does
+  child = jsvFindChildFromString(object, name, false);
+  if (child) {
+    jsvPropertyCacheSet(key, object, name, JSVPC_OWN, child);
+    return child;
+  }
+  child = jspeiFindChildFromStringInParents(object, name);
+  if (child) {
+    jsvPropertyCacheSet(key, object, name, JSVPC_INHERITED, child);
+    return jspNewChildFromParentField(object, name, child);
+  }
+  child = jswFindBuiltInFunction(object, name);
+  if (child) {
+    jsvPropertyCacheSet(key, object, name, JSVPC_BUILTIN, 0);
+    return jspNewChildFromParentField(object, name, child);
+  }
+  return jspGetMissingField(object, name);
+}
+
+/// jspGetNamedFieldAtSite for `object.name` where the name is the current token
+static ALWAYS_INLINE JsVar *jspGetNamedFieldAtToken(JsVar *object, const char* name) {
+  return jspGetNamedFieldAtSite(object, name, (uint32_t)jsvGetRef(lex->sourceVar)*2654435761U + (uint32_t)jsvStringIteratorGetIndex(&lex->tokenStart.it));
+}
+#endif
+
 /// see jspGetNamedField - note that nameVar should have had jsvAsArrayIndex called on it first
 JsVar *jspGetVarNamedField(JsVar *object, JsVar *nameVar, bool returnName) {
 
@@ -1075,7 +1318,11 @@ NO_INLINE JsVar *jspeFactorMember(JsVar *a, JsVar **parentResult) {
           JsVar *aVar = jsvSkipName(a);
           JsVar *child = 0;
           if (aVar)
+#ifdef JSV_PROPERTY_CACHE_SIZE
+            child = jspGetNamedFieldAtToken(aVar, name);
+#else
             child = jspGetNamedField(aVar, name, true);
+#endif
           if (!child) {
             if (jsvHasChildren(aVar)) {
               // if no child found, create a pointer to where it could be
@@ -1138,7 +1385,7 @@ NO_INLINE JsVar *jspeFactorMember(JsVar *a, JsVar **parentResult) {
   return a;
 }
 
-NO_INLINE JsVar *jspeConstruct(JsVar *func, JsVar *funcName, bool hasArgs) {
+static NO_INLINE JsVar *jspeConstructInternal(JsVar *func, JsVar *funcName, bool isParsing, int argCount, JsVar **argPtr) {
   assert(JSP_SHOULD_EXECUTE);
   if (!jsvIsFunction(func)) {
     jsExceptionHere(JSET_ERROR, "Constructor should be a function, but is %t", func);
@@ -1153,7 +1400,7 @@ NO_INLINE JsVar *jspeConstruct(JsVar *func, JsVar *funcName, bool hasArgs) {
   JsVar *prototypeVar = jsvSkipName(prototypeName);
   jsvUnLock3(jsvAddNamedChild(thisObj, prototypeVar, JSPARSE_INHERITS_VAR), prototypeVar, prototypeName);
 
-  JsVar *a = jspeFunctionCall(func, funcName, thisObj, hasArgs, 0, 0);
+  JsVar *a = jspeFunctionCall(func, funcName, thisObj, isParsing, argCount, argPtr);
 
   /* FIXME: we should ignore return values that aren't objects (bug #848), but then we need
    * to be aware of `new String()` and `new Uint8Array()`. Ideally we'd let through
@@ -1172,6 +1419,15 @@ NO_INLINE JsVar *jspeConstruct(JsVar *func, JsVar *funcName, bool hasArgs) {
   return thisObj;
 }
 
+NO_INLINE JsVar *jspeConstruct(JsVar *func, JsVar *funcName, bool hasArgs) {
+  return jspeConstructInternal(func, funcName, hasArgs, 0, 0);
+}
+
+/// `new func(args...)` where the arguments have already been worked out
+JsVar *jspConstruct(JsVar *func, JsVar *funcName, int argCount, JsVar **argPtr) {
+  return jspeConstructInternal(func, funcName, false, argCount, argPtr);
+}
+
 NO_INLINE JsVar *jspeFactorFunctionCall() {
   /* The parent if we're executing a method call */
   bool isConstructor = false;
@@ -1569,6 +1825,13 @@ NO_INLINE JsVar *__jspePostfixExpression(JsVar *a) {
     int op = lex->tk;
     JSP_ASSERT_MATCH(op);
     if (JSP_SHOULD_EXECUTE) {
+      JsVarInt oldInt;
+      if (jsvIsName(a) && jsvMathsOpIntegerInPlace(a, 1, op==LEX_PLUSPLUS ? '+' : '-', &oldInt)) {
+        // it was an integer, and we could change it without allocating
+        jsvUnLock(a);
+        a = jsvNewFromInteger(oldInt);
+        continue;
+      }
       JsVar *one = jsvNewFromInteger(1);
       JsVar *oldValue = jsvAsNumberAndUnLock(jsvSkipName(a)); // keep the old value (but convert to number)
       JsVar *res = jsvMathsOpSkipNames(oldValue, one, op==LEX_PLUSPLUS ? '+' : '-');
@@ -1592,7 +1855,7 @@ NO_INLINE JsVar *jspePostfixExpression() {
     int op = lex->tk;
     JSP_ASSERT_MATCH(op);
     a = jspePostfixExpression();
-    if (JSP_SHOULD_EXECUTE) {
+    if (JSP_SHOULD_EXECUTE && !(jsvIsName(a) && jsvMathsOpIntegerInPlace(a, 1, op==LEX_PLUSPLUS ? '+' : '-', 0))) {
       JsVar *one = jsvNewFromInteger(1);
       JsVar *res = jsvMathsOpSkipNames(a, one, op==LEX_PLUSPLUS ? '+' : '-');
       jsvUnLock(one);
@@ -1661,6 +1924,54 @@ unsigned int jspeGetBinaryExpressionPrecedence(int op) {
   }
 }
 
+/// `needle in haystack` - returns a boolean, or undefined if there was an error
+JsVar *jspIn(JsVar *needle, JsVar *haystack) {
+  if (jsvIsArray(haystack) || jsvIsObject(haystack)) { // search keys, NOT values
+    JsVar *index = jsvAsArrayIndex(needle);
+    JsVar *varFound = jsvFindChildFromVar(haystack, index, false);
+    jsvUnLock(index);
+    bool found = varFound!=0;
+    jsvUnLock(varFound);
+    return jsvNewFromBool(found);
+  }
+  // else it will be undefined
+  jsExceptionHere(JSET_ERROR, "Cannot use 'in' operator to search a %t", haystack);
+  return 0;
+}
+
+/// `obj instanceof constructor`
+bool jspInstanceOf(JsVar *obj, JsVar *constructor) {
+  bool inst = false;
+  if (!jsvIsFunction(constructor)) {
+    jsExceptionHere(JSET_ERROR, "Expecting a function on RHS in instanceof check, got %t", constructor);
+    return false;
+  }
+  if (jsvIsObject(obj) || jsvIsFunction(obj)) {
+    JsVar *bproto = jspGetNamedField(constructor, JSPARSE_PROTOTYPE_VAR, false);
+    JsVar *proto = jsvObjectGetChild(obj, JSPARSE_INHERITS_VAR, 0);
+    while (proto) {
+      if (proto == bproto) inst=true;
+      // search prototype chain
+      JsVar *childProto = jsvObjectGetChild(proto, JSPARSE_INHERITS_VAR, 0);
+      jsvUnLock(proto);
+      proto = childProto;
+    }
+    if (jspIsConstructor(constructor, "Object")) inst = true;
+    jsvUnLock(bproto);
+  }
+  if (!inst) {
+    const char *name = jswGetBasicObjectName(obj);
+    if (name) {
+      inst = jspIsConstructor(constructor, name);
+    }
+    // Hack for built-ins that should also be instances of Object
+    if (!inst && (jsvIsArray(obj) || jsvIsArrayBuffer(obj)) &&
+        jspIsConstructor(constructor, "Object"))
+      inst = true;
+  }
+  return inst;
+}
+
 NO_INLINE JsVar *__jspeBinaryExpression(JsVar *a, unsigned int lastPrecedence) {
   /* This one's a bit strange. Basically all the ops have their own precedence, it's not
    * like & and | share the same precedence. We don't want to recurse for each one,
@@ -1697,49 +2008,13 @@ NO_INLINE JsVar *__jspeBinaryExpression(JsVar *a, unsigned int lastPrecedence) {
         if (op==LEX_R_IN) {
           JsVar *av = jsvSkipName(a); // needle
           JsVar *bv = jsvSkipName(b); // haystack
-          if (jsvIsArray(bv) || jsvIsObject(bv)) { // search keys, NOT values
-            av = jsvAsArrayIndexAndUnLock(av);
-            JsVar *varFound = jsvFindChildFromVar( bv, av, false);
-            jsvUnLock(a);
-            a = jsvNewFromBool(varFound!=0);
-            jsvUnLock(varFound);
-          } else {// else it will be undefined
-            jsExceptionHere(JSET_ERROR, "Cannot use 'in' operator to search a %t", bv);
-            jsvUnLock(a);
-            a = 0;
-          }
+          jsvUnLock(a);
+          a = jspIn(av, bv);
           jsvUnLock2(av, bv);
         } else if (op==LEX_R_INSTANCEOF) {
-          bool inst = false;
           JsVar *av = jsvSkipName(a);
           JsVar *bv = jsvSkipName(b);
-          if (!jsvIsFunction(bv)) {
-            jsExceptionHere(JSET_ERROR, "Expecting a function on RHS in instanceof check, got %t", bv);
-          } else {
-            if (jsvIsObject(av) || jsvIsFunction(av)) {
-              JsVar *bproto = jspGetNamedField(bv, JSPARSE_PROTOTYPE_VAR, false);
-              JsVar *proto = jsvObjectGetChild(av, JSPARSE_INHERITS_VAR, 0);
-              while (proto) {
-                if (proto == bproto) inst=true;
-                // search prototype chain
-                JsVar *childProto = jsvObjectGetChild(proto, JSPARSE_INHERITS_VAR, 0);
-                jsvUnLock(proto);
-                proto = childProto;
-              }
-              if (jspIsConstructor(bv, "Object")) inst = true;
-              jsvUnLock(bproto);
-            }
-            if (!inst) {
-              const char *name = jswGetBasicObjectName(av);
-              if (name) {
-                inst = jspIsConstructor(bv, name);
-              }
-              // Hack for built-ins that should also be instances of Object
-              if (!inst && (jsvIsArray(av) || jsvIsArrayBuffer(av)) &&
-                  jspIsConstructor(bv, "Object"))
-                inst = true;
-            }
-          }
+          bool inst = jspInstanceOf(av, bv);
           jsvUnLock3(av, bv, a);
           a = jsvNewFromBool(inst);
         } else {  // --------------------------------------------- NORMAL
@@ -1841,6 +2116,9 @@ NO_INLINE JsVar *__jspeAssignmentExpression(JsVar *lhs) {
           }
           jsvUnLock(currentValue);
         }
+        if (op && jsvIsName(lhs) && jsvIsSimpleInt(rhs) &&
+            jsvMathsOpIntegerInPlace(lhs, rhs->varData.integer, op, 0))
+          op = 0; // integer updated in place, nothing to allocate
         if (op) {
           /* Fallback which does a proper add */
           JsVar *res = jsvMathsOpSkipNames(lhs,rhs,op);
@@ -2469,6 +2747,16 @@ NO_INLINE JsVar *jspeStatement() {
     lex->tokenLastStart = jsvStringIteratorGetIndex(&lex->tokenStart.it)-1;
     jsiDebuggerLoop();
   }
+#endif
+#ifdef JSPROFILE_MAX_FUNCTIONS
+  if (jsprofSampling && JSP_SHOULD_EXECUTE)
+    jsprofSample(jsvStringIteratorGetIndex(&lex->tokenStart.it)-1);
+#endif
+#ifdef JSPARSE_BYTECODE
+  // Loops in code that's only run once get compiled - see if we can do that
+  if ((lex->tk==LEX_R_FOR || lex->tk==LEX_R_WHILE || lex->tk==LEX_R_DO) &&
+      jsbcExecuteLoop())
+    return 0;
 #endif
   if (lex->tk==LEX_ID ||
       lex->tk==LEX_INT ||
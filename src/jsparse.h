@@ -46,10 +46,14 @@ bool jspIsInterrupted();
 void jspSetInterrupted(bool interrupt);
 /// Has there been an error during parsing
 bool jspHasError();
+/// Check we have enough stack to recurse further - if not, report an error and return false
+bool jspCheckStackPosition();
 /// Set the error flag - set lineReported if we've already output the line number
 void jspSetError(bool lineReported);
 /// We had an exception (argument is the exception's value)
 void jspSetException(JsVar *value);
+/// Append the current position in the code (and a marker) to a stack trace
+void jspAppendStackTrace(JsVar *stackTrace);
 /** Return the reported exception if there was one (and clear it) */
 JsVar *jspGetException();
 /** Return a stack trace string if there was one (and clear it) */
@@ -190,6 +194,24 @@ JsVar *jspGetVarNamedField(JsVar *object, JsVar *nameVar, bool returnName);
 JsVar *jspCallNamedFunction(JsVar *object, char* name, int argCount, JsVar **argPtr);
 
 
+#ifdef JSV_PROPERTY_CACHE_SIZE
+/** jspGetNamedField(object, name, true) for `object.name`, where `site`
+ * identifies the bit of code that's doing it - so we can remember where
+ * we found it last time */
+JsVar *jspGetNamedFieldAtSite(JsVar *object, const char* name, uint32_t site);
+#endif
+
+/// `new func(args...)` where the arguments have already been worked out
+JsVar *jspConstruct(JsVar *func, JsVar *funcName, int argCount, JsVar **argPtr);
+/// `needle in haystack` - returns a boolean, or undefined if there was an error
+JsVar *jspIn(JsVar *needle, JsVar *haystack);
+/// `obj instanceof constructor`
+bool jspInstanceOf(JsVar *obj, JsVar *constructor);
+/// Get the precedence of a BinaryExpression - or return 0 if not one
+unsigned int jspeGetBinaryExpressionPrecedence(int op);
+/// Find a variable in the current (innermost) scope, optionally creating it
+JsVar *jspeiFindOnTop(const char *name, bool createIfNotFound);
+
 // These are exported for the Web IDE's compiler. See exportPtrs in jswrap_process.c
 JsVar *jspeiFindInScopes(const char *name);
 void jspReplaceWith(JsVar *dst, JsVar *src);
@@ -0,0 +1,328 @@
+/*
+ * This file is part of Espruino, a JavaScript interpreter for Microcontrollers
+ *
+ * Copyright (C) 2013 Gordon Williams <gw@pur3.co.uk>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * ----------------------------------------------------------------------------
+ * Execution profiler - records how many times each function is called and
+ * how long is spent in it, and (optionally) samples which line is running
+ * ----------------------------------------------------------------------------
+ */
+#include "jsprofile.h"
+#include "jslex.h"
+#include "jshardware.h"
+
+#ifdef JSPROFILE_MAX_FUNCTIONS
+
+/* Nothing here keeps hold of any JsVars (so the profiler can't stop anything
+ * being freed, and doesn't care about reset/load). Functions are identified by
+ * their ref (or native function pointer), and their names are copied when
+ * they're first called. */
+
+#define JSPROF_MAX_NODES (JSPROFILE_MAX_FUNCTIONS*2) ///< Different call stacks we record
+#define JSPROF_MAX_LINES (JSPROFILE_MAX_FUNCTIONS*2) ///< Different lines we record samples for
+#define JSPROF_MAX_DEPTH 32 ///< Calls deeper than this aren't recorded
+#define JSPROF_NAME_LENGTH 16
+#define JSPROF_NONE 255 ///< No function/node (because we ran out of space for it)
+#define JSPROF_TOP 254 ///< The code that isn't in any function
+
+/// A function that has been called
+typedef struct {
+  JsVarRef function; ///< The function, if it's not native
+  void *nativePtr; ///< The native function's pointer, if it is
+  uint16_t line; ///< The line the function was defined on (JSPARSE_FUNCTION_LINENUMBER_NAME), or 0
+  unsigned char active; ///< How many calls to it are in progress (so recursive calls don't get their time counted twice)
+  uint32_t calls;
+  JsSysTime time; ///< Time spent in the function, including functions it called
+  JsSysTime selfTime; ///< Time spent in the function itself
+  char name[JSPROF_NAME_LENGTH];
+} JsProfFunction;
+
+/// A call stack - a function, called from the call stack in 'parent'
+typedef struct {
+  unsigned char parent; ///< The node for the function that called this one, or JSPROF_NONE for top-level code
+  unsigned char function;
+  JsSysTime selfTime;
+} JsProfNode;
+
+/// A call that is in progress
+typedef struct {
+  unsigned char function;
+  unsigned char node;
+  JsSysTime start;
+  JsSysTime childTime; ///< Time spent in the functions it called
+} JsProfFrame;
+
+/// A line that has been sampled
+typedef struct {
+  unsigned char function; ///< The function the line is in, or JSPROF_TOP
+  uint16_t line;
+  uint32_t samples;
+} JsProfLine;
+
+bool jsprofRunning = false;
+bool jsprofSampling = false;
+
+static JsProfFunction jsprofFunctions[JSPROFILE_MAX_FUNCTIONS];
+static unsigned char jsprofFunctionCount;
+static JsProfNode jsprofNodes[JSPROF_MAX_NODES];
+static unsigned char jsprofNodeCount;
+static JsProfFrame jsprofStack[JSPROF_MAX_DEPTH];
+static unsigned int jsprofDepth; ///< How many calls are in progress (which may be more than JSPROF_MAX_DEPTH)
+static JsProfLine jsprofLines[JSPROF_MAX_LINES];
+static unsigned char jsprofLineCount;
+static uint32_t jsprofDroppedSamples; ///< Samples we couldn't record because jsprofLines was full
+static JsSysTime jsprofStartTime, jsprofEndTime; ///< When profiling started and stopped (or 0 if it's still going)
+static JsSysTime jsprofTopChildTime; ///< Time spent in functions called from top-level code
+static JsSysTime jsprofSampleInterval, jsprofNextSample;
+
+void jsprofStart(JsSysTime sampleInterval) {
+  jsprofFunctionCount = 0;
+  jsprofNodeCount = 0;
+  jsprofDepth = 0;
+  jsprofLineCount = 0;
+  jsprofDroppedSamples = 0;
+  jsprofTopChildTime = 0;
+  jsprofStartTime = jshGetSystemTime();
+  jsprofEndTime = 0;
+  jsprofSampleInterval = sampleInterval;
+  jsprofNextSample = jsprofStartTime + sampleInterval;
+  jsprofSampling = sampleInterval>0;
+  jsprofRunning = true;
+}
+
+void jsprofStop() {
+  if (!jsprofRunning) return;
+  jsprofEndTime = jshGetSystemTime();
+  // anything still running when we stopped has been running until now
+  while (jsprofDepth)
+    jsprofFunctionExit();
+  jsprofRunning = false;
+  jsprofSampling = false;
+}
+
+/// Find (or add) the function we're calling, or return JSPROF_NONE if there's no space
+static unsigned char jsprofFindFunction(JsVar *function, JsVar *functionName) {
+  JsVarRef ref = 0;
+  void *nativePtr = 0;
+  if (jsvIsNative(function))
+    nativePtr = jsvGetNativeFunctionPtr(function);
+  else
+    ref = jsvGetRef(function);
+  unsigned char i;
+  for (i=0;i<jsprofFunctionCount;i++)
+    if (jsprofFunctions[i].function==ref && jsprofFunctions[i].nativePtr==nativePtr)
+      return i;
+  if (jsprofFunctionCount>=JSPROFILE_MAX_FUNCTIONS) return JSPROF_NONE;
+  JsProfFunction *f = &jsprofFunctions[jsprofFunctionCount];
+  memset(f, 0, sizeof(JsProfFunction));
+  f->function = ref;
+  f->nativePtr = nativePtr;
+  if (ref) {
+    f->line = (uint16_t)jsvGetIntegerAndUnLock(jsvObjectGetChild(function, JSPARSE_FUNCTION_LINENUMBER_NAME, 0));
+    // use the function's own name (if it has one) if we weren't given one
+    if (!functionName)
+      functionName = jsvObjectGetChild(function, JSPARSE_FUNCTION_NAME_NAME, 0);
+    else
+      jsvLockAgain(functionName);
+  } else
+    jsvLockAgainSafe(functionName);
+  if (functionName) {
+    jsvGetString(functionName, f->name, JSPROF_NAME_LENGTH);
+    jsvUnLock(functionName);
+  } else
+    strncpy(f->name, nativePtr ? "(native)" : "(anonymous)", JSPROF_NAME_LENGTH);
+  return jsprofFunctionCount++;
+}
+
+/// Find (or add) the node for calling the given function from parent
+static unsigned char jsprofFindNode(unsigned char parent, unsigned char function) {
+  unsigned char i;
+  for (i=0;i<jsprofNodeCount;i++)
+    if (jsprofNodes[i].parent==parent && jsprofNodes[i].function==function)
+      return i;
+  if (jsprofNodeCount>=JSPROF_MAX_NODES) return JSPROF_NONE;
+  jsprofNodes[jsprofNodeCount].parent = parent;
+  jsprofNodes[jsprofNodeCount].function = function;
+  jsprofNodes[jsprofNodeCount].selfTime = 0;
+  return jsprofNodeCount++;
+}
+
+void jsprofFunctionEnter(JsVar *function, JsVar *functionName) {
+  if (jsprofDepth++ >= JSPROF_MAX_DEPTH) return;
+  JsProfFrame *frame = &jsprofStack[jsprofDepth-1];
+  frame->function = jsprofFindFunction(function, functionName);
+  unsigned char parent = (jsprofDepth>1) ? jsprofStack[jsprofDepth-2].node : JSPROF_NONE;
+  if (frame->function==JSPROF_NONE) {
+    frame->node = JSPROF_NONE;
+  } else {
+    jsprofFunctions[frame->function].calls++;
+    jsprofFunctions[frame->function].active++;
+    // if we didn't record our parent's node, we can't record ours either
+    frame->node = (jsprofDepth==1 || parent!=JSPROF_NONE) ? jsprofFindNode(parent, frame->function) : JSPROF_NONE;
+  }
+  frame->childTime = 0;
+  frame->start = jshGetSystemTime();
+}
+
+void jsprofFunctionExit() {
+  if (!jsprofDepth) return; // we started profiling from inside this function
+  if (jsprofDepth-- > JSPROF_MAX_DEPTH) return;
+  JsProfFrame *frame = &jsprofStack[jsprofDepth];
+  JsSysTime time = (jsprofEndTime ? jsprofEndTime : jshGetSystemTime()) - frame->start;
+  JsSysTime selfTime = time - frame->childTime;
+  if (frame->function!=JSPROF_NONE) {
+    JsProfFunction *f = &jsprofFunctions[frame->function];
+    f->active--;
+    if (!f->active) f->time += time; // the outermost call includes the time of any recursive ones
+    f->selfTime += selfTime;
+  }
+  if (frame->node!=JSPROF_NONE)
+    jsprofNodes[frame->node].selfTime += selfTime;
+  if (jsprofDepth)
+    jsprofStack[jsprofDepth-1].childTime += time;
+  else
+    jsprofTopChildTime += time;
+}
+
+void jsprofSample(size_t tokenPos) {
+  JsSysTime time = jshGetSystemTime();
+  if (time < jsprofNextSample || !lex || !lex->sourceVar) return;
+  jsprofNextSample = time + jsprofSampleInterval;
+  size_t line, col;
+  jsvGetLineAndCol(lex->sourceVar, tokenPos, &line, &col);
+  if (lex->lineNumberOffset)
+    line += (size_t)lex->lineNumberOffset - 1;
+  unsigned char function = JSPROF_TOP;
+  if (jsprofDepth)
+    function = (jsprofDepth <= JSPROF_MAX_DEPTH) ? jsprofStack[jsprofDepth-1].function : JSPROF_NONE;
+  if (function==JSPROF_NONE) {
+    jsprofDroppedSamples++;
+    return;
+  }
+  unsigned char i;
+  for (i=0;i<jsprofLineCount;i++) {
+    if (jsprofLines[i].function==function && jsprofLines[i].line==line) {
+      jsprofLines[i].samples++;
+      return;
+    }
+  }
+  if (jsprofLineCount>=JSPROF_MAX_LINES) {
+    jsprofDroppedSamples++;
+    return;
+  }
+  jsprofLines[jsprofLineCount].function = function;
+  jsprofLines[jsprofLineCount].line = (uint16_t)line;
+  jsprofLines[jsprofLineCount].samples = 1;
+  jsprofLineCount++;
+}
+
+static JsSysTime jsprofGetTotalTime() {
+  return (jsprofEndTime ? jsprofEndTime : jshGetSystemTime()) - jsprofStartTime;
+}
+
+static JsVar *jsprofNewFromTime(JsSysTime time) {
+  return jsvNewFromFloat(jshGetMillisecondsFromTime(time));
+}
+
+static const char *jsprofGetFunctionName(unsigned char function) {
+  return (function==JSPROF_TOP) ? "(top)" : jsprofFunctions[function].name;
+}
+
+/// Insertion sort of indices, biggest first
+static void jsprofSortIndices(unsigned char *indices, int count, JsSysTime (*getValue)(unsigned char)) {
+  int i, j;
+  for (i=0;i<count;i++) indices[i] = (unsigned char)i;
+  for (i=1;i<count;i++) {
+    unsigned char idx = indices[i];
+    JsSysTime value = getValue(idx);
+    for (j=i; j>0 && getValue(indices[j-1])<value; j--)
+      indices[j] = indices[j-1];
+    indices[j] = idx;
+  }
+}
+static JsSysTime jsprofGetFunctionSelfTime(unsigned char i) { return jsprofFunctions[i].selfTime; }
+static JsSysTime jsprofGetLineSamples(unsigned char i) { return jsprofLines[i].samples; }
+
+JsVar *jsprofGetProfile() {
+  if (!jsprofStartTime) return 0; // never started
+  JsVar *obj = jsvNewObject();
+  if (!obj) return 0;
+  jsvObjectSetChildAndUnLock(obj, "time", jsprofNewFromTime(jsprofGetTotalTime()));
+  jsvObjectSetChildAndUnLock(obj, "topTime", jsprofNewFromTime(jsprofGetTotalTime() - jsprofTopChildTime));
+  unsigned char order[JSPROF_MAX_LINES];
+  int i;
+  JsVar *functions = jsvNewEmptyArray();
+  if (functions) {
+    jsprofSortIndices(order, jsprofFunctionCount, jsprofGetFunctionSelfTime);
+    for (i=0;i<jsprofFunctionCount;i++) {
+      JsProfFunction *f = &jsprofFunctions[order[i]];
+      JsVar *o = jsvNewObject();
+      if (!o) break;
+      jsvObjectSetChildAndUnLock(o, "name", jsvNewFromString(f->name));
+      if (f->line) jsvObjectSetChildAndUnLock(o, "line", jsvNewFromInteger(f->line));
+      jsvObjectSetChildAndUnLock(o, "calls", jsvNewFromInteger((JsVarInt)f->calls));
+      jsvObjectSetChildAndUnLock(o, "time", jsprofNewFromTime(f->time));
+      jsvObjectSetChildAndUnLock(o, "selfTime", jsprofNewFromTime(f->selfTime));
+      jsvArrayPushAndUnLock(functions, o);
+    }
+    jsvObjectSetChildAndUnLock(obj, "functions", functions);
+  }
+  if (jsprofSampleInterval) {
+    JsVar *lines = jsvNewEmptyArray();
+    if (lines) {
+      jsprofSortIndices(order, jsprofLineCount, jsprofGetLineSamples);
+      for (i=0;i<jsprofLineCount;i++) {
+        JsProfLine *l = &jsprofLines[order[i]];
+        JsVar *o = jsvNewObject();
+        if (!o) break;
+        jsvObjectSetChildAndUnLock(o, "function", jsvNewFromString(jsprofGetFunctionName(l->function)));
+        jsvObjectSetChildAndUnLock(o, "line", jsvNewFromInteger(l->line));
+        jsvObjectSetChildAndUnLock(o, "samples", jsvNewFromInteger((JsVarInt)l->samples));
+        jsvArrayPushAndUnLock(lines, o);
+      }
+      jsvObjectSetChildAndUnLock(obj, "lines", lines);
+    }
+    if (jsprofDroppedSamples)
+      jsvObjectSetChildAndUnLock(obj, "droppedSamples", jsvNewFromInteger((JsVarInt)jsprofDroppedSamples));
+  }
+  return obj;
+}
+
+/// Append the names of the functions in the call stack for this node, separated by ';'
+static void jsprofAppendNodeStack(JsVar *str, unsigned char node) {
+  if (jsprofNodes[node].parent!=JSPROF_NONE) {
+    jsprofAppendNodeStack(str, jsprofNodes[node].parent);
+  } else {
+    jsvAppendString(str, jsprofGetFunctionName(JSPROF_TOP));
+  }
+  JsProfFunction *f = &jsprofFunctions[jsprofNodes[node].function];
+  if (f->line)
+    jsvAppendPrintf(str, ";%s:%d", f->name, f->line);
+  else
+    jsvAppendPrintf(str, ";%s", f->name);
+}
+
+static int jsprofGetMicroseconds(JsSysTime time) {
+  JsVarFloat us = jshGetMillisecondsFromTime(time)*1000;
+  return (us < 0x7FFFFFFF) ? (int)us : 0x7FFFFFFF;
+}
+
+JsVar *jsprofGetFoldedStacks() {
+  if (!jsprofStartTime) return 0; // never started
+  JsVar *str = jsvNewFromEmptyString();
+  if (!str) return 0;
+  jsvAppendPrintf(str, "%s %d\n", jsprofGetFunctionName(JSPROF_TOP), jsprofGetMicroseconds(jsprofGetTotalTime() - jsprofTopChildTime));
+  unsigned char i;
+  for (i=0;i<jsprofNodeCount;i++) {
+    jsprofAppendNodeStack(str, i);
+    jsvAppendPrintf(str, " %d\n", jsprofGetMicroseconds(jsprofNodes[i].selfTime));
+  }
+  return str;
+}
+
+#endif
@@ -0,0 +1,46 @@
+/*
+ * This file is part of Espruino, a JavaScript interpreter for Microcontrollers
+ *
+ * Copyright (C) 2013 Gordon Williams <gw@pur3.co.uk>
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ * ----------------------------------------------------------------------------
+ * Execution profiler - records how many times each function is called and
+ * how long is spent in it, and (optionally) samples which line is running
+ * ----------------------------------------------------------------------------
+ */
+#ifndef JSPROFILE_H_
+#define JSPROFILE_H_
+
+#include "jsutils.h"
+#include "jsvar.h"
+
+#ifdef JSPROFILE_MAX_FUNCTIONS
+
+extern bool jsprofRunning; ///< Are we profiling? (check this before calling jsprofFunctionEnter/Exit)
+extern bool jsprofSampling; ///< Are we sampling lines? (check this before calling jsprofSample)
+
+/// Clear any old results and start profiling. If sampleInterval isn't 0, also sample which line is running that often
+void jsprofStart(JsSysTime sampleInterval);
+/// Stop profiling (the results are kept until the next jsprofStart)
+void jsprofStop();
+
+/// Called when a function (native or not) is about to be executed. functionName may be 0
+void jsprofFunctionEnter(JsVar *function, JsVar *functionName);
+/// Called when the function from the last jsprofFunctionEnter has finished
+void jsprofFunctionExit();
+/** Called at the start of each statement with its position in the
+ * code the current lexer is on - records a sample if one is due */
+void jsprofSample(size_t tokenPos);
+
+/// Return the results as an object (see E.getProfile)
+JsVar *jsprofGetProfile();
+/// Return the results as 'folded stacks' text (one line per call stack, with the time in it in microseconds)
+JsVar *jsprofGetFoldedStacks();
+
+#endif
+
+#endif /* JSPROFILE_H_ */
@@ -335,6 +335,18 @@ bool jstGetLastBufferTimerTask(JsVar *var, UtilTimerTask *task) {
   JsVarRef ref = jsvGetRef(var);
   return utilTimerGetLastTask(jstBufferTaskChecker, (void*)&ref, task);
 }
+
+// data = unused
+static bool jstAnyBufferTaskChecker(UtilTimerTask *task, void *data) {
+  NOT_USED(data);
+  return UET_IS_BUFFER_EVENT(task->type);
+}
+
+/// Return true if any timer tasks are reading from or writing to variables
+bool jstHasBufferTimerTasks() {
+  UtilTimerTask task;
+  return utilTimerGetLastTask(jstAnyBufferTaskChecker, 0, &task);
+}
 #endif
 
 bool jstPinOutputAtTime(JsSysTime time, Pin *pins, int pinCount, uint8_t value) {
@@ -23,6 +23,16 @@
  * but which are good to know about */
 JsErrorFlags jsErrorFlags;
 
+/// Flags that change how Espruino works - see E.setFlags
+JsFlags jsFlags = JSF_NONE
+#ifdef JSLEX_PRETOKENISE
+  | JSF_PRETOKENISE
+#endif
+#ifdef JSPARSE_BYTECODE
+  | JSF_BYTECODE
+#endif
+  ;
+
 
 bool isWhitespace(char ch) {
     return (ch==0x09) || // \t - tab
@@ -475,6 +485,419 @@ unsigned char *flash_memcpy(unsigned char *dst, const unsigned char *src, size_t
 #endif
 
 
+#ifdef FLOAT_ROUNDTRIP
+/* Conversion between doubles and decimal.
+ *
+ * Numbers are printed with Grisu2 (Florian Loitsch, "Printing Floating-Point
+ * Numbers Quickly and Accurately with Integers"), which always gives digits that
+ * read back as exactly the same double, and almost always the fewest digits that
+ * will do that.
+ *
+ * Decimal numbers are read with the same table of powers of 10 to get within a
+ * few bits of the answer, and if that isn't enough to know which way to round,
+ * the number is compared exactly with the half way point using big integers. */
+
+/// A floating point number with a 64 bit mantissa - f * 2^e
+typedef struct {
+  uint64_t f;
+  int e;
+} FpExt;
+
+/// 10^(-348+8*i) as normalised 64 bit mantissas (rounded)...
+static const uint64_t fpPowersOf10F[] = {
+  0xfa8fd5a0081c0288ULL, 0xbaaee17fa23ebf76ULL, 0x8b16fb203055ac76ULL,
+  0xcf42894a5dce35eaULL, 0x9a6bb0aa55653b2dULL, 0xe61acf033d1a45dfULL,
+  0xab70fe17c79ac6caULL, 0xff77b1fcbebcdc4fULL, 0xbe5691ef416bd60cULL,
+  0x8dd01fad907ffc3cULL, 0xd3515c2831559a83ULL, 0x9d71ac8fada6c9b5ULL,
+  0xea9c227723ee8bcbULL, 0xaecc49914078536dULL, 0x823c12795db6ce57ULL,
+  0xc21094364dfb5637ULL, 0x9096ea6f3848984fULL, 0xd77485cb25823ac7ULL,
+  0xa086cfcd97bf97f4ULL, 0xef340a98172aace5ULL, 0xb23867fb2a35b28eULL,
+  0x84c8d4dfd2c63f3bULL, 0xc5dd44271ad3cdbaULL, 0x936b9fcebb25c996ULL,
+  0xdbac6c247d62a584ULL, 0xa3ab66580d5fdaf6ULL, 0xf3e2f893dec3f126ULL,
+  0xb5b5ada8aaff80b8ULL, 0x87625f056c7c4a8bULL, 0xc9bcff6034c13053ULL,
+  0x964e858c91ba2655ULL, 0xdff9772470297ebdULL, 0xa6dfbd9fb8e5b88fULL,
+  0xf8a95fcf88747d94ULL, 0xb94470938fa89bcfULL, 0x8a08f0f8bf0f156bULL,
+  0xcdb02555653131b6ULL, 0x993fe2c6d07b7facULL, 0xe45c10c42a2b3b06ULL,
+  0xaa242499697392d3ULL, 0xfd87b5f28300ca0eULL, 0xbce5086492111aebULL,
+  0x8cbccc096f5088ccULL, 0xd1b71758e219652cULL, 0x9c40000000000000ULL,
+  0xe8d4a51000000000ULL, 0xad78ebc5ac620000ULL, 0x813f3978f8940984ULL,
+  0xc097ce7bc90715b3ULL, 0x8f7e32ce7bea5c70ULL, 0xd5d238a4abe98068ULL,
+  0x9f4f2726179a2245ULL, 0xed63a231d4c4fb27ULL, 0xb0de65388cc8ada8ULL,
+  0x83c7088e1aab65dbULL, 0xc45d1df942711d9aULL, 0x924d692ca61be758ULL,
+  0xda01ee641a708deaULL, 0xa26da3999aef774aULL, 0xf209787bb47d6b85ULL,
+  0xb454e4a179dd1877ULL, 0x865b86925b9bc5c2ULL, 0xc83553c5c8965d3dULL,
+  0x952ab45cfa97a0b3ULL, 0xde469fbd99a05fe3ULL, 0xa59bc234db398c25ULL,
+  0xf6c69a72a3989f5cULL, 0xb7dcbf5354e9beceULL, 0x88fcf317f22241e2ULL,
+  0xcc20ce9bd35c78a5ULL, 0x98165af37b2153dfULL, 0xe2a0b5dc971f303aULL,
+  0xa8d9d1535ce3b396ULL, 0xfb9b7cd9a4a7443cULL, 0xbb764c4ca7a44410ULL,
+  0x8bab8eefb6409c1aULL, 0xd01fef10a657842cULL, 0x9b10a4e5e9913129ULL,
+  0xe7109bfba19c0c9dULL, 0xac2820d9623bf429ULL, 0x80444b5e7aa7cf85ULL,
+  0xbf21e44003acdd2dULL, 0x8e679c2f5e44ff8fULL, 0xd433179d9c8cb841ULL,
+  0x9e19db92b4e31ba9ULL, 0xeb96bf6ebadf77d9ULL, 0xaf87023b9bf0ee6bULL,
+};
+/// ... and their binary exponents
+static const int16_t fpPowersOf10E[] = {
+  -1220, -1193, -1166, -1140, -1113, -1087, -1060, -1034, -1007, -980, -954, -927,
+  -901, -874, -847, -821, -794, -768, -741, -715, -688, -661, -635, -608,
+  -582, -555, -529, -502, -475, -449, -422, -396, -369, -343, -316, -289,
+  -263, -236, -210, -183, -157, -130, -103, -77, -50, -24, 3, 30,
+  56, 83, 109, 136, 162, 189, 216, 242, 269, 295, 322, 348,
+  375, 402, 428, 455, 481, 508, 534, 561, 588, 614, 641, 667,
+  694, 720, 747, 774, 800, 827, 853, 880, 907, 933, 960, 986,
+  1013, 1039, 1066,
+};
+/// 10^i that fit in 64 bit integers
+static const uint64_t fpPowersOf10Int[] = {
+  1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL, 10000000ULL, 100000000ULL, 1000000000ULL,
+  10000000000ULL, 100000000000ULL, 1000000000000ULL, 10000000000000ULL, 100000000000000ULL,
+  1000000000000000ULL, 10000000000000000ULL, 100000000000000000ULL, 1000000000000000000ULL, 10000000000000000000ULL
+};
+/// 10^i that can be stored exactly in a double
+static const double fpPowersOf10Exact[] = {
+  1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+  1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+#define FP_HIDDEN_BIT 0x0010000000000000ULL
+#define FP_MANTISSA_MASK 0x000FFFFFFFFFFFFFULL
+
+/// Shift so the top bit of the mantissa is set (x.f must not be 0)
+static FpExt fpNormalise(FpExt x) {
+  int s = __builtin_clzll(x.f);
+  x.f <<= s;
+  x.e -= s;
+  return x;
+}
+
+/// Multiply, keeping the top 64 bits of the mantissa (rounded)
+static FpExt fpMultiply(FpExt x, FpExt y) {
+  uint64_t a = x.f >> 32, b = x.f & 0xFFFFFFFF;
+  uint64_t c = y.f >> 32, d = y.f & 0xFFFFFFFF;
+  uint64_t ac = a*c, bc = b*c, ad = a*d, bd = b*d;
+  uint64_t tmp = (bd >> 32) + (ad & 0xFFFFFFFF) + (bc & 0xFFFFFFFF);
+  tmp += 1U << 31; // round
+  FpExt r;
+  r.f = ac + (ad >> 32) + (bc >> 32) + (tmp >> 32);
+  r.e = x.e + y.e + 64;
+  return r;
+}
+
+/// Get 10^-k from the table, such that multiplying a number with binary exponent e by it gives an exponent that Grisu2 can use
+static FpExt fpGetCachedPower(int e, int *k) {
+  double dk = (-61 - e) * 0.30102999566398114 + 347; // log10(2), offset so dk is always positive
+  int ik = (int)dk;
+  if (dk - ik > 0.0) ik++;
+  unsigned int index = (unsigned int)((ik >> 3) + 1);
+  *k = -(-348 + (int)(index << 3));
+  FpExt r;
+  r.f = fpPowersOf10F[index];
+  r.e = fpPowersOf10E[index];
+  return r;
+}
+
+/// Move the last digit closer to w if we can while staying inside the range that reads back as the same number
+static void fpGrisuRound(char *buf, int len, uint64_t delta, uint64_t rest, uint64_t tenKappa, uint64_t wpw) {
+  while (rest < wpw && delta - rest >= tenKappa &&
+         (rest + tenKappa < wpw || wpw - rest > rest + tenKappa - wpw)) {
+    buf[len - 1]--;
+    rest += tenKappa;
+  }
+}
+
+/// Generate the digits of w, stopping as soon as what we have is inside (mp-delta .. mp)
+static int fpDigitGen(FpExt w, FpExt mp, uint64_t delta, char *buf, int *k) {
+  int oneE = -mp.e;
+  uint64_t one = ((uint64_t)1) << oneE;
+  uint64_t wpw = mp.f - w.f;
+  uint32_t p1 = (uint32_t)(mp.f >> oneE);
+  uint64_t p2 = mp.f & (one - 1);
+  int kappa = 10;
+  while (kappa>1 && p1 < fpPowersOf10Int[kappa-1]) kappa--;
+  int len = 0;
+  while (kappa > 0) {
+    uint32_t pow = (uint32_t)fpPowersOf10Int[kappa-1];
+    uint32_t d = p1 / pow;
+    p1 %= pow;
+    if (d || len) buf[len++] = (char)('0' + d);
+    kappa--;
+    uint64_t tmp = (((uint64_t)p1) << oneE) + p2;
+    if (tmp <= delta) {
+      *k += kappa;
+      fpGrisuRound(buf, len, delta, tmp, fpPowersOf10Int[kappa] << oneE, wpw);
+      return len;
+    }
+  }
+  while (true) {
+    p2 *= 10;
+    delta *= 10;
+    char d = (char)(p2 >> oneE);
+    if (d || len) buf[len++] = (char)('0' + d);
+    p2 &= one - 1;
+    kappa--;
+    if (p2 < delta) {
+      *k += kappa;
+      int index = -kappa;
+      fpGrisuRound(buf, len, delta, p2, one, wpw * (index < 20 ? fpPowersOf10Int[index] : 0));
+      return len;
+    }
+  }
+}
+
+/** Write the shortest digits for val (which must be finite and >0) to buf (which
+ * must have space for 18). Returns how many there are - val = digits * 10^k */
+static int fpGrisu2(double val, char *buf, int *k) {
+  union { double d; uint64_t u; } u;
+  u.d = val;
+  int biasedE = (int)((u.u >> 52) & 0x7FF);
+  FpExt v;
+  v.f = u.u & FP_MANTISSA_MASK;
+  if (biasedE) {
+    v.f += FP_HIDDEN_BIT;
+    v.e = biasedE - 1075;
+  } else
+    v.e = 1 - 1075;
+  // the points half way between val and the doubles either side of it
+  FpExt mPlus, mMinus;
+  mPlus.f = (v.f << 1) + 1;
+  mPlus.e = v.e - 1;
+  mPlus = fpNormalise(mPlus);
+  if (v.f == FP_HIDDEN_BIT) { // the double below is closer
+    mMinus.f = (v.f << 2) - 1;
+    mMinus.e = v.e - 2;
+  } else {
+    mMinus.f = (v.f << 1) - 1;
+    mMinus.e = v.e - 1;
+  }
+  mMinus.f <<= mMinus.e - mPlus.e;
+  mMinus.e = mPlus.e;
+  // scale everything so we can get the digits out with integer maths
+  FpExt c = fpGetCachedPower(mPlus.e, k);
+  FpExt w = fpMultiply(fpNormalise(v), c);
+  FpExt wPlus = fpMultiply(mPlus, c);
+  FpExt wMinus = fpMultiply(mMinus, c);
+  wMinus.f++;
+  wPlus.f--;
+  return fpDigitGen(w, wPlus, wPlus.f - wMinus.f, buf, k);
+}
+
+static double fpDecimalToDouble(const char *digits, int nDigits, int e, bool truncated);
+
+/** Write val (which must be finite and >0) to str (of size len) in the fewest
+ * digits that read back as the same number, formatted like JS's Number.toString */
+static void fpToShortestString(double val, char *str, size_t len) {
+  char digits[20];
+  char buf[32];
+  int k;
+  int nDigits = fpGrisu2(val, digits, &k);
+  /* Grisu2 very occasionally gives more digits than it needs to, when a much
+   * shorter number is right on the edge of the range it checks (eg.
+   * 72.21064200000001 rather than 72.210642). If it looks like that's
+   * happened, see if rounding to 15 digits still reads back the same. */
+  int i;
+  if (nDigits > 15) {
+    char c = digits[12];
+    for (i=12;i<nDigits-1 && digits[i]==c;i++);
+    if ((c=='0' || c=='9') && i==nDigits-1) {
+      char rounded[15];
+      int n = 15, e = k + nDigits - 15;
+      memcpy(rounded, digits, 15);
+      if (digits[15] >= '5') { // round up
+        for (i=14;i>=0 && rounded[i]=='9';i--) rounded[i] = '0';
+        if (i>=0) rounded[i]++;
+        else { // 999 -> 1000
+          rounded[0] = '1';
+          e += 15;
+          n = 1;
+        }
+      }
+      while (n>1 && rounded[n-1]=='0') { // remove trailing zeros
+        n--;
+        e++;
+      }
+      if (fpDecimalToDouble(rounded, n, e, false) == val) {
+        memcpy(digits, rounded, (size_t)n);
+        nDigits = n;
+        k = e;
+      }
+    }
+  }
+  int n = nDigits + k; // where the decimal point goes
+  int j = 0;
+  if (nDigits <= n && n <= 21) { // integer - digits then zeros
+    for (i=0;i<nDigits;i++) buf[j++] = digits[i];
+    for (;i<n;i++) buf[j++] = '0';
+  } else if (0 < n && n <= 21) { // decimal point within the digits
+    for (i=0;i<nDigits;i++) {
+      if (i==n) buf[j++] = '.';
+      buf[j++] = digits[i];
+    }
+  } else if (-6 < n && n <= 0) { // 0.000ddd
+    buf[j++] = '0';
+    buf[j++] = '.';
+    for (i=n;i<0;i++) buf[j++] = '0';
+    for (i=0;i<nDigits;i++) buf[j++] = digits[i];
+  } else { // d.ddde+n
+    buf[j++] = digits[0];
+    if (nDigits>1) {
+      buf[j++] = '.';
+      for (i=1;i<nDigits;i++) buf[j++] = digits[i];
+    }
+    buf[j++] = 'e';
+    buf[j++] = (n-1 < 0) ? '-' : '+';
+    itostr((n-1 < 0) ? 1-n : n-1, &buf[j], 10);
+    j += (int)strlen(&buf[j]);
+  }
+  buf[j] = 0;
+  // copy, with bounds checking
+  for (i=0;buf[i] && (size_t)i+1<len;i++) str[i] = buf[i];
+  if (len) str[i] = 0;
+}
+
+/// Big integers for exact comparisons when reading numbers (least significant word first)
+#define FP_MAX_DIGITS 40 ///< How many significant digits we keep when reading numbers - any more are only used to break an exact tie
+#define FP_BIGNUM_WORDS 42 // 10^364 * 2^54, the largest we need, is 1264 bits
+typedef struct {
+  uint32_t w[FP_BIGNUM_WORDS];
+  int n;
+} FpBigNum;
+
+static void fpBigNumSet(FpBigNum *b, uint64_t v) {
+  b->w[0] = (uint32_t)v;
+  b->w[1] = (uint32_t)(v >> 32);
+  b->n = b->w[1] ? 2 : (b->w[0] ? 1 : 0);
+}
+
+static void fpBigNumMulAdd(FpBigNum *b, uint32_t m, uint32_t add) {
+  uint64_t carry = add;
+  int i;
+  for (i=0;i<b->n;i++) {
+    carry += (uint64_t)b->w[i] * m;
+    b->w[i] = (uint32_t)carry;
+    carry >>= 32;
+  }
+  if (carry) {
+    assert(b->n < FP_BIGNUM_WORDS);
+    b->w[b->n++] = (uint32_t)carry;
+  }
+}
+
+static void fpBigNumMulPow10(FpBigNum *b, int e) {
+  while (e>=9) {
+    fpBigNumMulAdd(b, 1000000000, 0);
+    e -= 9;
+  }
+  if (e) fpBigNumMulAdd(b, (uint32_t)fpPowersOf10Int[e], 0);
+}
+
+static void fpBigNumShiftLeft(FpBigNum *b, int bits) {
+  int words = bits >> 5;
+  int i;
+  bits &= 31;
+  if (bits) {
+    uint32_t carry = 0;
+    for (i=0;i<b->n;i++) {
+      uint32_t w = b->w[i];
+      b->w[i] = (w << bits) | carry;
+      carry = w >> (32-bits);
+    }
+    if (carry) {
+      assert(b->n < FP_BIGNUM_WORDS);
+      b->w[b->n++] = carry;
+    }
+  }
+  if (words) {
+    assert(b->n+words <= FP_BIGNUM_WORDS);
+    for (i=b->n-1;i>=0;i--) b->w[i+words] = b->w[i];
+    for (i=0;i<words;i++) b->w[i] = 0;
+    b->n += words;
+  }
+}
+
+static int fpBigNumCompare(const FpBigNum *a, const FpBigNum *b) {
+  if (a->n != b->n) return (a->n < b->n) ? -1 : 1;
+  int i;
+  for (i=a->n-1;i>=0;i--)
+    if (a->w[i] != b->w[i]) return (a->w[i] < b->w[i]) ? -1 : 1;
+  return 0;
+}
+
+/** Return the double nearest to digits * 10^e, where digits is nDigits ASCII
+ * digits (the first not 0). If `truncated` is set, there were more non-zero
+ * digits after these that didn't fit */
+static double fpDecimalToDouble(const char *digits, int nDigits, int e, bool truncated) {
+  if (!nDigits) return 0;
+  // the first 19 digits fit in a 64 bit integer
+  int mDigits = (nDigits<19) ? nDigits : 19;
+  uint64_t m = 0;
+  int i;
+  for (i=0;i<mDigits;i++) m = m*10 + (uint64_t)(digits[i]-'0');
+  int mExp = e + nDigits - mDigits;
+  bool mExact = !truncated && mDigits==nDigits;
+  // the mantissa and power of 10 are both exact as doubles, so one multiply/divide rounds correctly
+  if (mExact && m <= (((uint64_t)1) << 53) && mExp >= -22 && mExp <= 22)
+    return (mExp<0) ? (double)m / fpPowersOf10Exact[-mExp] : (double)m * fpPowersOf10Exact[mExp];
+  if (e + nDigits > 310) return INFINITY;
+  if (e + nDigits < -324) return 0;
+  // get within a few bits with the table - 10^mExp = 10^(-348+8*index) * 10^rem
+  int index = (mExp + 348) >> 3;
+  int rem = (mExp + 348) & 7;
+  FpExt v, p;
+  v.f = m;
+  v.e = 0;
+  p.f = fpPowersOf10F[index];
+  p.e = fpPowersOf10E[index];
+  v = fpNormalise(fpMultiply(fpNormalise(v), p));
+  if (rem) {
+    p.f = fpPowersOf10Int[rem];
+    p.e = 0;
+    v = fpNormalise(fpMultiply(v, fpNormalise(p)));
+  }
+  // now round to 53 bits (or fewer if it's denormal)
+  int shift = 11;
+  int exp = v.e + 11;
+  if (exp < -1074) {
+    shift += -1074 - exp;
+    exp = -1074;
+  }
+  if (shift > 64) return 0;
+  uint64_t mant = (shift==64) ? 0 : v.f >> shift;
+  uint64_t rest = (shift==64) ? v.f : v.f & ((((uint64_t)1) << shift) - 1);
+  uint64_t half = ((uint64_t)1) << (shift-1);
+  const uint64_t maxError = 32; // how far out the multiplications (and any digits after the first 19) could have made us
+  if (rest + maxError >= half && rest <= half + maxError) {
+    // too close to half way to know - compare digits * 10^e with (mant+0.5) * 2^exp exactly
+    FpBigNum a, b;
+    fpBigNumSet(&a, 0);
+    for (i=0;i<nDigits;i+=9) {
+      int chunk = (nDigits-i < 9) ? nDigits-i : 9;
+      uint32_t n = 0;
+      int j;
+      for (j=0;j<chunk;j++) n = n*10 + (uint32_t)(digits[i+j]-'0');
+      fpBigNumMulAdd(&a, (uint32_t)fpPowersOf10Int[chunk], n);
+    }
+    fpBigNumSet(&b, mant*2 + 1);
+    if (e >= 0) fpBigNumMulPow10(&a, e);
+    else fpBigNumMulPow10(&b, -e);
+    if (exp-1 >= 0) fpBigNumShiftLeft(&b, exp-1);
+    else fpBigNumShiftLeft(&a, 1-exp);
+    int cmp = fpBigNumCompare(&a, &b);
+    if (cmp>0 || (cmp==0 && (truncated || (mant&1)))) mant++; // exactly half way rounds to even
+  } else if (rest > half) mant++;
+  if (mant == (FP_HIDDEN_BIT << 1)) { // rounded up past 53 bits
+    mant >>= 1;
+    exp++;
+  }
+  union { double d; uint64_t u; } u;
+  if (mant < FP_HIDDEN_BIT) { // denormal
+    u.u = mant;
+  } else {
+    if (exp + 1075 >= 0x7FF) return INFINITY;
+    u.u = (((uint64_t)(exp + 1075)) << 52) | (mant & FP_MANTISSA_MASK);
+  }
+  return u.d;
+}
+#endif
+
 /**
  * Convert a string to a JS float variable where the string is of a specific radix.
  * \return A JS float variable.
@@ -500,6 +923,57 @@ JsVarFloat stringToFloatWithRadix(
   if (!radix) return NAN;
 
 
+#ifdef FLOAT_ROUNDTRIP
+  if (radix == 10) {
+    char digits[FP_MAX_DIGITS]; // significant digits
+    int nDigits = 0;
+    int e = 0; // the number is digits * 10^e
+    bool truncated = false;
+    while (*s >= '0' && *s <= '9') {
+      if (nDigits<FP_MAX_DIGITS) {
+        if (nDigits || *s!='0') digits[nDigits++] = *s;
+      } else {
+        e++;
+        if (*s != '0') truncated = true;
+      }
+      s++;
+    }
+    if (*s == '.') {
+      s++; // skip .
+      while (*s >= '0' && *s <= '9') {
+        if (nDigits<FP_MAX_DIGITS) {
+          if (nDigits || *s!='0') digits[nDigits++] = *s;
+          e--;
+        } else if (*s != '0') truncated = true;
+        s++;
+      }
+    }
+    while (nDigits && digits[nDigits-1]=='0') {
+      nDigits--;
+      e++;
+    }
+    // handle exponentials
+    if (*s == 'e' || *s == 'E') {
+      s++;  // skip E
+      bool isENegated = false;
+      if (*s == '-' || *s == '+') {
+        isENegated = *s=='-';
+        s++;
+      }
+      int ex = 0;
+      while (*s >= '0' && *s <= '9') {
+        if (ex < 100000) ex = (ex*10) + (*s - '0');
+        s++;
+      }
+      e += isENegated ? -ex : ex;
+    }
+    // check that we managed to parse something at least
+    if (numberStart==s || (numberStart[0]=='.' && numberStart[1]==0)) return NAN;
+    JsVarFloat v = (JsVarFloat)fpDecimalToDouble(digits, nDigits, e, truncated);
+    return isNegated ? -v : v;
+  }
+#endif
+
   JsVarFloat v = 0;
   JsVarFloat mul = 0.1;
 
@@ -614,6 +1088,13 @@ void ftoa_bounded_extra(JsVarFloat val,char *str, size_t len, int radix, int fra
       *(str++) = '-';
       val = -val;
     }
+#ifdef FLOAT_ROUNDTRIP
+    if (radix==10 && fractionalDigits<0) {
+      if (val==0) strncpy(str,"0",len);
+      else fpToShortestString(val, str, len);
+      return;
+    }
+#endif
 
     // what if we're really close to an integer? Just use that...
     if (((JsVarInt)(val+stopAtError)) == (1+(JsVarInt)val))
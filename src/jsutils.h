@@ -221,6 +221,43 @@ typedef int64_t JsSysTime;
 #define JS_NUMBER_BUFFER_SIZE 66 ///< 64 bit base 2 + minus + terminating 0
 
 #define JS_VARS_BEFORE_IDLE_GC 32 ///< If we have less free variables than this, do a garbage collect on Idle
+#define JS_VARS_BEFORE_IDLE_INCREMENTAL_GC 256 ///< If incremental GC is enabled and we have less free variables than this, start a collection on Idle
+
+#ifndef SAVE_ON_FLASH
+#define JSV_HASH_INDEX_MIN_CHILDREN 32 ///< If we have to search past this many keys in an Object, give it a hash index (see jsvFindChildFromString)
+#define JSV_ARRAY_INDEX_MIN_ELEMENTS 32 ///< If we have to search past this many elements in a densely packed Array, give it an index (see jsvGetArrayIndex)
+#define JSV_FREE_RUN_BUCKETS 12 ///< How many sizes of run of free JsVars we remember the location of, so we don't have to search memory to allocate flat strings (see jsvNewFlatStringOfLength)
+#define JSV_DEFRAG_BATCH_SIZE 64 ///< How many variables jsvDefragment moves before updating references to them
+#define JSV_STRING_TAIL_CACHE_SIZE 4 ///< How many Strings we remember the last block of, so appending doesn't have to search for the end (see jsvStringIteratorGotoEnd)
+#define JSV_HEAP_PROFILE_MAX_SITES 32 ///< How many of the places in the code that allocated the most variables jsvGetHeapProfile reports
+#define JSWRAPPER_SYMBOL_HASH ///< Look up built-in functions and objects with perfect hash tables made by build_jswrapper.py, rather than searching through them (see jswSearchSymbolTable)
+#define JSI_TIMER_HEAP_INITIAL 8 ///< Keep timers in a heap ordered by when they're due (starting with room for this many), so idle doesn't have to look at every timer (see jsiTimerGetNext)
+#ifndef USE_FLOATS
+#define FLOAT_ROUNDTRIP ///< Print numbers with the fewest digits that read back as the same number, and read decimal numbers correctly rounded (see ftoa_bounded_extra)
+#endif
+/* These need static tables of a few hundred bytes or more, or change how code
+ * is stored (eg. Function.toString loses whitespace), so only use them where
+ * there's plenty of RAM */
+#ifdef LINUX
+#define JSV_GC_GRAY_STACK_SIZE 128 ///< How many variables incremental GC can remember that it has yet to scan (see jsvGarbageCollectIncremental)
+#define JSV_ATOM_TABLE_SIZE 64 ///< How many long property names we remember, so that objects with the same keys can share the storage for them (see jsvMakeIntoVariableName)
+#define JSV_PROPERTY_CACHE_SIZE 32 ///< How many property accesses (`a.b`) we remember the results of, so they don't have to be looked up again (see jspeFactorMember)
+#define JSLEX_PRETOKENISE ///< Store the code of functions with operators and reserved words as single characters, and without whitespace or comments (see jslNewTokenisedStringFromLexer)
+#define JSPARSE_BYTECODE ///< Compile functions (when first called) and loops to bytecode for a simple stack-based VM, rather than parsing them each time they're run (see jsbcCompileFunction)
+#define JSPARSE_VARIABLE_CACHE_SIZE 64 ///< How many variable lookups from bytecode we remember the results of, so the scopes don't have to be searched again (see jsbcGetVariable)
+#define JSPROFILE_MAX_FUNCTIONS 32 ///< How many different functions the execution profiler records (see E.profile)
+#endif
+#ifdef RESIZABLE_JSVARS
+#define JSV_ALLOCATION_SITES ///< Allow us to record where each variable was allocated (this uses malloc, so only where variables are malloc'd too)
+#endif
+#endif
+
+/* If the compiler can do compare-and-swap on the free list (a JsVarRef plus a
+ * count of the same size), use it rather than disabling interrupts whenever we
+ * allocate or free a variable (see jsvNewWithFlags) */
+#if (JSVARREF_SIZE==4 && defined(__GCC_HAVE_SYNC_COMPARE_AND_SWAP_8)) || (JSVARREF_SIZE<4 && defined(__GCC_HAVE_SYNC_COMPARE_AND_SWAP_4))
+#define JSV_LOCK_FREE_ALLOCATION
+#endif
 
 #define JSPARSE_MAX_SCOPES  8
 
@@ -241,6 +278,7 @@ typedef int64_t JsSysTime;
 #define JSPARSE_FUNCTION_THIS_NAME JS_HIDDEN_CHAR_STR"ths" // the 'this' variable - for bound functions
 #define JSPARSE_FUNCTION_NAME_NAME JS_HIDDEN_CHAR_STR"nam" // for named functions (a = function foo() { foo(); })
 #define JSPARSE_FUNCTION_LINENUMBER_NAME JS_HIDDEN_CHAR_STR"lin" // The line number offset of the function
+#define JSPARSE_FUNCTION_BYTECODE_NAME JS_HIDDEN_CHAR_STR"byt" // The function's compiled bytecode (if JSPARSE_BYTECODE)
 #define JS_EVENT_PREFIX "#on"
 
 #define JSPARSE_EXCEPTION_VAR "except" // when exceptions are thrown, they're stored in the root scope
@@ -409,6 +447,16 @@ typedef enum {
  * but which are good to know about */
 extern JsErrorFlags jsErrorFlags;
 
+/// Flags that change how Espruino works - update jswrap_espruino_getFlags if you add to this
+typedef enum {
+  JSF_NONE = 0,
+  JSF_PRETOKENISE = 1, ///< When a function is defined, store its code pretokenised (if JSLEX_PRETOKENISE) rather than as the original source
+  JSF_BYTECODE = 2, ///< Compile functions and loops to bytecode (if JSPARSE_BYTECODE) rather than parsing them each time
+} PACKED_FLAGS JsFlags;
+
+/// Flags that change how Espruino works - see E.setFlags
+extern JsFlags jsFlags;
+
 JsVarFloat stringToFloatWithRadix(const char *s, int forceRadix);
 JsVarFloat stringToFloat(const char *str);
 
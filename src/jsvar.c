@@ -16,6 +16,7 @@
 #include "jsparse.h"
 #include "jswrap_json.h"
 #include "jsinteractive.h"
+#include "jstimer.h"
 #include "jswrapper.h"
 #include "jswrap_math.h" // for jswrap_math_mod
 #include "jswrap_object.h" // for jswrap_object_toString
@@ -46,9 +47,158 @@ JsVar jsVars[JSVAR_CACHE_SIZE];
 unsigned int jsVarsSize = JSVAR_CACHE_SIZE;
 #endif
 
+#ifdef JSV_LOCK_FREE_ALLOCATION
+#if JSVARREF_SIZE==4
+typedef uint64_t JsvFreeListHead;
+#else
+typedef uint32_t JsvFreeListHead;
+#endif
+#define JSV_FREE_LIST_COUNT_SHIFT (sizeof(JsvFreeListHead)*4)
+/** Reference of the first unused variable (variables are in a linked list) in
+ * the bottom half, and a count of how many times it has changed in the top half.
+ * Without the count, something taking a variable off the list could be fooled
+ * by the first variable being taken and put back again while it was working
+ * out what the next one was (the 'ABA problem') */
+volatile JsvFreeListHead jsvFreeListHead;
+#else
 volatile JsVarRef jsVarFirstEmpty; ///< reference of first unused variable (variables are in a linked list)
+#endif
 volatile bool isMemoryBusy; ///< Are we doing garbage collection or similar, so can't access memory?
 
+#ifdef JSV_GC_GRAY_STACK_SIZE
+/// What stage of incremental garbage collection are we at?
+typedef enum {
+  JSVGC_IDLE,   ///< No collection in progress
+  JSVGC_FLAG,   ///< Setting JSV_GARBAGE_COLLECT on every var
+  JSVGC_MARK,   ///< Clearing JSV_GARBAGE_COLLECT from everything reachable from a locked var
+  JSVGC_RESCAN, ///< The gray stack overflowed, so we're scanning the children of every marked var
+  JSVGC_UNLINK, ///< Unreferencing anything used by vars we're about to free
+  JSVGC_FREE,   ///< Freeing vars that still have JSV_GARBAGE_COLLECT set
+} JsvGCPhase;
+static volatile JsvGCPhase jsvGCPhase = JSVGC_IDLE;
+static JsVarRef jsvGCCursor; ///< The next var to look at in the current phase
+static JsVarRef jsvGCGray[JSV_GC_GRAY_STACK_SIZE]; ///< Vars that have been marked but whose children haven't been scanned
+static unsigned int jsvGCGrayCount;
+static bool jsvGCGrayOverflow; ///< Did we run out of space in jsvGCGray?
+static unsigned int jsvGCBudget; ///< Microseconds per slice, or 0 if incremental GC is disabled
+static JsvGCStats jsvGCStats;
+static void jsvGCShade(JsVar *var);
+static void jsvGCNewFlatString(JsVar *flatString);
+static void jsvGCRecordPause(JsSysTime startTime);
+/// Are we marking vars that are used? If so, anything that is locked or referenced must be marked too
+static ALWAYS_INLINE bool jsvGCIsMarking() {
+  return jsvGCPhase==JSVGC_MARK || jsvGCPhase==JSVGC_RESCAN;
+}
+#endif
+#ifdef JSV_DEFRAG_BATCH_SIZE
+static bool jsvDefragNeeded = false; ///< A flat string couldn't be allocated even though there was enough free memory
+#endif
+#ifdef JSV_STRING_TAIL_CACHE_SIZE
+/// The last block of a String that was recently appended to (see jsvStringTailCacheGet)
+typedef struct {
+  JsVarRef string; ///< The first block of the string, or 0 if unused
+  JsVarRef tail; ///< The last block
+  size_t tailIndex; ///< The index of the first character in the last block
+} JsvStringTail;
+static JsvStringTail jsvStringTails[JSV_STRING_TAIL_CACHE_SIZE];
+static unsigned char jsvStringTailNext; ///< The entry we'll replace next
+
+/// Forget everything in the string tail cache - eg. if we freed vars without jsvFreePtr
+static void jsvStringTailCacheClear() {
+  memset(jsvStringTails, 0, sizeof(jsvStringTails));
+}
+
+/// Forget about a string (because it's being freed or restructured)
+static ALWAYS_INLINE void jsvStringTailCacheForget(JsVar *str) {
+  JsVarRef ref = jsvGetRef(str);
+  unsigned int i;
+  for (i=0;i<JSV_STRING_TAIL_CACHE_SIZE;i++)
+    if (jsvStringTails[i].string == ref)
+      jsvStringTails[i].string = 0;
+}
+#endif
+#ifdef JSV_ATOM_TABLE_SIZE
+#define JSV_ATOM_TABLE_PROBES 4 ///< How many slots after the one a name hashes to that we'll look in
+/* Interned atoms. Names are too small to hold long property names, so the
+ * characters that don't fit go in a String (an 'atom') linked from the name's
+ * lastChild. Names with the same characters share the same atom (which is
+ * reference counted), so arrays of objects with the same keys (eg. JSON
+ * records) don't need a copy of every key.
+ *
+ * This table holds a reference to every atom, and there's only ever one atom
+ * with the same characters - if there's no space in the table for a new one,
+ * the name just gets its own STRING_EXTs. That means two names with atoms are
+ * only equal if their atoms are the same var, so they can be compared without
+ * looking at the characters in the atom. Garbage collection treats the
+ * atoms in the table as used, and afterwards removes the ones that nothing
+ * else uses. */
+static JsVarRef jsvAtoms[JSV_ATOM_TABLE_SIZE];
+/// Is every atom in jsvAtoms? If not (eg. if we couldn't add them all after loading), we can't compare atoms by reference
+static bool jsvAtomsUnique;
+#endif
+#ifdef JSV_PROPERTY_CACHE_SIZE
+/// Where a property was found the last time it was accessed from somewhere (see jsvPropertyCacheGet)
+typedef struct {
+  uint32_t key; ///< Identifies the property and where it was accessed from, or 0 if unused
+  JsVarRef object; ///< The object that the property was accessed on
+  JsVarRef name; ///< The name that was found (for JSVPC_OWN and JSVPC_INHERITED)
+  unsigned char type; ///< JsvPropertyCacheType
+  unsigned char fieldLength; ///< The length of the property's name...
+  char fieldStart[4]; ///< ... and its first characters, so we can tell names with the same key apart (0 padded)
+  unsigned int epoch; ///< jsvPropertyCacheEpoch when this was found (for JSVPC_INHERITED and JSVPC_BUILTIN)
+} JsvPropertyCacheEntry;
+static JsvPropertyCacheEntry jsvPropertyCache[JSV_PROPERTY_CACHE_SIZE];
+/// Changed whenever something happens that could change where an inherited property is found
+static unsigned int jsvPropertyCacheEpoch;
+#endif
+#ifdef JSPARSE_VARIABLE_CACHE_SIZE
+/// Changed whenever something happens that could change where a variable is found (see jsvGetNameEpoch)
+static unsigned int jsvNameEpoch = 1;
+
+/// Forget everything in the property cache - eg. if we freed vars without jsvFreePtr
+static void jsvPropertyCacheClear() {
+  memset(jsvPropertyCache, 0, sizeof(jsvPropertyCache));
+}
+
+/// Forget about properties of an object (or just the ones that weren't its own children)
+static void jsvPropertyCacheForgetObject(JsVarRef object, bool notOwn) {
+  unsigned int i;
+  for (i=0;i<JSV_PROPERTY_CACHE_SIZE;i++)
+    if (jsvPropertyCache[i].object == object && (!notOwn || jsvPropertyCache[i].type!=JSVPC_OWN))
+      jsvPropertyCache[i].key = 0;
+}
+
+/// Forget about a name that's being removed from its parent
+static void jsvPropertyCacheForgetName(JsVarRef name) {
+  unsigned int i;
+  for (i=0;i<JSV_PROPERTY_CACHE_SIZE;i++)
+    if (jsvPropertyCache[i].name == name)
+      jsvPropertyCache[i].key = 0;
+}
+#endif
+#ifdef JSV_ALLOCATION_SITES
+/// Where in the code a var was allocated (see jsvSetAllocationTracking)
+typedef struct {
+  JsVarRef code; ///< The code that was being executed (lex->sourceVar), or 0
+  uint32_t position; ///< The start of the token we were at in the code
+} JsvAllocationSite;
+static JsvAllocationSite *jsvAllocationSites = 0; ///< One for each var (indexed by ref-1) if we're tracking allocations, or 0
+
+/// Remember where in the code a var was allocated
+static void jsvRecordAllocationSite(JsVar *v) {
+  JsvAllocationSite *site = &jsvAllocationSites[jsvGetRef(v)-1];
+  if (lex && lex->sourceVar) {
+    site->code = jsvGetRef(lex->sourceVar);
+    // tokenStart is one character past the start of the current token
+    size_t idx = jsvStringIteratorGetIndex(&lex->tokenStart.it);
+    site->position = (uint32_t)(idx ? idx-1 : 0);
+  } else {
+    site->code = 0;
+    site->position = 0;
+  }
+}
+#endif
+
 // ----------------------------------------------------------------------------
 // ----------------------------------------------------------------------------
 
@@ -151,6 +301,224 @@ void jsvSetLastChild(JsVar *v, JsVarRef r) {
 #endif
 
 
+/* Variables can be allocated and freed from IRQs (and other threads on Linux)
+ * while the main loop is doing the same, so the free list is used as a stack
+ * with compare-and-swap where we can, or with interrupts disabled where we
+ * can't. Anything else that changes the free list (rebuilding it, or taking
+ * vars from the middle of it) does so while isMemoryBusy is set, and other
+ * code can't allocate then. */
+
+/// Get the first unused variable
+static ALWAYS_INLINE JsVarRef jsvFreeListGetFirst() {
+#ifdef JSV_LOCK_FREE_ALLOCATION
+  return (JsVarRef)__atomic_load_n(&jsvFreeListHead, __ATOMIC_ACQUIRE);
+#else
+  return jsVarFirstEmpty;
+#endif
+}
+
+#ifdef JSV_LOCK_FREE_ALLOCATION
+/// Make a new value for jsvFreeListHead, with the count one more than in 'head'
+static ALWAYS_INLINE JsvFreeListHead jsvFreeListNewHead(JsvFreeListHead head, JsVarRef first) {
+  return (JsvFreeListHead)((((head >> JSV_FREE_LIST_COUNT_SHIFT)+1) << JSV_FREE_LIST_COUNT_SHIFT) | first);
+}
+#endif
+
+/// Set the first unused variable, when we're rebuilding the whole free list
+static void jsvFreeListSetFirst(JsVarRef first) {
+#ifdef JSV_LOCK_FREE_ALLOCATION
+  JsvFreeListHead head = __atomic_load_n(&jsvFreeListHead, __ATOMIC_RELAXED);
+  __atomic_store_n(&jsvFreeListHead, jsvFreeListNewHead(head, first), __ATOMIC_RELEASE);
+#else
+  jsVarFirstEmpty = first;
+#endif
+}
+
+/// Take the first variable off the free list, or return 0 if there isn't one
+static ALWAYS_INLINE JsVar *jsvFreeListPop() {
+#ifdef JSV_LOCK_FREE_ALLOCATION
+  JsvFreeListHead head = __atomic_load_n(&jsvFreeListHead, __ATOMIC_ACQUIRE);
+  JsVar *v;
+  JsvFreeListHead newHead;
+  do {
+    if (!(JsVarRef)head) return 0;
+    v = jsvGetAddressOf((JsVarRef)head);
+    /* Something else may allocate v before we swap, in which case this
+     * is rubbish - but then the count will have changed and the swap fails */
+    newHead = jsvFreeListNewHead(head, jsvGetNextSibling(v));
+  } while (!__atomic_compare_exchange_n(&jsvFreeListHead, &head, newHead, true, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE));
+  return v;
+#else
+  jshInterruptOff(); // to allow this to be used from an IRQ
+  JsVar *v = 0;
+  if (jsVarFirstEmpty) {
+    v = jsvGetAddressOf(jsVarFirstEmpty);
+    jsVarFirstEmpty = jsvGetNextSibling(v); // move our reference to the next in the free list
+  }
+  jshInterruptOn();
+  return v;
+#endif
+}
+
+/// Put a variable on the front of the free list
+static ALWAYS_INLINE void jsvFreeListPush(JsVar *var) {
+#ifdef JSV_FREE_RUN_BUCKETS
+  jsvSetPrevSibling(var, 0); // see jsvFreeListUpdatePrev
+#endif
+#ifdef JSV_LOCK_FREE_ALLOCATION
+  JsvFreeListHead head = __atomic_load_n(&jsvFreeListHead, __ATOMIC_RELAXED);
+  JsvFreeListHead newHead;
+  do {
+    jsvSetNextSibling(var, (JsVarRef)head);
+    newHead = jsvFreeListNewHead(head, jsvGetRef(var));
+  } while (!__atomic_compare_exchange_n(&jsvFreeListHead, &head, newHead, true, __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+#else
+  jshInterruptOff(); // to allow this to be used from an IRQ
+  jsvSetNextSibling(var, jsVarFirstEmpty);
+  jsVarFirstEmpty = jsvGetRef(var);
+  jshInterruptOn();
+#endif
+}
+
+#ifdef JSV_FREE_RUN_BUCKETS
+/* The free list is doubly linked (with prevSibling) so we can remove vars
+ * from the middle of it (see jsvFreeListUpdatePrev). That means that when allocating a flat string we
+ * don't have to scan all of memory if we know where there's a run of free
+ * vars. jsvFreeRuns[N] remembers the biggest run we've seen that was between
+ * 2^(N+1) and 2^(N+2)-1 vars long (with the last bucket holding anything
+ * bigger). These are just hints - vars may have been allocated since they
+ * were added - so runs are always checked before use. */
+typedef struct {
+  JsVarRef start;
+  unsigned int length;
+} JsvFreeRun;
+static JsvFreeRun jsvFreeRuns[JSV_FREE_RUN_BUCKETS];
+
+static unsigned int jsvFreeRunGetBucket(unsigned int length) {
+  unsigned int bucket = 0;
+  while (length>3 && bucket<JSV_FREE_RUN_BUCKETS-1) {
+    length >>= 1;
+    bucket++;
+  }
+  return bucket;
+}
+
+/// Remember a run of free vars (if it's bigger than the one we knew about)
+static void jsvFreeRunAdd(JsVarRef start, unsigned int length) {
+  if (length<2) return; // flat strings are always at least 2 blocks
+  JsvFreeRun *run = &jsvFreeRuns[jsvFreeRunGetBucket(length)];
+  if (length >= run->length) {
+    run->start = start;
+    run->length = length;
+  }
+}
+
+/** Called after the free list has been rebuilt in order of address. This
+ * sets up prevSibling, and remembers all the runs of free vars */
+static void jsvFreeListRelink() {
+  memset(jsvFreeRuns, 0, sizeof(jsvFreeRuns));
+  JsVarRef prev = 0;
+  JsVarRef runStart = 0;
+  JsVar *prevVar = 0;
+  JsVarRef ref = jsvFreeListGetFirst();
+  while (ref) {
+    JsVar *var = jsvGetAddressOf(ref);
+    jsvSetPrevSibling(var, prev);
+    /* With RESIZABLE_JSVARS (Linux), we have chunks of variables that may
+     * not be contiguous - so check the addresses rather than the refs */
+    if (!prevVar || var != prevVar+1) {
+      if (runStart) jsvFreeRunAdd(runStart, (unsigned int)(prev+1-runStart));
+      runStart = ref;
+    }
+    prev = ref;
+    prevVar = var;
+    ref = jsvGetNextSibling(var);
+  }
+  if (runStart) jsvFreeRunAdd(runStart, (unsigned int)(prev+1-runStart));
+}
+
+/** Make sure prevSibling is right for every var in the free list. Taking
+ * vars off the front of the list doesn't update prevSibling of the next one
+ * (with compare-and-swap we can't - something else may already have taken
+ * it), and vars are put on the front with prevSibling=0. So only vars up
+ * to the first one that was already right and non-zero can be wrong. */
+static void jsvFreeListUpdatePrev() {
+  JsVarRef prev = 0;
+  JsVarRef ref = jsvFreeListGetFirst();
+  while (ref) {
+    JsVar *var = jsvGetAddressOf(ref);
+    JsVarRef oldPrev = jsvGetPrevSibling(var);
+    if (oldPrev != prev) jsvSetPrevSibling(var, prev);
+    else if (oldPrev) break; // everything after here is right
+    prev = ref;
+    ref = jsvGetNextSibling(var);
+  }
+}
+
+/// If 'first' is the first var in the free list, replace it with 'next' and return true
+static bool jsvFreeListReplaceFirst(JsVarRef first, JsVarRef next) {
+#ifdef JSV_LOCK_FREE_ALLOCATION
+  JsvFreeListHead head = __atomic_load_n(&jsvFreeListHead, __ATOMIC_ACQUIRE);
+  while ((JsVarRef)head == first) {
+    if (__atomic_compare_exchange_n(&jsvFreeListHead, &head, jsvFreeListNewHead(head, next), false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+      return true;
+  }
+  return false;
+#else
+  jshInterruptOff(); // jsvFreePtr can be called from an IRQ
+  bool isFirst = jsVarFirstEmpty == first;
+  if (isFirst) jsVarFirstEmpty = next;
+  jshInterruptOn();
+  return isFirst;
+#endif
+}
+
+/** Remove a var from anywhere in the free list. jsvFreeListUpdatePrev must
+ * have been called, and this must be called while isMemoryBusy (so nothing
+ * else can take vars off the list - they can still be freed though) */
+static void jsvFreeListRemove(JsVar *var) {
+  JsVarRef prev = jsvGetPrevSibling(var);
+  JsVarRef next = jsvGetNextSibling(var);
+  if (!prev) {
+    if (jsvFreeListReplaceFirst(jsvGetRef(var), next)) {
+      if (next) jsvSetPrevSibling(jsvGetAddressOf(next), 0);
+      return;
+    }
+    // Something was freed and put in front of us
+    jsvFreeListUpdatePrev();
+    prev = jsvGetPrevSibling(var);
+  }
+  jsvSetNextSibling(jsvGetAddressOf(prev), next);
+  if (next) jsvSetPrevSibling(jsvGetAddressOf(next), prev);
+}
+
+/// Try and take the given number of contiguous vars from the runs we know about, or return 0
+static JsVar *jsvFreeRunAllocate(unsigned int blocks) {
+  unsigned int bucket;
+  for (bucket=jsvFreeRunGetBucket(blocks);bucket<JSV_FREE_RUN_BUCKETS;bucket++) {
+    JsvFreeRun run = jsvFreeRuns[bucket];
+    if (run.length < blocks) continue;
+    jsvFreeRuns[bucket].length = 0;
+    // check it's still free
+    unsigned int i;
+    for (i=0;i<blocks;i++)
+      if ((jsvGetAddressOf((JsVarRef)(run.start+i))->flags&JSV_VARTYPEMASK) != JSV_UNUSED)
+        break;
+    if (i<blocks) {
+      jsvFreeRunAdd(run.start, i); // we know this bit is ok
+      continue;
+    }
+    // it is! remove all the vars from the free list
+    jsvFreeListUpdatePrev();
+    for (i=0;i<blocks;i++)
+      jsvFreeListRemove(jsvGetAddressOf((JsVarRef)(run.start+i)));
+    jsvFreeRunAdd((JsVarRef)(run.start+blocks), run.length-blocks);
+    return jsvGetAddressOf(run.start);
+  }
+  return 0;
+}
+#endif
+
 // For debugging/testing ONLY - maximum # of vars we are allowed to use
 void jsvSetMaxVarsUsed(unsigned int size) {
 #ifdef RESIZABLE_JSVARS
@@ -165,7 +533,7 @@ void jsvSetMaxVarsUsed(unsigned int size) {
 void jsvCreateEmptyVarList() {
   assert(!isMemoryBusy);
   isMemoryBusy = true;
-  jsVarFirstEmpty = 0;
+  jsvFreeListSetFirst(0);
   JsVar firstVar; // temporary var to simplify code in the loop below
   jsvSetNextSibling(&firstVar, 0);
   JsVar *lastEmpty = &firstVar;
@@ -182,7 +550,10 @@ void jsvCreateEmptyVarList() {
     }
   }
   jsvSetNextSibling(lastEmpty, 0);
-  jsVarFirstEmpty = jsvGetNextSibling(&firstVar);
+  jsvFreeListSetFirst(jsvGetNextSibling(&firstVar));
+#ifdef JSV_FREE_RUN_BUCKETS
+  jsvFreeListRelink();
+#endif
   isMemoryBusy = false;
 }
 
@@ -192,7 +563,10 @@ void jsvCreateEmptyVarList() {
 void jsvClearEmptyVarList() {
   assert(!isMemoryBusy);
   isMemoryBusy = true;
-  jsVarFirstEmpty = 0;
+  jsvFreeListSetFirst(0);
+#ifdef JSV_FREE_RUN_BUCKETS
+  memset(jsvFreeRuns, 0, sizeof(jsvFreeRuns));
+#endif
   JsVarRef i;
   for (i=1;i<=jsVarsSize;i++) {
     JsVar *var = jsvGetAddressOf(i);
@@ -207,17 +581,183 @@ void jsvClearEmptyVarList() {
   isMemoryBusy = false;
 }
 
+#ifdef JSV_ATOM_TABLE_SIZE
+/// If this name's characters continue in a shared atom, return it (not locked)
+static JsVar *jsvGetNameAtom(JsVar *name) {
+  if (!jsvIsName(name) || !jsvIsString(name) || !jsvGetLastChild(name)) return 0;
+  JsVar *atom = jsvGetAddressOf(jsvGetLastChild(name));
+  return jsvIsBasicString(atom) ? atom : 0;
+}
+
+/// Remove all atoms from the table (they're freed if nothing else uses them)
+static void jsvAtomTableClear() {
+  unsigned int i;
+  for (i=0;i<JSV_ATOM_TABLE_SIZE;i++) {
+    JsVarRef ref = jsvAtoms[i];
+    jsvAtoms[i] = 0;
+    if (ref) jsvUnRefRef(ref);
+  }
+  jsvAtomsUnique = false; // names still have atoms that aren't in the table
+}
+
+/// Remove atoms that nothing but the table uses (which frees them). Returns true if any were freed
+static bool jsvAtomTableFreeUnused() {
+  bool freed = false;
+  unsigned int i;
+  for (i=0;i<JSV_ATOM_TABLE_SIZE;i++) {
+    JsVarRef ref = jsvAtoms[i];
+    if (ref && jsvGetRefs(jsvGetAddressOf(ref))==1 && !jsvGetLocks(jsvGetAddressOf(ref))) {
+      jsvAtoms[i] = 0;
+      jsvUnRefRef(ref);
+      freed = true;
+    }
+  }
+  return freed;
+}
+
+/// Hash the characters of str from startChar onwards (see jsvAtomFind)
+static uint32_t jsvAtomHash(JsVar *str, size_t startChar, size_t *len) {
+  uint32_t hash = 5381;
+  *len = 0;
+  JsvStringIterator it;
+  jsvStringIteratorNew(&it, str, startChar);
+  while (jsvStringIteratorHasChar(&it)) {
+    hash = hash*33 + (unsigned char)jsvStringIteratorGetChar(&it);
+    (*len)++;
+    jsvStringIteratorNext(&it);
+  }
+  jsvStringIteratorFree(&it);
+  return hash;
+}
+
+/// Find the atom in the table that contains the characters of str from startChar onwards, or return 0
+static JsVarRef jsvAtomFind(JsVar *str, size_t startChar, uint32_t hash, size_t len) {
+  unsigned int i;
+  for (i=0;i<JSV_ATOM_TABLE_PROBES;i++) {
+    JsVarRef ref = jsvAtoms[(hash+i) % JSV_ATOM_TABLE_SIZE];
+    if (!ref) continue; // atoms are removed individually, so there may be more after this
+    JsVar *atom = jsvGetAddressOf(ref);
+    if (jsvGetStringLength(atom)==len && jsvCompareString(atom, str, 0, startChar, false)==0)
+      return ref;
+  }
+  return 0;
+}
+
+/// Add an atom to the table - returns false if there's no space
+static bool jsvAtomAdd(JsVar *atom, uint32_t hash) {
+  unsigned int i;
+  for (i=0;i<JSV_ATOM_TABLE_PROBES;i++) {
+    JsVarRef *slot = &jsvAtoms[(hash+i) % JSV_ATOM_TABLE_SIZE];
+    if (!*slot) {
+      *slot = jsvGetRef(jsvRef(atom));
+      return true;
+    }
+  }
+  return false;
+}
+
+/** Return an atom (locked) containing the characters of str from startChar
+ * onwards - either one we made before or a new one. Returns 0 if out of
+ * memory, or if there's no space in the table for a new one */
+static JsVar *jsvAtomGet(JsVar *str, size_t startChar) {
+  size_t len;
+  uint32_t hash = jsvAtomHash(str, startChar, &len);
+  JsVarRef ref = jsvAtomFind(str, startChar, hash, len);
+  if (ref) return jsvLock(ref);
+  // Not found - make a new one (which may garbage collect, and free unused atoms)
+  JsVar *atom = jsvNewFromStringVar(str, startChar, JSVAPPENDSTRINGVAR_MAXLENGTH);
+  if (atom && !jsvAtomAdd(atom, hash)) {
+    jsvUnLock(atom);
+    atom = 0;
+  }
+  return atom;
+}
+
+/** Put every atom that names use into the table (eg. after loading). If
+ * there are two atoms with the same characters, names are changed to use
+ * just one of them */
+static void jsvAtomTableRebuild() {
+  memset(jsvAtoms, 0, sizeof(jsvAtoms));
+  jsvAtomsUnique = true;
+  JsVarRef i;
+  for (i=1;i<=jsVarsSize;i++) {
+    JsVar *var = jsvGetAddressOf(i);
+    JsVar *atom = jsvGetNameAtom(var);
+    if (atom) {
+      size_t len;
+      uint32_t hash = jsvAtomHash(atom, 0, &len);
+      JsVarRef ref = jsvAtomFind(atom, 0, hash, len);
+      if (!ref) {
+        if (!jsvAtomAdd(atom, hash))
+          jsvAtomsUnique = false;
+      } else if (ref != jsvGetLastChild(var)) {
+        jsvSetLastChild(var, jsvRefRef(ref));
+        jsvUnRef(atom); // which may free it
+      }
+    }
+    if (jsvIsFlatString(var))
+      i = (JsVarRef)(i+jsvGetFlatStringBlocks(var));
+  }
+}
+
+/** If str is long enough that the end of it would be in an atom, return the
+ * atom that holds it (see jsvIsNameEqualString). Otherwise (or if we can't
+ * rely on atoms being unique) return 0 */
+static JsVarRef jsvAtomFindForString(const char *str) {
+  if (!jsvAtomsUnique) return 0;
+  size_t i;
+  for (i=0;i<=JSVAR_DATA_STRING_NAME_LEN;i++)
+    if (!str[i]) return 0; // short enough to fit in a name
+  const char *tail = &str[JSVAR_DATA_STRING_NAME_LEN];
+  uint32_t hash = 5381;
+  size_t len = 0;
+  while (tail[len]) hash = hash*33 + (unsigned char)tail[len++];
+  for (i=0;i<JSV_ATOM_TABLE_PROBES;i++) {
+    JsVarRef ref = jsvAtoms[(hash+i) % JSV_ATOM_TABLE_SIZE];
+    if (ref && jsvGetStringLength(jsvGetAddressOf(ref))==len && jsvIsStringEqual(jsvGetAddressOf(ref), tail))
+      return ref;
+  }
+  return 0;
+}
+#endif
+
+/** Is the name equal to str? strAtom is the atom that holds the end of str
+ * (see jsvAtomFindForString) or 0 - if both have an atom we can just compare
+ * them, rather than all of the characters */
+static ALWAYS_INLINE bool jsvIsNameEqualString(JsVar *name, const char *str, JsVarRef strAtom) {
+#ifdef JSV_ATOM_TABLE_SIZE
+  if (strAtom && jsvGetNameAtom(name))
+    return jsvGetLastChild(name)==strAtom &&
+           memcmp(name->varData.str, str, JSVAR_DATA_STRING_NAME_LEN)==0;
+#else
+  NOT_USED(strAtom);
+#endif
+  return jsvIsStringEqual(name, str);
+}
+
 void jsvSoftInit() {
+#ifdef JSV_ATOM_TABLE_SIZE
+  jsvAtomTableRebuild(); // we may have loaded different vars
+#endif
+#ifdef JSV_PROPERTY_CACHE_SIZE
+  jsvPropertyCacheClear();
+#endif
+#ifdef JSPARSE_VARIABLE_CACHE_SIZE
+  jsvNameEpoch++; // names we found may be freed (or be different ones)
+#endif
   jsvCreateEmptyVarList();
 }
 
 void jsvSoftKill() {
+#ifdef JSV_ATOM_TABLE_SIZE
+  jsvAtomTableClear();
+#endif
   jsvClearEmptyVarList();
 }
 
 /** This links all JsVars together, so we can have our nice
  * linked list of free JsVars. It returns the ref of the first
- * item - that we should set jsVarFirstEmpty to (if it is 0) */
+ * item - that we should make the first in the free list (if it is empty) */
 static JsVarRef jsvInitJsVars(JsVarRef start, unsigned int count) {
   JsVarRef i;
   for (i=start;i<start+count;i++) {
@@ -225,7 +765,13 @@ static JsVarRef jsvInitJsVars(JsVarRef start, unsigned int count) {
     v->flags = JSV_UNUSED;
     // v->locks = 0; // locks is 0 anyway because it is stored in flags
     jsvSetNextSibling(v, (JsVarRef)(i+1)); // link to next
+#ifdef JSV_FREE_RUN_BUCKETS
+    jsvSetPrevSibling(v, (JsVarRef)(i-1)); // so jsvFreeListUpdatePrev knows the list is right
+#endif
   }
+#ifdef JSV_FREE_RUN_BUCKETS
+  jsvSetPrevSibling(jsvGetAddressOf(start), 0);
+#endif
   jsvSetNextSibling(jsvGetAddressOf((JsVarRef)(start+count-1)), (JsVarRef)0); // set the final one to 0
   return start;
 }
@@ -237,7 +783,7 @@ void jsvInit() {
   jsVarBlocks[0] = malloc(sizeof(JsVar) * JSVAR_BLOCK_SIZE);
 #endif
 
-  jsVarFirstEmpty = jsvInitJsVars(1/*first*/, jsVarsSize);
+  jsvFreeListSetFirst(jsvInitJsVars(1/*first*/, jsVarsSize));
   jsvSoftInit();
 }
 
@@ -250,6 +796,9 @@ void jsvKill() {
   jsVarBlocks = 0;
   jsVarsSize = 0;
 #endif
+#ifdef JSV_ALLOCATION_SITES
+  jsvSetAllocationTracking(false);
+#endif
 }
 
 /** Find or create the ROOT variable item - used mainly
@@ -303,10 +852,19 @@ void jsvSetMemoryTotal(unsigned int jsNewVarCount) {
   unsigned int i;
   for (i=oldBlockCount;i<newBlockCount;i++)
     jsVarBlocks[i] = malloc(sizeof(JsVar) * JSVAR_BLOCK_SIZE);
-  /** and now reset all the newly allocated vars. We know jsVarFirstEmpty
-   * is 0 (because jsiFreeMoreMemory returned 0) so we can just assign it.  */
-  assert(!jsVarFirstEmpty);
-  jsVarFirstEmpty = jsvInitJsVars(oldSize+1, jsVarsSize-oldSize);
+  /** and now reset all the newly allocated vars. We know the free list
+   * is empty (because jsiFreeMoreMemory returned 0) so we can just assign it.  */
+  assert(!jsvFreeListGetFirst());
+  jsvFreeListSetFirst(jsvInitJsVars(oldSize+1, jsVarsSize-oldSize));
+#ifdef JSV_ALLOCATION_SITES
+  if (jsvAllocationSites) {
+    jsvAllocationSites = realloc(jsvAllocationSites, sizeof(JsvAllocationSite)*jsVarsSize);
+    memset(&jsvAllocationSites[oldSize], 0, sizeof(JsvAllocationSite)*(jsVarsSize-oldSize));
+  }
+#endif
+#ifdef JSV_FREE_RUN_BUCKETS
+  jsvFreeListRelink();
+#endif
   // jsiConsolePrintf("Resized memory from %d blocks to %d\n", oldBlockCount, newBlockCount);
   isMemoryBusy = false;
 #else
@@ -317,7 +875,7 @@ void jsvSetMemoryTotal(unsigned int jsNewVarCount) {
 
 bool jsvMoreFreeVariablesThan(unsigned int vars) {
   if (!vars) return false;
-  JsVarRef r = jsVarFirstEmpty;
+  JsVarRef r = jsvFreeListGetFirst();
   while (r) {
     if (!vars) return true;
     vars--;
@@ -330,7 +888,7 @@ bool jsvMoreFreeVariablesThan(unsigned int vars) {
 
 /// Get whether memory is full or not
 bool jsvIsMemoryFull() {
-  return !jsVarFirstEmpty;
+  return !jsvFreeListGetFirst();
 }
 
 // Show what is still allocated, for debugging memory problems
@@ -382,23 +940,18 @@ JsVar *jsvNewWithFlags(JsVarFlags flags) {
     jsErrorFlags |= JSERR_MEMORY_BUSY;
     return 0;
   }
-  if (jsVarFirstEmpty!=0) {
-    jshInterruptOff(); // to allow this to be used from an IRQ
-    JsVar *v = jsvGetAddressOf(jsVarFirstEmpty); // jsvResetVariable will lock
-    jsVarFirstEmpty = jsvGetNextSibling(v); // move our reference to the next in the fr
-    jshInterruptOn();
+  JsVar *v = jsvFreeListPop(); // safe to use from an IRQ
+  if (v) {
     assert(v->flags == JSV_UNUSED);
-    // Cope with IRQs/multi-threading when getting a new free variable
- /*   JsVarRef empty;
-    JsVarRef next;
-    JsVar *v;
-    do {
-      empty = jsVarFirstEmpty;
-      v = jsvGetAddressOf(empty); // jsvResetVariable will lock
-      next = jsvGetNextSibling(v); // move our reference to the next in the free list
-    } while (!__sync_bool_compare_and_swap(&jsVarFirstEmpty, empty, next));
-    assert(v->flags == JSV_UNUSED);*/
     jsvResetVariable(v, flags); // setup variable, and add one lock
+#ifdef JSV_GC_GRAY_STACK_SIZE
+    /* New vars aren't marked for GC, but while we're setting flags they
+     * could get references to vars that will be - so scan them later */
+    if (jsvGCPhase==JSVGC_FLAG) jsvGCShade(v);
+#endif
+#ifdef JSV_ALLOCATION_SITES
+    if (jsvAllocationSites) jsvRecordAllocationSite(v);
+#endif
     // return pointer
     return v;
   }
@@ -426,17 +979,33 @@ JsVar *jsvNewWithFlags(JsVarFlags flags) {
 #endif
 }
 
+#ifdef JSV_HASH_INDEX_MIN_CHILDREN
+static void jsvHashIndexFree(JsVar *parent);
+#endif
+#ifdef JSV_ARRAY_INDEX_MIN_ELEMENTS
+static void jsvArrayIndexFree(JsVar *arr);
+#endif
+
 ALWAYS_INLINE void jsvFreePtrInternal(JsVar *var) {
   assert(jsvGetLocks(var)==0);
   var->flags = JSV_UNUSED;
   // add this to our free list
-  jshInterruptOff(); // to allow this to be used from an IRQ
-  jsvSetNextSibling(var, jsVarFirstEmpty);
-  jsVarFirstEmpty = jsvGetRef(var);
-  jshInterruptOn();
+  jsvFreeListPush(var); // safe to use from an IRQ
 }
 
 ALWAYS_INLINE void jsvFreePtr(JsVar *var) {
+#ifdef JSV_HASH_INDEX_MIN_CHILDREN
+  // Objects may use nextSibling for their hash index
+  if (jsvHasHashIndex(var)) jsvHashIndexFree(var);
+#endif
+#ifdef JSV_ARRAY_INDEX_MIN_ELEMENTS
+  // Arrays may use nextSibling for their index
+  if (jsvIsArray(var)) jsvArrayIndexFree(var);
+#endif
+#ifdef JSV_PROPERTY_CACHE_SIZE
+  // Another object could end up here
+  if (jsvHasChildren(var)) jsvPropertyCacheForgetObject(jsvGetRef(var), false);
+#endif
   /* To be here, we're not supposed to be part of anything else. If
    * we were, we'd have been freed by jsvGarbageCollect */
   assert((!jsvGetNextSibling(var) && !jsvGetPrevSibling(var)) || // check that next/prevSibling are not set
@@ -463,8 +1032,18 @@ ALWAYS_INLINE void jsvFreePtr(JsVar *var) {
 
   /* Now, free children - see jsvar.h comments for how! */
   if (jsvHasStringExt(var)) {
+#ifdef JSV_STRING_TAIL_CACHE_SIZE
+    jsvStringTailCacheForget(var);
+#endif
     // Free the string without recursing
     JsVarRef stringDataRef = jsvGetLastChild(var);
+#ifdef JSV_ATOM_TABLE_SIZE
+    if (jsvGetNameAtom(var)) {
+      // the rest of the name is shared with other names
+      jsvUnRefRef(stringDataRef);
+      stringDataRef = 0;
+    }
+#endif
 #ifdef CLEAR_MEMORY_ON_FREE
     jsvSetLastChild(var, 0);
 #endif // CLEAR_MEMORY_ON_FREE
@@ -485,6 +1064,10 @@ ALWAYS_INLINE void jsvFreePtr(JsVar *var) {
         p->flags = JSV_UNUSED; // set locks to 0 so the assert in jsvFreePtrInternal doesn't get fed up
         jsvFreePtrInternal(p);
       }
+#ifdef JSV_FREE_RUN_BUCKETS
+      // remember this, so the next flat string can go straight here
+      jsvFreeRunAdd(jsvGetRef(var), (unsigned int)jsvGetFlatStringBlocks(var)+1);
+#endif
     } else if (jsvIsBasicString(var)) {
 #ifdef CLEAR_MEMORY_ON_FREE
       jsvSetFirstChild(var, 0); // firstchild could have had string data in
@@ -556,6 +1139,10 @@ ALWAYS_INLINE JsVar *jsvLock(JsVarRef ref) {
   //var->locks++;
   assert(jsvGetLocks(var) < JSV_LOCK_MAX);
   var->flags += JSV_LOCK_ONE;
+#ifdef JSV_GC_GRAY_STACK_SIZE
+  // Anything that gets locked while we're marking must be kept
+  if ((var->flags & JSV_GARBAGE_COLLECT) && jsvGCIsMarking()) jsvGCShade(var);
+#endif
 #ifdef DEBUG
   if (jsvGetLocks(var)==0) {
     jsError("Too many locks to Variable!");
@@ -570,6 +1157,9 @@ ALWAYS_INLINE JsVar *jsvLockAgain(JsVar *var) {
   assert(var);
   assert(jsvGetLocks(var) < JSV_LOCK_MAX);
   var->flags += JSV_LOCK_ONE;
+#ifdef JSV_GC_GRAY_STACK_SIZE
+  if ((var->flags & JSV_GARBAGE_COLLECT) && jsvGCIsMarking()) jsvGCShade(var);
+#endif
   return var;
 }
 
@@ -622,6 +1212,11 @@ NO_INLINE void jsvUnLockMany(unsigned int count, JsVar **vars) {
 JsVar *jsvRef(JsVar *var) {
   assert(var && jsvHasRef(var));
   jsvSetRefs(var, (JsVarRefCounter)(jsvGetRefs(var)+1));
+#ifdef JSV_GC_GRAY_STACK_SIZE
+  /* Write barrier - if we're marking and this is now referenced from
+   * something that's already been scanned, it must not be freed */
+  if ((var->flags & JSV_GARBAGE_COLLECT) && jsvGCIsMarking()) jsvGCShade(var);
+#endif
   assert(jsvGetRefs(var));
   return var;
 }
@@ -662,6 +1257,23 @@ JsVar *jsvNewFlatStringOfLength(unsigned int byteLength) {
   isMemoryBusy = true;
   // Work out how many blocks we need. One for the header, plus some for the characters
   size_t blocks = 1 + ((byteLength+sizeof(JsVar)-1) / sizeof(JsVar));
+#ifdef JSV_FREE_RUN_BUCKETS
+  // If we know where there's space, we don't have to look through all of memory
+  JsVar *flatStringFromRun = jsvFreeRunAllocate((unsigned int)blocks);
+  if (flatStringFromRun) {
+    jsvResetVariable(flatStringFromRun, JSV_FLAT_STRING);
+    flatStringFromRun->varData.integer = (JsVarInt)byteLength;
+    memset((char*)&flatStringFromRun[1], 0, sizeof(JsVar)*(blocks-1));
+#ifdef JSV_GC_GRAY_STACK_SIZE
+    jsvGCNewFlatString(flatStringFromRun);
+#endif
+#ifdef JSV_ALLOCATION_SITES
+    if (jsvAllocationSites) jsvRecordAllocationSite(flatStringFromRun);
+#endif
+    isMemoryBusy = false;
+    return flatStringFromRun;
+  }
+#endif
   // Now try and find them
   unsigned int blockCount = 0;
 
@@ -669,7 +1281,7 @@ JsVar *jsvNewFlatStringOfLength(unsigned int byteLength) {
   JsVar *lastVar = 0;
 #endif
 
-  jsVarFirstEmpty = 0;
+  jsvFreeListSetFirst(0);
   JsVar firstVar; // temporary var to simplify code in the loop below
   jsvSetNextSibling(&firstVar, 0);
   JsVar *lastEmpty = &firstVar;
@@ -726,8 +1338,24 @@ JsVar *jsvNewFlatStringOfLength(unsigned int byteLength) {
     }
   }
   jsvSetNextSibling(lastEmpty, 0);
-  jsVarFirstEmpty = jsvGetNextSibling(&firstVar);
+  jsvFreeListSetFirst(jsvGetNextSibling(&firstVar));
+#ifdef JSV_FREE_RUN_BUCKETS
+  jsvFreeListRelink();
+#endif
+#ifdef JSV_GC_GRAY_STACK_SIZE
+  if (flatString) jsvGCNewFlatString(flatString);
+#endif
+#ifdef JSV_ALLOCATION_SITES
+  if (flatString && jsvAllocationSites) jsvRecordAllocationSite(flatString);
+#endif
   isMemoryBusy = false;
+#ifdef JSV_DEFRAG_BATCH_SIZE
+  /* If there was enough free memory, it was just too fragmented. We can't
+   * move vars now as our caller may have references to them, so do it
+   * when we're next idle (see jsvDefragment) */
+  if (!flatString && jsvMoreFreeVariablesThan((unsigned int)blocks))
+    jsvDefragNeeded = true;
+#endif
   // Return whatever we had (0 if we couldn't manage it)
   return flatString;
 }
@@ -769,6 +1397,30 @@ JsVar *jsvNewFromString(const char *str) {
   return first;
 }
 
+JsVar *jsvNewFromStringBuf(const char *str, size_t length) {
+  JsVar *first = jsvNewWithFlags(JSV_STRING_0);
+  if (!first) return 0; // out of memory
+  // Copy a block at a time, creating new jsVars as each one fills up
+  JsVar *var = jsvLockAgain(first);
+  while (true) {
+    size_t l = jsvGetMaxCharactersInVar(var);
+    if (l>length) l = length;
+    memcpy(var->varData.str, str, l);
+    jsvSetCharactersInVar(var, l);
+    str += l;
+    length -= l;
+    if (!length) break;
+    JsVar *next = jsvNewWithFlags(JSV_STRING_EXT_0);
+    if (!next) break; // Truncating string as not enough memory
+    // we don't ref, because  StringExts are never reffed as they only have one owner (and ALWAYS have an owner)
+    jsvSetLastChild(var, jsvGetRef(next));
+    jsvUnLock(var);
+    var = next;
+  }
+  jsvUnLock(var);
+  return first;
+}
+
 JsVar *jsvNewStringOfLength(unsigned int byteLength) {
   // Create a var
   JsVar *first = jsvNewWithFlags(JSV_STRING_0);
@@ -853,29 +1505,49 @@ JsVar *jsvMakeIntoVariableName(JsVar *var, JsVar *valueOrZero) {
       /* Argh. String is too large to fit in a JSV_NAME! We must chomp make
        * new STRINGEXTs to put the data in
        */
-      JsvStringIterator it;
-      jsvStringIteratorNew(&it, var, JSVAR_DATA_STRING_NAME_LEN);
-      JsVar *startExt = jsvNewWithFlags(JSV_STRING_EXT_0);
-      JsVar *ext = jsvLockAgainSafe(startExt);
-      size_t nChars = 0;
-      while (ext && jsvStringIteratorHasChar(&it)) {
-        if (nChars >= JSVAR_DATA_STRING_MAX_LEN) {
-          jsvSetCharactersInVar(ext, nChars);
-          JsVar *ext2 = jsvNewWithFlags(JSV_STRING_EXT_0);
-          if (ext2) {
-            jsvSetLastChild(ext, jsvGetRef(ext2));
+#ifdef JSV_STRING_TAIL_CACHE_SIZE
+      jsvStringTailCacheForget(var);
+#endif
+      JsVar *startExt = 0;
+#ifdef JSV_ATOM_TABLE_SIZE
+      // Share the rest of the name with any other names that have it
+      startExt = jsvAtomGet(var, JSVAR_DATA_STRING_NAME_LEN);
+      if (startExt) {
+        jsvRef(startExt);
+        // The atom has all our characters, so we don't need our STRING_EXTs any more
+        JsVarRef ref = jsvGetLastChild(var);
+        while (ref) {
+          JsVar *ext = jsvGetAddressOf(ref);
+          ref = jsvGetLastChild(ext);
+          jsvFreePtrInternal(ext);
+        }
+      }
+#endif
+      if (!startExt) {
+        JsvStringIterator it;
+        jsvStringIteratorNew(&it, var, JSVAR_DATA_STRING_NAME_LEN);
+        startExt = jsvNewWithFlags(JSV_STRING_EXT_0);
+        JsVar *ext = jsvLockAgainSafe(startExt);
+        size_t nChars = 0;
+        while (ext && jsvStringIteratorHasChar(&it)) {
+          if (nChars >= JSVAR_DATA_STRING_MAX_LEN) {
+            jsvSetCharactersInVar(ext, nChars);
+            JsVar *ext2 = jsvNewWithFlags(JSV_STRING_EXT_0);
+            if (ext2) {
+              jsvSetLastChild(ext, jsvGetRef(ext2));
+            }
+            jsvUnLock(ext);
+            ext = ext2;
+            nChars = 0;
           }
+          ext->varData.str[nChars++] = jsvStringIteratorGetChar(&it);
+          jsvStringIteratorNext(&it);
+        }
+        jsvStringIteratorFree(&it);
+        if (ext) {
+          jsvSetCharactersInVar(ext, nChars);
           jsvUnLock(ext);
-          ext = ext2;
-          nChars = 0;
         }
-        ext->varData.str[nChars++] = jsvStringIteratorGetChar(&it);
-        jsvStringIteratorNext(&it);
-      }
-      jsvStringIteratorFree(&it);
-      if (ext) {
-        jsvSetCharactersInVar(ext, nChars);
-        jsvUnLock(ext);
       }
       jsvSetCharactersInVar(var, JSVAR_DATA_STRING_NAME_LEN);
       jsvSetLastChild(var, jsvGetRef(startExt));
@@ -991,6 +1663,16 @@ bool jsvIsBasicVarEqual(JsVar *a, JsVar *b) {
       }
     }
   } else if (jsvIsString(a) && jsvIsString(b)) {
+#ifdef JSV_ATOM_TABLE_SIZE
+    if (jsvGetNameAtom(a) && jsvIsName(b)) {
+      // Names that share an atom are equal if the start of them is...
+      if (jsvGetLastChild(a)==jsvGetLastChild(b))
+        return memcmp(a->varData.str, b->varData.str, JSVAR_DATA_STRING_NAME_LEN)==0;
+      // ... and there's only one atom with the same characters
+      if (jsvAtomsUnique && jsvGetNameAtom(b))
+        return false;
+    }
+#endif
     JsvStringIterator ita, itb;
     jsvStringIteratorNew(&ita, a, 0);
     jsvStringIteratorNew(&itb, b, 0);
@@ -1270,6 +1952,16 @@ size_t jsvGetStringLength(const JsVar *v) {
   const JsVar *var = v;
   JsVar *newVar = 0;
   if (!jsvHasCharacterData(v)) return 0;
+#ifdef JSV_STRING_TAIL_CACHE_SIZE
+  // If we know where the end is, we don't need to count through everything
+  size_t tailIndex;
+  JsVar *tail = jsvStringTailCacheGet((JsVar*)v, &tailIndex);
+  if (tail) {
+    strLength = tailIndex + jsvGetCharactersInVar(tail);
+    jsvUnLock(tail);
+    return strLength;
+  }
+#endif
 
   while (var) {
     JsVarRef ref = jsvGetLastChild(var);
@@ -1283,6 +1975,53 @@ size_t jsvGetStringLength(const JsVar *v) {
   return strLength;
 }
 
+#ifdef JSV_STRING_TAIL_CACHE_SIZE
+/* Finding the end of a string means following its chain of STRING_EXTs,
+ * so appending to a long string one bit at a time would take longer and
+ * longer. Instead we remember the last block of the few strings that were
+ * last appended to (there's no space in the string itself). Entries are
+ * forgotten when the string is freed, so anything in here is valid.
+ */
+JsVar *jsvStringTailCacheGet(JsVar *str, size_t *tailIndex) {
+  JsVarRef ref = jsvGetRef(str);
+  unsigned int i;
+  for (i=0;i<JSV_STRING_TAIL_CACHE_SIZE;i++) {
+    if (jsvStringTails[i].string == ref) {
+      *tailIndex = jsvStringTails[i].tailIndex;
+      return jsvLock(jsvStringTails[i].tail);
+    }
+  }
+  return 0;
+}
+
+void jsvStringTailCacheSet(JsVar *str, JsVar *tail, size_t tailIndex) {
+  if (!jsvIsBasicString(str)) return; // names may get turned into other things
+  JsVarRef ref = jsvGetRef(str);
+  unsigned int i;
+  for (i=0;i<JSV_STRING_TAIL_CACHE_SIZE;i++)
+    if (jsvStringTails[i].string == ref)
+      break;
+  if (i>=JSV_STRING_TAIL_CACHE_SIZE) {
+    i = jsvStringTailNext;
+    jsvStringTailNext = (unsigned char)((jsvStringTailNext+1) % JSV_STRING_TAIL_CACHE_SIZE);
+  }
+  jsvStringTails[i].string = ref;
+  jsvStringTails[i].tail = jsvGetRef(tail);
+  jsvStringTails[i].tailIndex = tailIndex;
+}
+
+void jsvStringTailCacheExtended(JsVar *oldTail, JsVar *newTail, size_t newTailIndex) {
+  JsVarRef ref = jsvGetRef(oldTail);
+  unsigned int i;
+  for (i=0;i<JSV_STRING_TAIL_CACHE_SIZE;i++) {
+    if (jsvStringTails[i].string && jsvStringTails[i].tail == ref) {
+      jsvStringTails[i].tail = jsvGetRef(newTail);
+      jsvStringTails[i].tailIndex = newTailIndex;
+    }
+  }
+}
+#endif
+
 size_t jsvGetFlatStringBlocks(const JsVar *v) {
   assert(jsvIsFlatString(v));
   return ((size_t)v->varData.integer+sizeof(JsVar)-1) / sizeof(JsVar);
@@ -2042,6 +2781,11 @@ JsVar *jsvCopyNameOnly(JsVar *src, bool linkChildren, bool keepAsName) {
       // If it had extra string data it should have been handled above
       assert(keepAsName || !jsvGetLastChild(src));
       // copy extra bits of string if there were any
+#ifdef JSV_ATOM_TABLE_SIZE
+      if (jsvGetNameAtom(src)) {
+        jsvSetLastChild(dst, jsvRefRef(jsvGetLastChild(src))); // atoms are shared
+      } else
+#endif
       if (jsvGetLastChild(src)) {
         JsVar *child = jsvLock(jsvGetLastChild(src));
         JsVar *childCopy = jsvCopy(child);
@@ -2101,16 +2845,36 @@ JsVar *jsvCopy(JsVar *src) {
   }
 
   if (jsvHasStringExt(src)) {
-    // copy extra bits of string if there were any
-    if (jsvGetLastChild(src)) {
-      JsVar *child = jsvLock(jsvGetLastChild(src));
-      JsVar *childCopy = jsvCopy(child);
-      if (childCopy) {// could be out of memory
-        jsvSetLastChild(dst, jsvGetRef(childCopy)); // no ref for stringext
-        jsvUnLock(childCopy);
-      }
+    // copy extra bits of string if there were any (without recursion, as there may be lots)
+    JsVarRef childRef = jsvGetLastChild(src);
+#ifdef JSV_ATOM_TABLE_SIZE
+    if (jsvGetNameAtom(src)) {
+      // atoms are shared, so we don't copy them
+      jsvSetLastChild(dst, jsvRefRef(childRef));
+      childRef = 0;
+    }
+#endif
+    JsVar *dstTail = jsvLockAgain(dst);
+    size_t tailIndex = 0;
+    while (childRef) {
+      JsVar *child = jsvLock(childRef);
+      JsVar *childCopy = jsvNewWithFlags(child->flags & JSV_VARIABLEINFOMASK);
+      if (childCopy) { // could be out of memory
+        memcpy(&childCopy->varData, &child->varData, JSVAR_DATA_STRING_MAX_LEN);
+        jsvSetLastChild(dstTail, jsvGetRef(childCopy)); // no ref for stringext
+        tailIndex += jsvGetCharactersInVar(dstTail);
+        jsvUnLock(dstTail);
+        dstTail = childCopy;
+        childRef = jsvGetLastChild(child);
+      } else
+        childRef = 0;
       jsvUnLock(child);
     }
+#ifdef JSV_STRING_TAIL_CACHE_SIZE
+    // we're often about to append to this (eg. a+b)
+    if (dstTail != dst) jsvStringTailCacheSet(dst, dstTail, tailIndex);
+#endif
+    jsvUnLock(dstTail);
   } else if (jsvHasChildren(src)) {
     // Copy children..
     JsVarRef vr;
@@ -2132,33 +2896,363 @@ JsVar *jsvCopy(JsVar *src) {
   return dst;
 }
 
-void jsvAddName(JsVar *parent, JsVar *namedChild) {
-  namedChild = jsvRef(namedChild); // ref here VERY important as adding to structure!
-  assert(jsvIsName(namedChild));
+/* Objects that have lots of keys get a hash index, so we don't have to
+ * walk the whole linked list of children to find one. It's stored in a
+ * flat string that is linked from the Object's (otherwise unused) nextSibling
+ * field. The flat string contains a uint32_t with the number of slots that
+ * have been used (including deleted ones), followed by a power of 2 number
+ * of open-addressed slots containing the refs of the Object's NAMEs.
+ *
+ * Slots are never reused after a delete, which means that the order in which
+ * we probe is always the order in which the keys were added - so if there are
+ * duplicate keys we find the same one as a linear search would. */
+#ifdef JSV_HASH_INDEX_MIN_CHILDREN
+#define JSV_HASH_INDEX_DELETED ((JsVarRef)~(JsVarRef)0)
+#define JSV_HASH_INDEX_HASH_START 2166136261U // FNV-1a
+#define JSV_HASH_INDEX_HASH_CHAR(H, CH) (((H) ^ (unsigned char)(CH)) * 16777619U)
 
-  // update array length
-  if (jsvIsArray(parent) && jsvIsInt(namedChild)) {
-    JsVarInt index = namedChild->varData.integer;
-    if (index >= jsvGetArrayLength(parent)) {
-      jsvSetArrayLength(parent, index + 1, false);
-    }
+static ALWAYS_INLINE bool jsvCanHaveHashIndex(const JsVar *v) {
+  return (v->flags&JSV_VARTYPEMASK)==JSV_OBJECT || (v->flags&JSV_VARTYPEMASK)==JSV_ROOT;
+}
+
+bool jsvHasHashIndex(const JsVar *v) {
+  return jsvCanHaveHashIndex(v) && jsvGetNextSibling(v)!=0;
+}
+
+static uint32_t jsvHashIndexHashString(const char *str) {
+  uint32_t hash = JSV_HASH_INDEX_HASH_START;
+  while (*str) {
+    hash = JSV_HASH_INDEX_HASH_CHAR(hash, *str);
+    str++;
   }
+  return hash;
+}
 
-  if (jsvGetLastChild(parent)) { // we have children already
-    JsVar *insertAfter = jsvLock(jsvGetLastChild(parent));
-    if (jsvIsArray(parent)) {
-      // we must insert in order - so step back until we get the right place
-      while (insertAfter && jsvCompareInteger(namedChild, insertAfter)<0) {
-        JsVarRef prev = jsvGetPrevSibling(insertAfter);
-        jsvUnLock(insertAfter);
-        insertAfter = prev ? jsvLock(prev) : 0;
-      }
+static ALWAYS_INLINE uint32_t jsvHashIndexHashInteger(JsVarInt i) {
+  return (uint32_t)i * 2654435761U;
+}
+
+/// Hash a key - returns false if the key can't be hashed (so we must search linearly)
+static bool jsvHashIndexHashVar(const JsVar *key, uint32_t *hash) {
+  if (jsvIsString(key)) {
+    uint32_t h = JSV_HASH_INDEX_HASH_START;
+    JsvStringIterator it;
+    jsvStringIteratorNewConst(&it, key, 0);
+    while (jsvStringIteratorHasChar(&it)) {
+      h = JSV_HASH_INDEX_HASH_CHAR(h, jsvStringIteratorGetChar(&it));
+      jsvStringIteratorNext(&it);
     }
+    jsvStringIteratorFree(&it);
+    *hash = h;
+    return true;
+  }
+  // jsvIsBasicVarEqual compares all integerish values by their integer
+  if (jsvIsIntegerish(key) && !jsvIsNull(key)) {
+    *hash = jsvHashIndexHashInteger(key->varData.integer);
+    return true;
+  }
+  return false;
+}
 
-    if (insertAfter) {
-      if (jsvGetNextSibling(insertAfter)) {
-        // great, we're in the middle...
-        JsVar *insertBefore = jsvLock(jsvGetNextSibling(insertAfter));
+/// Get the slots in the hash index, and the amount of them
+static ALWAYS_INLINE JsVarRef *jsvHashIndexGetSlots(JsVar *index, unsigned int *slotCount) {
+  *slotCount = (unsigned int)((jsvGetCharactersInVar(index)-sizeof(uint32_t)) / sizeof(JsVarRef));
+  return (JsVarRef*)(jsvGetFlatStringPointer(index)+sizeof(uint32_t));
+}
+
+/// Get the amount of slots used in the hash index (including deleted ones)
+static ALWAYS_INLINE uint32_t *jsvHashIndexGetUsed(JsVar *index) {
+  return (uint32_t*)jsvGetFlatStringPointer(index);
+}
+
+/// Add a name to the hash index - there must be space
+static void jsvHashIndexInsert(JsVar *index, JsVarRef childref, uint32_t hash) {
+  unsigned int slotCount;
+  JsVarRef *slots = jsvHashIndexGetSlots(index, &slotCount);
+  unsigned int i = hash & (slotCount-1);
+  while (slots[i])
+    i = (i+1) & (slotCount-1);
+  slots[i] = childref;
+  (*jsvHashIndexGetUsed(index))++;
+}
+
+/// Remove any hash index from the given object
+static void jsvHashIndexFree(JsVar *parent) {
+  JsVarRef indexRef = jsvGetNextSibling(parent);
+  if (!indexRef) return;
+  jsvSetNextSibling(parent, 0);
+  jsvUnRefRef(indexRef); // which frees it
+}
+
+/// (Re)create the hash index for an object with the given amount of children
+static void jsvHashIndexRebuild(JsVar *parent, unsigned int children) {
+  jsvHashIndexFree(parent);
+  // Use a load factor of at most 1/2 to start with
+  unsigned int slotCount = JSV_HASH_INDEX_MIN_CHILDREN;
+  while (slotCount < children*2) slotCount <<= 1;
+  JsVar *index = jsvNewFlatStringOfLength((unsigned int)(sizeof(uint32_t) + slotCount*sizeof(JsVarRef)));
+  if (!index) return; // no memory (or fragmented) - we'll just search linearly
+  JsVarRef childref = jsvGetFirstChild(parent);
+  while (childref) {
+    JsVar *child = jsvGetAddressOf(childref);
+    uint32_t hash;
+    if (!jsvHashIndexHashVar(child, &hash)) {
+      // something we can't index - give up
+      jsvUnLock(index);
+      return;
+    }
+    jsvHashIndexInsert(index, childref, hash);
+    childref = jsvGetNextSibling(child);
+  }
+  jsvSetNextSibling(parent, jsvGetRef(jsvRef(index)));
+  jsvUnLock(index);
+}
+
+/// Called from jsvAddName after a name has been linked in to an Object
+static void jsvHashIndexAdd(JsVar *parent, JsVar *namedChild) {
+  JsVar *index = jsvGetAddressOf(jsvGetNextSibling(parent));
+  unsigned int slotCount;
+  jsvHashIndexGetSlots(index, &slotCount);
+  uint32_t hash;
+  if (!jsvHashIndexHashVar(namedChild, &hash)) {
+    jsvHashIndexFree(parent);
+  } else if ((*jsvHashIndexGetUsed(index)+1)*4 > slotCount*3) {
+    // Too full - rebuild (which will also get rid of deleted slots)
+    jsvHashIndexRebuild(parent, (unsigned int)jsvGetChildren(parent));
+  } else {
+    jsvHashIndexInsert(index, jsvGetRef(namedChild), hash);
+  }
+}
+
+/// Called from jsvRemoveChild before a name is unlinked from an Object
+static void jsvHashIndexRemove(JsVar *parent, JsVar *child) {
+  JsVar *index = jsvGetAddressOf(jsvGetNextSibling(parent));
+  unsigned int slotCount;
+  JsVarRef *slots = jsvHashIndexGetSlots(index, &slotCount);
+  JsVarRef childref = jsvGetRef(child);
+  uint32_t hash;
+  if (!jsvHashIndexHashVar(child, &hash)) return;
+  unsigned int i = hash & (slotCount-1);
+  while (slots[i]) {
+    if (slots[i] == childref) {
+      slots[i] = JSV_HASH_INDEX_DELETED;
+      return;
+    }
+    i = (i+1) & (slotCount-1);
+  }
+}
+
+/// Find a child of an Object with a hash index. Either name or nameVar should be set
+static JsVar *jsvHashIndexFind(JsVar *parent, uint32_t hash, const char *name, JsVar *nameVar) {
+  JsVar *index = jsvGetAddressOf(jsvGetNextSibling(parent));
+  unsigned int slotCount;
+  JsVarRef *slots = jsvHashIndexGetSlots(index, &slotCount);
+  unsigned int i = hash & (slotCount-1);
+  while (slots[i]) {
+    if (slots[i] != JSV_HASH_INDEX_DELETED) {
+      JsVar *child = jsvGetAddressOf(slots[i]);
+      if (name ? jsvIsStringEqual(child, name) : jsvIsBasicVarEqual(child, nameVar))
+        return jsvLockAgain(child);
+    }
+    i = (i+1) & (slotCount-1);
+  }
+  return 0;
+}
+
+/** If parent has a hash index, use it to find a child (adding it if it's not
+ * there and addIfNotFound). Either name or nameVar should be set. Returns
+ * false if there's no index we can use, so we must search linearly */
+static bool jsvHashIndexFindChild(JsVar *parent, const char *name, JsVar *nameVar, bool addIfNotFound, JsVar **child) {
+  if (!jsvHasHashIndex(parent)) return false;
+  uint32_t hash;
+  if (name) hash = jsvHashIndexHashString(name);
+  else if (!jsvHashIndexHashVar(nameVar, &hash)) return false;
+  *child = jsvHashIndexFind(parent, hash, name, nameVar);
+  if (!*child && addIfNotFound) {
+    *child = name ? jsvMakeIntoVariableName(jsvNewFromString(name), 0) : jsvAsName(nameVar);
+    if (*child) // could be out of memory
+      jsvAddName(parent, *child);
+  }
+  return true;
+}
+
+/// We had to search past this many children of parent to find a name (or not) - if it was a lot, add an index so it's faster next time
+static void jsvHashIndexSearched(JsVar *parent, unsigned int searched) {
+  // If there's an index already, it just couldn't be used for the name we wanted
+  if (searched >= JSV_HASH_INDEX_MIN_CHILDREN && jsvCanHaveHashIndex(parent) && !jsvHasHashIndex(parent))
+    jsvHashIndexRebuild(parent, (unsigned int)jsvGetChildren(parent));
+}
+
+/// Get the number of Objects that currently have a hash index
+unsigned int jsvGetHashIndexCount() {
+  unsigned int count = 0;
+  unsigned int i;
+  for (i=1;i<=jsVarsSize;i++) {
+    JsVar *v = jsvGetAddressOf((JsVarRef)i);
+    if (jsvHasHashIndex(v))
+      count++;
+    else if (jsvIsFlatString(v))
+      i += (unsigned int)jsvGetFlatStringBlocks(v);
+  }
+  return count;
+}
+#else
+bool jsvHasHashIndex(const JsVar *v) { NOT_USED(v); return false; }
+unsigned int jsvGetHashIndexCount() { return 0; }
+#endif
+
+/* Arrays whose elements are densely packed (the only keys are the integers
+ * 0..n-1) can get an index too. It's a flat string linked from the Array's
+ * nextSibling, containing a uint32_t with the number of elements followed
+ * by the refs of the elements' NAMEs, in order - so arr[i] is a single lookup.
+ *
+ * Anything that stops the array being densely packed (or that renumbers
+ * elements) just removes the index, and the next long search recreates it. */
+#ifdef JSV_ARRAY_INDEX_MIN_ELEMENTS
+static ALWAYS_INLINE bool jsvHasArrayIndex(const JsVar *v) {
+  return jsvIsArray(v) && jsvGetNextSibling(v)!=0;
+}
+
+/// Get the element refs in the array index, and the amount of space for them
+static ALWAYS_INLINE JsVarRef *jsvArrayIndexGetSlots(JsVar *index, unsigned int *slotCount) {
+  *slotCount = (unsigned int)((jsvGetCharactersInVar(index)-sizeof(uint32_t)) / sizeof(JsVarRef));
+  return (JsVarRef*)(jsvGetFlatStringPointer(index)+sizeof(uint32_t));
+}
+
+/// Remove any index from the given Array
+static void jsvArrayIndexFree(JsVar *arr) {
+  JsVarRef indexRef = jsvGetNextSibling(arr);
+  if (!indexRef) return;
+  jsvSetNextSibling(arr, 0);
+  jsvUnRefRef(indexRef); // which frees it
+}
+
+/// (Re)create the index for an Array - if it's not densely packed nothing will be created
+static void jsvArrayIndexRebuild(JsVar *arr) {
+  jsvArrayIndexFree(arr);
+  JsVarInt length = jsvGetArrayLength(arr);
+  // quick checks to see if it could be densely packed
+  if (length<=0 || length>(JsVarInt)jsvGetMemoryTotal() ||
+      !jsvIsInt(jsvGetAddressOf(jsvGetLastChild(arr))) ||
+      jsvGetAddressOf(jsvGetLastChild(arr))->varData.integer!=length-1)
+    return;
+  // leave some space so we can push elements on the end
+  unsigned int slotCount = (unsigned int)length + (unsigned int)length/2 + 1;
+  JsVar *index = jsvNewFlatStringOfLength((unsigned int)(sizeof(uint32_t) + slotCount*sizeof(JsVarRef)));
+  if (!index) return; // no memory (or fragmented) - we'll just search linearly
+  uint32_t *count = (uint32_t*)jsvGetFlatStringPointer(index);
+  JsVarRef *slots = jsvArrayIndexGetSlots(index, &slotCount);
+  *count = 0;
+  JsVarRef childref = jsvGetFirstChild(arr);
+  while (childref) {
+    JsVar *child = jsvGetAddressOf(childref);
+    if (!jsvIsInt(child) || child->varData.integer!=(JsVarInt)*count) {
+      // not densely packed
+      jsvUnLock(index);
+      return;
+    }
+    slots[(*count)++] = childref;
+    childref = jsvGetNextSibling(child);
+  }
+  if ((JsVarInt)*count != length) {
+    // there's a hole at the end
+    jsvUnLock(index);
+    return;
+  }
+  jsvSetNextSibling(arr, jsvGetRef(jsvRef(index)));
+  jsvUnLock(index);
+}
+
+/// Called from jsvAddName after a name has been linked in to an Array
+static void jsvArrayIndexAdd(JsVar *arr, JsVar *namedChild) {
+  JsVar *index = jsvGetAddressOf(jsvGetNextSibling(arr));
+  uint32_t *count = (uint32_t*)jsvGetFlatStringPointer(index);
+  unsigned int slotCount;
+  JsVarRef *slots = jsvArrayIndexGetSlots(index, &slotCount);
+  if (!jsvIsInt(namedChild) || namedChild->varData.integer!=(JsVarInt)*count) {
+    jsvArrayIndexFree(arr); // no longer densely packed
+  } else if (*count < slotCount) {
+    slots[(*count)++] = jsvGetRef(namedChild);
+  } else {
+    jsvArrayIndexRebuild(arr); // out of space
+  }
+}
+
+/// Called from jsvRemoveChild before a name is unlinked from an Array
+static void jsvArrayIndexRemove(JsVar *arr, JsVar *child) {
+  JsVar *index = jsvGetAddressOf(jsvGetNextSibling(arr));
+  uint32_t *count = (uint32_t*)jsvGetFlatStringPointer(index);
+  if (*count>1 && jsvGetLastChild(arr)==jsvGetRef(child)) {
+    (*count)--; // removing the last element, we're still packed
+  } else {
+    jsvArrayIndexFree(arr);
+  }
+}
+
+/** Look up an element in an Array that has an index. Returns false if the
+ * index was out of date (and has been removed), so a normal search is needed */
+static bool jsvArrayIndexFind(JsVar *arr, JsVarInt i, JsVar **result) {
+  JsVar *index = jsvGetAddressOf(jsvGetNextSibling(arr));
+  uint32_t count = *(uint32_t*)jsvGetFlatStringPointer(index);
+  unsigned int slotCount;
+  JsVarRef *slots = jsvArrayIndexGetSlots(index, &slotCount);
+  if (i<0 || i>=(JsVarInt)count) {
+    // densely packed, so there's nothing else here
+    *result = 0;
+    return true;
+  }
+  JsVar *child = jsvGetAddressOf(slots[i]);
+  if (!jsvIsName(child) || !jsvIsInt(child) || child->varData.integer!=i) {
+    // something renumbered the elements
+    jsvArrayIndexFree(arr);
+    return false;
+  }
+  *result = jsvLockAgain(child);
+  return true;
+}
+#endif
+
+void jsvAddName(JsVar *parent, JsVar *namedChild) {
+  namedChild = jsvRef(namedChild); // ref here VERY important as adding to structure!
+  assert(jsvIsName(namedChild));
+#ifdef JSV_PROPERTY_CACHE_SIZE
+  if (!jsvIsInt(namedChild)) {
+    // This may hide something we found in a prototype
+    jsvPropertyCacheForgetObject(jsvGetRef(parent), true);
+    // and if anything references us, we may be a prototype
+    if (jsvGetRefs(parent) || jsvIsRoot(parent))
+      jsvPropertyCacheEpoch++;
+  }
+#endif
+#ifdef JSPARSE_VARIABLE_CACHE_SIZE
+  // If this is a scope, it may now hide a variable that was found further out
+  if (!jsvIsInt(namedChild) && (jsvGetRefs(parent) || jsvIsRoot(parent)))
+    jsvNameEpoch++;
+#endif
+
+  // update array length
+  if (jsvIsArray(parent) && jsvIsInt(namedChild)) {
+    JsVarInt index = namedChild->varData.integer;
+    if (index >= jsvGetArrayLength(parent)) {
+      jsvSetArrayLength(parent, index + 1, false);
+    }
+  }
+
+  if (jsvGetLastChild(parent)) { // we have children already
+    JsVar *insertAfter = jsvLock(jsvGetLastChild(parent));
+    if (jsvIsArray(parent)) {
+      // we must insert in order - so step back until we get the right place
+      while (insertAfter && jsvCompareInteger(namedChild, insertAfter)<0) {
+        JsVarRef prev = jsvGetPrevSibling(insertAfter);
+        jsvUnLock(insertAfter);
+        insertAfter = prev ? jsvLock(prev) : 0;
+      }
+    }
+
+    if (insertAfter) {
+      if (jsvGetNextSibling(insertAfter)) {
+        // great, we're in the middle...
+        JsVar *insertBefore = jsvLock(jsvGetNextSibling(insertAfter));
         jsvSetPrevSibling(insertBefore, jsvGetRef(namedChild));
         jsvSetNextSibling(namedChild, jsvGetRef(insertBefore));
         jsvUnLock(insertBefore);
@@ -2184,6 +3278,14 @@ void jsvAddName(JsVar *parent, JsVar *namedChild) {
     jsvSetFirstChild(parent, r);
     jsvSetLastChild(parent, r);
   }
+#ifdef JSV_HASH_INDEX_MIN_CHILDREN
+  if (jsvHasHashIndex(parent))
+    jsvHashIndexAdd(parent, namedChild);
+#endif
+#ifdef JSV_ARRAY_INDEX_MIN_ELEMENTS
+  if (jsvHasArrayIndex(parent))
+    jsvArrayIndexAdd(parent, namedChild);
+#endif
 }
 
 JsVar *jsvAddNamedChild(JsVar *parent, JsVar *child, const char *name) {
@@ -2213,8 +3315,14 @@ JsVar *jsvSetValueOfName(JsVar *name, JsVar *src) {
     else
       name->flags = (name->flags & (JsVarFlags)~JSV_VARTYPEMASK) | JSV_NAME_INT;
     jsvSetFirstChild(name, 0);
-  } else if (jsvGetFirstChild(name))
+  } else if (jsvGetFirstChild(name)) {
+#ifdef JSV_PROPERTY_CACHE_SIZE
+    // We could be replacing a prototype (or something that has one)
+    if (jsvHasChildren(jsvGetAddressOf(jsvGetFirstChild(name))))
+      jsvPropertyCacheEpoch++;
+#endif
     jsvUnRefRef(jsvGetFirstChild(name)); // free existing
+  }
   if (src) {
     if (jsvIsInt(name)) {
       if ((jsvIsInt(src) || jsvIsBoolean(src)) && !jsvIsPin(src)) {
@@ -2267,18 +3375,38 @@ JsVar *jsvFindChildFromString(JsVar *parent, const char *name, bool addIfNotFoun
   }
 
   assert(jsvHasChildren(parent));
+  JsVarRef nameAtom = 0;
+#ifdef JSV_ATOM_TABLE_SIZE
+  // If the end of the name is in an atom, names with atoms can be compared just by that
+  nameAtom = jsvAtomFindForString(name);
+#endif
+#ifdef JSV_HASH_INDEX_MIN_CHILDREN
+  JsVar *indexed;
+  if (jsvHashIndexFindChild(parent, name, 0, addIfNotFound, &indexed))
+    return indexed;
+  unsigned int searched = 0;
+#endif
   JsVarRef childref = jsvGetFirstChild(parent);
   while (childref) {
     // Don't Lock here, just use GetAddressOf - to try and speed up the finding
     // TODO: We can do this now, but when/if we move to cacheing vars, it'll break
     JsVar *child = jsvGetAddressOf(childref);
     if (*(int*)fastCheck==*(int*)child->varData.str && // speedy check of first 4 bytes
-        jsvIsStringEqual(child, name)) {
+        jsvIsNameEqualString(child, name, nameAtom)) {
       // found it! unlock parent but leave child locked
+#ifdef JSV_HASH_INDEX_MIN_CHILDREN
+      jsvHashIndexSearched(parent, searched);
+#endif
       return jsvLockAgain(child);
     }
     childref = jsvGetNextSibling(child);
+#ifdef JSV_HASH_INDEX_MIN_CHILDREN
+    searched++;
+#endif
   }
+#ifdef JSV_HASH_INDEX_MIN_CHILDREN
+  jsvHashIndexSearched(parent, searched);
+#endif
 
   JsVar *child = 0;
   if (addIfNotFound) {
@@ -2319,17 +3447,45 @@ JsVar *jsvAsName(JsVar *var) {
 /** Non-recursive finding */
 JsVar *jsvFindChildFromVar(JsVar *parent, JsVar *childName, bool addIfNotFound) {
   JsVar *child;
+#ifdef JSV_ARRAY_INDEX_MIN_ELEMENTS
+  if (jsvIsArray(parent) && jsvIsInt(childName)) {
+    // If we'd have to search a long way, try and add an index
+    if (!jsvHasArrayIndex(parent) && childName->varData.integer>=JSV_ARRAY_INDEX_MIN_ELEMENTS)
+      jsvArrayIndexRebuild(parent);
+    if (jsvHasArrayIndex(parent) && jsvArrayIndexFind(parent, childName->varData.integer, &child)) {
+      if (!child && addIfNotFound) {
+        child = jsvAsName(childName);
+        jsvAddName(parent, child);
+      }
+      return child;
+    }
+  }
+#endif
+#ifdef JSV_HASH_INDEX_MIN_CHILDREN
+  if (jsvHashIndexFindChild(parent, 0, childName, addIfNotFound && childName, &child))
+    return child;
+  unsigned int searched = 0;
+#endif
   JsVarRef childref = jsvGetFirstChild(parent);
 
   while (childref) {
     child = jsvLock(childref);
     if (jsvIsBasicVarEqual(child, childName)) {
       // found it! unlock parent but leave child locked
+#ifdef JSV_HASH_INDEX_MIN_CHILDREN
+      jsvHashIndexSearched(parent, searched);
+#endif
       return child;
     }
     childref = jsvGetNextSibling(child);
     jsvUnLock(child);
+#ifdef JSV_HASH_INDEX_MIN_CHILDREN
+    searched++;
+#endif
   }
+#ifdef JSV_HASH_INDEX_MIN_CHILDREN
+  jsvHashIndexSearched(parent, searched);
+#endif
 
   child = 0;
   if (addIfNotFound && childName) {
@@ -2344,6 +3500,30 @@ void jsvRemoveChild(JsVar *parent, JsVar *child) {
   assert(jsvIsName(child));
   JsVarRef childref = jsvGetRef(child);
   bool wasChild = false;
+#ifdef JSV_PROPERTY_CACHE_SIZE
+  if (!jsvIsInt(child)) {
+    jsvPropertyCacheForgetName(childref);
+    if (jsvGetRefs(parent) || jsvIsRoot(parent))
+      jsvPropertyCacheEpoch++;
+  }
+#endif
+#ifdef JSPARSE_VARIABLE_CACHE_SIZE
+  // If this is a scope, a variable that was found here is gone
+  if (!jsvIsInt(child) && (jsvGetRefs(parent) || jsvIsRoot(parent)))
+    jsvNameEpoch++;
+#endif
+#ifdef JSV_HASH_INDEX_MIN_CHILDREN
+  if (jsvHasHashIndex(parent)) {
+    if (jsvGetFirstChild(parent) == jsvGetLastChild(parent))
+      jsvHashIndexFree(parent); // we're removing the last child
+    else
+      jsvHashIndexRemove(parent, child);
+  }
+#endif
+#ifdef JSV_ARRAY_INDEX_MIN_ELEMENTS
+  if (jsvHasArrayIndex(parent))
+    jsvArrayIndexRemove(parent, child);
+#endif
   // unlink from parent
   if (jsvGetFirstChild(parent) == childref) {
     jsvSetFirstChild(parent, jsvGetNextSibling(child));
@@ -2394,6 +3574,69 @@ void jsvRemoveAllChildren(JsVar *parent) {
   }
 }
 
+#ifdef JSV_PROPERTY_CACHE_SIZE
+/* Property accesses like `a.b` can be slow - especially for built-in
+ * functions, where we have to search the object and then all its prototypes
+ * first. Instead we remember where each one was found. Entries are
+ * forgotten when the object is freed or the name is removed from it. Things
+ * found in prototypes could be hidden by adding a child to the object, or by
+ * anything changing in a prototype. We don't know what is a prototype, so
+ * we just assume anything that is referenced could be and invalidate all
+ * of them (with jsvPropertyCacheEpoch).
+ */
+/// Get the length of field (up to 255), and its first 4 characters (0 padded)
+static unsigned char jsvPropertyCacheGetFieldStart(const char *field, char *start) {
+  size_t len = strlen(field);
+  unsigned int i;
+  for (i=0;i<4;i++) start[i] = (i<len) ? field[i] : 0;
+  return (unsigned char)((len>255) ? 255 : len);
+}
+
+JsvPropertyCacheType jsvPropertyCacheGet(uint32_t key, JsVar *object, const char *field, JsVar **name) {
+  JsvPropertyCacheEntry *e = &jsvPropertyCache[key % JSV_PROPERTY_CACHE_SIZE];
+  if (e->key!=key || e->object!=jsvGetRef(object) ||
+      (e->type!=JSVPC_OWN && e->epoch!=jsvPropertyCacheEpoch))
+    return JSVPC_NONE;
+  // Different names can have the same key, so check it's really the same one
+  char fieldStart[4];
+  if (jsvPropertyCacheGetFieldStart(field, fieldStart)!=e->fieldLength ||
+      memcmp(fieldStart, e->fieldStart, sizeof(fieldStart)))
+    return JSVPC_NONE;
+  if (e->type!=JSVPC_BUILTIN) {
+    *name = jsvLock(e->name);
+    if (!jsvIsStringEqual(*name, field)) {
+      jsvUnLock(*name);
+      *name = 0;
+      return JSVPC_NONE;
+    }
+  }
+  return (JsvPropertyCacheType)e->type;
+}
+
+void jsvPropertyCacheSet(uint32_t key, JsVar *object, const char *field, JsvPropertyCacheType type, JsVar *name) {
+  assert(jsvHasChildren(object)); // otherwise we wouldn't know when it was freed
+  JsvPropertyCacheEntry *e = &jsvPropertyCache[key % JSV_PROPERTY_CACHE_SIZE];
+  e->key = key;
+  e->object = jsvGetRef(object);
+  e->name = name ? jsvGetRef(name) : 0;
+  e->type = (unsigned char)type;
+  e->fieldLength = jsvPropertyCacheGetFieldStart(field, e->fieldStart);
+  e->epoch = jsvPropertyCacheEpoch;
+}
+#endif
+
+#ifdef JSPARSE_VARIABLE_CACHE_SIZE
+/* Looking up variables means searching each scope in turn (see
+ * jspeiFindInScopes), so bytecode remembers where it found them. They can
+ * only be found somewhere else if a name is added to or removed from a scope,
+ * and anything used as a scope is referenced (or is root) - so when that
+ * happens to anything referenced we change the epoch and forget them all.
+ */
+unsigned int jsvGetNameEpoch() {
+  return jsvNameEpoch;
+}
+#endif
+
 /// Check if the given name is a child of the parent
 bool jsvIsChild(JsVar *parent, JsVar *child) {
   assert(jsvIsArray(parent) || jsvIsObject(parent));
@@ -2534,8 +3777,21 @@ static size_t _jsvCountJsVarsUsedRecursive(JsVar *v, bool resetRecursionFlag) {
       else childref = 0;
       jsvUnLock(child);
     }
+    if (jsvHasHashIndex(v) || (jsvIsArray(v) && jsvGetNextSibling(v))) {
+      JsVar *index = jsvLock(jsvGetNextSibling(v));
+      count += _jsvCountJsVarsUsedRecursive(index, resetRecursionFlag);
+      jsvUnLock(index);
+    }
   } else if (jsvIsFlatString(v))
     count += jsvGetFlatStringBlocks(v);
+#ifdef JSV_ATOM_TABLE_SIZE
+  if (jsvGetNameAtom(v)) {
+    // atoms are shared, so only count them once
+    JsVar *atom = jsvLock(jsvGetLastChild(v));
+    count += _jsvCountJsVarsUsedRecursive(atom, resetRecursionFlag);
+    jsvUnLock(atom);
+  } else
+#endif
   if (jsvHasCharacterData(v)) {
     JsVarRef childref = jsvGetLastChild(v);
     while (childref) {
@@ -2562,6 +3818,11 @@ size_t jsvCountJsVarsUsed(JsVar *v) {
 }
 
 JsVar *jsvGetArrayIndex(const JsVar *arr, JsVarInt index) {
+#ifdef JSV_ARRAY_INDEX_MIN_ELEMENTS
+  JsVar *child;
+  if (jsvHasArrayIndex(arr) && jsvArrayIndexFind((JsVar*)arr, index, &child))
+    return child;
+#endif
   JsVarRef childref = jsvGetLastChild(arr);
   JsVarInt lastArrayIndex = 0;
   // Look at last non-string element!
@@ -2758,6 +4019,9 @@ JsVar *jsvArrayPop(JsVar *arr) {
 /// Removes the first element of an array, and returns that element (or 0 if empty). DOES NOT RENUMBER.
 JsVar *jsvArrayPopFirst(JsVar *arr) {
   assert(jsvIsArray(arr));
+#ifdef JSV_ARRAY_INDEX_MIN_ELEMENTS
+  jsvArrayIndexFree(arr); // the elements won't start from 0 any more
+#endif
   if (jsvGetFirstChild(arr)) {
     JsVar *child = jsvLock(jsvGetFirstChild(arr));
     if (jsvGetFirstChild(arr) == jsvGetLastChild(arr))
@@ -2839,6 +4103,9 @@ JsVar *jsvArrayJoin(JsVar *arr, JsVar *filler) {
 /// Insert a new element before beforeIndex, DOES NOT UPDATE INDICES
 void jsvArrayInsertBefore(JsVar *arr, JsVar *beforeIndex, JsVar *element) {
   if (beforeIndex) {
+#ifdef JSV_ARRAY_INDEX_MIN_ELEMENTS
+    jsvArrayIndexFree(arr); // elements are about to be renumbered
+#endif
     JsVar *idxVar = jsvMakeIntoVariableName(jsvNewFromInteger(0), element);
     if (!idxVar) return; // out of memory
 
@@ -2905,6 +4172,43 @@ bool jsvMathsOpTypeEqual(JsVar *a, JsVar *b) {
 }
 
 JsVar *jsvMathsOp(JsVar *a, JsVar *b, int op) {
+  // Fast paths for the most common cases - two integers, or two floats
+  if (jsvIsSimpleInt(a) && jsvIsSimpleInt(b)) {
+    JsVarInt da = a->varData.integer;
+    JsVarInt db = b->varData.integer;
+    switch (op) {
+    case '+': return jsvNewFromLongInteger((long long)da + (long long)db);
+    case '-': return jsvNewFromLongInteger((long long)da - (long long)db);
+    case '*': return jsvNewFromLongInteger((long long)da * (long long)db);
+    case '&': return jsvNewFromInteger(da&db);
+    case '|': return jsvNewFromInteger(da|db);
+    case '^': return jsvNewFromInteger(da^db);
+    case LEX_LSHIFT: return jsvNewFromInteger((JsVarInt)((JsVarIntUnsigned)da << (db&31)));
+    case LEX_RSHIFT: return jsvNewFromInteger(da >> (db&31));
+    case LEX_EQUAL: case LEX_TYPEEQUAL: return jsvNewFromBool(da==db);
+    case LEX_NEQUAL: case LEX_NTYPEEQUAL: return jsvNewFromBool(da!=db);
+    case '<': return jsvNewFromBool(da<db);
+    case LEX_LEQUAL: return jsvNewFromBool(da<=db);
+    case '>': return jsvNewFromBool(da>db);
+    case LEX_GEQUAL: return jsvNewFromBool(da>=db);
+    default: break; // everything else is handled below
+    }
+  } else if (jsvIsFloat(a) && jsvIsFloat(b)) {
+    JsVarFloat da = a->varData.floating;
+    JsVarFloat db = b->varData.floating;
+    switch (op) {
+    case '+': return jsvNewFromFloat(da+db);
+    case '-': return jsvNewFromFloat(da-db);
+    case '*': return jsvNewFromFloat(da*db);
+    case '/': return jsvNewFromFloat(da/db);
+    case '<': return jsvNewFromBool(da<db);
+    case LEX_LEQUAL: return jsvNewFromBool(da<=db);
+    case '>': return jsvNewFromBool(da>db);
+    case LEX_GEQUAL: return jsvNewFromBool(da>=db);
+    default: break; // everything else is handled below
+    }
+  }
+
   // Type equality check
   if (op == LEX_TYPEEQUAL || op == LEX_NTYPEEQUAL) {
     bool eql = jsvMathsOpTypeEqual(a,b);
@@ -2952,9 +4256,9 @@ JsVar *jsvMathsOp(JsVar *a, JsVar *b, int op) {
       case '|': return jsvNewFromInteger(da|db);
       case '^': return jsvNewFromInteger(da^db);
       case '%': return db ? jsvNewFromInteger(da%db) : jsvNewFromFloat(NAN);
-      case LEX_LSHIFT: return jsvNewFromInteger(da << db);
-      case LEX_RSHIFT: return jsvNewFromInteger(da >> db);
-      case LEX_RSHIFTUNSIGNED: return jsvNewFromInteger((JsVarInt)(((JsVarIntUnsigned)da) >> db));
+      case LEX_LSHIFT: return jsvNewFromInteger((JsVarInt)((JsVarIntUnsigned)da << (db&31)));
+      case LEX_RSHIFT: return jsvNewFromInteger(da >> (db&31));
+      case LEX_RSHIFTUNSIGNED: return jsvNewFromInteger((JsVarInt)(((JsVarIntUnsigned)da) >> (db&31)));
       case LEX_EQUAL:     return jsvNewFromBool(da==db && jsvIsNull(a)==jsvIsNull(b));
       case LEX_NEQUAL:    return jsvNewFromBool(da!=db || jsvIsNull(a)!=jsvIsNull(b));
       case '<':           return jsvNewFromBool(da<db);
@@ -3037,6 +4341,55 @@ JsVar *jsvMathsOp(JsVar *a, JsVar *b, int op) {
   }
 }
 
+bool jsvMathsOpIntegerInPlace(JsVar *name, JsVarInt value, int op, JsVarInt *oldValue) {
+  JsVar *v = 0;
+  JsVarInt a;
+  if (!jsvIsName(name)) {
+    // a value on its own - we can only change it if we hold the only lock on it
+    if (!jsvIsSimpleInt(name) || jsvGetRefs(name)!=0 || jsvGetLocks(name)!=1) return false;
+    v = jsvLockAgain(name);
+    a = v->varData.integer;
+  } else if (jsvIsArrayBufferName(name) || jsvIsNewChild(name)) {
+    return false;
+  } else if (jsvIsNameInt(name)) { // the value is stored in the name itself
+    a = (JsVarInt)jsvGetFirstChildSigned(name);
+  } else {
+    if (jsvIsNameWithValue(name) || !jsvGetFirstChild(name)) return false;
+    v = jsvLock(jsvGetFirstChild(name));
+    // if anything else can see the value, we can't change it
+    if (!jsvIsSimpleInt(v) || jsvGetRefs(v)!=1 || jsvGetLocks(v)!=1) {
+      jsvUnLock(v);
+      return false;
+    }
+    a = v->varData.integer;
+  }
+  long long r;
+  switch (op) {
+  case '+': r = (long long)a + (long long)value; break;
+  case '-': r = (long long)a - (long long)value; break;
+  case '*': r = (long long)a * (long long)value; break;
+  case '&': r = a & value; break;
+  case '|': r = a | value; break;
+  case '^': r = a ^ value; break;
+  case LEX_LSHIFT: r = (JsVarInt)((JsVarIntUnsigned)a << (value&31)); break;
+  case LEX_RSHIFT: r = a >> (value&31); break;
+  default: // needs a float (or might do)
+    jsvUnLock(v);
+    return false;
+  }
+  if (v) {
+    bool fits = r>=-2147483648LL && r<=2147483647LL;
+    if (fits) v->varData.integer = (JsVarInt)r;
+    jsvUnLock(v);
+    if (!fits) return false;
+  } else {
+    if (r<JSVARREF_MIN || r>JSVARREF_MAX) return false;
+    jsvSetFirstChild(name, (JsVarRef)r);
+  }
+  if (oldValue) *oldValue = a;
+  return true;
+}
+
 JsVar *jsvNegateAndUnLock(JsVar *v) {
   JsVar *zero = jsvNewFromInteger(0);
   JsVar *res = jsvMathsOpSkipNames(zero, v, '-');
@@ -3238,6 +4591,14 @@ static void jsvGarbageCollectMarkUsed(JsVar *var) {
         jsvGarbageCollectMarkUsed(childVar);
       child = jsvGetNextSibling(childVar);
     }
+#ifdef JSV_HASH_INDEX_MIN_CHILDREN
+    if (jsvHasHashIndex(var))
+      jsvGetAddressOf(jsvGetNextSibling(var))->flags &= (JsVarFlags)~JSV_GARBAGE_COLLECT;
+#endif
+#ifdef JSV_ARRAY_INDEX_MIN_ELEMENTS
+    if (jsvHasArrayIndex(var))
+      jsvGetAddressOf(jsvGetNextSibling(var))->flags &= (JsVarFlags)~JSV_GARBAGE_COLLECT;
+#endif
   }
 }
 
@@ -3245,6 +4606,12 @@ static void jsvGarbageCollectMarkUsed(JsVar *var) {
 bool jsvGarbageCollect() {
   if (isMemoryBusy) return false;
   isMemoryBusy = true;
+#ifdef JSV_GC_GRAY_STACK_SIZE
+  JsSysTime startTime = jshGetSystemTime();
+  // A full collection replaces any incremental one that was in progress
+  jsvGCPhase = JSVGC_IDLE;
+  jsvGCGrayCount = 0;
+#endif
   JsVarRef i;
   // clear garbage collect flags
   for (i=1;i<=jsVarsSize;i++)  {
@@ -3266,12 +4633,28 @@ bool jsvGarbageCollect() {
     if (jsvIsFlatString(var))
       i = (JsVarRef)(i+jsvGetFlatStringBlocks(var));
   }
+#ifdef JSV_ATOM_TABLE_SIZE
+  // Atoms in the table are used too (we free the ones nothing else uses afterwards)
+  unsigned int atomIdx;
+  for (atomIdx=0;atomIdx<JSV_ATOM_TABLE_SIZE;atomIdx++)
+    if (jsvAtoms[atomIdx])
+      jsvGarbageCollectMarkUsed(jsvGetAddressOf(jsvAtoms[atomIdx]));
+#endif
   /* now sweep for things that we can GC!
    * Also update the free list - this means that every new variable that
    * gets allocated gets allocated towards the start of memory, which
    * hopefully helps compact everything towards the start. */
   bool freedSomething = false;
-  jsVarFirstEmpty = 0;
+#ifdef JSV_STRING_TAIL_CACHE_SIZE
+  jsvStringTailCacheClear(); // we don't free with jsvFreePtr
+#endif
+#ifdef JSV_PROPERTY_CACHE_SIZE
+  jsvPropertyCacheClear();
+#endif
+#ifdef JSPARSE_VARIABLE_CACHE_SIZE
+  jsvNameEpoch++; // names we found may be freed
+#endif
+  jsvFreeListSetFirst(0);
   JsVar firstVar; // temporary var to simplify code in the loop below
   jsvSetNextSibling(&firstVar, 0);
   JsVar *lastEmpty = &firstVar;
@@ -3312,6 +4695,12 @@ bool jsvGarbageCollect() {
               jsvUnRef(child);
           }
         }
+#ifdef JSV_ATOM_TABLE_SIZE
+        // The same goes for atoms, which are shared between names
+        JsVar *atom = jsvGetNameAtom(var);
+        if (atom && atom->flags!=JSV_UNUSED && !(atom->flags&JSV_GARBAGE_COLLECT))
+          jsvUnRef(atom);
+#endif
         /* Sanity checks here. We're making sure that any variables that are
          * linked from this one have either already been garbage collected or
          * are marked for GC */
@@ -3345,11 +4734,556 @@ bool jsvGarbageCollect() {
   /* Now find the first variable in our list, using
    * our fake 'firstVar' variable */
   jsvSetNextSibling(lastEmpty, 0);
-  jsVarFirstEmpty = jsvGetNextSibling(&firstVar);
+  jsvFreeListSetFirst(jsvGetNextSibling(&firstVar));
+#ifdef JSV_FREE_RUN_BUCKETS
+  jsvFreeListRelink();
+#endif
+#ifdef JSV_GC_GRAY_STACK_SIZE
+  jsvGCRecordPause(startTime);
+#endif
   isMemoryBusy = false;
+#ifdef JSV_ATOM_TABLE_SIZE
+  if (jsvAtomTableFreeUnused()) freedSomething = true;
+#endif
   return freedSomething;
 }
 
+#ifdef JSV_GC_GRAY_STACK_SIZE
+/* Incremental garbage collection works like jsvGarbageCollect, except each
+ * phase is done a few vars at a time (using jsvGCCursor) so that we never
+ * stop for longer than jsvGCBudget. Because JavaScript runs in between:
+ *
+ * - Vars allocated during the collection don't have JSV_GARBAGE_COLLECT
+ *   set, so are never freed by it.
+ * - Marking isn't recursive. Instead, marked vars whose children haven't
+ *   been looked at yet go on jsvGCGray. If that fills up we just remember
+ *   that it did, and later scan the children of everything that's marked.
+ * - While marking, any var that gets locked or referenced (jsvLock,
+ *   jsvLockAgain and jsvRef) is marked, so nothing can be hidden in a var
+ *   that has already been scanned.
+ * - Vars allocated while we're still setting flags could be given
+ *   references to vars that are about to be flagged, so they're scanned too.
+ * - Freed vars may be reused for flat strings, so jsvGCNewFlatString makes
+ *   sure we never look at their data blocks as if they were vars.
+ */
+
+/// Record how long a garbage collection pause took
+static void jsvGCRecordPause(JsSysTime startTime) {
+  JsSysTime t = jshGetSystemTime() - startTime;
+  jsvGCStats.pauses++;
+  jsvGCStats.totalPause += t;
+  if (t > jsvGCStats.maxPause) jsvGCStats.maxPause = t;
+}
+
+/// Mark a var as used, and remember that we must scan its children
+static void jsvGCShade(JsVar *var) {
+  var->flags &= (JsVarFlags)~JSV_GARBAGE_COLLECT;
+  jshInterruptOff();
+  if (jsvGCGrayCount < JSV_GC_GRAY_STACK_SIZE)
+    jsvGCGray[jsvGCGrayCount++] = jsvGetRef(var);
+  else
+    jsvGCGrayOverflow = true;
+  jshInterruptOn();
+}
+
+static ALWAYS_INLINE void jsvGCShadeRef(JsVarRef ref) {
+  JsVar *var = jsvGetAddressOf(ref);
+  if (var->flags & JSV_GARBAGE_COLLECT) jsvGCShade(var);
+}
+
+/// Shade all the children of a var that has been marked (see jsvGarbageCollectMarkUsed)
+static void jsvGCScan(JsVar *var) {
+  if (jsvHasCharacterData(var)) {
+    JsVarRef child = jsvGetLastChild(var);
+    while (child) {
+      JsVar *childVar = jsvGetAddressOf(child);
+      childVar->flags &= (JsVarFlags)~JSV_GARBAGE_COLLECT;
+      child = jsvGetLastChild(childVar);
+    }
+  }
+  if (jsvHasSingleChild(var)) {
+    if (jsvGetFirstChild(var))
+      jsvGCShadeRef(jsvGetFirstChild(var));
+  } else if (jsvHasChildren(var)) {
+    JsVarRef child = jsvGetFirstChild(var);
+    while (child) {
+      jsvGCShadeRef(child);
+      child = jsvGetNextSibling(jsvGetAddressOf(child));
+    }
+    // Objects and Arrays may have an index
+    if ((jsvHasHashIndex(var) || jsvIsArray(var)) && jsvGetNextSibling(var))
+      jsvGetAddressOf(jsvGetNextSibling(var))->flags &= (JsVarFlags)~JSV_GARBAGE_COLLECT;
+  }
+}
+
+/// Called when a flat string is allocated, so we don't treat its data as vars
+static void jsvGCNewFlatString(JsVar *flatString) {
+  if (jsvGCPhase==JSVGC_IDLE) return;
+  JsVarRef first = jsvGetRef(flatString);
+  JsVarRef last = (JsVarRef)(first + jsvGetFlatStringBlocks(flatString));
+  if (jsvGCCursor>first && jsvGCCursor<=last)
+    jsvGCCursor = (JsVarRef)(last+1);
+  // remove any data blocks from the gray stack
+  unsigned int i, j = 0;
+  for (i=0;i<jsvGCGrayCount;i++)
+    if (jsvGCGray[i]<=first || jsvGCGray[i]>last)
+      jsvGCGray[j++] = jsvGCGray[i];
+  jsvGCGrayCount = j;
+  if (jsvGCPhase==JSVGC_FLAG) jsvGCShade(flatString);
+}
+
+void jsvSetGCBudget(unsigned int microseconds) {
+  jsvGCBudget = microseconds;
+  // If we're turning incremental GC off, finish off what we'd started
+  if (!jsvGCBudget && jsvGCPhase != JSVGC_IDLE)
+    jsvGarbageCollect();
+}
+
+unsigned int jsvGetGCBudget() {
+  return jsvGCBudget;
+}
+
+bool jsvIsGarbageCollecting() {
+  return jsvGCPhase != JSVGC_IDLE;
+}
+
+void jsvGetGCStats(JsvGCStats *stats) {
+  *stats = jsvGCStats;
+}
+
+bool jsvGarbageCollectIncremental() {
+  if (isMemoryBusy) return jsvGCPhase != JSVGC_IDLE;
+  isMemoryBusy = true;
+  JsSysTime startTime = jshGetSystemTime();
+  JsSysTime endTime = startTime + jshGetTimeFromMilliseconds(jsvGCBudget/1000.0);
+  if (jsvGCPhase == JSVGC_IDLE) {
+    jsvGCPhase = JSVGC_FLAG;
+    jsvGCCursor = 1;
+    jsvGCGrayCount = 0;
+    jsvGCGrayOverflow = false;
+  }
+  unsigned int work = 0;
+  while (jsvGCPhase != JSVGC_IDLE) {
+    // only check the time every so often as it can be slow
+    if ((++work & 15)==0 && jshGetSystemTime() > endTime) break;
+    JsVar *var = 0;
+    if (jsvGCCursor <= jsVarsSize) {
+      var = jsvGetAddressOf(jsvGCCursor);
+      jsvGCCursor = (JsVarRef)(jsvGCCursor + 1 + (jsvIsFlatString(var) ? jsvGetFlatStringBlocks(var) : 0));
+    }
+    switch (jsvGCPhase) {
+    case JSVGC_IDLE: break;
+    case JSVGC_FLAG:
+      if (var) {
+        if ((var->flags&JSV_VARTYPEMASK) != JSV_UNUSED)
+          var->flags |= (JsVarFlags)JSV_GARBAGE_COLLECT;
+      } else {
+        jsvGCPhase = JSVGC_MARK;
+        jsvGCCursor = 1;
+#ifdef JSV_ATOM_TABLE_SIZE
+        // Atoms in the table are used too (we free the ones nothing else uses at the end)
+        unsigned int i;
+        for (i=0;i<JSV_ATOM_TABLE_SIZE;i++)
+          if (jsvAtoms[i]) jsvGCShadeRef(jsvAtoms[i]);
+#endif
+      }
+      break;
+    case JSVGC_MARK:
+    case JSVGC_RESCAN:
+      if (jsvGCGrayCount) {
+        // Scan anything we've already marked first
+        if (var) jsvGCCursor = jsvGetRef(var); // go back, we didn't look at this
+        JsVar *gray = jsvGetAddressOf(jsvGCGray[--jsvGCGrayCount]);
+        gray->flags &= (JsVarFlags)~JSV_GARBAGE_COLLECT;
+        jsvGCScan(gray);
+      } else if (var) {
+        if (jsvGCPhase == JSVGC_MARK) {
+          // Locked vars are the roots of everything that's used
+          if ((var->flags & JSV_GARBAGE_COLLECT) && jsvGetLocks(var)>0)
+            jsvGCShade(var);
+        } else {
+          if ((var->flags&JSV_VARTYPEMASK) != JSV_UNUSED && !(var->flags & JSV_GARBAGE_COLLECT))
+            jsvGCScan(var);
+        }
+      } else if (jsvGCGrayOverflow) {
+        // We couldn't remember everything, so look at all marked vars
+        jsvGCGrayOverflow = false;
+        jsvGCPhase = JSVGC_RESCAN;
+        jsvGCCursor = 1;
+      } else {
+        // everything that's used has been marked
+        jsvGCPhase = JSVGC_UNLINK;
+        jsvGCCursor = 1;
+      }
+      break;
+    case JSVGC_UNLINK:
+      if (var) {
+        if ((var->flags & JSV_GARBAGE_COLLECT) && jsvGetLocks(var)==0 &&
+            jsvHasSingleChild(var) && jsvGetFirstChild(var)) {
+          /* If this had a child that isn't going to be freed then we need
+           * to unref it (see jsvGarbageCollect). We do this before freeing
+           * anything so that we know the child hasn't been reallocated. */
+          JsVar *child = jsvGetAddressOf(jsvGetFirstChild(var));
+          if ((child->flags&JSV_VARTYPEMASK)!=JSV_UNUSED && !(child->flags&JSV_GARBAGE_COLLECT)) {
+            jsvUnRef(child);
+            jsvSetFirstChild(var, 0);
+          }
+        }
+#ifdef JSV_ATOM_TABLE_SIZE
+        JsVar *atom = (var->flags & JSV_GARBAGE_COLLECT) && jsvGetLocks(var)==0 ? jsvGetNameAtom(var) : 0;
+        if (atom && !(atom->flags&JSV_GARBAGE_COLLECT)) {
+          jsvUnRef(atom);
+          jsvSetLastChild(var, 0);
+        }
+#endif
+      } else {
+        jsvGCPhase = JSVGC_FREE;
+        jsvGCCursor = 1;
+#ifdef JSV_STRING_TAIL_CACHE_SIZE
+        jsvStringTailCacheClear(); // we don't free with jsvFreePtr
+#endif
+#ifdef JSV_PROPERTY_CACHE_SIZE
+        jsvPropertyCacheClear();
+#endif
+#ifdef JSPARSE_VARIABLE_CACHE_SIZE
+        jsvNameEpoch++; // names we found may be freed
+#endif
+      }
+      break;
+    case JSVGC_FREE:
+      if (var) {
+        if ((var->flags & JSV_GARBAGE_COLLECT) && jsvGetLocks(var)==0) {
+          JsVarRef ref = jsvGetRef(var);
+          unsigned int count = jsvIsFlatString(var) ? (unsigned int)jsvGetFlatStringBlocks(var) : 0;
+          // free the blocks in reverse, so the free list ends up in kind of the right order
+          while (true) {
+            JsVar *v = jsvGetAddressOf((JsVarRef)(ref+count));
+            v->flags = JSV_UNUSED;
+            jsvFreePtrInternal(v);
+            if (!count) break;
+            count--;
+          }
+        }
+      } else {
+        jsvGCPhase = JSVGC_IDLE;
+      }
+      break;
+    }
+  }
+  jsvGCRecordPause(startTime);
+  isMemoryBusy = false;
+#ifdef JSV_ATOM_TABLE_SIZE
+  if (jsvGCPhase == JSVGC_IDLE) jsvAtomTableFreeUnused();
+#endif
+  return jsvGCPhase != JSVGC_IDLE;
+}
+#endif
+
+#ifdef JSV_DEFRAG_BATCH_SIZE
+/* Defragmentation moves unlocked vars down into the lowest free slots, so
+ * that the free space ends up together at the end of memory where large
+ * flat strings can be allocated. A moved var's old slot is marked as unused
+ * with nextSibling pointing to where it went, and then every reference in
+ * memory is updated. We can tell which references to update because after
+ * a garbage collection nothing should reference an unused var.
+ *
+ * Locked vars stay where they are (there may be pointers to them), as do
+ * flat strings (they'd need a whole run of free space to move into). */
+
+
+bool jsvIsDefragmentNeeded() {
+  return jsvDefragNeeded;
+}
+
+/// If a var was moved, return its new reference
+static JsVarRef jsvDefragGetNewRef(JsVarRef ref) {
+  if (!ref) return 0;
+  JsVar *v = jsvGetAddressOf(ref);
+  if ((v->flags&JSV_VARTYPEMASK) == JSV_UNUSED)
+    return jsvGetNextSibling(v);
+  return ref;
+}
+
+/// Update all the references in a var to point to where things were moved (see jsvGarbageCollectMarkUsed)
+static void jsvDefragUpdateRefs(JsVar *var) {
+  if (jsvHasCharacterData(var))
+    jsvSetLastChild(var, jsvDefragGetNewRef(jsvGetLastChild(var)));
+  if (jsvIsName(var)) {
+    jsvSetNextSibling(var, jsvDefragGetNewRef(jsvGetNextSibling(var)));
+    jsvSetPrevSibling(var, jsvDefragGetNewRef(jsvGetPrevSibling(var)));
+  }
+  if (jsvHasSingleChild(var)) {
+    jsvSetFirstChild(var, jsvDefragGetNewRef(jsvGetFirstChild(var)));
+  } else if (jsvHasChildren(var)) {
+    jsvSetFirstChild(var, jsvDefragGetNewRef(jsvGetFirstChild(var)));
+    jsvSetLastChild(var, jsvDefragGetNewRef(jsvGetLastChild(var)));
+  }
+}
+
+/// Can this var be moved by jsvDefragment?
+static bool jsvDefragCanMove(JsVar *var) {
+  JsVarRef ref = jsvGetRef(var);
+  return jsvGetLocks(var)==0 &&
+      // we keep references to these in jsinteractive.c
+      ref!=timerArray && ref!=watchArray;
+}
+
+void jsvDefragment(JsvDefragStats *stats) {
+  JsSysTime startTime = jshGetSystemTime();
+  jsvDefragNeeded = false;
+  if (stats) memset(stats, 0, sizeof(JsvDefragStats));
+  // The utility timer accesses buffers directly from an IRQ - don't move them
+  if (isMemoryBusy || jstHasBufferTimerTasks()) return;
+  JsVarRef i;
+  /* Indexes contain references we don't know how to update, so just remove
+   * them. They're recreated the next time a long search is done (for
+   * Objects, whether or not the search finds anything) */
+  for (i=1;i<=jsVarsSize;i++) {
+    JsVar *var = jsvGetAddressOf(i);
+#ifdef JSV_HASH_INDEX_MIN_CHILDREN
+    if (jsvHasHashIndex(var)) jsvHashIndexFree(var);
+#endif
+#ifdef JSV_ARRAY_INDEX_MIN_ELEMENTS
+    if (jsvHasArrayIndex(var)) jsvArrayIndexFree(var);
+#endif
+    if (jsvIsFlatString(var))
+      i = (JsVarRef)(i+jsvGetFlatStringBlocks(var));
+  }
+  // Get rid of anything unused, so all references are to vars that are used
+  jsvGarbageCollect();
+  isMemoryBusy = true;
+#ifdef JSV_STRING_TAIL_CACHE_SIZE
+  jsvStringTailCacheClear(); // strings will move
+#endif
+
+  unsigned int moved = 0;
+  JsVarRef to = 1; // where we're moving vars to - everything below this is used
+  while (true) {
+    // Find the highest vars in memory that we can move
+    JsVarRef candidates[JSV_DEFRAG_BATCH_SIZE];
+    unsigned int candidateIdx = 0, candidateCount = 0;
+    for (i=to;i<=jsVarsSize;i++) {
+      JsVar *var = jsvGetAddressOf(i);
+      if (jsvIsFlatString(var)) {
+        i = (JsVarRef)(i+jsvGetFlatStringBlocks(var));
+      } else if ((var->flags&JSV_VARTYPEMASK)!=JSV_UNUSED && jsvDefragCanMove(var)) {
+        candidates[candidateIdx] = i;
+        candidateIdx = (candidateIdx+1) % JSV_DEFRAG_BATCH_SIZE;
+        if (candidateCount < JSV_DEFRAG_BATCH_SIZE) candidateCount++;
+      }
+    }
+    // Move them, highest first, into the lowest free vars
+    unsigned int batchMoved = 0;
+    while (candidateCount--) {
+      candidateIdx = (candidateIdx+JSV_DEFRAG_BATCH_SIZE-1) % JSV_DEFRAG_BATCH_SIZE;
+      JsVarRef from = candidates[candidateIdx];
+      JsVar *toVar = 0;
+      while (to < from) {
+        toVar = jsvGetAddressOf(to);
+        if ((toVar->flags&JSV_VARTYPEMASK)==JSV_UNUSED) break;
+        if (jsvIsFlatString(toVar))
+          to = (JsVarRef)(to+jsvGetFlatStringBlocks(toVar));
+        to++;
+      }
+      if (to >= from) break; // nowhere lower to put it
+      JsVar *fromVar = jsvGetAddressOf(from);
+      *toVar = *fromVar;
+#ifdef JSV_ALLOCATION_SITES
+      if (jsvAllocationSites) jsvAllocationSites[to-1] = jsvAllocationSites[from-1];
+#endif
+      fromVar->flags = JSV_UNUSED;
+      jsvSetNextSibling(fromVar, to);
+      to++;
+      batchMoved++;
+    }
+    if (!batchMoved) break;
+    moved += batchMoved;
+    // Now point everything at where the vars have moved to
+    for (i=1;i<=jsVarsSize;i++) {
+      JsVar *var = jsvGetAddressOf(i);
+      if ((var->flags&JSV_VARTYPEMASK)!=JSV_UNUSED)
+        jsvDefragUpdateRefs(var);
+      if (jsvIsFlatString(var))
+        i = (JsVarRef)(i+jsvGetFlatStringBlocks(var));
+    }
+#ifdef JSV_ATOM_TABLE_SIZE
+    unsigned int atomIdx;
+    for (atomIdx=0;atomIdx<JSV_ATOM_TABLE_SIZE;atomIdx++)
+      jsvAtoms[atomIdx] = jsvDefragGetNewRef(jsvAtoms[atomIdx]);
+#endif
+  }
+
+  // Rebuild the free list (in order), and count what we couldn't move
+  unsigned int pinned = 0;
+  bool foundFree = false;
+  jsvFreeListSetFirst(0);
+  JsVar firstVar; // temporary var to simplify code in the loop below
+  jsvSetNextSibling(&firstVar, 0);
+  JsVar *lastEmpty = &firstVar;
+  for (i=1;i<=jsVarsSize;i++) {
+    JsVar *var = jsvGetAddressOf(i);
+    if ((var->flags&JSV_VARTYPEMASK) == JSV_UNUSED) {
+      foundFree = true;
+      jsvSetNextSibling(lastEmpty, i);
+      lastEmpty = var;
+    } else {
+      unsigned int blocks = jsvIsFlatString(var) ? (unsigned int)jsvGetFlatStringBlocks(var) : 0;
+      if (foundFree) pinned += 1+blocks;
+      i = (JsVarRef)(i+blocks);
+    }
+  }
+  jsvSetNextSibling(lastEmpty, 0);
+  jsvFreeListSetFirst(jsvGetNextSibling(&firstVar));
+#ifdef JSV_FREE_RUN_BUCKETS
+  jsvFreeListRelink();
+#endif
+  isMemoryBusy = false;
+  if (stats) {
+    stats->moved = moved;
+    stats->pinned = pinned;
+    stats->time = jshGetSystemTime() - startTime;
+  }
+}
+#endif
+
+#ifdef JSV_HEAP_PROFILE_MAX_SITES
+const char *jsvGetHeapProfileTypeName(JsvHeapProfileType type) {
+  switch (type) {
+    case JSVHP_FREE: return "free";
+    case JSVHP_ROOT: return "root";
+    case JSVHP_NULL: return "null";
+    case JSVHP_ARRAY: return "array";
+    case JSVHP_ARRAYBUFFER: return "arrayBuffer";
+    case JSVHP_OBJECT: return "object";
+    case JSVHP_FUNCTION: return "function";
+    case JSVHP_NATIVE_FUNCTION: return "nativeFunction";
+    case JSVHP_INTEGER: return "integer";
+    case JSVHP_FLOAT: return "float";
+    case JSVHP_BOOLEAN: return "boolean";
+    case JSVHP_PIN: return "pin";
+    case JSVHP_NAME: return "name";
+    case JSVHP_STRING: return "string";
+    case JSVHP_STRING_EXT: return "stringExt";
+    case JSVHP_FLAT_STRING: return "flatString";
+    case JSVHP_NATIVE_STRING: return "nativeString";
+    case JSVHP_INDEX: return "index";
+    default: return "?";
+  }
+}
+
+/// What kind of variable is this (see jsvGetHeapProfile)
+static JsvHeapProfileType jsvGetHeapProfileType(JsVar *v) {
+  if ((v->flags&JSV_VARTYPEMASK) == JSV_UNUSED) return JSVHP_FREE;
+  if (jsvIsRoot(v)) return JSVHP_ROOT;
+  if (jsvIsName(v)) return JSVHP_NAME;
+  if (jsvIsNull(v)) return JSVHP_NULL;
+  if (jsvIsArray(v)) return JSVHP_ARRAY;
+  if (jsvIsArrayBuffer(v)) return JSVHP_ARRAYBUFFER;
+  if (jsvIsObject(v)) return JSVHP_OBJECT;
+  if (jsvIsNativeFunction(v)) return JSVHP_NATIVE_FUNCTION;
+  if (jsvIsFunction(v)) return JSVHP_FUNCTION;
+  if (jsvIsPin(v)) return JSVHP_PIN;
+  if (jsvIsBoolean(v)) return JSVHP_BOOLEAN;
+  if (jsvIsFloat(v)) return JSVHP_FLOAT;
+  if (jsvIsInt(v)) return JSVHP_INTEGER;
+  if (jsvIsFlatString(v)) return JSVHP_FLAT_STRING;
+  if (jsvIsNativeString(v)) return JSVHP_NATIVE_STRING;
+  if (jsvIsStringExt(v)) return JSVHP_STRING_EXT;
+  return JSVHP_STRING;
+}
+
+#ifdef JSV_ALLOCATION_SITES
+/// Add the site where a var was allocated to a hash table of sites (which must have space)
+static void jsvHeapProfileCountSite(JsvHeapProfileSite *table, unsigned int tableSize, JsvAllocationSite *site) {
+  unsigned int h = (site->code*31 + site->position) & (tableSize-1);
+  while (table[h].count && (table[h].code!=site->code || table[h].position!=site->position))
+    h = (h+1) & (tableSize-1);
+  table[h].code = site->code;
+  table[h].position = site->position;
+  table[h].count++;
+}
+#endif
+
+/* Walk over all of memory, counting what kind of variables there are. If
+ * allocation tracking is on, also count the variables that are in use by
+ * where they were allocated, and keep the places with the most. */
+void jsvGetHeapProfile(JsvHeapProfile *profile) {
+  memset(profile, 0, sizeof(JsvHeapProfile));
+#ifdef JSV_ALLOCATION_SITES
+  // big enough that it'll never be more than half full
+  unsigned int tableSize = 1;
+  while (tableSize < jsVarsSize*2) tableSize <<= 1;
+  JsvHeapProfileSite *table = jsvAllocationSites ? calloc(tableSize, sizeof(JsvHeapProfileSite)) : 0;
+#endif
+  JsVarRef i;
+  for (i=1;i<=jsVarsSize;i++) {
+    JsVar *var = jsvGetAddressOf(i);
+    JsvHeapProfileType type = jsvGetHeapProfileType(var);
+    unsigned int blocks = 1;
+    if (type==JSVHP_FLAT_STRING)
+      blocks += (unsigned int)jsvGetFlatStringBlocks(var);
+    profile->types[type] += blocks;
+    /* Indexes are flat strings, but we want to know about them separately.
+     * We may not have counted them yet, but that's fine as we're unsigned. */
+#ifdef JSV_HASH_INDEX_MIN_CHILDREN
+    if (jsvHasHashIndex(var)) {
+      unsigned int indexBlocks = 1+(unsigned int)jsvGetFlatStringBlocks(jsvGetAddressOf(jsvGetNextSibling(var)));
+      profile->types[JSVHP_INDEX] += indexBlocks;
+      profile->types[JSVHP_FLAT_STRING] -= indexBlocks;
+    }
+#endif
+#ifdef JSV_ARRAY_INDEX_MIN_ELEMENTS
+    if (jsvHasArrayIndex(var)) {
+      unsigned int indexBlocks = 1+(unsigned int)jsvGetFlatStringBlocks(jsvGetAddressOf(jsvGetNextSibling(var)));
+      profile->types[JSVHP_INDEX] += indexBlocks;
+      profile->types[JSVHP_FLAT_STRING] -= indexBlocks;
+    }
+#endif
+#ifdef JSV_ALLOCATION_SITES
+    if (table && type!=JSVHP_FREE)
+      jsvHeapProfileCountSite(table, tableSize, &jsvAllocationSites[i-1]);
+#endif
+    i = (JsVarRef)(i+blocks-1);
+  }
+#ifdef JSV_ALLOCATION_SITES
+  if (!table) return;
+  // Keep the sites with the most variables, in order
+  unsigned int t;
+  for (t=0;t<tableSize;t++) {
+    if (!table[t].count) continue;
+    unsigned int j = profile->siteCount;
+    if (j==JSV_HEAP_PROFILE_MAX_SITES) {
+      if (table[t].count <= profile->sites[j-1].count) continue;
+      j--; // replace the smallest
+    } else
+      profile->siteCount++;
+    while (j>0 && profile->sites[j-1].count < table[t].count) {
+      profile->sites[j] = profile->sites[j-1];
+      j--;
+    }
+    profile->sites[j] = table[t];
+  }
+  free(table);
+#endif
+}
+
+#ifdef JSV_ALLOCATION_SITES
+void jsvSetAllocationTracking(bool enabled) {
+  if (enabled && !jsvAllocationSites) {
+    // We don't know where existing vars came from
+    jsvAllocationSites = calloc(jsVarsSize, sizeof(JsvAllocationSite));
+  } else if (!enabled && jsvAllocationSites) {
+    free(jsvAllocationSites);
+    jsvAllocationSites = 0;
+  }
+}
+
+bool jsvGetAllocationTracking() {
+  return jsvAllocationSites != 0;
+}
+#endif
+#endif
+
 #ifndef RELEASE
 // Dump any locked variables that aren't referenced from `global` - for debugging memory leaks
 void jsvDumpLockedVars() {
@@ -252,6 +252,8 @@ typedef struct {
  * NAME_STRING_INT is the same as NAME_STRING, except 'child' contains the value rather than a pointer
  * FLAT_STRING uses the variable blocks that follow it as flat storage for all the data
  * NATIVE_FUNCTION's nativePtr is a pointer to code if there is no child called JSPARSE_FUNCTION_CODE_NAME, but if there is one, it's an index into that child
+ * OBJECT/ROOT may use 'next' to link to a FLAT_STRING containing a hash index of their keys (see jsvFindChildFromString)
+ * ARRAY may use 'next' to link to a FLAT_STRING containing the refs of its elements while they are densely packed (see jsvGetArrayIndex)
  *
  * For Objects that represent hardware devices, 'nativePtr' is actually set to a special string that
  * contains the device number. See jsiGetDeviceFromClass/jspNewObject
@@ -306,6 +308,7 @@ void jsvSetMemoryTotal(unsigned int jsNewVarCount);
 JsVar *jsvNewWithFlags(JsVarFlags flags); ///< Create a new variable with the given flags
 JsVar *jsvNewFlatStringOfLength(unsigned int byteLength); ///< Try and create a special flat string
 JsVar *jsvNewFromString(const char *str); ///< Create a new string
+JsVar *jsvNewFromStringBuf(const char *str, size_t length); ///< Create a new string from a buffer (which may contain 0s)
 JsVar *jsvNewStringOfLength(unsigned int byteLength); ///< Create a new string of the given length - full of 0s
 static ALWAYS_INLINE JsVar *jsvNewFromEmptyString() { JsVar *v = jsvNewWithFlags(JSV_STRING_0); return v; } ;///< Create a new empty string
 static ALWAYS_INLINE JsVar *jsvNewNull() { return jsvNewWithFlags(JSV_NULL); } ;///< Create a new null variable
@@ -511,6 +514,11 @@ JsVar *jsvAsString(JsVar *var, bool unlockVar); ///< If var is a string, lock an
 JsVar *jsvAsFlatString(JsVar *var); ///< Create a flat string from the given variable (or return it if it is already a flat string). NOTE: THIS CONVERTS VIA A STRING
 bool jsvIsEmptyString(JsVar *v); ///< Returns true if the string is empty - faster than jsvGetStringLength(v)==0
 size_t jsvGetStringLength(const JsVar *v); ///< Get the length of this string, IF it is a string
+#ifdef JSV_STRING_TAIL_CACHE_SIZE
+JsVar *jsvStringTailCacheGet(JsVar *str, size_t *tailIndex); ///< If we know the last block of this string, return it (locked) and the index of its first character
+void jsvStringTailCacheSet(JsVar *str, JsVar *tail, size_t tailIndex); ///< Remember the last block of a string
+void jsvStringTailCacheExtended(JsVar *oldTail, JsVar *newTail, size_t newTailIndex); ///< A new block was added after oldTail
+#endif
 size_t jsvGetFlatStringBlocks(const JsVar *v); ///< return the number of blocks used by the given flat string - EXCLUDING the first data block
 char *jsvGetFlatStringPointer(JsVar *v); ///< Get a pointer to the data in this flat string
 JsVar *jsvGetFlatStringFromPointer(char *v); ///< Given a pointer to the first element of a flat string, return the flat string itself (DANGEROUS!)
@@ -624,6 +632,14 @@ JsVar *jsvAsName(JsVar *var);
 JsVar *jsvMathsOpSkipNames(JsVar *a, JsVar *b, int op);
 bool jsvMathsOpTypeEqual(JsVar *a, JsVar *b);
 JsVar *jsvMathsOp(JsVar *a, JsVar *b, int op);
+/** Do `name = name op value` without allocating anything, if name's value is
+ * an integer that nothing else can see (it's stored in the name itself, or in
+ * a var that only the name uses) and the result is an integer that fits back
+ * in the same place. `name` can also be an integer that isn't referenced by
+ * anything, and is only locked by the caller. Returns false (having changed
+ * nothing) if this can't be done. If oldValue isn't 0, the value before the
+ * change is written to it */
+bool jsvMathsOpIntegerInPlace(JsVar *name, JsVarInt value, int op, JsVarInt *oldValue);
 /// Negates an integer/double value
 JsVar *jsvNegateAndUnLock(JsVar *v);
 
@@ -645,10 +661,38 @@ JsVar *jsvSetValueOfName(JsVar *name, JsVar *src); // Set the value of a child c
 JsVar *jsvFindChildFromString(JsVar *parent, const char *name, bool createIfNotFound); // Non-recursive finding of child with name. Returns a LOCKED var
 JsVar *jsvFindChildFromVar(JsVar *parent, JsVar *childName, bool addIfNotFound); // Non-recursive finding of child with name. Returns a LOCKED var
 
+/// Does this Object have a hash index of its keys? (see jsvFindChildFromString)
+bool jsvHasHashIndex(const JsVar *v);
+/// Get the number of Objects that currently have a hash index
+unsigned int jsvGetHashIndexCount();
+
 /// Remove a child - note that the child MUST ACTUALLY BE A CHILD! and should be a name, not a value.
 void jsvRemoveChild(JsVar *parent, JsVar *child);
 void jsvRemoveAllChildren(JsVar *parent);
 
+#ifdef JSV_PROPERTY_CACHE_SIZE
+/// Where a property was found (see jsvPropertyCacheGet)
+typedef enum {
+  JSVPC_NONE,      ///< We don't know
+  JSVPC_OWN,       ///< A child of the object itself
+  JSVPC_INHERITED, ///< A child of one of the object's prototypes
+  JSVPC_BUILTIN,   ///< A built-in function (see jswFindBuiltInFunction)
+} JsvPropertyCacheType;
+/** If we remembered where the property called field of this object was found
+ * (key identifies the property and where in the code it was accessed from),
+ * return where. For JSVPC_OWN and JSVPC_INHERITED, *name is set to the LOCKED
+ * name that was found */
+JsvPropertyCacheType jsvPropertyCacheGet(uint32_t key, JsVar *object, const char *field, JsVar **name);
+/// Remember where a property of an object (which must have children) was found. name should be 0 for JSVPC_BUILTIN
+void jsvPropertyCacheSet(uint32_t key, JsVar *object, const char *field, JsvPropertyCacheType type, JsVar *name);
+#endif
+
+#ifdef JSPARSE_VARIABLE_CACHE_SIZE
+/** Get a number that changes whenever a variable could be found somewhere
+ * different to where it was before (see jsbcGetVariable) */
+unsigned int jsvGetNameEpoch();
+#endif
+
 /// Get the named child of an object. If createChild!=0 then create the child
 JsVar *jsvObjectGetChild(JsVar *obj, const char *name, JsVarFlags createChild);
 /// Set the named child of an object, and return the child (so you can choose to unlock it if you want)
@@ -692,6 +736,93 @@ void jsvTrace(JsVar *var, int indent);
 /** Run a garbage collection sweep - return true if things have been freed */
 bool jsvGarbageCollect();
 
+#ifdef JSV_GC_GRAY_STACK_SIZE
+/** Set the maximum time (in microseconds) that each slice of incremental
+ * garbage collection may take, or 0 to disable incremental GC */
+void jsvSetGCBudget(unsigned int microseconds);
+/// Get the time budget for incremental garbage collection (0 = disabled)
+unsigned int jsvGetGCBudget();
+/// Is an incremental garbage collection in progress?
+bool jsvIsGarbageCollecting();
+/** Do a single time-limited slice of incremental garbage collection, starting
+ * a new collection if one isn't in progress. Returns true if the collection
+ * still has more to do. */
+bool jsvGarbageCollectIncremental();
+
+typedef struct {
+  unsigned int pauses; ///< How many times we've stopped to garbage collect (full collections or incremental slices)
+  JsSysTime maxPause; ///< The longest we've stopped for
+  JsSysTime totalPause; ///< The total amount of time we've spent collecting
+} JsvGCStats;
+/// Get statistics about garbage collection pauses
+void jsvGetGCStats(JsvGCStats *stats);
+#endif
+
+#ifdef JSV_DEFRAG_BATCH_SIZE
+typedef struct {
+  unsigned int moved; ///< How many vars were moved
+  unsigned int pinned; ///< How many used vars are still after the first free var (because they were locked or flat strings)
+  JsSysTime time; ///< How long it took
+} JsvDefragStats;
+/** Move unlocked vars towards the start of memory, so that free memory is
+ * contiguous and large flat strings can be allocated. This must only be
+ * called when nothing has a JsVarRef (rather than a lock) for a var - so
+ * not from deep inside other functions. Anything else that keeps refs (like
+ * the timer heap - see jsiTimersChanged) must be told afterwards. stats may be 0. */
+void jsvDefragment(JsvDefragStats *stats);
+/// Did a flat string fail to allocate because memory was fragmented? If so, jsvDefragment should be called when idle
+bool jsvIsDefragmentNeeded();
+#endif
+
+#ifdef JSV_HEAP_PROFILE_MAX_SITES
+/// The kinds of variable that jsvGetHeapProfile counts
+typedef enum {
+  JSVHP_FREE,
+  JSVHP_ROOT,
+  JSVHP_NULL,
+  JSVHP_ARRAY,
+  JSVHP_ARRAYBUFFER,
+  JSVHP_OBJECT,
+  JSVHP_FUNCTION,
+  JSVHP_NATIVE_FUNCTION,
+  JSVHP_INTEGER,
+  JSVHP_FLOAT,
+  JSVHP_BOOLEAN,
+  JSVHP_PIN,
+  JSVHP_NAME,
+  JSVHP_STRING,
+  JSVHP_STRING_EXT,
+  JSVHP_FLAT_STRING, ///< including the blocks that contain data
+  JSVHP_NATIVE_STRING,
+  JSVHP_INDEX, ///< the hash/array indexes of objects and arrays
+  JSVHP_TYPES ///< The number of kinds of variable
+} JsvHeapProfileType;
+
+/// A place in the code where variables that are still in use were allocated
+typedef struct {
+  JsVarRef code; ///< The code that was executing (it may have been freed since), or 0 if not known
+  size_t position; ///< The character in the code
+  unsigned int count; ///< How many variables that are still in use were allocated here
+} JsvHeapProfileSite;
+
+typedef struct {
+  unsigned int types[JSVHP_TYPES]; ///< How many variables there are of each kind
+  JsvHeapProfileSite sites[JSV_HEAP_PROFILE_MAX_SITES]; ///< Where the most variables were allocated (if jsvSetAllocationTracking was enabled)
+  unsigned int siteCount; ///< How many items in sites are used
+} JsvHeapProfile;
+
+/// Get the name of a kind of variable (used as a key in E.getHeapProfile)
+const char *jsvGetHeapProfileTypeName(JsvHeapProfileType type);
+/// Count the variables in memory by their kind and (if tracking is enabled) where they were allocated
+void jsvGetHeapProfile(JsvHeapProfile *profile);
+#ifdef JSV_ALLOCATION_SITES
+/// Start or stop recording where each variable was allocated
+void jsvSetAllocationTracking(bool enabled);
+/// Are we recording where each variable was allocated?
+bool jsvGetAllocationTracking();
+#endif
+#endif
+
 #ifndef RELEASE
 // Dump any locked variables that aren't referenced from `global` - for debugging memory leaks
 void jsvDumpLockedVars();
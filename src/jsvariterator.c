@@ -198,6 +198,21 @@ void jsvStringIteratorNext(JsvStringIterator *it) {
 
 void jsvStringIteratorGotoEnd(JsvStringIterator *it) {
   assert(it->var);
+#ifdef JSV_STRING_TAIL_CACHE_SIZE
+  JsVar *str = it->var;
+  if (it->varIndex==0 && jsvGetLastChild(str)) {
+    size_t tailIndex;
+    JsVar *tail = jsvStringTailCacheGet(str, &tailIndex);
+    if (tail) {
+      // we know where the end is already
+      jsvUnLock(it->var);
+      it->var = tail;
+      it->varIndex = tailIndex;
+      it->charsInVar = jsvGetCharactersInVar(it->var);
+    }
+  } else
+    str = 0;
+#endif
   while (jsvGetLastChild(it->var)) {
     JsVar *next = jsvLock(jsvGetLastChild(it->var));
     jsvUnLock(it->var);
@@ -205,6 +220,10 @@ void jsvStringIteratorGotoEnd(JsvStringIterator *it) {
     it->varIndex += it->charsInVar;
     it->charsInVar = jsvGetCharactersInVar(it->var);
   }
+#ifdef JSV_STRING_TAIL_CACHE_SIZE
+  // remember where the end was, as we'll probably want it again
+  if (str) jsvStringTailCacheSet(str, it->var, it->varIndex);
+#endif
   it->ptr = &it->var->varData.str[0];
   if (it->charsInVar) it->charIdx = it->charsInVar-1;
   else it->charIdx = 0;
@@ -233,6 +252,9 @@ void jsvStringIteratorAppend(JsvStringIterator *it, char ch) {
     }
     // we don't ref, because  StringExts are never reffed as they only have one owner (and ALWAYS have an owner)
     jsvSetLastChild(it->var, jsvGetRef(next));
+#ifdef JSV_STRING_TAIL_CACHE_SIZE
+    jsvStringTailCacheExtended(it->var, next, it->varIndex+it->charIdx);
+#endif
     jsvUnLock(it->var);
     it->var = next;
     it->ptr = &next->varData.str[0];
@@ -20,6 +20,7 @@
 #include "jswrapper.h"
 #include "jsinteractive.h"
 #include "jstimer.h"
+#include "jsprofile.h"
 
 /*JSON{
   "type" : "class",
@@ -643,6 +644,66 @@ JsVar *jswrap_espruino_getErrorFlags() {
   return arr;
 }
 
+/*JSON{
+  "type" : "staticmethod",
+  "ifndef" : "SAVE_ON_FLASH",
+  "ifdef" : "LINUX",
+  "class" : "E",
+  "name" : "getFlags",
+  "generate" : "jswrap_espruino_getFlags",
+  "return" : ["JsVar","An object containing flag names and their values"]
+}
+Get Espruino's interpreter flags that control the way it handles your JavaScript code.
+
+* `pretokenise` - When a function is defined, store its code with operators and reserved words as single characters, and whitespace and comments removed. This makes functions faster to execute and smaller, but `dump()` and `E.dumpStr()` won't show them exactly as they were written.
+* `bytecode` - When a function is first called (or a loop outside a function is run), compile it to bytecode so it doesn't have to be parsed each time. Code that can't be compiled is parsed as normal.
+*/
+#ifdef JSLEX_PRETOKENISE
+JsVar *jswrap_espruino_getFlags() {
+  JsVar *o = jsvNewObject();
+  if (!o) return 0;
+  jsvObjectSetChildAndUnLock(o, "pretokenise", jsvNewFromBool(jsFlags&JSF_PRETOKENISE));
+#ifdef JSPARSE_BYTECODE
+  jsvObjectSetChildAndUnLock(o, "bytecode", jsvNewFromBool(jsFlags&JSF_BYTECODE));
+#endif
+  return o;
+}
+
+static void jswrap_espruino_setFlag(JsVar *flags, const char *name, JsFlags flag) {
+  JsVar *v = jsvObjectGetChild(flags, name, 0);
+  if (v) {
+    if (jsvGetBoolAndUnLock(v)) jsFlags |= flag;
+    else jsFlags &= ~flag;
+  }
+}
+
+/*JSON{
+  "type" : "staticmethod",
+  "ifndef" : "SAVE_ON_FLASH",
+  "ifdef" : "LINUX",
+  "class" : "E",
+  "name" : "setFlags",
+  "generate" : "jswrap_espruino_setFlags",
+  "params" : [
+    ["flags","JsVar","An object containing flag names and boolean values. You need only specify the flags that you want to change."]
+  ]
+}
+Set the Espruino interpreter flags that control the way it handles your JavaScript code. See `E.getFlags` for a list of flags.
+
+For example `E.setFlags({pretokenise:false})` will make functions that are defined from then on keep their original source code, so that `dump()` shows them exactly as they were written.
+*/
+void jswrap_espruino_setFlags(JsVar *flags) {
+  if (!jsvIsObject(flags)) {
+    jsExceptionHere(JSET_TYPEERROR, "Expecting an Object, got %t", flags);
+    return;
+  }
+  jswrap_espruino_setFlag(flags, "pretokenise", JSF_PRETOKENISE);
+#ifdef JSPARSE_BYTECODE
+  jswrap_espruino_setFlag(flags, "bytecode", JSF_BYTECODE);
+#endif
+}
+#endif
+
 /*JSON{
   "type" : "staticmethod",
   "class" : "E",
@@ -964,6 +1025,285 @@ JsVar *jswrap_espruino_getSizeOf(JsVar *v, int depth) {
   return jsvNewFromInteger((JsVarInt)jsvCountJsVarsUsed(v));
 }
 
+/*JSON{
+  "type" : "staticmethod",
+  "ifndef" : "SAVE_ON_FLASH",
+  "ifdef" : "LINUX",
+  "class" : "E",
+  "name" : "setGCBudget",
+  "generate" : "jswrap_espruino_setGCBudget",
+  "params" : [
+    ["microseconds","int","The maximum time in microseconds that each garbage collection pause should take, or 0 to disable incremental garbage collection"]
+  ]
+}
+Normally when Espruino is idle and running low on memory it does a garbage
+collection in one go - which may take several milliseconds if a lot of memory
+is in use.
+
+If a budget is set with this function, garbage collection is instead done in
+several small steps (each one lasting about `microseconds`) between the
+execution of other JavaScript code, which helps to keep timing more
+predictable. Garbage collection will also start earlier, as it may take a
+while to complete.
+
+Garbage collection may still happen in one go if memory runs out completely.
+
+You can see how long pauses took with `process.memory().gcMaxPause`.
+ */
+#ifdef JSV_GC_GRAY_STACK_SIZE
+void jswrap_espruino_setGCBudget(JsVarInt microseconds) {
+  jsvSetGCBudget((microseconds>0) ? (unsigned int)microseconds : 0);
+}
+#endif
+
+/*JSON{
+  "type" : "staticmethod",
+  "ifndef" : "SAVE_ON_FLASH",
+  "class" : "E",
+  "name" : "defrag",
+  "generate" : "jswrap_espruino_defrag",
+  "return" : ["JsVar","An object containing `moved`, `pinned` and `time` fields"]
+}
+Defragment memory by moving variables towards the start of it, so that the
+free memory is all together. This allows large ArrayBuffers (which need one
+contiguous area of memory) to be allocated. This happens automatically when
+Espruino is idle if an allocation failed because memory was fragmented.
+
+Returns an object containing:
+
+* `moved` : The number of variables that were moved
+* `pinned` : The number of variables that couldn't be moved, and still take
+up space after the first free variable (because they were in use at the time,
+or they were already contiguous blocks of memory)
+* `time` : The time taken in milliseconds
+ */
+#ifdef JSV_DEFRAG_BATCH_SIZE
+JsVar *jswrap_espruino_defrag() {
+  JsvDefragStats stats;
+  jsvDefragment(&stats);
+  if (stats.moved) jsiTimersChanged(); // the timer heap has references to vars that may have moved
+  JsVar *obj = jsvNewObject();
+  if (!obj) return 0;
+  jsvObjectSetChildAndUnLock(obj, "moved", jsvNewFromInteger((JsVarInt)stats.moved));
+  jsvObjectSetChildAndUnLock(obj, "pinned", jsvNewFromInteger((JsVarInt)stats.pinned));
+  jsvObjectSetChildAndUnLock(obj, "time", jsvNewFromFloat(jshGetMillisecondsFromTime(stats.time)));
+  return obj;
+}
+#endif
+
+/*JSON{
+  "type" : "staticmethod",
+  "ifndef" : "SAVE_ON_FLASH",
+  "class" : "E",
+  "name" : "getHeapProfile",
+  "generate" : "jswrap_espruino_getHeapProfile",
+  "return" : ["JsVar","An object containing `total`, `types` and (if allocation tracking is on) `sites` fields"]
+}
+Look through all of memory and work out what it is being used for. This is
+useful if you're running out of memory and you don't know why. The result can
+be passed to `JSON.stringify`, so you can compare what was in memory at two
+different times.
+
+Returns an object containing:
+
+* `total` : The total number of variable blocks
+* `types` : An object containing the number of variable blocks used for each
+kind of variable - for instance `name` (the names of properties and
+variables), `string` and `stringExt` (strings that are stored in more than one
+block), `flatString` (strings and ArrayBuffers that are stored in one
+contiguous area of memory), and `free`.
+* `sites` : Only if `E.setAllocationTracking(true)` was called. An object
+where each key is the line and column in the code where variables that are
+still in use were allocated (followed by the code itself), and the value is how
+many of them there are. Only the places that allocated the most variables are
+listed, and `native` is used for variables that weren't allocated by
+JavaScript code (or were allocated before tracking was turned on). Line
+numbers inside functions are counted from the start of the function.
+ */
+#ifdef JSV_HEAP_PROFILE_MAX_SITES
+JsVar *jswrap_espruino_getHeapProfile() {
+  JsvHeapProfile profile;
+  jsvGetHeapProfile(&profile);
+  JsVar *obj = jsvNewObject();
+  if (!obj) return 0;
+  jsvObjectSetChildAndUnLock(obj, "total", jsvNewFromInteger((JsVarInt)jsvGetMemoryTotal()));
+  JsVar *types = jsvNewObject();
+  if (types) {
+    int t;
+    for (t=0;t<JSVHP_TYPES;t++)
+      if (profile.types[t])
+        jsvObjectSetChildAndUnLock(types, jsvGetHeapProfileTypeName((JsvHeapProfileType)t), jsvNewFromInteger((JsVarInt)profile.types[t]));
+    jsvObjectSetChildAndUnLock(obj, "types", types);
+  }
+#ifdef JSV_ALLOCATION_SITES
+  if (!jsvGetAllocationTracking()) return obj;
+  JsVar *sites = jsvNewObject();
+  if (!sites) return obj;
+  unsigned int s;
+  for (s=0;s<profile.siteCount;s++) {
+    JsvHeapProfileSite *site = &profile.sites[s];
+    JsVar *code = 0;
+    // The code may have been freed since - if so, we can't say where it was
+    if (site->code && site->code<=jsvGetMemoryTotal()) {
+      code = jsvLock(site->code);
+      if (!jsvIsString(code) || jsvIsName(code) || site->position>=jsvGetStringLength(code)) {
+        jsvUnLock(code);
+        code = 0;
+      }
+    }
+    JsVar *key;
+    if (code) {
+      size_t line, col;
+      jsvGetLineAndCol(code, site->position, &line, &col);
+      // Add the code itself, up to the end of the line
+      JsVar *snippet = jsvNewFromStringVar(code, site->position, 20);
+      int nl = jsvGetStringIndexOf(snippet, '\n');
+      if (nl>=0) {
+        JsVar *firstLine = jsvNewFromStringVar(snippet, 0, (size_t)nl);
+        jsvUnLock(snippet);
+        snippet = firstLine;
+      }
+      key = jsvVarPrintf("%d:%d ", (int)line, (int)col);
+      if (key) { // the code may be pretokenised
+        JsvStringIterator it;
+        jsvStringIteratorNew(&it, key, 0);
+        jsvStringIteratorGotoEnd(&it);
+        jslPrintTokenisedString(snippet, (vcbprintf_callback)jsvStringIteratorPrintfCallback, &it);
+        jsvStringIteratorFree(&it);
+      }
+      jsvUnLock2(snippet, code);
+    } else
+      key = jsvNewFromString(site->code ? "unknown" : "native");
+    // We may have had two sites that we now can't tell apart, so add to what's there
+    JsVar *name = key ? jsvFindChildFromVar(sites, key, true) : 0;
+    if (name) {
+      JsVar *count = jsvNewFromInteger((JsVarInt)site->count + jsvGetIntegerAndUnLock(jsvSkipName(name)));
+      jsvSetValueOfName(name, count);
+      jsvUnLock2(count, name);
+    }
+    jsvUnLock(key);
+  }
+  jsvObjectSetChildAndUnLock(obj, "sites", sites);
+#endif
+  return obj;
+}
+#endif
+
+/*JSON{
+  "type" : "staticmethod",
+  "ifndef" : "SAVE_ON_FLASH",
+  "class" : "E",
+  "name" : "setAllocationTracking",
+  "generate" : "jswrap_espruino_setAllocationTracking",
+  "params" : [
+    ["enabled","bool","Whether to record where in the code each variable is allocated"]
+  ]
+}
+Start (or stop) recording where in your code each variable is allocated, so
+that `E.getHeapProfile()` can report which parts of your code are using the
+most memory. This uses extra memory (outside of the variable blocks) and slows
+down allocation, so should only be used while debugging.
+
+This is only available on devices where memory for variables is allocated
+dynamically (eg. Linux).
+ */
+void jswrap_espruino_setAllocationTracking(bool enabled) {
+#ifdef JSV_ALLOCATION_SITES
+  jsvSetAllocationTracking(enabled);
+#else
+  NOT_USED(enabled);
+  jsExceptionHere(JSET_ERROR, "Allocation tracking is not supported on this device");
+#endif
+}
+
+/*JSON{
+  "type" : "staticmethod",
+  "ifndef" : "SAVE_ON_FLASH",
+  "ifdef" : "LINUX",
+  "class" : "E",
+  "name" : "profile",
+  "generate" : "jswrap_espruino_profile",
+  "params" : [
+    ["enabled","bool","Whether to profile the code that is executed"],
+    ["sampleInterval","float","(optional) If specified, how often (in milliseconds) to also record which line of code is running"]
+  ]
+}
+Start (or stop) recording how many times each function is called and how
+long is spent in it. Starting clears the results from any previous profile,
+and the results can then be read with `E.getProfile()`.
+
+For example:
+
+```
+E.profile(true, 1);
+myFunctionThatIsTooSlow();
+E.profile(false);
+console.log(E.getProfile());
+```
+
+Only the first few functions that are called (32 on most devices) are
+recorded, and the time spent in functions only includes time spent executing
+them - not time spent idle, waiting for a callback.
+ */
+#ifdef JSPROFILE_MAX_FUNCTIONS
+void jswrap_espruino_profile(bool enabled, JsVarFloat sampleInterval) {
+  if (enabled) {
+    JsSysTime interval = 0;
+    if (isfinite(sampleInterval) && sampleInterval>0) {
+      interval = jshGetTimeFromMilliseconds(sampleInterval);
+      if (interval<1) interval = 1;
+    }
+    jsprofStart(interval);
+  } else
+    jsprofStop();
+}
+#endif
+
+/*JSON{
+  "type" : "staticmethod",
+  "ifndef" : "SAVE_ON_FLASH",
+  "ifdef" : "LINUX",
+  "class" : "E",
+  "name" : "getProfile",
+  "generate" : "jswrap_espruino_getProfile",
+  "params" : [
+    ["format","JsVar","(optional) If `\"folded\"`, return the results as folded stacks for a flame graph (see below)"]
+  ],
+  "return" : ["JsVar","An object containing `time`, `topTime`, `functions` and (if lines were sampled) `lines` fields - or a String"]
+}
+Return the results of the last profile made with `E.profile`. All times are
+in milliseconds. Returns an object containing:
+
+* `time` : How long the profile has been running for
+* `topTime` : How much of that wasn't spent inside any function (for instance
+top-level code, or being idle)
+* `functions` : An array of all the functions that were called (native ones
+too), most time consuming first. Each has a `name` (the name it was called by
+the first time), `line` (the line it was defined on, if known), `calls` (how
+many times it was called), `time` (how long was spent in it, including the
+functions it called) and `selfTime` (how long was spent in just the function
+itself)
+* `lines` : If `E.profile` was given a `sampleInterval`, an array of the lines
+of code that were running when samples were taken, with the most common first.
+Each has the name of the `function` it's in (`(top)` for code not in a
+function), the `line` and the number of `samples`. Unless it's known which line
+a function was defined on, line numbers inside functions are counted from the
+start of the function.
+
+If `format` is `"folded"`, a String is returned with one line for each
+different call stack, of the form `(top);outer:12;inner:3 1234` - the
+functions that were called (with the line they were defined on), followed by
+the time spent in the last function in microseconds. This can be given
+directly to flame graph tools (for instance Brendan Gregg's `flamegraph.pl`).
+ */
+#ifdef JSPROFILE_MAX_FUNCTIONS
+JsVar *jswrap_espruino_getProfile(JsVar *format) {
+  if (jsvIsStringEqual(format, "folded"))
+    return jsprofGetFoldedStacks();
+  return jsprofGetProfile();
+}
+#endif
+
 /*JSON{
   "type" : "staticmethod",
     "ifndef" : "SAVE_ON_FLASH",
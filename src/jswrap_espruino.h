@@ -28,6 +28,8 @@ JsVarFloat jswrap_espruino_interpolate2d(JsVar *array, int width, JsVarFloat x,
 void jswrap_espruino_enableWatchdog(JsVarFloat time, JsVar *isAuto);
 void jswrap_espruino_kickWatchdog();
 JsVar *jswrap_espruino_getErrorFlags();
+JsVar *jswrap_espruino_getFlags();
+void jswrap_espruino_setFlags(JsVar *flags);
 JsVar *jswrap_espruino_toArrayBuffer(JsVar *str);
 JsVar *jswrap_espruino_toUint8Array(JsVar *args);
 JsVar *jswrap_espruino_toString(JsVar *args);
@@ -39,6 +41,12 @@ int jswrap_espruino_reverseByte(int v);
 void jswrap_espruino_dumpTimers();
 void jswrap_espruino_dumpLockedVars();
 JsVar *jswrap_espruino_getSizeOf(JsVar *v, int depth);
+void jswrap_espruino_setGCBudget(JsVarInt microseconds);
+JsVar *jswrap_espruino_defrag();
+JsVar *jswrap_espruino_getHeapProfile();
+void jswrap_espruino_setAllocationTracking(bool enabled);
+void jswrap_espruino_profile(bool enabled, JsVarFloat sampleInterval);
+JsVar *jswrap_espruino_getProfile(JsVar *format);
 void jswrap_espruino_mapInPlace(JsVar *from, JsVar *to, JsVar *map, JsVarInt bits);
 JsVar *jswrap_e_dumpStr();
 JsVarInt jswrap_espruino_HSBtoRGB(JsVarFloat hue, JsVarFloat sat, JsVarFloat bri);
@@ -328,6 +328,7 @@ Set the current system time in seconds (to the nearest second)
  */
 void jswrap_interactive_setTime(JsVarFloat time) {
   JsSysTime stime = jshGetTimeFromMilliseconds(time*1000);
+  jsiTimersShift(stime - jsiLastIdleTime); // timers stay due at the same time from now
   jsiLastIdleTime = stime;
   jshSetSystemTime(stime);
 }
@@ -443,7 +444,7 @@ JsVar *_jswrap_interface_setTimeoutOrInterval(JsVar *func, JsVarFloat interval,
     JsVar *timerPtr = jsvNewObject();
     if (interval<TIMER_MIN_INTERVAL) interval=TIMER_MIN_INTERVAL;
     JsSysTime intervalInt = jshGetTimeFromMilliseconds(interval);
-    jsvObjectSetChildAndUnLock(timerPtr, "time", jsvNewFromLongInteger((jshGetSystemTime() - jsiLastIdleTime) + intervalInt));
+    jsvObjectSetChildAndUnLock(timerPtr, "time", jsvNewFromLongInteger(jshGetSystemTime() + intervalInt));
     if (!isTimeout) {
       jsvObjectSetChildAndUnLock(timerPtr, "interval", jsvNewFromLongInteger(intervalInt));
     }
@@ -454,7 +455,6 @@ JsVar *_jswrap_interface_setTimeoutOrInterval(JsVar *func, JsVarFloat interval,
     // Add to array
     itemIndex = jsvNewFromInteger(jsiTimerAdd(timerPtr));
     jsvUnLock(timerPtr);
-    jsiTimersChanged(); // mark timers as changed
   }
   return itemIndex;
 }
@@ -500,26 +500,13 @@ If no argument is supplied, all timers and intervals are stopped
 void _jswrap_interface_clearTimeoutOrInterval(JsVar *idVar, bool isTimeout) {
   JsVar *timerArrayPtr = jsvLock(timerArray);
   if (jsvIsUndefined(idVar)) {
-    /* Delete all timers EXCEPT those with a 'watch' field,
-     as those were generated by jsinteractive.c for debouncing watches */
-    JsvObjectIterator it;
-    jsvObjectIteratorNew(&it, timerArrayPtr);
-    while (jsvObjectIteratorHasValue(&it)) {
-      JsVar *timerPtr = jsvObjectIteratorGetValue(&it);
-      JsVar *watchPtr = jsvObjectGetChild(timerPtr, "watch", 0);
-      if (!watchPtr)
-        jsvObjectIteratorRemoveAndGotoNext(&it, timerArrayPtr);
-      else
-        jsvObjectIteratorNext(&it); 
-      jsvUnLock2(watchPtr, timerPtr);
-    }
-    jsvObjectIteratorFree(&it);
+    jsvRemoveAllChildren(timerArrayPtr);
+    jsiTimersChanged(); // mark timers as changed
   } else {
     JsVar *child = jsvIsBasic(idVar) ? jsvFindChildFromVar(timerArrayPtr, idVar, false) : 0;
     if (child) {
-      JsVar *timerArrayPtr = jsvLock(timerArray);
-      jsvRemoveChild(timerArrayPtr, child);
-      jsvUnLock2(child, timerArrayPtr);
+      jsiTimerRemove(child);
+      jsvUnLock(child);
     } else {
       if (isTimeout)
         jsExceptionHere(JSET_ERROR, "Unknown Timeout");
@@ -528,7 +515,6 @@ void _jswrap_interface_clearTimeoutOrInterval(JsVar *idVar, bool isTimeout) {
     }
   }
   jsvUnLock(timerArrayPtr);
-  jsiTimersChanged(); // mark timers as changed
 }
 void jswrap_interface_clearInterval(JsVar *idVar) {
   _jswrap_interface_clearTimeoutOrInterval(idVar, false);
@@ -566,10 +552,9 @@ void jswrap_interface_changeInterval(JsVar *idVar, JsVarFloat interval) {
     JsVarInt intervalInt = (JsVarInt)jshGetTimeFromMilliseconds(interval);
     v = jsvNewFromInteger(intervalInt);
     jsvUnLock2(jsvSetNamedChild(timer, v, "interval"), v);
-    v = jsvNewFromInteger((JsVarInt)(jshGetSystemTime()-jsiLastIdleTime) + intervalInt);
-    jsvUnLock3(jsvSetNamedChild(timer, v, "time"), v, timer);
+    jsiTimerSetTime(timer, jshGetSystemTime() + intervalInt);
+    jsvUnLock(timer);
     // timerName already unlocked
-    jsiTimersChanged(); // mark timers as changed
   } else {
     jsExceptionHere(JSET_ERROR, "Unknown Interval");
   }
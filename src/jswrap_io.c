@@ -687,6 +687,7 @@ JsVar *jswrap_interface_setWatch(
     JsVar *watchArrayPtr = jsvLock(watchArray);
     itemIndex = jsvArrayAddToEnd(watchArrayPtr, watchPtr, 1) - 1;
     jsvUnLock2(watchArrayPtr, watchPtr);
+    jsiWatchesChanged();
 
 
   }
@@ -720,6 +721,7 @@ void jswrap_interface_clearWatch(JsVar *idVar) {
     // remove all items
     jsvRemoveAllChildren(watchArrayPtr);
     jsvUnLock(watchArrayPtr);
+    jsiWatchesChanged();
   } else {
     JsVar *watchArrayPtr = jsvLock(watchArray);
     JsVar *watchNamePtr = jsvFindChildFromVar(watchArrayPtr, idVar, false);
@@ -736,8 +738,37 @@ void jswrap_interface_clearWatch(JsVar *idVar) {
       // Now check if this pin is still being watched
       if (!jsiIsWatchingPin(pin))
         jshPinWatch(pin, false); // 'unwatch' pin
+      jsiWatchesChanged();
     } else {
       jsExceptionHere(JSET_ERROR, "Unknown Watch");
     }
   }
 }
+
+/*JSON{
+  "type" : "staticmethod",
+  "ifdef" : "LINUX",
+  "class" : "E",
+  "name" : "simulatePinChange",
+  "generate" : "jswrap_io_simulatePinChange",
+  "params" : [
+    ["pin","pin","The pin that has changed (it must have a watch on it)"],
+    ["state","bool","The new state of the pin"]
+  ]
+}
+**Linux only** - act as if the hardware had detected that a watched pin
+changed state. Watches (see `setWatch`) are then called in just the same way
+as they would be for a real pin, which is useful for testing.
+ */
+void jswrap_io_simulatePinChange(Pin pin, bool state) {
+  IOEvent event;
+  int channel;
+  for (channel=EV_EXTI0;channel<=EV_EXTI_MAX;channel++) {
+    event.flags = (IOEventFlags)channel;
+    if (jshIsEventForPin(&event, pin)) {
+      jshPushIOEvent((IOEventFlags)channel | (state?EV_EXTI_IS_HIGH:0), jshGetSystemTime());
+      return;
+    }
+  }
+  jsExceptionHere(JSET_ERROR, "Pin %p is not being watched", pin);
+}
@@ -27,3 +27,4 @@ void jswrap_io_shiftOut(JsVar *pins, JsVar *options, JsVar *data);
 
 JsVar *jswrap_interface_setWatch(JsVar *funcVar, Pin pin, JsVar *repeatOrObject);
 void jswrap_interface_clearWatch(JsVar *idVar);
+void jswrap_io_simulatePinChange(Pin pin, bool state);
@@ -17,6 +17,7 @@
 #include "jsparse.h"
 #include "jsinteractive.h"
 #include "jswrapper.h"
+#include "jswrap_string.h"
 
 const unsigned int JSON_LIMIT_AMOUNT = 15; // how big does an array get before we start to limit what we show
 const unsigned int JSON_LIMITED_AMOUNT = 5; // When limited, how many items do we show at the beginning and end
@@ -75,83 +76,260 @@ JsVar *jswrap_json_stringify(JsVar *v, JsVar *replacer, JsVar *space) {
 }
 
 
-JsVar *jswrap_json_parse_internal() {
-  switch (lex->tk) {
-  case LEX_R_TRUE:  jslGetNextToken(lex); return jsvNewFromBool(true);
-  case LEX_R_FALSE: jslGetNextToken(lex); return jsvNewFromBool(false);
-  case LEX_R_NULL:  jslGetNextToken(lex); return jsvNewWithFlags(JSV_NULL);
-  case '-': {
-    jslGetNextToken(lex);
-    if (lex->tk!=LEX_INT && lex->tk!=LEX_FLOAT) return 0;
-    JsVar *v = jswrap_json_parse_internal(lex);
-    JsVar *zero = jsvNewFromInteger(0);
-    JsVar *r = jsvMathsOp(zero, v, '-');
-    jsvUnLock2(v, zero);
-    return r;
+/// Where we are in the JSON we're parsing
+typedef struct {
+  JsvStringIterator it;
+  char ch; ///< The current character (or 0 at the end)
+} JsonParser;
+
+static ALWAYS_INLINE void jsonNextCh(JsonParser *p) {
+  jsvStringIteratorNextInline(&p->it);
+  p->ch = jsvStringIteratorGetChar(&p->it);
+}
+
+static void jsonSkipWhitespace(JsonParser *p) {
+  while (p->ch==' ' || p->ch=='\t' || p->ch=='\n' || p->ch=='\r')
+    jsonNextCh(p);
+}
+
+/// Report that we got something other than we expected. Always returns 0
+static JsVar *jsonError(JsonParser *p, const char *expecting) {
+  if (jspHasError()) return 0; // something below has already reported it
+  int pos = (int)jsvStringIteratorGetIndex(&p->it);
+  if (jsvStringIteratorHasChar(&p->it)) {
+    char got[4] = "' '";
+    got[1] = p->ch;
+    jsExceptionHere(JSET_SYNTAXERROR, "Expecting %s in JSON at position %d, got %s", expecting, pos, got);
+  } else
+    jsExceptionHere(JSET_SYNTAXERROR, "Expecting %s in JSON, got end of input", expecting);
+  return 0;
+}
+
+/// Check the next characters are the given ones (for true/false/null)
+static bool jsonMatchWord(JsonParser *p, const char *word) {
+  while (*word) {
+    if (p->ch != *word) return false;
+    jsonNextCh(p);
+    word++;
+  }
+  return true;
+}
+
+/// Parse a string (p->ch is the opening quote)
+static JsVar *jsonParseString(JsonParser *p) {
+  jsonNextCh(p); // "
+  JsVar *str = 0;
+  // characters are collected here - most strings fit, so str is only created if they don't
+  char buf[JSLEX_MAX_TOKEN_LENGTH];
+  size_t len = 0;
+  while (p->ch != '"') {
+    char ch = p->ch;
+    if ((unsigned char)ch < 32) { // control characters aren't allowed (and this includes the end of the input)
+      jsvUnLock(str);
+      return jsonError(p, "'\"'");
+    }
+    if (ch == '\\') {
+      jsonNextCh(p);
+      switch (p->ch) {
+        case '"': case '\\': case '/': ch = p->ch; break;
+        case 'b': ch = 8; break;
+        case 'f': ch = 12; break;
+        case 'n': ch = '\n'; break;
+        case 'r': ch = '\r'; break;
+        case 't': ch = '\t'; break;
+        case 'u': {
+          int i, code = 0;
+          for (i=0;i<4;i++) {
+            jsonNextCh(p);
+            int d = chtod(p->ch);
+            if (d<0 || d>15) {
+              jsvUnLock(str);
+              return jsonError(p, "a hex digit");
+            }
+            code = code*16 + d;
+          }
+          // We don't support unicode, so like the lexer we just take the bottom 8 bits
+          ch = (char)code;
+        } break;
+        default:
+          jsvUnLock(str);
+          return jsonError(p, "an escape character");
+      }
+    }
+    if (len == sizeof(buf)) {
+      if (!str) str = jsvNewFromEmptyString();
+      if (!str) return 0;
+      jsvAppendStringBuf(str, buf, len);
+      len = 0;
+    }
+    buf[len++] = ch;
+    jsonNextCh(p);
+  }
+  jsonNextCh(p); // "
+  if (!str) return jsvNewFromStringBuf(buf, len);
+  jsvAppendStringBuf(str, buf, len);
+  return str;
+}
+
+/// Parse a number (p->ch is '-' or a digit)
+static JsVar *jsonParseNumber(JsonParser *p) {
+  char buf[JSLEX_MAX_TOKEN_LENGTH];
+  size_t len = 0;
+  bool isNegative = p->ch=='-';
+  bool isInt = true;
+  long long intValue = 0;
+  int intDigits = 0;
+  if (isNegative) {
+    buf[len++] = '-';
+    jsonNextCh(p);
   }
-  case LEX_INT: {
-    long long v = stringToInt(jslGetTokenValueAsString(lex));
-    jslGetNextToken(lex);
-    return jsvNewFromLongInteger(v);
+  if (p->ch=='0') {
+    buf[len++] = '0';
+    jsonNextCh(p);
+  } else if (p->ch>='1' && p->ch<='9') {
+    while (p->ch>='0' && p->ch<='9') {
+      if (len < sizeof(buf)-1) buf[len++] = p->ch;
+      if (intDigits++ < 18) intValue = intValue*10 + (p->ch-'0');
+      jsonNextCh(p);
+    }
+  } else
+    return jsonError(p, "a digit");
+  if (p->ch=='.') {
+    isInt = false;
+    if (len < sizeof(buf)-1) buf[len++] = '.';
+    jsonNextCh(p);
+    if (p->ch<'0' || p->ch>'9') return jsonError(p, "a digit");
+    while (p->ch>='0' && p->ch<='9') {
+      if (len < sizeof(buf)-1) buf[len++] = p->ch;
+      jsonNextCh(p);
+    }
   }
-  case LEX_FLOAT: {
-    JsVarFloat v = stringToFloat(jslGetTokenValueAsString(lex));
-    jslGetNextToken(lex);
-    return jsvNewFromFloat(v);
+  if (p->ch=='e' || p->ch=='E') {
+    isInt = false;
+    if (len < sizeof(buf)-1) buf[len++] = 'e';
+    jsonNextCh(p);
+    if (p->ch=='+' || p->ch=='-') {
+      if (len < sizeof(buf)-1) buf[len++] = p->ch;
+      jsonNextCh(p);
+    }
+    if (p->ch<'0' || p->ch>'9') return jsonError(p, "a digit");
+    while (p->ch>='0' && p->ch<='9') {
+      if (len < sizeof(buf)-1) buf[len++] = p->ch;
+      jsonNextCh(p);
+    }
   }
-  case LEX_STR: {
-    JsVar *a = jslGetTokenValueAsVar(lex);
-    jslGetNextToken(lex);
-    return a;
+  if (len >= sizeof(buf)-1) {
+    jsExceptionHere(JSET_SYNTAXERROR, "Number too long in JSON");
+    return 0;
   }
+  // Integers are worked out as we go
+  if (isInt && intDigits <= 18 && !(isNegative && !intValue))
+    return jsvNewFromLongInteger(isNegative ? -intValue : intValue);
+  buf[len] = 0;
+  return jsvNewFromFloat(stringToFloat(buf));
+}
+
+/// Parse a JSON value, and any whitespace around it
+static JsVar *jsonParseValue(JsonParser *p) {
+  JsVar *result = 0;
+  jsonSkipWhitespace(p);
+  switch (p->ch) {
+  case 't':
+    if (!jsonMatchWord(p, "true")) return jsonError(p, "'true'");
+    result = jsvNewFromBool(true);
+    break;
+  case 'f':
+    if (!jsonMatchWord(p, "false")) return jsonError(p, "'false'");
+    result = jsvNewFromBool(false);
+    break;
+  case 'n':
+    if (!jsonMatchWord(p, "null")) return jsonError(p, "'null'");
+    result = jsvNewWithFlags(JSV_NULL);
+    break;
+  case '"':
+    result = jsonParseString(p);
+    break;
   case '[': {
-    JsVar *arr = jsvNewEmptyArray(); if (!arr) return 0;
-    jslGetNextToken(lex); // [
-    while (lex->tk != ']' && !jspHasError()) {
-      JsVar *value = jswrap_json_parse_internal(lex);
-      if (!value ||
-          (lex->tk!=']' && !jslMatch(','))) {
-        jsvUnLock2(value, arr);
+    if (!jspCheckStackPosition()) return 0;
+    result = jsvNewEmptyArray();
+    if (!result) return 0;
+    jsonNextCh(p); // [
+    jsonSkipWhitespace(p);
+    if (p->ch==']') {
+      jsonNextCh(p);
+      break;
+    }
+    while (true) {
+      JsVar *value = jsonParseValue(p);
+      if (!value) {
+        jsvUnLock(result);
         return 0;
       }
-      jsvArrayPush(arr, value);
+      jsvArrayPush(result, value);
       jsvUnLock(value);
+      if (p->ch==']') break;
+      if (p->ch!=',') {
+        jsvUnLock(result);
+        return jsonError(p, "',' or ']'");
+      }
+      jsonNextCh(p); // ,
     }
-    if (!jslMatch(']')) {
-      jsvUnLock(arr);
-      return 0;
-    }
-    return arr;
-  }
+    jsonNextCh(p); // ]
+  } break;
   case '{': {
-    JsVar *obj = jsvNewObject(); if (!obj) return 0;
-    jslGetNextToken(lex); // {
-    while (lex->tk == LEX_STR && !jspHasError()) {
-      JsVar *key = jsvAsArrayIndexAndUnLock(jslGetTokenValueAsVar(lex));
-      jslGetNextToken(lex);
-      JsVar *value = 0;
-      if (!jslMatch(':') ||
-          !(value=jswrap_json_parse_internal(lex)) ||
-          (lex->tk!='}' && !jslMatch(','))) {
-        jsvUnLock3(key, value, obj);
+    if (!jspCheckStackPosition()) return 0;
+    result = jsvNewObject();
+    if (!result) return 0;
+    jsonNextCh(p); // {
+    jsonSkipWhitespace(p);
+    if (p->ch=='}') {
+      jsonNextCh(p);
+      break;
+    }
+    while (true) {
+      jsonSkipWhitespace(p);
+      JsVar *key = 0, *value = 0;
+      if (p->ch!='"') {
+        jsvUnLock(result);
+        return jsonError(p, "a string");
+      }
+      key = jsvAsArrayIndexAndUnLock(jsonParseString(p));
+      jsonSkipWhitespace(p);
+      if (!key || p->ch!=':') {
+        jsvUnLock2(key, result);
+        return jsonError(p, "':'");
+      }
+      jsonNextCh(p); // :
+      value = jsonParseValue(p);
+      if (!value) {
+        jsvUnLock2(key, result);
         return 0;
       }
-      jsvAddName(obj, jsvMakeIntoVariableName(key, value));
+      // if a key is given twice, the last value wins
+      JsVar *existing = jsvFindChildFromVar(result, key, false);
+      if (existing) {
+        jsvSetValueOfName(existing, value);
+        jsvUnLock(existing);
+      } else
+        jsvAddName(result, jsvMakeIntoVariableName(key, value));
       jsvUnLock2(value, key);
+      if (p->ch=='}') break;
+      if (p->ch!=',') {
+        jsvUnLock(result);
+        return jsonError(p, "',' or '}'");
+      }
+      jsonNextCh(p); // ,
     }
-    if (!jslMatch('}')) {
-      jsvUnLock(obj);
-      return 0;
-    }
-    return obj;
-  }
-  default: {
-    char buf[32];
-    jslTokenAsString(lex->tk, buf, 32);
-    jsExceptionHere(JSET_SYNTAXERROR, "Expecting a valid value, got %s", buf);
-    return 0; // undefined = error
-  }
+    jsonNextCh(p); // }
+  } break;
+  default:
+    if (p->ch=='-' || (p->ch>='0' && p->ch<='9'))
+      result = jsonParseNumber(p);
+    else
+      return jsonError(p, "a valid value");
   }
+  jsonSkipWhitespace(p);
+  return result;
 }
 
 /*JSON{
@@ -166,20 +344,417 @@ JsVar *jswrap_json_parse_internal() {
 }
 Parse the given JSON string into a JavaScript object
 
-NOTE: This implementation uses eval() internally, and as such it is unsafe as it can allow arbitrary JS commands to be executed.
+**Note:** Anything that isn't valid JSON (for instance single quotes, unquoted keys, trailing commas or anything after the value) causes a `SyntaxError` to be thrown.
  */
 JsVar *jswrap_json_parse(JsVar *v) {
-  JsLex lex;
   JsVar *str = jsvAsString(v, false);
-  JsLex *oldLex = jslSetLex(&lex);
-  jslInit(str);
+  if (!str) return 0;
+  JsonParser p;
+  jsvStringIteratorNew(&p.it, str, 0);
+  p.ch = jsvStringIteratorGetChar(&p.it);
+  JsVar *res = jsonParseValue(&p);
+  if (res && jsvStringIteratorHasChar(&p.it)) { // there's more after the value
+    jsvUnLock(res);
+    res = jsonError(&p, "end of input");
+  }
+  jsvStringIteratorFree(&p.it);
   jsvUnLock(str);
-  JsVar *res = jswrap_json_parse_internal();
-  jslKill();
-  jslSetLex(oldLex);
   return res;
 }
 
+#ifndef SAVE_ON_FLASH
+#define JSON_PARSER_STATE_NAME JS_HIDDEN_CHAR_STR"st"
+#define JSON_PARSER_PATH_NAME JS_HIDDEN_CHAR_STR"path"
+#define JSON_PARSER_BUFFER_NAME JS_HIDDEN_CHAR_STR"buf"
+#define JSON_PARSER_MAX_PATH 8 ///< How many levels deep a JSON.Parser path can be
+#define JSON_PARSER_TYPED_DEPTH 32 ///< How many levels deep we check ']' and '}' match up
+
+typedef enum {
+  JSPF_STRING = 1,       ///< Inside a string
+  JSPF_ESCAPE = 2,       ///< Inside a string, just after a backslash
+  JSPF_KEY = 4,          ///< In an object, and the next string is a key
+  JSPF_CAPTURE = 8,      ///< Copying a selected value into the buffer
+  JSPF_CAPTURE_KEY = 16, ///< Copying a key (that we need to compare with the path) into the buffer
+  JSPF_SCALAR = 32,      ///< Copying a selected number/true/false/null - which only ends when we get a character that isn't part of it
+} JsonParserFlags;
+
+/// The state of a JSON.Parser between calls to write (stored in the object as a string)
+typedef struct {
+  unsigned short depth;     ///< How many arrays/objects are we inside
+  unsigned short captureDepth; ///< The depth the value we're copying started at
+  unsigned char flags;      ///< JsonParserFlags
+  unsigned char pathLength; ///< How many items in the path
+  uint32_t isArray;         ///< bit n is set if the array/object at depth n+1 is an array
+  uint32_t pathMatches;     ///< bit n is set if the key/index at depth n+1 matches path[n]
+  JsVarInt index[JSON_PARSER_MAX_PATH]; ///< The current index of any arrays at depth 1..pathLength
+} JsonParserState;
+
+/*JSON{
+  "type" : "class",
+  "class" : "JSONParser",
+  "ifndef" : "SAVE_ON_FLASH"
+}
+A parser for JSON that arrives in pieces (for instance from a Socket or Serial port).
+Create one with `new JSON.Parser(options)`, and see `JSON.Parser` for more information.
+ */
+/*JSON{
+  "type" : "event",
+  "class" : "JSONParser",
+  "name" : "value",
+  "params" : [
+    ["value","JsVar","The value that was parsed"]
+  ],
+  "ifndef" : "SAVE_ON_FLASH"
+}
+Called (from inside `write`) each time a whole value has been parsed - either a
+top-level value, or a value matching the `path` given to the constructor.
+ */
+/*JSON{
+  "type" : "staticproperty",
+  "class" : "JSON",
+  "name" : "Parser",
+  "generate" : "jswrap_json_parser_class",
+  "return" : ["JsVar","The JSONParser class"],
+  "ifndef" : "SAVE_ON_FLASH"
+}
+A class for parsing JSON that arrives a chunk at a time, without having to join
+all of the chunks into one big string first. Only the value currently being
+parsed is held in memory, so you can handle documents far bigger than the
+amount of free memory, as long as each value you're interested in fits.
+
+```
+var p = new JSON.Parser({path:["items","*"]});
+p.on('value', function(item) { print(item.name); });
+p.write('{"count":2,"items":[{"name":"a"},');
+p.write('{"name":"b"}]}');
+p.end();
+```
+
+`options` can contain:
+
+* `path` - an array (or a string like `"items.*"`) of object keys or array
+indices. Only values at that path are parsed and emitted, and everything else
+is skipped. `"*"` matches any key or index. If it isn't given, each top-level
+value is emitted - so newline-delimited JSON works too.
+
+As `write` and `end` are supported, a `JSON.Parser` can be used as the
+destination of `pipe`.
+
+**Note:** Values that don't match `path` are skipped without being fully
+checked, but anything that is emitted has been parsed like `JSON.parse` would.
+ */
+JsVar *jswrap_json_parser_class() {
+  jsvUnLock(jspNewPrototype("JSONParser")); // make sure the class is in the root scope
+  return jsvObjectGetChild(execInfo.root, "JSONParser", 0);
+}
+
+/*JSON{
+  "type" : "constructor",
+  "class" : "JSONParser",
+  "name" : "JSONParser",
+  "generate" : "jswrap_json_parser_constructor",
+  "params" : [
+    ["options","JsVar","An optional object containing `{path:[...]}` - see `JSON.Parser`"]
+  ],
+  "return" : ["JsVar","A JSONParser object"],
+  "ifndef" : "SAVE_ON_FLASH"
+}
+Create a parser for JSON that arrives in pieces - see `JSON.Parser`
+ */
+JsVar *jswrap_json_parser_constructor(JsVar *options) {
+  JsVar *path = 0;
+  if (jsvIsObject(options)) {
+    path = jsvObjectGetChild(options, "path", 0);
+    if (jsvIsString(path)) {
+      JsVar *dot = jsvNewFromString(".");
+      JsVar *arr = jswrap_string_split(path, dot);
+      jsvUnLock2(dot, path);
+      path = arr;
+    } else if (jsvIsUndefined(path)) {
+      path = jsvNewEmptyArray();
+    }
+  } else if (jsvIsUndefined(options)) {
+    path = jsvNewEmptyArray();
+  } else {
+    jsExceptionHere(JSET_ERROR, "Expecting options to be undefined or an Object, not %t", options);
+    return 0;
+  }
+  if (!jsvIsArray(path)) {
+    jsExceptionHere(JSET_ERROR, "Expecting path to be an Array or String, not %t", path);
+    jsvUnLock(path);
+    return 0;
+  }
+  JsVarInt pathLength = jsvGetArrayLength(path);
+  if (pathLength > JSON_PARSER_MAX_PATH) {
+    jsExceptionHere(JSET_ERROR, "Path can't be more than %d items long", JSON_PARSER_MAX_PATH);
+    jsvUnLock(path);
+    return 0;
+  }
+
+  JsonParserState state;
+  memset(&state, 0, sizeof(state));
+  state.pathLength = (unsigned char)pathLength;
+  JsVar *stateVar = jsvNewStringOfLength(sizeof(state));
+  JsVar *parser = jspNewObject(0, "JSONParser");
+  if (!parser || !stateVar) { // out of memory
+    jsvUnLock3(parser, stateVar, path);
+    return 0;
+  }
+  jsvSetString(stateVar, (char*)&state, sizeof(state));
+  jsvObjectSetChildAndUnLock(parser, JSON_PARSER_STATE_NAME, stateVar);
+  jsvObjectSetChildAndUnLock(parser, JSON_PARSER_PATH_NAME, path);
+  return parser;
+}
+
+/// Does the key/index at the given depth (0 = inside the top-level value) match the path?
+static bool jsonParserPathMatches(JsVar *path, int depth, JsVar *key, JsVarInt index) {
+  JsVar *item = jsvGetArrayItem(path, depth);
+  bool match;
+  if (jsvIsString(item) && jsvIsStringEqual(item, "*"))
+    match = true;
+  else if (key) {
+    JsVar *itemStr = jsvAsString(item, false);
+    match = itemStr && jsvCompareString(key, itemStr, 0, 0, true)==0 && jsvGetStringLength(key)==jsvGetStringLength(itemStr);
+    jsvUnLock(itemStr);
+  } else
+    match = (jsvIsInt(item) || (jsvIsString(item) && jsvIsStringNumericInt(item, false))) && jsvGetInteger(item)==index;
+  jsvUnLock(item);
+  return match;
+}
+
+/// We've just started a new key or index at the current depth - work out if it matches the path
+static void jsonParserSetIndex(JsonParserState *s, JsVar *path) {
+  int d = s->depth-1;
+  if (d >= s->pathLength) return;
+  s->pathMatches &= ~(1u<<d);
+  if (s->isArray & (1u<<d)) {
+    if (jsonParserPathMatches(path, d, 0, s->index[d]))
+      s->pathMatches |= 1u<<d;
+  } else {
+    // for objects we only know when we've got the key - unless the path says any key will do
+    JsVar *item = jsvGetArrayItem(path, d);
+    if (jsvIsString(item) && jsvIsStringEqual(item, "*"))
+      s->pathMatches |= 1u<<d;
+    jsvUnLock(item);
+  }
+}
+
+/// Is a value starting at the current position one we want?
+static bool jsonParserIsSelected(JsonParserState *s) {
+  uint32_t mask = (1u<<s->pathLength)-1;
+  return s->depth==s->pathLength && !(s->flags & JSPF_KEY) && (s->pathMatches&mask)==mask;
+}
+
+/// Is a key starting at the current position one we need to compare with the path?
+static bool jsonParserWantsKey(JsonParserState *s) {
+  if (!(s->flags & JSPF_KEY) || s->depth==0 || s->depth>s->pathLength) return false;
+  uint32_t mask = (1u<<(s->depth-1))-1; // the keys outside this one must all match
+  return (s->pathMatches&mask)==mask && !(s->pathMatches & (1u<<(s->depth-1)));
+}
+
+/// We've got a whole value or key in the buffer - handle it. Returns false on error
+static bool jsonParserGotBuffer(JsVar *parser, JsonParserState *s, JsVar *path, JsvStringIterator *buf) {
+  jsvStringIteratorFree(buf);
+  JsVar *text = jsvObjectGetChild(parser, JSON_PARSER_BUFFER_NAME, 0);
+  JsVar *value = jswrap_json_parse(text);
+  jsvUnLock(text);
+  // start again with an empty buffer
+  text = jsvNewFromEmptyString();
+  jsvObjectSetChild(parser, JSON_PARSER_BUFFER_NAME, text);
+  jsvStringIteratorNew(buf, text, 0);
+  jsvUnLock(text);
+  if (!value) return false;
+  if (s->flags & JSPF_CAPTURE_KEY) {
+    s->flags &= (unsigned char)~JSPF_CAPTURE_KEY;
+    if (jsonParserPathMatches(path, s->depth-1, value, 0))
+      s->pathMatches |= 1u<<(s->depth-1);
+  } else {
+    s->flags &= (unsigned char)~(JSPF_CAPTURE|JSPF_SCALAR);
+    jsiExecuteObjectCallbacks(parser, JS_EVENT_PREFIX"value", &value, 1);
+  }
+  jsvUnLock(value);
+  return !jspHasError();
+}
+
+static void jsonParserUnexpected(char ch) {
+  char got[4] = "' '";
+  got[1] = ch;
+  jsExceptionHere(JSET_SYNTAXERROR, "Unexpected %s in JSON", got);
+}
+
+/*JSON{
+  "type" : "method",
+  "class" : "JSONParser",
+  "name" : "write",
+  "generate" : "jswrap_json_parser_write",
+  "params" : [
+    ["data","JsVar","The next part of the JSON"]
+  ],
+  "ifndef" : "SAVE_ON_FLASH"
+}
+Add the next part of the JSON to the parser. A `value` event is emitted (before
+this returns) for each value that is completed.
+ */
+void jswrap_json_parser_write(JsVar *parser, JsVar *data) {
+  JsVar *stateVar = jsvObjectGetChild(parser, JSON_PARSER_STATE_NAME, 0);
+  JsVar *path = jsvObjectGetChild(parser, JSON_PARSER_PATH_NAME, 0);
+  JsVar *str = jsvAsString(data, false);
+  JsonParserState s;
+  if (!stateVar || !path || !str || jsvGetStringChars(stateVar, 0, (char*)&s, sizeof(s))!=sizeof(s)) {
+    jsvUnLock3(stateVar, path, str);
+    return;
+  }
+  JsVar *text = jsvObjectGetChild(parser, JSON_PARSER_BUFFER_NAME, 0);
+  if (!text) {
+    text = jsvNewFromEmptyString();
+    jsvObjectSetChild(parser, JSON_PARSER_BUFFER_NAME, text);
+  }
+  JsvStringIterator buf;
+  jsvStringIteratorNew(&buf, text, 0);
+  jsvStringIteratorGotoEnd(&buf);
+  jsvUnLock(text);
+
+  JsvStringIterator it;
+  jsvStringIteratorNew(&it, str, 0);
+  bool ok = true;
+  while (ok && jsvStringIteratorHasChar(&it)) {
+    char ch = jsvStringIteratorGetChar(&it);
+    jsvStringIteratorNextInline(&it);
+    bool copy = (s.flags & (JSPF_CAPTURE|JSPF_CAPTURE_KEY))!=0;
+    if (s.flags & JSPF_STRING) {
+      if (copy) jsvStringIteratorAppend(&buf, ch);
+      if (s.flags & JSPF_ESCAPE) s.flags &= (unsigned char)~JSPF_ESCAPE;
+      else if (ch=='\\') s.flags |= JSPF_ESCAPE;
+      else if (ch=='"') {
+        s.flags &= (unsigned char)~JSPF_STRING;
+        if ((s.flags & JSPF_CAPTURE_KEY) || ((s.flags & JSPF_CAPTURE) && s.depth==s.captureDepth))
+          ok = jsonParserGotBuffer(parser, &s, path, &buf);
+      }
+      continue;
+    }
+    if (s.flags & JSPF_SCALAR) {
+      if (isAlpha(ch) || isNumeric(ch) || ch=='-' || ch=='+' || ch=='.') {
+        jsvStringIteratorAppend(&buf, ch);
+        continue;
+      }
+      ok = jsonParserGotBuffer(parser, &s, path, &buf);
+      if (!ok) break;
+      copy = false;
+    }
+    if (ch==' ' || ch=='\t' || ch=='\n' || ch=='\r') continue;
+    if (!copy && ch!=']' && ch!='}' && ch!=',' && ch!=':') {
+      if (jsonParserIsSelected(&s)) {
+        s.flags |= JSPF_CAPTURE;
+        s.captureDepth = s.depth;
+        copy = true;
+        if (ch!='"' && ch!='[' && ch!='{') s.flags |= JSPF_SCALAR;
+      } else if (ch=='"' && jsonParserWantsKey(&s)) {
+        s.flags |= JSPF_CAPTURE_KEY;
+        copy = true;
+      }
+    }
+    if (copy) jsvStringIteratorAppend(&buf, ch);
+    switch (ch) {
+    case '"':
+      s.flags |= JSPF_STRING;
+      break;
+    case '[':
+    case '{':
+      if (s.depth<JSON_PARSER_TYPED_DEPTH) {
+        if (ch=='[') s.isArray |= 1u<<s.depth;
+        else s.isArray &= ~(1u<<s.depth);
+      }
+      if (s.depth==0xFFFF) {
+        jsExceptionHere(JSET_SYNTAXERROR, "JSON nested too deeply");
+        ok = false;
+        break;
+      }
+      s.depth++;
+      if (ch=='[') s.flags &= (unsigned char)~JSPF_KEY;
+      else s.flags |= JSPF_KEY;
+      if (!(s.flags & JSPF_CAPTURE) && s.depth<=s.pathLength) {
+        s.index[s.depth-1] = 0;
+        jsonParserSetIndex(&s, path);
+      }
+      break;
+    case ']':
+    case '}':
+      if (s.depth==0 || (s.depth<=JSON_PARSER_TYPED_DEPTH && ((s.isArray>>(s.depth-1))&1)!=(ch==']'))) {
+        jsonParserUnexpected(ch);
+        ok = false;
+        break;
+      }
+      s.depth--;
+      s.flags &= (unsigned char)~JSPF_KEY;
+      if ((s.flags & JSPF_CAPTURE) && s.depth==s.captureDepth)
+        ok = jsonParserGotBuffer(parser, &s, path, &buf);
+      break;
+    case ',':
+      if (s.depth==0) {
+        jsonParserUnexpected(ch);
+        ok = false;
+        break;
+      }
+      if (!(s.flags & JSPF_CAPTURE) && s.depth<=s.pathLength) {
+        bool isArray = (s.isArray>>(s.depth-1))&1;
+        if (isArray) s.index[s.depth-1]++;
+        else s.flags |= JSPF_KEY;
+        jsonParserSetIndex(&s, path);
+      } else if (s.depth<=JSON_PARSER_TYPED_DEPTH && !((s.isArray>>(s.depth-1))&1))
+        s.flags |= JSPF_KEY;
+      break;
+    case ':':
+      s.flags &= (unsigned char)~JSPF_KEY;
+      break;
+    default: // part of a number/true/false/null we're not interested in
+      break;
+    }
+  }
+  jsvStringIteratorFree(&it);
+  jsvStringIteratorFree(&buf);
+  jsvSetString(stateVar, (char*)&s, sizeof(s));
+  jsvUnLock3(stateVar, path, str);
+}
+
+/*JSON{
+  "type" : "method",
+  "class" : "JSONParser",
+  "name" : "end",
+  "generate" : "jswrap_json_parser_end",
+  "params" : [
+    ["data","JsVar","Optional - the last part of the JSON"]
+  ],
+  "ifndef" : "SAVE_ON_FLASH"
+}
+Tell the parser there is no more JSON, so any number at the very end is emitted.
+If the JSON stopped part-way through a value, a `SyntaxError` is thrown. The parser
+can then be used again for a new document.
+ */
+void jswrap_json_parser_end(JsVar *parser, JsVar *data) {
+  if (!jsvIsUndefined(data)) {
+    jswrap_json_parser_write(parser, data);
+    if (jspHasError()) return;
+  }
+  // A space ends any number that's still in progress
+  JsVar *space = jsvNewFromString(" ");
+  jswrap_json_parser_write(parser, space);
+  jsvUnLock(space);
+  JsVar *stateVar = jsvObjectGetChild(parser, JSON_PARSER_STATE_NAME, 0);
+  JsonParserState s;
+  if (stateVar && jsvGetStringChars(stateVar, 0, (char*)&s, sizeof(s))==sizeof(s)) {
+    if (!jspHasError() && (s.depth || (s.flags & JSPF_STRING)))
+      jsExceptionHere(JSET_SYNTAXERROR, "Unexpected end of JSON input");
+    // reset, ready for the next document
+    unsigned char pathLength = s.pathLength;
+    memset(&s, 0, sizeof(s));
+    s.pathLength = pathLength;
+    jsvSetString(stateVar, (char*)&s, sizeof(s));
+  }
+  jsvUnLock(stateVar);
+  jsvObjectSetChildAndUnLock(parser, JSON_PARSER_BUFFER_NAME, jsvNewFromEmptyString());
+}
+#endif
+
 /* This is like jsfGetJSONWithCallback, but handles ONLY functions (and does not print the initial 'function' text) */
 void jsfGetJSONForFunctionWithCallback(JsVar *var, JSONFlags flags, vcbprintf_callback user_callback, void *user_data) {
   assert(jsvIsFunction(var));
@@ -218,7 +793,9 @@ void jsfGetJSONForFunctionWithCallback(JsVar *var, JSONFlags flags, vcbprintf_ca
       } else {
         const char *prefix = jsvIsFunctionReturn(var) ? "return " : "";
         bool hadNewLine = jsvGetStringIndexOf(codeVar,'\n')>0;
-        cbprintf(user_callback, user_data, hadNewLine?"{\n  %s%v\n}":"{%s%v}", prefix, codeVar);
+        cbprintf(user_callback, user_data, hadNewLine?"{\n  %s":"{%s", prefix);
+        jslPrintTokenisedString(codeVar, user_callback, user_data);
+        cbprintf(user_callback, user_data, hadNewLine?"\n}":"}");
       }
     } else cbprintf(user_callback, user_data, "{}");
   }
@@ -16,6 +16,11 @@
 JsVar *jswrap_json_stringify(JsVar *v, JsVar *replacer, JsVar *space);
 JsVar *jswrap_json_parse(JsVar *v);
 
+JsVar *jswrap_json_parser_class();
+JsVar *jswrap_json_parser_constructor(JsVar *options);
+void jswrap_json_parser_write(JsVar *parser, JsVar *data);
+void jswrap_json_parser_end(JsVar *parser, JsVar *data);
+
 typedef enum {
   JSON_NONE,
   JSON_SOME_NEWLINES     = 1, //< insert newlines in non-simple arrays and objects
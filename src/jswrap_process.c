@@ -126,6 +126,10 @@ Run a Garbage Collection pass, and return an object containing information on me
 * `usage` : Memory that has been used (in blocks)
 * `total` : Total memory (in blocks)
 * `history` : Memory used for command history - that is freed if memory is low. Note that this is INCLUDED in the figure for 'free'
+* `indexedObjects` : The number of Objects with so many keys that they have been given a hash index to speed up lookups. The index memory is INCLUDED in the figure for 'usage'
+* `gcPauses` : The number of times Espruino has stopped to do garbage collection (each step of an incremental garbage collection counts as one - see `E.setGCBudget`)
+* `gcMaxPause` : The longest time in milliseconds that garbage collection has stopped JavaScript execution for
+* `gcTime` : The total time in milliseconds spent doing garbage collection
 * `stackEndAddress` : (on ARM) the address (that can be used with peek/poke/etc) of the END of the stack. The stack grows down, so unless you do a lot of recursion the bytes above this can be used.
 * `flash_start` : (on ARM) the address of the start of flash memory (usually `0x8000000`)
 * `flash_binary_end` : (on ARM) the address in flash memory of the end of Espruino's firmware.
@@ -152,6 +156,16 @@ JsVar *jswrap_process_memory() {
     jsvObjectSetChildAndUnLock(obj, "usage", jsvNewFromInteger((JsVarInt)usage));
     jsvObjectSetChildAndUnLock(obj, "total", jsvNewFromInteger((JsVarInt)total));
     jsvObjectSetChildAndUnLock(obj, "history", jsvNewFromInteger((JsVarInt)history));
+#ifndef SAVE_ON_FLASH
+    jsvObjectSetChildAndUnLock(obj, "indexedObjects", jsvNewFromInteger((JsVarInt)jsvGetHashIndexCount()));
+#endif
+#ifdef JSV_GC_GRAY_STACK_SIZE
+    JsvGCStats gcStats;
+    jsvGetGCStats(&gcStats);
+    jsvObjectSetChildAndUnLock(obj, "gcPauses", jsvNewFromInteger((JsVarInt)gcStats.pauses));
+    jsvObjectSetChildAndUnLock(obj, "gcMaxPause", jsvNewFromFloat(jshGetMillisecondsFromTime(gcStats.maxPause)));
+    jsvObjectSetChildAndUnLock(obj, "gcTime", jsvNewFromFloat(jshGetMillisecondsFromTime(gcStats.totalPause)));
+#endif
 
 #ifdef ARM
     extern int LINKER_END_VAR; // end of ram used (variables) - should be 'void', but 'int' avoids warnings
@@ -282,22 +282,38 @@ void jswrap_serial_setup(JsVar *parent, JsVar *baud, JsVar *options) {
 }
 
 
+// Data is collected up here so it can be sent with jshTransmitBuffer
+typedef struct {
+  IOEventFlags device;
+  unsigned int len;
+  unsigned char buf[32];
+} JswSerialPrintData;
+
+static void _jswrap_serial_print_flush(JswSerialPrintData *p) {
+  jshTransmitBuffer(p->device, p->buf, p->len);
+  p->len = 0;
+}
 static void _jswrap_serial_print_cb(int data, void *userData) {
-  IOEventFlags device = *(IOEventFlags*)userData;
-  jshTransmit(device, (unsigned char)data);
+  JswSerialPrintData *p = (JswSerialPrintData*)userData;
+  p->buf[p->len++] = (unsigned char)data;
+  if (p->len >= sizeof(p->buf))
+    _jswrap_serial_print_flush(p);
 }
 void _jswrap_serial_print(JsVar *parent, JsVar *arg, bool isPrint, bool newLine) {
   NOT_USED(parent);
-  IOEventFlags device = jsiGetDeviceFromClass(parent);
-  if (!DEVICE_IS_USART(device)) return;
+  JswSerialPrintData p;
+  p.device = jsiGetDeviceFromClass(parent);
+  p.len = 0;
+  if (!DEVICE_IS_USART(p.device)) return;
 
   if (isPrint) arg = jsvAsString(arg, false);
-  jsvIterateCallback(arg, _jswrap_serial_print_cb, (void*)&device);
+  jsvIterateCallback(arg, _jswrap_serial_print_cb, (void*)&p);
   if (isPrint) jsvUnLock(arg);
   if (newLine) {
-    _jswrap_serial_print_cb((unsigned char)'\r', (void*)&device);
-    _jswrap_serial_print_cb((unsigned char)'\n', (void*)&device);
+    _jswrap_serial_print_cb((unsigned char)'\r', (void*)&p);
+    _jswrap_serial_print_cb((unsigned char)'\n', (void*)&p);
   }
+  _jswrap_serial_print_flush(&p);
 }
 
 /*JSON{
@@ -78,10 +78,15 @@ typedef struct {
   const JswSymPtr *symbols;
   const char *symbolChars;
   unsigned char symbolCount;
+#ifdef JSWRAPPER_SYMBOL_HASH
+  const unsigned char *hashTable; ///< Perfect hash of the symbol names (see build_jswrapper.py)
+  unsigned char hashBuckets;
+  unsigned char hashSlots;
+#endif
 } PACKED_JSW_SYM JswSymList;
 
-/// Do a binary search of the symbol table list
-JsVar *jswBinarySearch(const JswSymList *symbolsPtr, JsVar *parent, const char *name);
+/// Find the symbol with the given name in the symbol table list, and create it (or 0)
+JsVar *jswSearchSymbolTable(const JswSymList *symbolsPtr, JsVar *parent, const char *name);
 
 /** If 'name' is something that belongs to an internal function, execute it.  */
 JsVar *jswFindBuiltInFunction(JsVar *parent, const char *name);
@@ -32,6 +32,12 @@
 #include "jsinteractive.h"
 
 #include <pthread.h>
+#ifdef LINUX_EPOLL
+ #include <sys/epoll.h>
+ #include <sys/eventfd.h>
+ #include <sys/timerfd.h>
+ #include <errno.h>
+#endif
 
 #define FAKE_FLASH_FILENAME  "espruino.flash"
 #define FAKE_FLASH_BLOCKSIZE 4096
@@ -52,6 +58,46 @@
 int ioDevices[EV_DEVICE_MAX+1]; // list of open IO devices (or 0)
 JshPinState gpioState[JSH_PIN_COUNT]; // will be set to UNDEFINED if it isn't exported
 
+#ifdef LINUX_EPOLL
+/* Rather than polling, the input thread waits on inputEpoll and jshSleep
+ * waits on sleepEpoll. The input thread wakes jshSleep with sleepWake
+ * whenever it pushes an event, and jshSleep uses sleepTimer so it
+ * wakes up for the next JS timer. */
+// what each fd in inputEpoll is for (anything else is an index into ioDevices)
+#define EPOLL_TAG_WAKE  0x10000
+#define EPOLL_TAG_STDIN 0x20000
+#define EPOLL_TAG_GPIO  0x40000 // ORed with the pin number
+
+static int inputEpoll = -1; // stdin, ioDevices, GPIO edges and inputWake
+static int inputWake = -1; // eventfd to wake the input thread (data to transmit, or shutting down)
+static bool inputWakePending; // have we already written to inputWake?
+static bool stdinIsFile; // stdin can't be used with epoll (it's a file or /dev/null) so just read it until it ends
+static bool ioDeviceBlocked[EV_DEVICE_MAX+1]; // the device's write() would block, so we're waiting for EPOLLOUT
+static int sleepEpoll = -1; // sleepWake, sleepTimer and sockets
+static int sleepWake = -1; // eventfd to wake jshSleep because an event has been pushed
+static int sleepTimer = -1; // timerfd to wake jshSleep when the next JS timer is due
+
+static bool epollControl(int epoll, int op, int fd, uint32_t events, uint32_t tag) {
+  struct epoll_event ev;
+  memset(&ev, 0, sizeof(ev));
+  ev.events = events;
+  ev.data.u32 = tag;
+  return epoll_ctl(epoll, op, fd, &ev) == 0;
+}
+#define epollAdd(EPOLL, FD, EVENTS, TAG) epollControl(EPOLL, EPOLL_CTL_ADD, FD, EVENTS, TAG)
+#define epollModify(EPOLL, FD, EVENTS, TAG) epollControl(EPOLL, EPOLL_CTL_MOD, FD, EVENTS, TAG)
+
+static void eventfdSignal(int fd) {
+  uint64_t n = 1;
+  if (fd>=0) write(fd, &n, sizeof(n));
+}
+
+static void eventfdClear(int fd) {
+  uint64_t n; // also works for timerfd
+  read(fd, &n, sizeof(n));
+}
+#endif
+
 #ifdef SYSFS_GPIO_DIR
 
 #include <unistd.h>
@@ -59,6 +105,9 @@ JshPinState gpioState[JSH_PIN_COUNT]; // will be set to UNDEFINED if it isn't ex
 
 bool gpioShouldWatch[JSH_PIN_COUNT]; // whether we should watch this pin for changes
 bool gpioLastState[JSH_PIN_COUNT]; // the last state of this pin
+#ifdef LINUX_EPOLL
+int gpioWatchFd[JSH_PIN_COUNT]; // the pin's 'value' file if the kernel tells us about its edges, or -1 if we have to poll it
+#endif
 
 
 // functions for accessing the sysfs GPIO
@@ -96,25 +145,61 @@ JsVarInt sysfs_read_int(const char *path) {
   sysfs_read(path, buf, sizeof(buf));
   return stringToIntWithRadix(buf, 10, 0);
 }
+
+#ifdef LINUX_EPOLL
+/** Ask the kernel to report edges on this pin via its 'value' file, so the
+ * input thread can wait for them in epoll. If it can't, the pin is polled */
+void sysfs_watch_edges(Pin pin, bool watch) {
+  char path[64] = SYSFS_GPIO_DIR"/gpio";
+  itostr(pin, &path[strlen(path)], 10);
+  char *pathEnd = &path[strlen(path)];
+  if (gpioWatchFd[pin]>=0) {
+    close(gpioWatchFd[pin]); // this removes it from inputEpoll too
+    gpioWatchFd[pin] = -1;
+  }
+  strcpy(pathEnd, "/edge");
+  sysfs_write(path, watch?"both":"none");
+  if (!watch) return;
+  char edge[8];
+  sysfs_read(path, edge, sizeof(edge));
+  if (strncmp(edge, "both", 4)) return; // not supported
+  strcpy(pathEnd, "/value");
+  int f = open(path, O_RDONLY | O_NONBLOCK);
+  if (f<0) return;
+  char ch;
+  read(f, &ch, 1); // edges are only reported after the value has been read
+  if (epollAdd(inputEpoll, f, EPOLLPRI | EPOLLERR, EPOLL_TAG_GPIO | (uint32_t)pin))
+    gpioWatchFd[pin] = f;
+  else
+    close(f);
+}
+#endif
 #endif
 // ----------------------------------------------------------------------------
 #ifdef USE_WIRINGPI
-void irqEXTI0() { jshPushIOWatchEvent(EV_EXTI0); }
-void irqEXTI1() { jshPushIOWatchEvent(EV_EXTI1); }
-void irqEXTI2() { jshPushIOWatchEvent(EV_EXTI2); }
-void irqEXTI3() { jshPushIOWatchEvent(EV_EXTI3); }
-void irqEXTI4() { jshPushIOWatchEvent(EV_EXTI4); }
-void irqEXTI5() { jshPushIOWatchEvent(EV_EXTI5); }
-void irqEXTI6() { jshPushIOWatchEvent(EV_EXTI6); }
-void irqEXTI7() { jshPushIOWatchEvent(EV_EXTI7); }
-void irqEXTI8() { jshPushIOWatchEvent(EV_EXTI8); }
-void irqEXTI9() { jshPushIOWatchEvent(EV_EXTI9); }
-void irqEXTI10() { jshPushIOWatchEvent(EV_EXTI10); }
-void irqEXTI11() { jshPushIOWatchEvent(EV_EXTI11); }
-void irqEXTI12() { jshPushIOWatchEvent(EV_EXTI12); }
-void irqEXTI13() { jshPushIOWatchEvent(EV_EXTI13); }
-void irqEXTI14() { jshPushIOWatchEvent(EV_EXTI14); }
-void irqEXTI15() { jshPushIOWatchEvent(EV_EXTI15); }
+// these are called from wiringPi's own thread
+void irqEXTI(IOEventFlags exti) {
+  jshPushIOWatchEvent(exti);
+#ifdef LINUX_EPOLL
+  eventfdSignal(sleepWake);
+#endif
+}
+void irqEXTI0() { irqEXTI(EV_EXTI0); }
+void irqEXTI1() { irqEXTI(EV_EXTI1); }
+void irqEXTI2() { irqEXTI(EV_EXTI2); }
+void irqEXTI3() { irqEXTI(EV_EXTI3); }
+void irqEXTI4() { irqEXTI(EV_EXTI4); }
+void irqEXTI5() { irqEXTI(EV_EXTI5); }
+void irqEXTI6() { irqEXTI(EV_EXTI6); }
+void irqEXTI7() { irqEXTI(EV_EXTI7); }
+void irqEXTI8() { irqEXTI(EV_EXTI8); }
+void irqEXTI9() { irqEXTI(EV_EXTI9); }
+void irqEXTI10() { irqEXTI(EV_EXTI10); }
+void irqEXTI11() { irqEXTI(EV_EXTI11); }
+void irqEXTI12() { irqEXTI(EV_EXTI12); }
+void irqEXTI13() { irqEXTI(EV_EXTI13); }
+void irqEXTI14() { irqEXTI(EV_EXTI14); }
+void irqEXTI15() { irqEXTI(EV_EXTI15); }
 void irqEXTIDoNothing() { }
 
 void (*irqEXTIs[16])(void) = {
@@ -225,8 +310,8 @@ int getch()
 {
     int r;
     unsigned char c;
-    if ((r = (int)read(STDIN_FILENO, &c, sizeof(c))) < 0) {
-        return r;
+    if ((r = (int)read(STDIN_FILENO, &c, sizeof(c))) <= 0) {
+        return -1; // error, or end of file
     } else {
         return c;
     }
@@ -236,6 +321,136 @@ int getch()
 pthread_t inputThread;
 bool isInitialised;
 
+#ifdef LINUX_EPOLL
+void jshInputThread() {
+  JsSysTime ctrlCTime = 0;
+  bool devicesBlocked = false;
+  bool stdinEnded = false;
+  while (isInitialised) {
+    bool pushed = false;
+    int timeout = -1; // wait until something happens, unless we have to poll something
+    /* Handle the delayed Ctrl-C -> interrupt behaviour (see description by EXEC_CTRL_C's definition).
+     * We behave like SysTick would, and move it on every 50ms */
+    if (execInfo.execute & EXEC_CTRL_C_MASK) {
+      JsSysTime now = jshGetSystemTime();
+      if (now >= ctrlCTime) {
+        if (execInfo.execute & EXEC_CTRL_C_WAIT)
+          execInfo.execute = (execInfo.execute & ~EXEC_CTRL_C_WAIT) | EXEC_INTERRUPTED;
+        if (execInfo.execute & EXEC_CTRL_C)
+          execInfo.execute = (execInfo.execute & ~EXEC_CTRL_C) | EXEC_CTRL_C_WAIT;
+        ctrlCTime = now + jshGetTimeFromMilliseconds(50);
+      }
+      timeout = 50;
+    }
+    // Read stdin if it's just a file
+    if (stdinIsFile && !stdinEnded) {
+      char buf[IOEVENT_MAXCHARS];
+      while (!stdinEnded && jshGetEventsUsed() < IOBUFFERMASK/2) {
+        int bytes = (int)read(STDIN_FILENO, buf, sizeof(buf));
+        if (bytes>0) {
+          jshPushIOCharEvents(EV_USBSERIAL, buf, (unsigned int)bytes);
+          pushed = true;
+        } else stdinEnded = true;
+      }
+      if (!stdinEnded) timeout = 1;
+    }
+    // Write any data we have, as much at once as we can
+    IOEventFlags device;
+    for (device=0;device<=EV_DEVICE_MAX;device++) {
+      unsigned char *data;
+      unsigned int len;
+      while (!ioDeviceBlocked[device] && (len = jshGetDataToTransmit(device, &data))) {
+        if (!ioDevices[device]) {
+          jshTransmitClearDevice(device); // nowhere for it to go
+          break;
+        }
+        int bytes = (int)write(ioDevices[device], data, len);
+        if (bytes>0) {
+          jshTransmitDataSent(device, (unsigned int)bytes);
+        } else if (bytes<0 && errno!=EAGAIN && errno!=EWOULDBLOCK) {
+          jshTransmitClearDevice(device); // error - drop the data
+        } else {
+          // the device can't take any more - wait until epoll says it can
+          ioDeviceBlocked[device] = true;
+          epollModify(inputEpoll, ioDevices[device], EPOLLIN | EPOLLOUT, device);
+        }
+      }
+    }
+#ifdef SYSFS_GPIO_DIR
+    // Poll any pins that the kernel can't tell us about edges on
+    Pin pin;
+    for (pin=0;pin<JSH_PIN_COUNT;pin++)
+      if (gpioShouldWatch[pin] && gpioWatchFd[pin]<0) {
+        timeout = 1;
+        bool state = jshPinGetValue(pin);
+        if (state != gpioLastState[pin]) {
+          jshPushIOEvent(pinToEVEXTI(pin) | (state?EV_EXTI_IS_HIGH:0), jshGetSystemTime());
+          gpioLastState[pin] = state;
+          pushed = true;
+        }
+      }
+#endif
+    if (pushed) eventfdSignal(sleepWake);
+    // If the IO buffer was too full to read devices, give the main thread a chance to empty it
+    if (devicesBlocked) {
+      usleep(1000);
+      devicesBlocked = false;
+    }
+
+    struct epoll_event events[8];
+    int n = epoll_wait(inputEpoll, events, sizeof(events)/sizeof(events[0]), timeout);
+    pushed = false;
+    int i;
+    for (i=0;i<n;i++) {
+      uint32_t tag = events[i].data.u32;
+      if (tag == EPOLL_TAG_WAKE) {
+        __atomic_store_n(&inputWakePending, false, __ATOMIC_SEQ_CST);
+        eventfdClear(inputWake);
+      } else if (tag == EPOLL_TAG_STDIN) {
+        char buf[IOEVENT_MAXCHARS];
+        int bytes = (int)read(STDIN_FILENO, buf, sizeof(buf));
+        if (bytes>0) {
+          jshPushIOCharEvents(EV_USBSERIAL, buf, (unsigned int)bytes);
+          pushed = true;
+        } else // end of file (or error) - stop waiting for it
+          epoll_ctl(inputEpoll, EPOLL_CTL_DEL, STDIN_FILENO, 0);
+#ifdef SYSFS_GPIO_DIR
+      } else if (tag & EPOLL_TAG_GPIO) {
+        Pin pin = (Pin)(tag & ~EPOLL_TAG_GPIO);
+        char ch = 0;
+        if (gpioWatchFd[pin]>=0 && lseek(gpioWatchFd[pin], 0, SEEK_SET)==0 &&
+            read(gpioWatchFd[pin], &ch, 1)==1) {
+          bool state = ch=='1';
+          if (state != gpioLastState[pin]) {
+            jshPushIOEvent(pinToEVEXTI(pin) | (state?EV_EXTI_IS_HIGH:0), jshGetSystemTime());
+            gpioLastState[pin] = state;
+            pushed = true;
+          }
+        }
+#endif
+      } else if (tag<=EV_DEVICE_MAX && ioDevices[tag]) {
+        if ((events[i].events & EPOLLOUT) && ioDeviceBlocked[tag]) {
+          // we can write again - the data is sent next time around the loop
+          ioDeviceBlocked[tag] = false;
+          epollModify(inputEpoll, ioDevices[tag], EPOLLIN, tag);
+        }
+        // Read from the device - if we have space
+        if (jshGetEventsUsed() < IOBUFFERMASK/2) {
+          char buf[IOEVENT_MAXCHARS];
+          // read can return -1 (EAGAIN) because O_NONBLOCK is set
+          int bytes = (int)read(ioDevices[tag], buf, sizeof(buf));
+          if (bytes>0) {
+            jshPushIOCharEvents((IOEventFlags)tag, buf, (unsigned int)bytes);
+            pushed = true;
+          }
+        } else
+          devicesBlocked = true;
+      }
+    }
+    if (pushed) eventfdSignal(sleepWake);
+  }
+}
+#else
 void jshInputThread() {
   while (isInitialised) {
     bool shortSleep = false;
@@ -255,7 +470,7 @@ void jshInputThread() {
       int i;
       for (i=0;i<=EV_DEVICE_MAX;i++) {
         if (ioDevices[i]) {
-          char buf[32];
+          char buf[IOEVENT_MAXCHARS];
           // read can return -1 (EAGAIN) because O_NONBLOCK is set
           int bytes = (int)read(ioDevices[i], buf, sizeof(buf));
           if (bytes>0) {
@@ -269,12 +484,13 @@ void jshInputThread() {
     // Write any data we have
     IOEventFlags device = jshGetDeviceToTransmit();
     while (device != EV_NONE) {
-      char ch = (char)jshGetCharToTransmit(device);
-      //printf("[[ '%c'\r\n", ch);
+      unsigned char *data;
+      unsigned int len = jshGetDataToTransmit(device, &data);
       if (ioDevices[device]) {
-        write(ioDevices[device], &ch, 1);
+        write(ioDevices[device], data, len);
         shortSleep = true;
       }
+      jshTransmitDataSent(device, len);
       device = jshGetDeviceToTransmit();
     }
 
@@ -295,6 +511,7 @@ void jshInputThread() {
     usleep(shortSleep ? 1000 : 50000);
   }
 }
+#endif
 
 
 
@@ -311,8 +528,12 @@ void jshInit() {
 #endif
 
   int i;
-  for (i=0;i<=EV_DEVICE_MAX;i++)
+  for (i=0;i<=EV_DEVICE_MAX;i++) {
     ioDevices[i] = 0;
+#ifdef LINUX_EPOLL
+    ioDeviceBlocked[i] = false;
+#endif
+  }
 
   jshInitDevices();
 #ifndef __MINGW32__
@@ -337,8 +558,23 @@ void jshInit() {
 #ifdef SYSFS_GPIO_DIR
   for (i=0;i<JSH_PIN_COUNT;i++) {
     gpioShouldWatch[i] = false;    
+#ifdef LINUX_EPOLL
+    gpioWatchFd[i] = -1;
+#endif
   }
 #endif
+#ifdef LINUX_EPOLL
+  inputEpoll = epoll_create1(EPOLL_CLOEXEC);
+  inputWake = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  inputWakePending = false;
+  epollAdd(inputEpoll, inputWake, EPOLLIN, EPOLL_TAG_WAKE);
+  stdinIsFile = !epollAdd(inputEpoll, STDIN_FILENO, EPOLLIN, EPOLL_TAG_STDIN);
+  sleepEpoll = epoll_create1(EPOLL_CLOEXEC);
+  sleepWake = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  sleepTimer = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+  epollAdd(sleepEpoll, sleepWake, EPOLLIN, 0);
+  epollAdd(sleepEpoll, sleepTimer, EPOLLIN, 0);
+#endif
 
   isInitialised = true;
   int err = pthread_create(&inputThread, NULL, &jshInputThread, NULL);
@@ -354,6 +590,11 @@ void jshKill() {
   int i;
 
   isInitialised = false;
+#ifdef LINUX_EPOLL
+  // wake the input thread up so it sees it has to stop, and wait for it
+  eventfdSignal(inputWake);
+  pthread_join(inputThread, NULL);
+#endif
 
   for (i=0;i<=EV_DEVICE_MAX;i++)
     if (ioDevices[i]) {
@@ -368,6 +609,21 @@ void jshKill() {
     if (gpioState[i] != JSHPINSTATE_UNDEFINED)
       sysfs_write_int(SYSFS_GPIO_DIR"/unexport", i);
 #endif
+#ifdef LINUX_EPOLL
+#ifdef SYSFS_GPIO_DIR
+  for (i=0;i<JSH_PIN_COUNT;i++)
+    if (gpioWatchFd[i]>=0) {
+      close(gpioWatchFd[i]);
+      gpioWatchFd[i] = -1;
+    }
+#endif
+  close(inputEpoll);
+  close(inputWake);
+  close(sleepEpoll);
+  close(sleepWake);
+  close(sleepTimer);
+  inputEpoll = inputWake = sleepEpoll = sleepWake = sleepTimer = -1;
+#endif
 }
 
 void jshIdle() {
@@ -579,6 +835,9 @@ IOEventFlags jshPinWatch(Pin pin, bool shouldWatch) {
 #ifdef SYSFS_GPIO_DIR
         gpioShouldWatch[pin] = true;
         gpioLastState[pin] = jshPinGetValue(pin);
+#ifdef LINUX_EPOLL
+        sysfs_watch_edges(pin, true);
+#endif
 #endif
 #ifdef USE_WIRINGPI
         wiringPiISR(pin, INT_EDGE_BOTH, irqEXTIs[exti-EV_EXTI0]);
@@ -589,6 +848,10 @@ IOEventFlags jshPinWatch(Pin pin, bool shouldWatch) {
     if (!shouldWatch || !exti) {
       gpioEventFlags[pin] = 0;
 #ifdef SYSFS_GPIO_DIR
+#ifdef LINUX_EPOLL
+      if (gpioShouldWatch[pin])
+        sysfs_watch_edges(pin, false);
+#endif
       gpioShouldWatch[pin] = false;
 #endif
 #ifdef USE_WIRINGPI
@@ -623,6 +886,10 @@ void jshUSARTSetup(IOEventFlags device, JshUSARTInfo *inf) {
     if (!ioDevices[device]) {
       jsError("Open of path %s failed", path);
     } else {
+#ifdef LINUX_EPOLL
+      ioDeviceBlocked[device] = false;
+      epollAdd(inputEpoll, ioDevices[device], EPOLLIN, device);
+#endif
       struct termios settings;
       tcgetattr(ioDevices[device], &settings); // get current settings
 
@@ -701,7 +968,11 @@ void jshUSARTSetup(IOEventFlags device, JshUSARTInfo *inf) {
  * to set up interrupts */
 void jshUSARTKick(IOEventFlags device) {
   assert(DEVICE_IS_USART(device) || DEVICE_IS_SPI(device));
-  // all done by the idle loop
+  // all done by the input thread - just make sure it's awake
+#ifdef LINUX_EPOLL
+  if (!__atomic_exchange_n(&inputWakePending, true, __ATOMIC_SEQ_CST))
+    eventfdSignal(inputWake);
+#endif
 }
 
 void jshSPISetup(IOEventFlags device, JshSPIInfo *inf) {
@@ -714,6 +985,9 @@ void jshSPISetup(IOEventFlags device, JshSPIInfo *inf) {
      if (!ioDevices[device]) {
        jsError("Open of path %s failed", path);
      } else {
+#ifdef LINUX_EPOLL
+       epollAdd(inputEpoll, ioDevices[device], EPOLLIN, device);
+#endif
      }
    } else {
      jsError("No path defined for device");
@@ -758,6 +1032,38 @@ void jshI2CRead(IOEventFlags device, unsigned char address, int nBytes, unsigned
 }
 
 /// Enter simple sleep mode (can be woken up by interrupts). Returns true on success
+#ifdef LINUX_EPOLL
+bool jshSleep(JsSysTime timeUntilWake) {
+  if (timeUntilWake <= 0) return true;
+  // set up the timer (if all zero, it's disabled and we just wait for IO)
+  struct itimerspec t;
+  memset(&t, 0, sizeof(t));
+  JsVarFloat secs = jshGetMillisecondsFromTime(timeUntilWake) / 1000;
+  if (secs < 0x7FFFFFFF) {
+    t.it_value.tv_sec = (time_t)secs;
+    t.it_value.tv_nsec = (long)((secs - (JsVarFloat)t.it_value.tv_sec) * 1000000000);
+    if (!t.it_value.tv_sec && !t.it_value.tv_nsec)
+      t.it_value.tv_nsec = 1;
+  }
+  timerfd_settime(sleepTimer, 0, &t, 0);
+  /* If there's no timer, don't wait forever - the host may call jsiLoop with
+   * nothing left that could wake us (eg. when running tests) */
+  bool hasTimer = t.it_value.tv_sec || t.it_value.tv_nsec;
+  struct epoll_event events[8];
+  int n = epoll_wait(sleepEpoll, events, sizeof(events)/sizeof(events[0]), hasTimer ? -1 : 50);
+  if (n>0) {
+    // eventfd/timerfd are non-blocking, so it's fine to just try and clear both
+    eventfdClear(sleepWake);
+    eventfdClear(sleepTimer);
+  }
+  return true;
+}
+
+void jshSleepWakeOnFd(int fd) {
+  // edge triggered as the socket code will read/write everything it can each time around the idle loop
+  epollAdd(sleepEpoll, fd, EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET, 0);
+}
+#else
 bool jshSleep(JsSysTime timeUntilWake) {
   bool hasWatches = false;
 #ifdef SYSFS_GPIO_DIR
@@ -776,6 +1082,7 @@ bool jshSleep(JsSysTime timeUntilWake) {
     usleep(usecs); 
   return true;
 }
+#endif
 
 void jshUtilTimerDisable() {
 }
@@ -4,6 +4,7 @@
 #include <sys/stat.h>
 #include <signal.h>
 #include <dirent.h> // for readdir
+#include <pthread.h>
 
 #include "jslex.h"
 #include "jsvar.h"
@@ -196,7 +197,6 @@ bool run_memory_tests(int vars) {
   return true;
 }
 
-
 void sig_handler(int sig)
 {
   //printf("Got Signal %d\n",sig);fflush(stdout);
@@ -221,6 +221,7 @@ void show_help() {
     printf("   --test-mem-all          Run all Exhaustive Memory crash tests\n");
     printf("   --test-mem test.js      Run the supplied Exhaustive Memory crash test\n");
     printf("   --test-mem-n test.js #  Run the supplied Exhaustive Memory crash test with # vars\n");
+    printf("   --test-alloc-threads    Run a test that allocates variables from 2 threads at once\n");
 }
 
 void die(const char *txt) {
@@ -228,6 +229,71 @@ void die(const char *txt) {
   exit(1);
 }
 
+#define ALLOC_TEST_ITERATIONS 1000000
+#define ALLOC_TEST_LIVE 64 // how many vars each thread keeps allocated at once
+
+volatile bool allocTestStarted;
+volatile bool allocTestFailed;
+
+/* Allocate and free variables, checking that nothing else has been given
+ * (and so has overwritten) the ones we have */
+void alloc_test_loop(int id) {
+  JsVar *live[ALLOC_TEST_LIVE];
+  JsVarInt base = (JsVarInt)id * ALLOC_TEST_ITERATIONS;
+  int i;
+  memset(live, 0, sizeof(live));
+  while (!allocTestStarted);
+  for (i=0;i<ALLOC_TEST_ITERATIONS;i++) {
+    int n = i % ALLOC_TEST_LIVE;
+    if (live[n]) {
+      if (jsvGetInteger(live[n]) != base+i-ALLOC_TEST_LIVE)
+        allocTestFailed = true;
+      jsvUnLock(live[n]);
+    }
+    live[n] = jsvNewFromInteger(base+i);
+    if (!live[n]) allocTestFailed = true;
+  }
+  for (i=0;i<ALLOC_TEST_LIVE;i++)
+    jsvUnLock(live[i]);
+}
+
+void *alloc_test_thread(void *arg) {
+  NOT_USED(arg);
+  alloc_test_loop(1);
+  return 0;
+}
+
+/* Allocate and free variables from two threads at once, to check that
+ * the free list copes (as it has to with IRQs on a microcontroller) */
+bool run_alloc_thread_test() {
+  printf("----------------------------------\r\n");
+  printf("----------------------------- TEST ALLOCATION FROM 2 THREADS\r\n");
+  jshInit();
+  jsvInit();
+  unsigned int usedBefore = jsvGetMemoryUsage();
+  unsigned int freeBefore = jsvGetMemoryTotal() - usedBefore;
+  pthread_t thread;
+  allocTestStarted = false;
+  allocTestFailed = false;
+  if (pthread_create(&thread, NULL, &alloc_test_thread, NULL))
+    die("Unable to create thread\n");
+  allocTestStarted = true;
+  alloc_test_loop(0);
+  pthread_join(thread, NULL);
+  // everything should be back on the free list exactly once
+  bool ok = !allocTestFailed &&
+      jsvGetMemoryUsage() == usedBefore &&
+      jsvMoreFreeVariablesThan(freeBefore-1) &&
+      !jsvMoreFreeVariablesThan(freeBefore);
+  jsvKill();
+  jshKill();
+  if (ok)
+    printf("----------------------------- PASS\r\n");
+  else
+    printf("----------------------------- FAIL <-------\r\n");
+  return ok;
+}
+
 int handleErrors() {
   int e = 0;
   JsVar *exception = jspGetException();
@@ -300,6 +366,9 @@ int main(int argc, char **argv) {
         if (i+2>=argc) die("Expecting an extra 2 arguments\n");
         bool ok = run_memory_test(argv[i+1], atoi(argv[i+2]));
         exit(ok ? 0 : 1);
+      } else if (!strcmp(a,"--test-alloc-threads")) {
+        bool ok = run_alloc_thread_test();
+        exit(ok ? 0 : 1);
       } else {
         printf("Unknown Argument %s\n", a);
         show_help();
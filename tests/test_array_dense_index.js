@@ -0,0 +1,46 @@
+// Densely packed arrays get an index of their elements - check it stays correct
+
+var r = [];
+var a = [];
+var i, ok;
+for (i=0;i<200;i++) a.push(i*3);
+ok = true;
+for (i=0;i<a.length;i++) if (a[i]!==i*3) ok = false;
+r.push(ok);
+r.push(a[200]===undefined && a[-1]===undefined && a.length==200);
+
+// writes
+for (i=0;i<a.length;i++) a[i] = i;
+r.push(a[150]==150 && a.indexOf(150)==150);
+a[a.length] = 200;
+r.push(a.length==201 && a[200]==200);
+
+// pop, shift, unshift, splice, reverse all renumber or remove elements
+r.push(a.pop()==200 && a.length==200 && a[199]==199);
+r.push(a.shift()==0 && a[0]==1 && a[198]==199 && a[199]===undefined);
+a.unshift(0);
+r.push(a[0]==0 && a[100]==100 && a[199]==199);
+a.splice(50,10);
+r.push(a.length==190 && a[49]==49 && a[50]==60 && a[189]==199);
+a.splice(50,0,50,51,52,53,54,55,56,57,58,59);
+ok = a.length==200;
+for (i=0;i<a.length;i++) if (a[i]!==i) ok = false;
+r.push(ok);
+a.reverse();
+ok = true;
+for (i=0;i<a.length;i++) if (a[i]!==199-i) ok = false;
+r.push(ok);
+a.sort(function(x,y){return x-y;});
+ok = true;
+for (i=0;i<a.length;i++) if (a[i]!==i) ok = false;
+r.push(ok);
+
+// making it sparse
+a[300] = 300;
+r.push(a.length==301 && a[250]===undefined && a[300]==300 && a[100]==100);
+delete a[10];
+r.push(a[10]===undefined && a[11]==11 && !(10 in a));
+a.foo = "bar";
+r.push(a.foo=="bar" && a[120]==120 && JSON.stringify(a.slice(0,3))=="[0,1,2]");
+
+result = r.every(function(x){return x;});
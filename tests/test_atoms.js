@@ -0,0 +1,58 @@
+// Long property names that are used in lots of objects share their storage
+
+var json = [], i;
+for (i=0;i<20;i++) json.push('{"temperature":'+i+',"humidityLevel":'+(i*2)+'}');
+var recs = JSON.parse("["+json.join(",")+"]");
+var shortRecs = [];
+for (i=0;i<20;i++) shortRecs.push({temp:i,humid:i*2});
+// Each record should cost about the same as one with short names
+var extra = E.getSizeOf(recs) - E.getSizeOf(shortRecs);
+
+var ok = extra < 10;
+function check() {
+  for (i=0;i<20;i++) {
+    if (recs[i].temperature!=i || recs[i]["humidityLevel"]!=i*2) ok = false;
+    if (Object.keys(recs[i]).join()!="temperature,humidityLevel") ok = false;
+  }
+}
+check();
+
+// Names that start the same must still be different
+var o = {};
+o.temperatureA = 1;
+o.temperatureB = 2;
+o["temperature"] = 3;
+ok = ok && o.temperatureA==1 && o.temperatureB==2 && o.temperature==3 && o.temperatureC===undefined;
+
+// Changing a key we got from an object mustn't change the object
+var k = Object.keys(recs[0])[0];
+k += "Changed";
+ok = ok && k=="temperatureChanged" && recs[1].temperature==1 && JSON.stringify(recs[2])=='{"temperature":2,"humidityLevel":4}';
+
+// Freeing some records (and moving everything around) mustn't affect the others
+recs.splice(0,10);
+o = undefined;
+process.memory(); // garbage collect
+E.defrag();
+for (i=0;i<10;i++) {
+  if (recs[i].temperature!=i+10) ok = false;
+  recs[i].temperature = -1;
+}
+recs.push({temperature:-1, humidityLevel:0});
+ok = ok && recs.every(function(r) { return r.temperature==-1; });
+
+// Atoms are kept over a garbage collection, so a record made afterwards still shares them
+process.memory(); // garbage collect
+var late = JSON.parse('{"temperature":1,"humidityLevel":2}');
+ok = ok && E.getSizeOf([recs[0],late])==E.getSizeOf([recs[0],recs[1]]);
+
+// More long names than fit in the table - and names that only differ after the start
+var many = {};
+for (i=0;i<200;i++) many["longPropertyName"+i] = i;
+process.memory(); // garbage collect
+E.defrag();
+for (i=0;i<200;i++) if (many["longPropertyName"+i]!==i) ok = false;
+ok = ok && eval("many.longPropertyName123")===123 && eval("many.longPropertyName200")===undefined;
+ok = ok && Object.keys(many).every(function(k,i) { return k=="longPropertyName"+i && many[k]===i; });
+
+result = ok;
@@ -0,0 +1,25 @@
+// Built-in functions and objects are looked up by name in generated tables - make sure every one can be found, and nothing else
+
+var missing = [];
+// check that everything in the list of names can be found on obj
+function check(namesFrom, obj, objName) {
+  Object.getOwnPropertyNames(namesFrom).forEach(function(name) {
+    if (obj[name]===undefined && name!="prototype") missing.push(objName+"."+name);
+  });
+}
+check(this, this, "global");
+check(Math, Math, "Math");
+check(JSON, JSON, "JSON");
+check(Number, Number, "Number");
+check(Array.prototype, [1,2], "Array");
+check(String.prototype, "Hello", "String");
+
+// things that aren't built in (but are close to things that are)
+var notFound = [typeof Mathx, typeof Math.sinx, typeof Math.si, typeof [].pus, typeof digitalWrit, typeof Math[""]];
+
+// built-in objects are found when first used
+var found = [typeof Math.sin, typeof JSON.stringify, typeof digitalWrite, typeof E.toUint8Array, typeof Uint8ClampedArray];
+
+result = missing.length==0 &&
+  notFound.every(function(t) { return t=="undefined"; }) &&
+  found.every(function(t) { return t=="function"; });
@@ -0,0 +1,105 @@
+// Functions and loops are compiled to bytecode - make sure they do the same as the parser
+
+var results = [];
+function add(a,b) { return a+b; }
+results.push(add(1,2), add("a","b"), add(1));
+
+// locals, loops, break and continue
+function loops(n) {
+  var s = 0, i = 0;
+  for (var j=0;j<n;j++) { if (j==3) continue; if (j>7) break; s += j; }
+  while (i<5) i++;
+  do { i+=2; if (i>20) break; } while (i<10);
+  return [s,i,j];
+}
+results.push(loops(100));
+
+// strings, objects, arrays and compound assignment
+function members() {
+  var s = "";
+  for (var i=0;i<5;i++) s += i;
+  var o = {a:1, "b c":2, s:s};
+  o.a++;
+  o["b c"] += 3;
+  o.d = [1,2,3];
+  o.d[1] *= 5;
+  o.e = o.f = 7;
+  return JSON.stringify(o);
+}
+results.push(members());
+
+// prefix/postfix, unary and logical operators
+function ops() {
+  var i = 5, j = i++, k = ++i;
+  return [i, j, k, -3, +"4", ~5, !i, typeof i, void 0, 1&&2, 0||"z", null&&1, i>2?"big":"small", 7>>>1];
+}
+results.push(ops());
+
+// constructors and methods
+function Foo(x) { this.x = x; }
+Foo.prototype.get = function() { return this.x; };
+function construct() {
+  var f = new Foo(5);
+  return [f.get(), f instanceof Foo, "x" in f, "y" in f];
+}
+results.push(construct());
+
+// typed arrays
+function typed() {
+  var a = new Uint8Array(4);
+  for (var i=0;i<4;i++) a[i] = i*100;
+  a[1] += 1;
+  return a.join(",");
+}
+results.push(typed());
+
+// global variables
+function globals() { gv = 3; gv += 2; return gv; }
+results.push(globals(), gv);
+
+// `typeof` doesn't need the variable to exist
+function typeofUndeclared() { return typeof notDeclaredAnywhere; }
+results.push(typeofUndeclared());
+
+// the parser doesn't hoist `var`, so using a name before it refers to a global
+function beforeVar() { hv = 3; var hv; return hv; }
+results.push(beforeVar(), hv);
+
+// things that can't be compiled are still parsed
+function closure() { var a = 1; return function() { return a; }; }
+function tryCatch() { try { throw "oops"; } catch (e) { return e; } }
+results.push(closure()(), tryCatch());
+
+// errors
+function thrower() { throw "thrown"; }
+try { thrower(); } catch (e) { results.push(e); }
+function badField() { var x; return x.foo; }
+try { badField(); } catch (e) { results.push(e.msg); }
+
+// loops outside of functions
+var total = 0;
+for (var k=0;k<10;k++) total += k;
+while (total>0) total -= 7;
+results.push(total, k);
+
+// turning the flag off
+E.setFlags({bytecode:false});
+function notCompiled(a) { return a*2; }
+results.push(notCompiled(4), E.getFlags().bytecode);
+E.setFlags({bytecode:true});
+
+result = JSON.stringify(results) == JSON.stringify([
+  3, "ab", NaN,
+  [25,11,8],
+  '{"a":2,"b c":5,"s":"01234","d":[1,10,3],"f":7,"e":7}',
+  [7,5,7,-3,4,-6,false,"number",null,2,"z",null,"big",3],
+  [5,true,true,false],
+  "0,101,200,44",
+  5, 5,
+  "undefined",
+  undefined, 3,
+  1, "oops",
+  "thrown",
+  "Field or method \"foo\" does not already exist, and can't create it on undefined",
+  -4, 10,
+  8, false]);
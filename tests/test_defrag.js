@@ -0,0 +1,35 @@
+// Defragmenting memory so that large ArrayBuffers can be allocated in one block
+
+var keep = [], drop = [], i;
+// Objects and arrays with indexes
+var obj = {}, arr = [];
+for (i=0;i<100;i++) { obj["k"+i] = i; arr.push(i*2); }
+obj.k50; arr[50]; // make sure the indexes get created
+// The size of an ArrayBuffer when it's in one block (we keep it so its memory doesn't get reused)
+var flat = new Uint8Array(2048);
+var flatSize = E.getSizeOf(flat);
+
+// Fill memory with data, where every other item will be freed
+var free = process.memory().free;
+while (free > 40) {
+  for (i=0;i<(free-40)/6;i++) {
+    keep.push({n:keep.length});
+    drop.push({n:i});
+  }
+  free = process.memory().free;
+}
+drop = undefined;
+process.memory(); // garbage collect
+
+var sizeBefore = E.getSizeOf(new Uint8Array(2048));
+var indexedBefore = process.memory().indexedObjects;
+var r = E.defrag();
+var sizeAfter = E.getSizeOf(new Uint8Array(2048));
+var indexedAfter = process.memory().indexedObjects; // defrag removes indexes...
+
+var ok = true;
+for (i=0;i<keep.length;i++) if (keep[i].n!=i) ok = false;
+for (i=0;i<100;i++) if (obj["k"+i]!=i || arr[i]!=i*2) ok = false;
+var indexedAgain = process.memory().indexedObjects; // ... but just reading from obj creates its index again
+
+result = ok && indexedBefore>0 && indexedAfter==0 && indexedAgain>0 && r.moved>0 && r.time>=0 && sizeBefore>flatSize && sizeAfter==flatSize;
@@ -0,0 +1,29 @@
+// Allocating and freeing lots of flat strings (which use remembered runs of free memory)
+
+function test() {
+  var arrs = [];
+  var i, j, a, ok = true;
+  for (i=0;i<200;i++) {
+    a = new Uint8Array(20 + (i*37)%300);
+    for (j=0;j<a.length;j++) a[j] = i+j;
+    arrs.push(a);
+    if (i%3==0) arrs.shift(); // free some as we go
+  }
+  for (i=0;i<arrs.length;i++) {
+    a = arrs[i];
+    for (j=0;j<a.length;j++) if (a[j]!=((a[0]+j)&255)) ok = false;
+  }
+  // flat strings from E.toString
+  var s = E.toString(new Uint8Array(100).fill(65));
+  return ok && s.length==100 && s[0]=="A" && s[99]=="A";
+}
+
+var r = [false,false,false];
+var usage, after;
+r[0] = test();
+usage = process.memory().usage;
+r[1] = test();
+after = process.memory().usage;
+r[2] = after == usage; // no leaks
+
+result = r.every(function(x){return x;});
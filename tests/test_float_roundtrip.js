@@ -0,0 +1,44 @@
+// Numbers are printed with the fewest digits that read back as the same number, and read back correctly rounded
+
+var results = [];
+// the same as any other JS engine prints them
+results.push(String(0.1), String(0.1+0.2), String(1/3), String(-2/3), String(123.456));
+results.push(String(1e21), String(1e20), String(1.5e300), String(1e-7), String(0.000001), String(1.23e-18));
+results.push(String(5e-324), String(1.7976931348623157e308), String(72.210642), String(-0));
+results.push(JSON.stringify([1.5, 2.25e-9, -1e100]));
+
+// everything reads back as exactly the same number
+var ok = true;
+for (var i=1;i<500;i++) {
+  var v = Math.sin(i) * Math.pow(10, (i%40)-20);
+  if (parseFloat(String(v)) !== v || JSON.parse(JSON.stringify(v)) !== v) ok = false;
+}
+results.push(ok);
+results.push(12345678901234567890123 === 1.2345678901234568e+22, JSON.parse("[98765432109876543210]")[0] === 98765432109876540000);
+
+// numbers that need correct rounding to read
+results.push(parseFloat("2.4703282292062328e-324") === 5e-324);
+results.push(parseFloat("2.4703282292062327e-324") === 0);
+results.push(parseFloat("9007199254740993") === 9007199254740992);
+results.push(parseFloat("9007199254740995") === 9007199254740996);
+results.push(parseFloat("1.000000000000000111022302462515654042363") === 1);
+results.push(parseFloat("1.000000000000000111022302462515654042364") === 1.0000000000000002);
+results.push(parseFloat("1e400"), parseFloat("-1e-400"), parseFloat(".5e1"), parseFloat("12abc"), parseFloat("."));
+
+// other radixes and fixed digits are as before
+results.push((255.5).toString(16), (1.005).toFixed(2), (0.5).toFixed(0));
+
+var expected = ["0.1", "0.30000000000000004", "0.3333333333333333", "-0.6666666666666666", "123.456",
+  "1e+21", "100000000000000000000", "1.5e+300", "1e-7", "0.000001", "1.23e-18",
+  "5e-324", "1.7976931348623157e+308", "72.210642", "0",
+  "[1.5,2.25e-9,-1e+100]",
+  true, true, true, true, true, true, true, true, true,
+  Infinity, -0, 5, 12, NaN,
+  "ff.8", "1.00", (0.5).toFixed(0)];
+result = results.length == expected.length;
+for (i=0;i<expected.length;i++) {
+  if (results[i] !== expected[i] && !(isNaN(results[i]) && isNaN(expected[i]) && typeof results[i]=="number")) {
+    console.log("Mismatch at "+i+": "+results[i]+" vs "+expected[i]);
+    result = false;
+  }
+}
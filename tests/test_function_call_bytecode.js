@@ -0,0 +1,34 @@
+// Compiled functions get their arguments without a scope full of parameter names - make sure they still get the right ones
+
+var results = [];
+function add3(a, b, c) { return [a, b, c]; }
+function dflt(a, b) { b = b || "d"; return a + b; }
+function same(a, a) { return a; }
+function inc(x) { x++; return x; }
+
+results.push(add3(1, 2, 3));
+results.push(add3(1)); // missing arguments
+results.push(add3(1, 2, 3, 4, 5)); // extra arguments
+results.push(dflt("a"), dflt("a", "b"));
+results.push(same(1, 2));
+var v = 5;
+results.push(inc(v), v); // changing an argument doesn't change the caller's variable
+
+// bound 'this' and arguments
+var o = { n : 10, get : function(x) { return this.n + x; } };
+results.push(o.get(1));
+var b = o.get.bind({ n : 20 });
+results.push(b(2));
+var bb = add3.bind(undefined, "x");
+results.push(bb("y"), bb("y", "z"));
+
+// named function expressions can call themselves
+var fact = function f(n) { return n<=1 ? 1 : n*f(n-1); };
+results.push(fact(5));
+
+// called from native code rather than the parser
+results.push([1, 2, 3].map(function(x, i) { return x * 10 + i; }));
+results.push([3, 1, 2].sort(function(a, b) { return a - b; }));
+
+result = JSON.stringify(results) == JSON.stringify([
+  [1,2,3],[1,null,null],[1,2,3],"ad","ab",1,6,5,11,22,["x","y",null],["x","y","z"],120,[10,21,32],[1,2,3]]);
@@ -0,0 +1,42 @@
+// Incremental garbage collection, while JavaScript is moving data around
+
+var live = [], other = [], garbage, i;
+var startPauses, moves = 0;
+
+// Make some cyclic garbage
+garbage = {};
+var first = garbage;
+for (i=0;i<300;i++) garbage = {prev:garbage};
+first.prev = garbage;
+first = undefined;
+// Fill up memory with data we'll keep, so that incremental GC starts on idle
+var free = process.memory().free;
+while (free > 200) {
+  for (i=0;i<(free-200)/4;i++) live.push({n:live.length});
+  free = process.memory().free;
+}
+var total = live.length;
+
+startPauses = process.memory().gcPauses;
+E.setGCBudget(1);
+garbage = undefined;
+
+// Move data from something that may already have been scanned to something that may not
+var interval = setInterval(function() {
+  if (live.length) {
+    other.push(live.pop());
+    moves++;
+  }
+}, 1);
+
+setTimeout(function() {
+  clearInterval(interval);
+  E.setGCBudget(0);
+  var m = process.memory();
+  var all = live.concat(other);
+  var ok = all.length == total;
+  var seen = [];
+  all.forEach(function(o) { if (seen[o.n]) ok = false; seen[o.n] = true; });
+  for (i=0;i<total;i++) if (!seen[i]) ok = false;
+  result = ok && moves>0 && (m.gcPauses - startPauses) > 2;
+}, 200);
@@ -0,0 +1,30 @@
+// Work out what memory is being used for, and where it was allocated
+
+function count(p) {
+  var n = 0;
+  for (var t in p.types) n += p.types[t];
+  return n;
+}
+E.setAllocationTracking(true);
+var before = E.getHeapProfile();
+var things = [];
+function makeThings() {
+  for (var i=0;i<50;i++) things.push({});
+}
+makeThings();
+var buf = new Uint8Array(200);
+var after = E.getHeapProfile();
+E.setAllocationTracking(false);
+
+var ok = count(before)==before.total && count(after)==after.total;
+ok = ok && (after.types.object - before.types.object) >= 50;
+ok = ok && after.types.flatString > (before.types.flatString|0);
+// Somewhere in the code should have allocated all our objects
+var mostAllocated = 0;
+for (var s in after.sites)
+  if (s!="native" && after.sites[s]>mostAllocated) mostAllocated = after.sites[s];
+ok = ok && mostAllocated >= 50;
+// With tracking off there's nothing to report
+ok = ok && E.getHeapProfile().sites===undefined;
+
+result = ok;
@@ -0,0 +1,84 @@
+// Integer maths is done without allocating where possible - make sure the results are still right
+
+var results = [];
+// overflow turns into a float, in the parser and in compiled code
+var big = 2147483647;
+big++;
+results.push(big);
+var big2 = 2147483647;
+big2 += 1;
+results.push(big2);
+function addc(a, b) { return a + b; }
+function mulc(a, b) { return a * b; }
+results.push(addc(2147483647, 1), mulc(65536, 65536), addc(-2147483648, -1));
+// shifts only use the bottom 5 bits of the shift amount
+results.push(1<<32, 1<<33, 256>>33);
+function shl(a, b) { return a << b; }
+results.push(shl(1, 32), shl(1, 31));
+
+// changing a variable mustn't change anything that was copied from it
+var a = 5;
+var b = a;
+a++;
+a += 2;
+results.push(a, b);
+function copies() {
+  var x = 5;
+  var y = x;
+  x++;
+  ++x;
+  x += 10;
+  var z = x++;
+  return [x, y, z];
+}
+results.push(copies());
+var o = { n : 1 };
+var n = o.n;
+o.n++;
+o.n += 3;
+results.push(o.n, n);
+var arr = [1, 2];
+var first = arr[0];
+arr[0]++;
+arr[0] <<= 2;
+results.push(arr[0], first);
+
+// closures, and values on the stack
+function counter() {
+  var c = 0;
+  return function() { return c++; };
+}
+var ctr = counter();
+ctr(); ctr();
+results.push(ctr());
+function loop() {
+  var i, t = 0;
+  for (i = 0; i < 10; i++) t += i;
+  var u = i++ + i++;
+  return [t, i, u];
+}
+results.push(loop());
+
+// using a local as an index mustn't turn the local itself into the array's key
+function keyed() {
+  var a = [], k = 0;
+  a[k] = 5;
+  k += 1;
+  return a[0] + "," + k;
+}
+results.push(keyed());
+function fill() {
+  var a = [];
+  for (var i = 0; i < 5; i++) a[i] = i;
+  return a;
+}
+results.push(fill());
+
+// int/float comparisons and fast paths
+results.push(3 < 4.5, 4.5 < 3, 1 === 1, 1 === 1.0, 2.5 * 2, 7 / 2, 7 % 3);
+
+var expected = [2147483648, 2147483648, 2147483648, 4294967296, -2147483649,
+  1, 2, 128, 1, -2147483648,
+  8, 5, [18, 5, 17], 5, 1, 8, 1, 2, [45, 12, 21], "5,1", [0, 1, 2, 3, 4],
+  true, false, true, true, 5, 3.5, 1];
+result = JSON.stringify(results) == JSON.stringify(expected);
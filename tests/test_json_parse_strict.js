@@ -0,0 +1,30 @@
+// JSON.parse should only accept valid JSON, and should parse it correctly
+
+var ok = [
+  ['{"a":1,"b":[true,false,null],"c":"x\\ny\\u0041"}', {a:1,b:[true,false,null],c:"x\nyA"}],
+  [' [ 1 , -2.5e3 , 0.125, 12345678901234567890 ] ', [1,-2500,0.125,12345678901234567890]],
+  ['"a long string that will not fit into a single block of variables at all, not even close"', "a long string that will not fit into a single block of variables at all, not even close"],
+  ['{"1":"a","x":{"y":{}}}', {1:"a",x:{y:{}}}],
+  ['{"a":1,"a":2}', {a:2}],
+  ['-0', -0],
+  ['"\\"\\\\\\/"', '"\\/'],
+];
+var bad = [ "", "[1,2", "[1,]", "{'a':1}", "{a:1}", '{"a":1,}', "01", "1.", ".5", "+1", "0x10",
+            "NaN", "Infinity", "undefined", "tru", "[1] x", '"abc', '"\\x41"', "\"a\nb\"", "1+1", "function(){}" ];
+
+var errors = [];
+ok.forEach(function(t) {
+  var v = JSON.parse(t[0]);
+  if (JSON.stringify(v)!=JSON.stringify(t[1])) errors.push(t[0]);
+});
+bad.forEach(function(t) {
+  try {
+    JSON.parse(t);
+    errors.push(t);
+  } catch (e) {
+    if (!(e instanceof SyntaxError)) errors.push(t);
+  }
+});
+if (errors.length) console.log("Failed:", errors);
+
+result = errors.length==0 && 1/JSON.parse("-0")<0 && JSON.parse("[1,2]").length==2;
@@ -0,0 +1,34 @@
+// JSON.Parser should give the same values however the JSON is split up
+
+function parse(options, chunks) {
+  var values = [];
+  var p = new JSON.Parser(options);
+  p.on('value', function(v) { values.push(v); });
+  chunks.forEach(function(c) { p.write(c); });
+  p.end();
+  return JSON.stringify(values);
+}
+function split(s, n) {
+  var r = [];
+  for (var i=0;i<s.length;i+=n) r.push(s.substr(i,n));
+  return r;
+}
+
+var doc = JSON.stringify({count:3, meta:{a:[1,2],"it\"ems":5}, items:[{name:"a",v:1.5},{name:"b",v:[true,null]},{name:"c}",v:"x,]"}]});
+var ok = true;
+for (var n=1;n<10;n++) {
+  var chunks = split(doc, n);
+  ok = ok &&
+    parse({path:["items","*"]}, chunks)==JSON.stringify(JSON.parse(doc).items) &&
+    parse({path:"items.1.v"}, chunks)=='[[true,null]]' &&
+    parse({path:["meta","it\"ems"]}, chunks)=='[5]' &&
+    parse({path:["*","a"]}, chunks)=='[[1,2]]' &&
+    parse(undefined, split(doc+' 12 "s"\n-3.5e2 {} 7', n))=="["+doc+',12,"s",-350,{},7]';
+}
+
+var errors = 0;
+['[1,2}', '{"a":1', '[1] {a:1}', '[01]'].forEach(function(json) {
+  try { parse(undefined, [json]); } catch (e) { if (e instanceof SyntaxError) errors++; }
+});
+
+result = ok && errors==4 && new JSON.Parser() instanceof JSON.Parser;
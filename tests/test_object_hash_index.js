@@ -0,0 +1,45 @@
+// Objects with lots of keys get a hash index - check it behaves like a normal object
+
+var o = {};
+var i;
+for (i=0;i<200;i++) o["key"+i] = i;
+var r = [];
+
+r.push(process.memory().indexedObjects>=1);
+var ok = true;
+for (i=0;i<200;i++) if (o["key"+i]!==i) ok = false;
+r.push(ok);
+r.push(o.key500===undefined && !("key500" in o));
+
+// delete and re-add
+for (i=0;i<200;i+=2) delete o["key"+i];
+ok = true;
+for (i=0;i<200;i++) if (o["key"+i]!==((i&1)?i:undefined)) ok = false;
+r.push(ok);
+for (i=0;i<200;i+=2) o["key"+i] = -i;
+ok = true;
+for (i=0;i<200;i++) if (o["key"+i]!==((i&1)?i:-i)) ok = false;
+r.push(ok);
+
+// key order is still insertion order
+var k = Object.keys(o);
+r.push(k.length==200 && k[0]=="key1" && k[99]=="key199" && k[100]=="key0" && k[199]=="key198");
+var n = 0;
+for (i in o) n++;
+r.push(n==200);
+r.push(JSON.parse(JSON.stringify(o)).key3==3);
+
+// integer keys
+var a = {};
+for (i=0;i<100;i++) a[i] = i*2;
+ok = true;
+for (i=0;i<100;i++) if (a[i]!==i*2 || a[""+i]!==i*2) ok = false;
+r.push(ok);
+
+// removing all keys
+for (i in o) delete o[i];
+r.push(Object.keys(o).length==0);
+o.foo = 1;
+r.push(o.foo==1);
+
+result = r.every(function(x){return x;});
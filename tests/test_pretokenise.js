@@ -0,0 +1,50 @@
+// Function code is stored pretokenised - make sure it still runs and prints the same
+
+var results = [];
+function ops(a,b) {
+  // operators that mustn't join together when whitespace is removed
+  var x = a - -b, y = a + +b, z = a- --b;
+  return [x, y, z, 1 .toString(), 1.5.toFixed(1), a<-b, a/ /* comment */ 2];
+}
+results.push(ops(4,2).join());
+
+function words(o) { return o.if + o["return"] + o.new + (typeof o) + ("if" in o) + (o instanceof Object); }
+results.push(words({"if":1, "return":2, "new":3}));
+
+function strs() { return "a°b\"c//d" + 'e/*f' + `g${1+2}h`; }
+results.push(strs());
+
+// printing it out should give code that works the same
+function printed() {
+  var s = "x";
+  if (s.length>0 && typeof s=="string") return s+s;
+}
+results.push(printed.toString());
+eval("var printed2 = "+printed.toString());
+results.push(printed2());
+
+// line numbers are still right
+function thrower() {
+  var a = 1;
+
+  a.foo.bar = 2;
+}
+try { thrower(); } catch (e) { results.push(e.stack.split("\n")[0].trim().substr(0,9)); }
+
+// and we can turn it off to keep the source
+E.setFlags({pretokenise:false});
+function src() { return 1 /* comment */; }
+results.push(src.toString(), E.getFlags().pretokenise);
+E.setFlags({pretokenise:true});
+results.push(E.getFlags().pretokenise);
+
+result = JSON.stringify(results) == JSON.stringify([
+  "6,6,3,1,1.5,false,2",
+  "6objecttruetrue",
+  "a°b\"c//de/*fg3h",
+  "function () {\n  var s=\"x\";\nif(s.length>0&&typeof s==\"string\")return s+s;\n}",
+  "xx",
+  "at line 3",
+  "function () {return 1 /* comment */;}", false,
+  true
+]);
@@ -0,0 +1,28 @@
+// Check that the profiler counts calls and builds call stacks properly
+
+function inner(n) { var s=0; for (var i=0;i<n;i++) s+=i; return s; }
+function outer() {
+  var t=0;
+  for (var k=0;k<5;k++) t+=inner(10);
+  return t;
+}
+var fact = function f(n) { return n<=1 ? 1 : n*f(n-1); };
+
+E.profile(true, 0.01);
+outer();
+fact(5);
+[1,2,3].forEach(function(x) { inner(x); });
+E.profile(false);
+var p = E.getProfile();
+var folded = E.getProfile("folded");
+
+function find(name) {
+  return p.functions.filter(function(f) { return f.name==name; })[0];
+}
+var okTimes = p.functions.every(function(f) { return f.time>=0 && f.selfTime>=0 && f.selfTime<=f.time+0.001; });
+
+result = find("inner").calls==8 && find("outer").calls==1 && find("fact").calls==5 &&
+  find("forEach").calls==1 && okTimes && p.time>=0 && p.lines.length>0 &&
+  folded.indexOf("(top);outer;inner ")>=0 &&
+  folded.indexOf("(top);forEach;(anonymous);inner ")>=0 &&
+  folded.indexOf("(top);fact;fact;fact;fact;fact ")>=0;
@@ -0,0 +1,56 @@
+// Property accesses remember where they found things - make sure that's always still right
+
+var results = [];
+function get(o) { return o.val; } // the same access site, used for different objects
+
+// own properties that get removed and added
+var a = {val:1};
+results.push(get(a));
+delete a.val;
+results.push(get(a));
+a.val = 2;
+results.push(get(a));
+
+// inherited properties that get hidden, changed, and un-hidden
+function Foo() {}
+Foo.prototype.val = 3;
+var f = new Foo();
+results.push(get(f));
+f.val = 4;
+results.push(get(f));
+delete f.val;
+Foo.prototype.val = 5;
+results.push(get(f));
+Foo.prototype = { val : 6 };
+results.push(get(new Foo()), get(f));
+
+// changing what something inherits from
+var p1 = {val:7}, p2 = {val:8};
+var o = Object.create(p1);
+results.push(get(o));
+o.__proto__ = p2;
+results.push(get(o));
+
+// new objects (which may reuse the memory of old ones) with different properties
+var i;
+for (i=0;i<4;i++) {
+  var n = (i&1) ? {val:i} : {other:i};
+  results.push(get(n));
+}
+
+// built-in functions, which can be replaced
+var arr = [1,2,3];
+function idx(a) { return a.indexOf(2); }
+results.push(idx(arr));
+arr.indexOf = function() { return "own"; };
+results.push(idx(arr));
+delete arr.indexOf;
+results.push(idx(arr));
+
+// different names that end up with the same key ('a'*31+'b' == 'b'*31+'C'),
+// accessed from the same place (the code for each eval is in the same place)
+var c = {ab:"x", bC:"y"};
+results.push(eval("c.ab"), eval("c.bC"));
+
+result = JSON.stringify(results) ==
+  JSON.stringify([1,undefined,2,3,4,5,6,5,7,8,undefined,1,undefined,3,1,"own",1,"x","y"]);
@@ -0,0 +1,13 @@
+// A burst of characters much bigger than the old IO buffer should all arrive, in order
+var sent = "";
+for (var i=0;i<4096;i++) sent += String.fromCharCode(32+(i*7)%95);
+var received = "", events = 0;
+LoopbackB.on('data', function(d) { received += d; events++; });
+E.getErrorFlags(); // clear any old errors
+LoopbackA.write(sent);
+
+setTimeout(function() {
+  var errors = E.getErrorFlags();
+  result = received==sent && events<=4 && errors.indexOf("FIFO_FULL")<0;
+  if (!result) console.log(received.length, events, errors);
+}, 20);
@@ -0,0 +1,14 @@
+// Serial.write/print/println send their data in blocks - check nothing is lost or reordered at the block boundaries
+var long = "";
+for (var i=0;i<100;i++) long += String.fromCharCode(65+i%26);
+var received = "";
+LoopbackB.on('data', function(d) { received += d; });
+LoopbackA.write(long, [49,50,51], {data:"xy", count:20}, 52);
+LoopbackA.print([1,2,3]);
+LoopbackA.println(long);
+
+var expected = long + "123" + "xyxyxyxyxyxyxyxyxyxyxyxyxyxyxyxyxyxyxyxy" + "4" + "1,2,3" + long + "\r\n";
+setTimeout(function() {
+  result = received==expected;
+  if (!result) console.log(JSON.stringify(received));
+}, 10);
@@ -0,0 +1,43 @@
+// Appending to lots of strings at once (which uses the cache of where strings end)
+
+var strs = ["","","","","","","",""];
+var i, j, ok = true;
+for (i=0;i<200;i++) {
+  for (j=0;j<strs.length;j++) {
+    // different strings get appended at different rates
+    if (i%(j+1)==0) strs[j] += String.fromCharCode(65+(i%26));
+  }
+  if (i==100) {
+    process.memory(); // garbage collect
+    E.defrag(); // move everything around
+  }
+}
+for (j=0;j<strs.length;j++) {
+  var expected = "";
+  for (i=0;i<200;i++)
+    if (i%(j+1)==0) expected = expected + String.fromCharCode(65+(i%26));
+  if (strs[j] != expected || strs[j].length != expected.length) ok = false;
+}
+
+// Strings that get copied, used as names, and appended to
+var a = "Hello World, this is a long string";
+var b = a + "!";
+b += "?";
+var o = {};
+o[b] = 42;
+b += ".";
+a += "#";
+ok = ok && a == "Hello World, this is a long string#" &&
+  b == "Hello World, this is a long string!?." && b.length == 37 &&
+  o["Hello World, this is a long string!?"] == 42;
+
+// A string that gets freed and its memory reused
+var c = "";
+for (i=0;i<50;i++) c += "abc";
+var len = c.length;
+c = undefined;
+var d = "x";
+for (i=0;i<50;i++) d += "def";
+ok = ok && len==150 && d.length==151 && d.substr(148)=="def";
+
+result = ok;
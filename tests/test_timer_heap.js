@@ -0,0 +1,27 @@
+// Timers should run in the order they're due, however they're added, changed or cleared
+
+var log = [];
+function add(name, ms) {
+  return setTimeout(function() { log.push(name); }, ms);
+}
+// lots of timers, added out of order
+// (they're all at least 10ms apart, so a slow run doesn't change the order)
+for (var i=20;i>0;i--) add(String.fromCharCode(96+i), 10+i*20);
+clearTimeout(add("never", 60));
+var n = 0;
+var iv = setInterval(function() {
+  log.push("i"+(++n));
+  if (n==2) changeInterval(iv, 1000); // next one is 1s away, so never runs
+}, 40);
+var selfRuns = 0;
+setTimeout(function() {
+  clearInterval(iv);
+  // a timer clearing itself while it runs
+  var self = setInterval(function() { selfRuns++; clearInterval(self); }, 5);
+  // move vars around under the timers
+  E.defrag();
+}, 100);
+setTimeout(function() {
+  result = selfRuns==1 && log.join(",") == "a,i1,b,c,i2,d,e,f,g,h,i,j,k,l,m,n,o,p,q,r,s,t";
+  if (!result) console.log(selfRuns, log.join(","));
+}, 500);
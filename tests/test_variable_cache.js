@@ -0,0 +1,59 @@
+// Compiled code remembers where it found variables - make sure that's always still right
+
+var results = [];
+var v = "global";
+function get() { return v; }
+function set(x) { v = x; }
+results.push(get());
+set("changed");
+results.push(get(), v);
+
+// deleting a global, then creating it again
+delete v;
+try { get(); } catch (e) { results.push("deleted"); }
+v = "again";
+results.push(get());
+
+// closures see their own scope, even if they're the same code
+function make(x) { return function() { return x; }; }
+var a = make(1), b = make(2);
+results.push(a(), b(), a());
+
+// a variable added to an outer scope hides the global one
+var hide = "global";
+function outer(define) {
+  var f = function() { return hide; };
+  var r = [f()];
+  if (define) eval("var hide = 'local'");
+  r.push(f());
+  return r;
+}
+results.push(outer(false), outer(true));
+
+// functions that are redefined
+for (var i=0;i<3;i++) {
+  eval("function redefined() { return " + i + "; }");
+  results.push(redefined());
+}
+
+// built-in functions replaced by globals
+function builtin() { return typeof getTime; }
+results.push(builtin());
+var getTime = 5;
+results.push(builtin());
+delete getTime;
+results.push(builtin());
+
+// loops outside of functions
+var total = 0;
+for (var j=0;j<5;j++) total += j;
+results.push(total);
+
+result = JSON.stringify(results) == JSON.stringify([
+  "global", "changed", "changed",
+  "deleted", "again",
+  1, 2, 1,
+  ["global","global"], ["global","local"],
+  0, 1, 2,
+  "function", "number", "function",
+  10]);
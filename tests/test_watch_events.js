@@ -0,0 +1,36 @@
+// Watches should be called for the right edges, debounced, and removed when they don't repeat
+// (uses E.simulatePinChange, so only runs on Linux)
+
+var log = [];
+// edge filtering
+setWatch(function(e) { log.push("r"+e.state); }, D1, {repeat:true, edge:"rising"});
+setWatch(function(e) { log.push("f"+e.state); }, D1, {repeat:true, edge:"falling"});
+E.simulatePinChange(D1, 1);
+E.simulatePinChange(D1, 0);
+E.simulatePinChange(D1, 1);
+// non-repeating watches are removed after they're called
+var once = setWatch(function() { log.push("once"); }, D2, {repeat:false});
+E.simulatePinChange(D2, 1);
+E.simulatePinChange(D2, 0);
+// a watch that sets itself up again from its callback isn't called again for the same edge
+var rearms = 0;
+function arm() { setWatch(function() { rearms++; arm(); }, D3, {repeat:false}); }
+arm();
+E.simulatePinChange(D3, 1);
+// bounces within the debounce time only call the watch once, with the final state
+setWatch(function(e) { log.push("d"+e.state); }, D4, {repeat:true, debounce:20});
+E.simulatePinChange(D4, 1);
+E.simulatePinChange(D4, 0);
+E.simulatePinChange(D4, 1);
+
+setTimeout(function() {
+  E.simulatePinChange(D3, 0);
+  E.simulatePinChange(D4, 0);
+}, 60);
+setTimeout(function() {
+  var removed = false;
+  try { clearWatch(once); } catch (e) { removed = true; }
+  result = removed && rearms==2 &&
+    log.join(",") == "rtrue,ffalse,rtrue,once,dtrue,dfalse";
+  if (!result) console.log(removed, rearms, log.join(","));
+}, 150);